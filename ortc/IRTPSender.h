@@ -98,6 +98,19 @@ namespace ortc
 
     virtual PromisePtr send(const Parameters &parameters) = 0;
     virtual void stop() = 0;
+
+    // NOTE: forwards RTP arriving on the receiver out this sender without
+    //       decoding or re-encoding (i.e. selective forwarding). The SSRC,
+    //       sequence numbers, timestamps, payload types and header
+    //       extensions are rewritten to match this sender's parameters and
+    //       RTCP feedback (NACK/PLI/FIR/REMB) is translated back to the
+    //       source. When a "rid" is specified only that encoding of the
+    //       receiver is forwarded. Specify a NULL receiver to stop
+    //       forwarding.
+    virtual PromisePtr setForwardingSource(
+                                           IRTPReceiverPtr receiver,
+                                           const char *rid = NULL
+                                           ) = 0;
   };
 
   //---------------------------------------------------------------------------
@@ -296,6 +296,153 @@ namespace ortc
       }
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark SSLContextCache
+    #pragma mark
+
+    ZS_DECLARE_CLASS_PTR(SSLContextCache)
+
+    // Process wide cache of fully configured SSL_CTX objects so that the
+    // certificate, key, cipher list and SRTP profile setup is only paid once
+    // per distinct configuration rather than once per DTLS transport. The
+    // cache holds one reference to each context; every transport takes its
+    // own reference and releases it with SSL_CTX_free as before.
+    class SSLContextCache : public SharedRecursiveLock,
+                            public ISingletonManagerDelegate
+    {
+    protected:
+      struct make_private {};
+
+      typedef String Key;
+      typedef std::list<Key> KeyList;
+      typedef std::pair<SSL_CTX *, KeyList::iterator> ContextPair;
+      typedef std::map<Key, ContextPair> ContextMap;
+
+    public:
+      //-----------------------------------------------------------------------
+      SSLContextCache(const make_private &) :
+        SharedRecursiveLock(SharedRecursiveLock::create()),
+        mMaxContexts(UseSettings::getUInt(ORTC_SETTING_DTLS_TRANSPORT_MAX_CACHED_SSL_CONTEXTS))
+      {
+      }
+
+      //-----------------------------------------------------------------------
+      ~SSLContextCache()
+      {
+        clear();
+      }
+
+      //-----------------------------------------------------------------------
+      static SSLContextCachePtr create()
+      {
+        SSLContextCachePtr pThis(make_shared<SSLContextCache>(make_private{}));
+        return pThis;
+      }
+
+      //-----------------------------------------------------------------------
+      static SSLContextCachePtr singleton()
+      {
+        AutoRecursiveLock lock(*UseServicesHelper::getGlobalLock());
+        static SingletonLazySharedPtr<SSLContextCache> singleton(create());
+        SSLContextCachePtr result = singleton.singleton();
+
+        static zsLib::SingletonManager::Register registerSingleton("ortc::SSLContextCache", result);
+
+        if (!result) {
+          ZS_LOG_WARNING(Detail, slog("singleton gone"))
+        }
+
+        return result;
+      }
+
+      //-----------------------------------------------------------------------
+      static Log::Params slog(const char *message)
+      {
+        return Log::Params(message, "ortc::SSLContextCache");
+      }
+
+      //-----------------------------------------------------------------------
+      // returns a context with a reference owned by the caller (or NULL)
+      SSL_CTX *find(const Key &key)
+      {
+        AutoRecursiveLock lock(*this);
+
+        auto found = mContexts.find(key);
+        if (found == mContexts.end()) return NULL;
+
+        auto &info = (*found).second;
+
+        // move to the front of the most recently used list
+        mUsage.splice(mUsage.begin(), mUsage, info.second);
+
+        SSL_CTX_up_ref(info.first);
+        return info.first;
+      }
+
+      //-----------------------------------------------------------------------
+      // the cache takes its own reference to the context
+      void add(
+               const Key &key,
+               SSL_CTX *ctx
+               )
+      {
+        if (0 == mMaxContexts) return;
+
+        AutoRecursiveLock lock(*this);
+
+        if (mContexts.end() != mContexts.find(key)) return;  // lost a race with another transport (keep the original)
+
+        SSL_CTX_up_ref(ctx);
+
+        mUsage.push_front(key);
+        mContexts[key] = ContextPair(ctx, mUsage.begin());
+
+        while (mContexts.size() > mMaxContexts) {
+          auto found = mContexts.find(mUsage.back());
+          ZS_THROW_BAD_STATE_IF(found == mContexts.end())
+
+          ZS_LOG_DEBUG(slog("evicting ssl context") + ZS_PARAM("key", (*found).first))
+
+          SSL_CTX_free((*found).second.first);
+          mContexts.erase(found);
+          mUsage.pop_back();
+        }
+      }
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark SSLContextCache => ISingletonManagerDelegate
+      #pragma mark
+
+      virtual void notifySingletonCleanup() override
+      {
+        clear();
+      }
+
+      //-----------------------------------------------------------------------
+      void clear()
+      {
+        AutoRecursiveLock lock(*this);
+
+        for (auto iter = mContexts.begin(); iter != mContexts.end(); ++iter) {
+          SSL_CTX_free((*iter).second.first);
+        }
+        mContexts.clear();
+        mUsage.clear();
+      }
+
+    protected:
+      size_t mMaxContexts {};
+
+      KeyList mUsage;
+      ContextMap mContexts;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -310,6 +457,10 @@ namespace ortc
       UseSettings::setUInt(ORTC_SETTING_DTLS_TRANSPORT_MAX_PENDING_DTLS_BUFFER, kMaxDtlsPacketLen*4);
 
       UseSettings::setUInt(ORTC_SETTING_DTLS_TRANSPORT_MAX_PENDING_RTP_PACKETS, 50);
+
+      UseSettings::setUInt(ORTC_SETTING_DTLS_TRANSPORT_MAX_CACHED_SSL_CONTEXTS, 32);
+
+      UseSettings::setUInt(ORTC_SETTING_ORTC_DTLS_HANDSHAKE_THREADS, 2);
     }
 
     //-------------------------------------------------------------------------
@@ -516,7 +667,7 @@ namespace ortc
                                            const CertificateList &certificates
                                            )
     {
-      DTLSTransportPtr pThis(make_shared<DTLSTransport>(make_private {}, IORTCForInternal::queueORTC(), delegate, iceTransport, certificates));
+      DTLSTransportPtr pThis(make_shared<DTLSTransport>(make_private {}, IORTCForInternal::queueDTLSHandshake(), delegate, iceTransport, certificates));
       pThis->mThisWeak = pThis;
       pThis->init();
       return pThis;
@@ -743,6 +894,59 @@ namespace ortc
       return transport->sendPacket(sendOverICETransport, packetType, buffer, bufferLengthInBytes);
     }
 
+    //-------------------------------------------------------------------------
+    bool DTLSTransport::sendPackets(
+                                    IICETypes::Components sendOverICETransport,
+                                    IICETypes::Components packetType,
+                                    const PacketBufferList &packets
+                                    )
+    {
+      ZS_LOG_TRACE(log("sending rtp packets") + ZS_PARAM("total packets", packets.size()))
+
+      UseSRTPTransportPtr transport;
+
+      {
+        AutoRecursiveLock lock(*this);
+        if (!mSRTPTransport) {
+          ZS_LOG_WARNING(Debug, log("srtp transport is not ready"))
+          return false;
+        }
+
+        transport = mSRTPTransport;
+
+        if ((isShutdown()) ||
+            (isShuttingDown())) {
+          ZS_LOG_WARNING(Debug, log("cannot send rtp packets while shutdown/shutting down") + ZS_PARAM("total packets", packets.size()))
+          return false;
+        }
+
+        if (!isValidated()) {
+          ZS_LOG_WARNING(Debug, log("cannot send rtp packets while stream is not validated") + ZS_PARAM("total packets", packets.size()))
+          return false;
+        }
+      }
+
+      // WARNING: Best to not send packets to srtp transport inside an object lock
+      return transport->sendPackets(sendOverICETransport, packetType, packets);
+    }
+
+    //-------------------------------------------------------------------------
+    void DTLSTransport::flushPackets(IICETypes::Components sendOverICETransport)
+    {
+      UseICETransportPtr transport;
+
+      {
+        AutoRecursiveLock lock(*this);
+        transport = mICETransport;
+      }
+
+      if (!transport) return;
+
+      ASSERT(sendOverICETransport == transport->component())
+
+      // WARNING: Best to not flush the ice transport inside an object lock
+      transport->flushPackets();
+    }
 
     //-------------------------------------------------------------------------
     IICETransportPtr DTLSTransport::getICETransport() const
@@ -827,15 +1031,21 @@ namespace ortc
 
           if (mPendingIncomingDTLS.CurrentSize() < mMaxPendingDTLSBuffer) {
             mPendingIncomingDTLS.Put(buffer, bufferLengthInBytes);
+            mPendingIncomingDTLSSizes.push(bufferLengthInBytes);
           } else {
             ZS_LOG_WARNING(Debug, log("too many pending dtls packets (thus ignoring incoming dtls packet)"))
           }
 
-          if (!mFixedRole) {
-            EventWriteOrtcDtlsTransportRoleSet(__func__, mID, IDTLSTransportTypes::toString(IDTLSTransport::Role_Server));
-            mFixedRole = true;
-            mAdapter->setServerRole();
-            mAdapter->startSSLWithPeer();
+          if ((!mFixedRole) ||
+              (Adapter::SS_OPEN != mAdapter->getState())) {
+            // handshake records are processed on the transport's handshake
+            // worker queue so the packet thread is never stalled by the
+            // signature and key exchange work
+            if (!mPendingIncomingDTLSPosted) {
+              mPendingIncomingDTLSPosted = true;
+              IDTLSTransportAsyncDelegateProxy::create(mThisWeak.lock())->onAdapterReadPendingDTLS();
+            }
+            return true;
           }
 
           BYTE extractedBuffer[kMaxDtlsPacketLen] {};
@@ -982,12 +1192,41 @@ namespace ortc
       return transport->sendPacket(buffer, bufferLengthInBytes);
     }
 
+    //-------------------------------------------------------------------------
+    bool DTLSTransport::sendEncryptedPackets(
+                                             IICETypes::Components sendOverICETransport,
+                                             IICETypes::Components packetType,
+                                             const PacketBufferList &packets
+                                             )
+    {
+      UseICETransportPtr transport;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if ((isShuttingDown()) ||
+            (isShutdown())) {
+          ZS_LOG_WARNING(Debug, log("cannot send encrypted packets while shutdown") + ZS_PARAM("send over component", IICETypes::toString(sendOverICETransport)) + ZS_PARAM("packet type", packetType) + ZS_PARAM("total packets", packets.size()))
+          return false;
+        }
+
+        transport = mICETransport;
+        if (!transport) {
+          ZS_LOG_WARNING(Debug, log("ice transport is not available") + ZS_PARAM("send over component", IICETypes::toString(sendOverICETransport)) + ZS_PARAM("packet type", packetType) + ZS_PARAM("total packets", packets.size()))
+          return false;
+        }
+
+        ASSERT(sendOverICETransport == transport->component())
+      }
+
+      return transport->sendPackets(packets);
+    }
+
     //-------------------------------------------------------------------------
     bool DTLSTransport::handleReceivedDecryptedPacket(
                                                       IICETypes::Components viaTransport,
                                                       IICETypes::Components packetType,
-                                                      const BYTE *buffer,
-                                                      size_t bufferLengthInBytes
+                                                      SecureByteBlockPtr decryptedBuffer
                                                       )
     {
       {
@@ -995,16 +1234,16 @@ namespace ortc
 
         if ((isShuttingDown()) ||
             (isShutdown())) {
-          ZS_LOG_WARNING(Debug, log("cannot send encrypted packet while shutdown") + ZS_PARAM("packet type", packetType) + ZS_PARAM("buffer length", bufferLengthInBytes))
+          ZS_LOG_WARNING(Debug, log("cannot send encrypted packet while shutdown") + ZS_PARAM("packet type", packetType) + ZS_PARAM("buffer length", decryptedBuffer->SizeInBytes()))
           return false;
         }
       }
 
-      EventWriteOrtcDtlsTransportForwardingPacketToRtpListener(__func__, mID, mRTPListener->getID(), zsLib::to_underlying(viaTransport), zsLib::to_underlying(packetType), SafeInt<unsigned int>(bufferLengthInBytes), buffer);
+      EventWriteOrtcDtlsTransportForwardingPacketToRtpListener(__func__, mID, mRTPListener->getID(), zsLib::to_underlying(viaTransport), zsLib::to_underlying(packetType), SafeInt<unsigned int>(decryptedBuffer->SizeInBytes()), decryptedBuffer->BytePtr());
 
-      ZS_LOG_INSANE(log("forwarding packet to RTP listener") + ZS_PARAM("rtp listener id", mRTPListener->getID()) + ZS_PARAM("via", IICETypes::toString(viaTransport)) + ZS_PARAM("packet type", IICETypes::toString(packetType)) + ZS_PARAM("buffer length", bufferLengthInBytes))
+      ZS_LOG_INSANE(log("forwarding packet to RTP listener") + ZS_PARAM("rtp listener id", mRTPListener->getID()) + ZS_PARAM("via", IICETypes::toString(viaTransport)) + ZS_PARAM("packet type", IICETypes::toString(packetType)) + ZS_PARAM("buffer length", decryptedBuffer->SizeInBytes()))
 
-      return mRTPListener->handleRTPPacket(mComponent, packetType, buffer, bufferLengthInBytes);
+      return mRTPListener->handleRTPPacket(mComponent, packetType, decryptedBuffer);
     }
 
     //-------------------------------------------------------------------------
@@ -1230,14 +1469,14 @@ namespace ortc
             // cannot fit next packet into fill buffer so data filled thus far
             if (filled > 0) {
               EventWriteOrtcDtlsTransportForwardDataPacketToIceTransport(__func__, mID, transport->getID(), SafeInt<unsigned int>(filled), &(fillBuffer[0]));
-              if (!transport->sendPacket(&(fillBuffer[0]), filled)) return;
+              if (!transport->sendPacket(&(fillBuffer[0]), filled)) goto flush_packets;
               filled = 0;
             }
 
             if (packet->SizeInBytes() > sizeof(fillBuffer)) {
               // packet size exceed buffer capacity so send it immediately (anything previous put into fill buffer has been sent already)
               EventWriteOrtcDtlsTransportForwardDataPacketToIceTransport(__func__, mID, transport->getID(), SafeInt<unsigned int>(packet->SizeInBytes()), packet->BytePtr());
-              if (!transport->sendPacket(*packet, packet->SizeInBytes())) return;
+              if (!transport->sendPacket(*packet, packet->SizeInBytes())) goto flush_packets;
               continue;
             }
           }
@@ -1249,10 +1488,90 @@ namespace ortc
         if (0 != filled) {
           // final push of filled buffer over the wire
           EventWriteOrtcDtlsTransportForwardDataPacketToIceTransport(__func__, mID, transport->getID(), SafeInt<unsigned int>(filled), &(fillBuffer[0]));
-          if (!transport->sendPacket(&(fillBuffer[0]), filled)) return;
+          if (!transport->sendPacket(&(fillBuffer[0]), filled)) goto flush_packets;
           filled = 0;
         }
       }
+
+    flush_packets:
+      {
+        // handshake and data channel packets are never held for a flush window
+        transport->flushPackets();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void DTLSTransport::onAdapterReadPendingDTLS()
+    {
+      ZS_LOG_TRACE(log("on adapter read pending dtls"))
+
+      while (true) {
+        SecureByteBlockPtr decryptedPacket;
+
+        {
+          AutoRecursiveLock lock(*this);
+
+          mPendingIncomingDTLSPosted = false;
+
+          if (isShutdown()) {
+            ZS_LOG_WARNING(Debug, log("cannot read pending dtls packets while shutdown"))
+            return;
+          }
+
+          if (mPendingIncomingDTLSSizes.size() < 1) {
+            ZS_LOG_TRACE(log("no pending dtls packets to read"))
+            return;
+          }
+
+          if (!mFixedRole) {
+            EventWriteOrtcDtlsTransportRoleSet(__func__, mID, IDTLSTransportTypes::toString(IDTLSTransport::Role_Server));
+            mFixedRole = true;
+            mAdapter->setServerRole();
+            mAdapter->startSSLWithPeer();
+          }
+
+          auto pendingBefore = mPendingIncomingDTLSSizes.size();
+
+          BYTE extractedBuffer[kMaxDtlsPacketLen] {};
+
+          size_t read = 0;
+          int error = 0;
+          auto result = mAdapter->read(extractedBuffer, sizeof(extractedBuffer), &read, &error);
+
+          wakeUpIfNeeded();
+
+          switch (result) {
+            case SR_SUCCESS: {
+              decryptedPacket = make_shared<SecureByteBlock>(extractedBuffer, read);
+              break;
+            }
+            case SR_BLOCK: {
+              if (mPendingIncomingDTLSSizes.size() >= pendingBefore) {
+                ZS_LOG_TRACE(log("dtls adapter did not consume packet (waiting for more activity)"))
+                return;
+              }
+              ZS_LOG_TRACE(log("dtls packet consumed"))
+              continue;
+            }
+            case SR_EOS:  {
+              ZS_LOG_DEBUG(log("end of stream reached (thus shutting down)"))
+              cancel();
+              return;
+            }
+            case SR_ERROR: {
+              ZS_LOG_ERROR(Debug, log("read error found (thus shutting down)") + ZS_PARAM("error code", error))
+              cancel();
+              return;
+            }
+          }
+        }
+
+        // WARNING: Forward packet to data channel outside of object lock
+        if (decryptedPacket) {
+          EventWriteOrtcDtlsTransportForwardingPacketToDataTransport(__func__, mID, mDataTransport->getID(), zsLib::to_underlying(component()), SafeInt<unsigned int>(decryptedPacket->SizeInBytes()), decryptedPacket->BytePtr());
+          mDataTransport->handleDataPacket(decryptedPacket->BytePtr(), decryptedPacket->SizeInBytes());
+        }
+      }
     }
 
     //-------------------------------------------------------------------------
@@ -1443,13 +1762,19 @@ namespace ortc
     //-------------------------------------------------------------------------
     size_t DTLSTransport::adapterReadPacket(BYTE *buffer, size_t bufferLengthInBytes)
     {
-      size_t currentSize = SafeInt<CryptoPP::lword>(mPendingIncomingDTLS.CurrentSize());
-      if (currentSize < 1) return 0;
+      if (mPendingIncomingDTLSSizes.size() < 1) return 0;
 
-      auto readSize = (currentSize < bufferLengthInBytes ? currentSize : bufferLengthInBytes);
+      // never read across a datagram boundary (DTLS records must be handed
+      // to the SSL library one datagram at a time)
+      size_t &datagramSize = mPendingIncomingDTLSSizes.front();
+
+      auto readSize = (datagramSize < bufferLengthInBytes ? datagramSize : bufferLengthInBytes);
 
       mPendingIncomingDTLS.Get(buffer, readSize);
 
+      datagramSize -= readSize;
+      if (0 == datagramSize) mPendingIncomingDTLSSizes.pop();
+
       return readSize;
     }
 
@@ -1518,6 +1843,8 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "put pending incoming RTP packets into queue", mPutIncomingRTPIntoPendingQueue);
       UseServicesHelper::debugAppend(resultEl, "pending incoming RTP packets", mPendingIncomingRTP.size());
       UseServicesHelper::debugAppend(resultEl, "pending incoming dtls buffer size (bytes)", mPendingIncomingDTLS.CurrentSize());
+      UseServicesHelper::debugAppend(resultEl, "pending incoming dtls packets", mPendingIncomingDTLSSizes.size());
+      UseServicesHelper::debugAppend(resultEl, "pending incoming dtls posted", mPendingIncomingDTLSPosted);
 
       UseServicesHelper::debugAppend(resultEl, "pending outgoing dtls packets", mPendingOutgoingDTLS.size());
 
@@ -2767,6 +3094,18 @@ namespace ortc
     {
       SSL_CTX *ctx = NULL;
 
+      auto cache = SSLContextCache::singleton();
+      String cacheKey = getSSLContextCacheKey();
+
+      if ((cache) &&
+          (cacheKey.hasData())) {
+        ctx = cache->find(cacheKey);
+        if (ctx) {
+          ZS_LOG_TRACE(log("using cached ssl context") + ZS_PARAM("key", cacheKey))
+          return ctx;
+        }
+      }
+
       ctx = SSL_CTX_new(ssl_mode_ == SSL_MODE_DTLS ? DTLS_method() : TLS_method());
       // Version limiting for BoringSSL will be done below.
 
@@ -2825,9 +3164,41 @@ namespace ortc
         }
       }
 
+      // The context is shared between transports thus sessions must never
+      // resume across peers (a resumed handshake skips the peer certificate
+      // callback which the fingerprint validation relies upon).
+      SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+      SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+
+      if ((cache) &&
+          (cacheKey.hasData())) {
+        ZS_LOG_DEBUG(log("caching ssl context") + ZS_PARAM("key", cacheKey))
+        cache->add(cacheKey, ctx);
+      }
+
       return ctx;
     }
 
+    //-------------------------------------------------------------------------
+    String DTLSTransport::Adapter::getSSLContextCacheKey() const
+    {
+      String fingerprintStr;
+
+      if (identity_) {
+        auto fingerprint = identity_->fingerprint();
+        if (!fingerprint) return String();
+        if (fingerprint->mValue.isEmpty()) return String();
+
+        fingerprintStr = fingerprint->mAlgorithm + ":" + fingerprint->mValue;
+      }
+
+      return String(SSL_MODE_DTLS == ssl_mode_ ? "dtls" : "tls") + "/" +
+             string(static_cast<int>(ssl_max_version_)) + "/" +
+             (client_auth_enabled() ? "auth" : "no-auth") + "/" +
+             srtp_ciphers_ + "/" +
+             fingerprintStr;
+    }
+
     //-------------------------------------------------------------------------
     int DTLSTransport::Adapter::sslVerifyCallback(int ok, X509_STORE_CTX* store)
     {
@@ -76,6 +76,32 @@
 #else
 #endif
 
+#ifdef HAVE_RECVMMSG
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <errno.h>
+#endif //HAVE_RECVMMSG
+
+#ifdef HAVE_SENDMMSG
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <errno.h>
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif //UDP_SEGMENT
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif //SOL_UDP
+#endif //HAVE_SENDMMSG
+
+#ifdef HAVE_SO_REUSEPORT
+#include <sys/socket.h>
+#include <errno.h>
+#endif //HAVE_SO_REUSEPORT
+
 #ifdef HAVE_IPHLPAPI_H
 #include <Iphlpapi.h>
 #pragma comment(lib, "Iphlpapi.lib")
@@ -120,6 +146,90 @@ namespace ortc
     #pragma mark helpers
     #pragma mark
 
+#ifdef HAVE_SENDMMSG
+    //-------------------------------------------------------------------------
+    // NOTE: defined here as batch sending is only used by this translation
+    //       unit (and only where supported by the platform); defined ahead
+    //       of the gatherer methods which fill and flush the batch
+    struct ICEGatherer::UDPSendBatch
+    {
+      struct Packet
+      {
+        IPAddress mRemoteIP;
+        sockaddr_storage mAddress {};
+        socklen_t mAddressLength {};
+        size_t mOffset {};
+        size_t mSize {};
+      };
+
+      typedef std::vector<Packet> PacketVector;
+      typedef std::vector<BYTE> BufferVector;
+      typedef std::vector<struct mmsghdr> MessageVector;
+      typedef std::vector<struct iovec> IOVecVector;
+
+      // NOTE: the batch is filled by senders and flushed by senders, the
+      //       flush timer and socket write readiness (all outside the
+      //       gatherer lock) thus carries its own lock
+      Lock mLock;
+
+      size_t mMaxPackets {};
+      bool mSegmentationOffload {};
+
+      // NOTE: Packets are copied back to back into a single buffer which is
+      //       reused for every batch. Consecutive equal sized packets to the
+      //       same destination are therefore already laid out as a single
+      //       segmentation offload (GSO) send.
+      BufferVector mBuffer;
+      PacketVector mPackets;
+
+      MessageVector mMessages;
+      IOVecVector mIOVecs;
+
+      static UDPSendBatchPtr create(
+                                    size_t maxPackets,
+                                    bool segmentationOffload
+                                    );
+
+      bool isEmpty() const {return mPackets.empty();}
+      bool isFull() const {return mPackets.size() >= mMaxPackets;}
+      size_t size() const {return mPackets.size();}
+
+      const Packet &front() const {return mPackets.front();}
+      const BYTE *frontBuffer() const {return &(mBuffer[mPackets.front().mOffset]);}
+
+      void push(
+                const IPAddress &remoteIP,
+                const BYTE *buffer,
+                size_t bufferSizeInBytes
+                );
+      void discard(size_t total);
+      void clear();
+
+      size_t send(
+                  SOCKET socket,
+                  int &outError
+                  );
+
+    protected:
+      size_t getSegmentRun(size_t index) const;
+
+      bool sendSegmented(
+                         SOCKET socket,
+                         size_t index,
+                         size_t total,
+                         int &outError
+                         );
+
+      size_t sendMultiple(
+                          SOCKET socket,
+                          size_t index,
+                          size_t total,
+                          int &outError
+                          );
+    };
+
+#endif //HAVE_SENDMMSG
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -368,6 +478,23 @@ namespace ortc
       UseSettings::setBool(ORTC_SETTING_GATHERER_GATHER_PASSIVE_TCP_CANDIDATES, true);
 
       UseSettings::setUInt(ORTC_SETTING_GATHERER_RECHECK_IP_ADDRESSES_IN_SECONDS, 60);
+
+#ifdef HAVE_RECVMMSG
+      UseSettings::setUInt(ORTC_SETTING_GATHERER_UDP_RECEIVE_BATCH_SIZE, 32);
+#else
+      UseSettings::setUInt(ORTC_SETTING_GATHERER_UDP_RECEIVE_BATCH_SIZE, 1);
+#endif //HAVE_RECVMMSG
+      UseSettings::setUInt(ORTC_SETTING_GATHERER_UDP_RECEIVE_BATCH_SLAB_SIZE_IN_BYTES, 4096);
+
+#ifdef HAVE_SENDMMSG
+      UseSettings::setUInt(ORTC_SETTING_GATHERER_UDP_SEND_BATCH_SIZE, 32);
+#else
+      UseSettings::setUInt(ORTC_SETTING_GATHERER_UDP_SEND_BATCH_SIZE, 1);
+#endif //HAVE_SENDMMSG
+      UseSettings::setUInt(ORTC_SETTING_GATHERER_UDP_SEND_FLUSH_WINDOW_IN_MILLISECONDS, 2);
+      UseSettings::setBool(ORTC_SETTING_GATHERER_UDP_SEND_SEGMENTATION_OFFLOAD, true);
+
+      UseSettings::setUInt(ORTC_SETTING_GATHERER_UDP_REUSE_PORT_SHARDS, 1);
     }
 
     //-------------------------------------------------------------------------
@@ -535,10 +662,26 @@ namespace ortc
       mMaxTotalBuffers(UseSettings::getUInt(ORTC_SETTING_GATHERER_MAX_TOTAL_INCOMING_PACKET_BUFFERING)),
       mMaxTCPBufferingSizePendingConnection(UseSettings::getUInt(ORTC_SETTING_GATHERER_MAX_PENDING_OUTGOING_TCP_SOCKET_BUFFERING_IN_BYTES)),
       mMaxTCPBufferingSizeConnected(UseSettings::getUInt(ORTC_SETTING_GATHERER_MAX_CONNECTED_TCP_SOCKET_BUFFERING_IN_BYTES)),
-      mGatherPassiveTCP(UseSettings::getBool(ORTC_SETTING_GATHERER_GATHER_PASSIVE_TCP_CANDIDATES))
+      mGatherPassiveTCP(UseSettings::getBool(ORTC_SETTING_GATHERER_GATHER_PASSIVE_TCP_CANDIDATES)),
+      mUDPReceiveBatchSize(UseSettings::getUInt(ORTC_SETTING_GATHERER_UDP_RECEIVE_BATCH_SIZE)),
+      mUDPReceiveBatchSlabSize(UseSettings::getUInt(ORTC_SETTING_GATHERER_UDP_RECEIVE_BATCH_SLAB_SIZE_IN_BYTES)),
+      mUDPSendBatchSize(UseSettings::getUInt(ORTC_SETTING_GATHERER_UDP_SEND_BATCH_SIZE)),
+      mUDPSendFlushWindow(UseSettings::getUInt(ORTC_SETTING_GATHERER_UDP_SEND_FLUSH_WINDOW_IN_MILLISECONDS)),
+      mUDPSendSegmentationOffload(UseSettings::getBool(ORTC_SETTING_GATHERER_UDP_SEND_SEGMENTATION_OFFLOAD)),
+      mUDPReusePortShards(UseSettings::getUInt(ORTC_SETTING_GATHERER_UDP_REUSE_PORT_SHARDS))
     {
       mSTUNPacketParseOptions = STUNPacket::ParseOptions(STUNPacket::RFC_AllowAll, false, "ortc::ICEGatherer", mID);
 
+      if (mUDPReceiveBatchSlabSize < 1500) mUDPReceiveBatchSlabSize = 1500;
+      if (mUDPReceiveBatchSlabSize > 0xFFFF) mUDPReceiveBatchSlabSize = 0xFFFF;
+
+      // a zero window would hold packets until a batch fills up
+      if (Milliseconds() == mUDPSendFlushWindow) mUDPSendBatchSize = 1;
+
+#ifndef HAVE_SO_REUSEPORT
+      mUDPReusePortShards = 1;
+#endif //ndef HAVE_SO_REUSEPORT
+
       auto recheckIPsInSeconds = UseSettings::getUInt(ORTC_SETTING_GATHERER_RECHECK_IP_ADDRESSES_IN_SECONDS);
 
       if (0 != recheckIPsInSeconds) {
@@ -1077,6 +1220,7 @@ namespace ortc
       ZS_LOG_DEBUG(log("removing route") + route->toDebug())
 
       mRoutes.erase(found);
+      ++mUDPShardRouteCacheGeneration;
 
       auto foundQuick = mQuickSearchRoutes.find(LocalCandidateRemoteIPPair(route->mLocalCandidate, routerRoute->mRemoteIP));
       EventWriteOrtcIceGathererSearchQuickRoute(__func__, mID, route->mLocalCandidate.get(), routerRoute->mRemoteIP.string(), foundQuick != mQuickSearchRoutes.end());
@@ -1120,6 +1264,9 @@ namespace ortc
 
       ITURNSocketPtr turn;
       RoutePtr route;
+      SocketPtr udpSocket;
+      IPAddress boundIP;
+      UDPSendBatchPtr sendBatch;
 
       {
         AutoRecursiveLock lock(*this);
@@ -1149,7 +1296,20 @@ namespace ortc
             goto send_failed;
           }
           EventWriteOrtcIceGathererSendIceTransportPacketViaUdp(__func__, mID, transport.getID(), routerRoute->mID, route->mHostPort->mID, route->mRouterRoute->mRemoteIP.string(), SafeInt<unsigned int>(bufferSizeInBytes), buffer);
-          return sendUDPPacket(route->mHostPort->mBoundUDPSocket, route->mHostPort->mBoundUDPIP, route->mRouterRoute->mRemoteIP, buffer, bufferSizeInBytes);
+#ifdef HAVE_SENDMMSG
+          if (mUDPSendBatchSize > 1) {
+            if (!route->mHostPort->mUDPSendBatch) {
+              route->mHostPort->mUDPSendBatch = UDPSendBatch::create(mUDPSendBatchSize, mUDPSendSegmentationOffload);
+            }
+            if (!mUDPSendFlushTimer) {
+              mUDPSendFlushTimer = Timer::create(mThisWeak.lock(), mUDPSendFlushWindow, false);
+            }
+            sendBatch = route->mHostPort->mUDPSendBatch;
+          }
+#endif //HAVE_SENDMMSG
+          udpSocket = route->mHostPort->mBoundUDPSocket;
+          boundIP = route->mHostPort->mBoundUDPIP;
+          goto send_via_udp;
         }
         if (route->mRelayPort) {
           if (!route->mRelayPort->mTURNSocket) {
@@ -1195,6 +1355,14 @@ namespace ortc
       }
       goto send_failed;
 
+    send_via_udp:
+
+      // NOTE: socket I/O happens outside the gatherer lock
+#ifdef HAVE_SENDMMSG
+      if (sendBatch) return queueUDPPacket(*sendBatch, udpSocket, boundIP, route->mRouterRoute->mRemoteIP, buffer, bufferSizeInBytes);
+#endif //HAVE_SENDMMSG
+      return sendUDPPacket(udpSocket, boundIP, route->mRouterRoute->mRemoteIP, buffer, bufferSizeInBytes);
+
     send_via_turn:
 
       ZS_LOG_INSANE(log("sent packet over TURN"))
@@ -1214,6 +1382,101 @@ namespace ortc
       return false;
     }
 
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::sendPackets(
+                                  UseICETransport &transport,
+                                  RouterRoutePtr routerRoute,
+                                  const PacketBufferList &packets
+                                  )
+    {
+      if (packets.size() < 1) return true;
+
+      RoutePtr route;
+      SocketPtr udpSocket;
+      IPAddress boundIP;
+      PUID hostPortID {};
+      UDPSendBatchPtr sendBatch;
+
+      bool result = true;
+
+      // NOTE: the route is resolved once for the entire list; only UDP host
+      //       ports are batched, TURN and TCP routes fall back to sending
+      //       each packet individually.
+      {
+        AutoRecursiveLock lock(*this);
+
+        auto found = mRoutes.find(routerRoute->mID);
+        if (found == mRoutes.end()) goto send_individually;
+
+        route = (*found).second;
+        if (!route->mHostPort) goto send_individually;
+        if (!route->mHostPort->mBoundUDPSocket) goto send_individually;
+
+        route->mLastUsed = zsLib::now();
+
+#ifdef HAVE_SENDMMSG
+        if (mUDPSendBatchSize > 1) {
+          if (!route->mHostPort->mUDPSendBatch) {
+            route->mHostPort->mUDPSendBatch = UDPSendBatch::create(mUDPSendBatchSize, mUDPSendSegmentationOffload);
+          }
+          if (!mUDPSendFlushTimer) {
+            mUDPSendFlushTimer = Timer::create(mThisWeak.lock(), mUDPSendFlushWindow, false);
+          }
+          sendBatch = route->mHostPort->mUDPSendBatch;
+        }
+#endif //HAVE_SENDMMSG
+        udpSocket = route->mHostPort->mBoundUDPSocket;
+        boundIP = route->mHostPort->mBoundUDPIP;
+        hostPortID = route->mHostPort->mID;
+        goto send_via_udp;
+      }
+
+    send_individually:
+      {
+        for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+          auto &buffer = (*iter);
+          if (!buffer) continue;
+          if (!sendPacket(transport, routerRoute, buffer->BytePtr(), buffer->SizeInBytes())) result = false;
+        }
+        return result;
+      }
+
+    send_via_udp:
+      {
+        // NOTE: socket I/O happens outside the gatherer lock
+        for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+          auto &buffer = (*iter);
+          if (!buffer) continue;
+          if (!buffer->SizeInBytes()) continue;
+
+          EventWriteOrtcIceGathererSendIceTransportPacket(__func__, mID, transport.getID(), routerRoute->mID, SafeInt<unsigned int>(buffer->SizeInBytes()), buffer->BytePtr());
+          EventWriteOrtcIceGathererSendIceTransportPacketViaUdp(__func__, mID, transport.getID(), routerRoute->mID, hostPortID, route->mRouterRoute->mRemoteIP.string(), SafeInt<unsigned int>(buffer->SizeInBytes()), buffer->BytePtr());
+
+#ifdef HAVE_SENDMMSG
+          if (sendBatch) {
+            if (!queueUDPPacket(*sendBatch, udpSocket, boundIP, route->mRouterRoute->mRemoteIP, buffer->BytePtr(), buffer->SizeInBytes())) result = false;
+            continue;
+          }
+#endif //HAVE_SENDMMSG
+          if (!sendUDPPacket(udpSocket, boundIP, route->mRouterRoute->mRemoteIP, buffer->BytePtr(), buffer->SizeInBytes())) result = false;
+        }
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::flushPackets()
+    {
+#ifdef HAVE_SENDMMSG
+      // NOTE: called after every send thus must be cheap when nothing is
+      //       pending
+      if (!mUDPSendPending) return;
+
+      ZS_LOG_INSANE(log("flushing batched packets"))
+      flushAllUDPPackets();
+#endif //HAVE_SENDMMSG
+    }
+
     //-------------------------------------------------------------------------
     void ICEGatherer::notifyLikelyReflexiveActivity(RouterRoutePtr routerRoute)
     {
@@ -1392,6 +1655,32 @@ namespace ortc
       Time now = zsLib::now();
 
       ZS_LOG_TRACE(log("on timer fired") + ZS_PARAM("timer", timer->getID()))
+
+#ifdef HAVE_SENDMMSG
+      // scope: the flush timer is handled outside the lock as flushing
+      //        performs socket I/O
+      {
+        bool flushUDP = false;
+
+        {
+          AutoRecursiveLock lock(*this);
+          if (mUDPSendFlushTimer == timer) {
+            EventWriteOrtcIceGathererInternalTimerEventFired(__func__, mID, timer->getID(), "udp send flush timer", 0);
+            ZS_LOG_INSANE(log("udp send flush window elapsed"))
+
+            mUDPSendFlushTimer->cancel();
+            mUDPSendFlushTimer.reset();
+            flushUDP = true;
+          }
+        }
+
+        if (flushUDP) {
+          flushAllUDPPackets();
+          return;
+        }
+      }
+#endif //HAVE_SENDMMSG
+
       AutoRecursiveLock lock(*this);
 
       if (mWarmUpAterNewInterfaceBindingTimer == timer) {
@@ -1638,6 +1927,8 @@ namespace ortc
 
       HostPortPtr hostPort;
       TCPPortPtr tcpPort;
+      UDPSendBatchPtr sendBatch;
+      IPAddress boundIP;
 
       // scope: figure out which host port fired the event
       {
@@ -1648,6 +1939,10 @@ namespace ortc
           auto found = mHostPortSockets.find(socket);
           if (found != mHostPortSockets.end()) {
             hostPort = (*found).second;
+            if (hostPort->mBoundUDPSocket == socket) {
+              sendBatch = hostPort->mUDPSendBatch;
+              boundIP = hostPort->mBoundUDPIP;
+            }
             EventWriteOrtcIceGathererInternalSocketWriteReadyEventFired(__func__, mID, hostPort->mID);
             ZS_LOG_INSANE(log("write found host port") + hostPort->toDebug())
             goto found_host_port;
@@ -1664,6 +1959,14 @@ namespace ortc
 
     found_host_port:
       {
+#ifdef HAVE_SENDMMSG
+        // send whatever remained batched when the socket last blocked
+        if (sendBatch) {
+          AutoLock batchLock(sendBatch->mLock);
+          if (!flushUDPPackets(*sendBatch, socket, boundIP)) mUDPSendPending = true;
+        }
+#endif //HAVE_SENDMMSG
+
         // warning: do NOT call from within a lock
         write(*hostPort, socket);
         return;
@@ -1880,6 +2183,7 @@ namespace ortc
 
       STUNPacketPtr stunPacket;
       CandidatePtr localCandidate;
+      LocalCandidateID localCandidateID {};
 
       {
         AutoRecursiveLock lock(*this);
@@ -1911,6 +2215,7 @@ namespace ortc
         }
 
         localCandidate = relayPort->mRelayCandidate;
+        localCandidateID = relayPort->mRelayCandidateID;
         relayPort->mLastActivity = zsLib::now();
 
         stunPacket = STUNPacket::parseIfSTUN(packet, packetLengthInBytes, mSTUNPacketParseOptions);
@@ -1949,7 +2254,7 @@ namespace ortc
           return;
         }
 
-        auto response = handleIncomingPacket(localCandidate, source, stunPacket);
+        auto response = handleIncomingPacket(localCandidate, localCandidateID, source, stunPacket);
         if (response) {
           ZS_LOG_TRACE(log("sending response packet") + localCandidate->toDebug() + ZS_PARAM("to", source.string()) + ZS_PARAM("packet length", response->SizeInBytes()))
           socket->sendPacket(source, *response, response->SizeInBytes());
@@ -1959,7 +2264,7 @@ namespace ortc
 
     found_packet:
       {
-        handleIncomingPacket(localCandidate, source, packet, packetLengthInBytes);
+        handleIncomingPacket(localCandidate, localCandidateID, source, packet, packetLengthInBytes, UDPShardPtr());
       }
     }
 
@@ -2147,6 +2452,17 @@ namespace ortc
 
       UseServicesHelper::debugAppend(resultEl, "installed transports", mInstalledTransports.size());
 
+      UseServicesHelper::debugAppend(resultEl, "udp receive batch size", mUDPReceiveBatchSize);
+      UseServicesHelper::debugAppend(resultEl, "udp receive batch slab size", mUDPReceiveBatchSlabSize);
+
+      UseServicesHelper::debugAppend(resultEl, "udp send batch size", mUDPSendBatchSize);
+      UseServicesHelper::debugAppend(resultEl, "udp send flush window", mUDPSendFlushWindow);
+      UseServicesHelper::debugAppend(resultEl, "udp send segmentation offload", mUDPSendSegmentationOffload);
+      UseServicesHelper::debugAppend(resultEl, "udp send flush timer", mUDPSendFlushTimer ? mUDPSendFlushTimer->getID() : 0);
+
+      UseServicesHelper::debugAppend(resultEl, "udp reuse port shards", mUDPReusePortShards);
+      UseServicesHelper::debugAppend(resultEl, "udp shard route cache generation", mUDPShardRouteCacheGeneration.load());
+
       return resultEl;
     }
 
@@ -2926,7 +3242,7 @@ namespace ortc
             hostPort->mBindUDPBackOffTimer->notifyAttempting();
 
             IPAddress bindIP(hostPort->mHostData->mIP);
-            hostPort->mBoundUDPSocket = bind(firstAttempt, bindIP, IICETypes::Protocol_UDP);
+            hostPort->mBoundUDPSocket = bind(firstAttempt, bindIP, IICETypes::Protocol_UDP, mUDPReusePortShards > 1);
             if (hostPort->mBoundUDPSocket) {
               EventWriteOrtcIceGathererHostPortBind(__func__, mID, hostPort->mID, bindIP.string(), IICETypes::toString(IICETypes::Protocol_UDP), true);
               ZS_LOG_DEBUG(log("successfully bound UDP socket") + hostPort->toDebug())
@@ -2937,6 +3253,9 @@ namespace ortc
               hostPort->mBoundUDPIP = bindIP;
               mHostPortSockets[hostPort->mBoundUDPSocket] = hostPort;
               hostPort->mCandidateUDP = createCandidate(hostPort->mHostData, IICETypes::CandidateType_Host, bindIP);
+              hostPort->mCandidateUDPID = mGathererRouter->getLocalCandidateID(hostPort->mCandidateUDP);
+
+              createUDPShards(hostPort);
             } else {
               EventWriteOrtcIceGathererHostPortBind(__func__, mID, hostPort->mID, bindIP.string(), IICETypes::toString(IICETypes::Protocol_UDP), false);
               hostPort->mBindUDPBackOffTimer->notifyAttemptFailed();
@@ -2962,7 +3281,7 @@ namespace ortc
               hostPort->mBindTCPBackOffTimer->notifyAttempting();
 
               IPAddress bindIP(hostPort->mHostData->mIP);
-              hostPort->mBoundTCPSocket = bind(firstAttempt, bindIP, IICETypes::Protocol_TCP);
+              hostPort->mBoundTCPSocket = bind(firstAttempt, bindIP, IICETypes::Protocol_TCP, false);
               if (hostPort->mBoundTCPSocket) {
                 EventWriteOrtcIceGathererHostPortBind(__func__, mID, hostPort->mID, bindIP.string(), IICETypes::toString(IICETypes::Protocol_TCP), true);
                 ZS_LOG_DEBUG(log("successfully bound TCP socket") + ZS_PARAM("bind ip", bindIP.string()))
@@ -2974,10 +3293,12 @@ namespace ortc
                 mHostPortSockets[hostPort->mBoundTCPSocket] = hostPort;
                 if (mGatherPassiveTCP) {
                   hostPort->mCandidateTCPPassive = createCandidate(hostPort->mHostData, IICETypes::CandidateType_Host, bindIP, IICETypes::Protocol_TCP, IICETypes::TCPCandidateType_Passive);
+                  hostPort->mCandidateTCPPassiveID = mGathererRouter->getLocalCandidateID(hostPort->mCandidateTCPPassive);
                 }
                 IPAddress bindActiveIP(bindIP);
                 bindActiveIP.setPort(9);
                 hostPort->mCandidateTCPActive = createCandidate(hostPort->mHostData, IICETypes::CandidateType_Host, bindActiveIP, IICETypes::Protocol_TCP, IICETypes::TCPCandidateType_Active);
+                hostPort->mCandidateTCPActiveID = mGathererRouter->getLocalCandidateID(hostPort->mCandidateTCPActive);
               } else {
                 EventWriteOrtcIceGathererHostPortBind(__func__, mID, hostPort->mID, bindIP.string(), IICETypes::toString(IICETypes::Protocol_TCP), false);
                 hostPort->mBindTCPBackOffTimer->notifyAttemptFailed();
@@ -3331,6 +3652,7 @@ namespace ortc
             EventWriteOrtcIceGathererReflexivePortFoundMapped(__func__, mID, reflexivePort->mID, ip.string());
 
             reflexivePort->mCandidate = createCandidate(hostPort->mHostData, IICETypes::CandidateType_Srflex, hostPort->mBoundUDPIP, hostPort->mBoundUDPIP, ip, server);
+            reflexivePort->mCandidateID = mGathererRouter->getLocalCandidateID(reflexivePort->mCandidate);
 
             ZS_LOG_DEBUG(log("found reflexive candidate") + reflexivePort->mCandidate->toDebug())
             continue;
@@ -3603,6 +3925,7 @@ namespace ortc
                 if (relayPort->mServerResponseIP.isAddressEmpty()) {
                   relayPort->mServerResponseIP = relayPort->mTURNSocket->getServerResponseIP();
                   hostPort->mIPToRelayPortMapping[relayPort->mServerResponseIP] = relayPort;
+                  ++mUDPShardRouteCacheGeneration;
                 }
                 break;
               }
@@ -3614,6 +3937,7 @@ namespace ortc
                   auto found = hostPort->mIPToRelayPortMapping.find(relayPort->mServerResponseIP);
                   if (found != hostPort->mIPToRelayPortMapping.end()) {
                     hostPort->mIPToRelayPortMapping.erase(found);
+                    ++mUDPShardRouteCacheGeneration;
                   }
                 }
                 if (relayPort->mRelayCandidate) {
@@ -3672,11 +3996,13 @@ namespace ortc
             if (!relayPort->mRelayCandidate) {
               EventWriteOrtcIceGathererRelayPortFoundIP(__func__, mID, relayPort->mID, IICETypes::toString(IICETypes::CandidateType_Relay), relayIP.string());
               relayPort->mRelayCandidate = createCandidate(hostPort->mHostData, IICETypes::CandidateType_Relay, hostPort->mBoundUDPIP, hostPort->mBoundUDPIP, relayIP, server);
+              relayPort->mRelayCandidateID = mGathererRouter->getLocalCandidateID(relayPort->mRelayCandidate);
               ZS_LOG_DEBUG(log("found relay candidate") + ZS_PARAM("relay", relayPort->mRelayCandidate->toDebug()))
             }
             if (!relayPort->mReflexiveCandidate) {
               EventWriteOrtcIceGathererRelayPortFoundIP(__func__, mID, relayPort->mID, IICETypes::toString(IICETypes::CandidateType_Srflex), mappedIP.string());
               relayPort->mReflexiveCandidate = createCandidate(hostPort->mHostData, IICETypes::CandidateType_Srflex, hostPort->mBoundUDPIP, hostPort->mBoundUDPIP, mappedIP, server);
+              relayPort->mReflexiveCandidateID = mGathererRouter->getLocalCandidateID(relayPort->mReflexiveCandidate);
               ZS_LOG_DEBUG(log("found relayed reflexive candidate") + ZS_PARAM("reflexive", relayPort->mReflexiveCandidate->toDebug()))
             }
             continue;
@@ -3949,6 +4275,7 @@ namespace ortc
         }
 
         mRoutes.clear();
+        ++mUDPShardRouteCacheGeneration;
       }
 
       {
@@ -4006,8 +4333,14 @@ namespace ortc
       }
       mBufferedPackets.clear();
 
+      if (mUDPSendFlushTimer) {
+        mUDPSendFlushTimer->cancel();
+        mUDPSendFlushTimer.reset();
+      }
+
       mQuickSearchRoutes.clear();
       mRoutes.clear();
+      ++mUDPShardRouteCacheGeneration;
       if (mCleanUnusedRoutesTimer) {
         mCleanUnusedRoutesTimer->cancel();
         mCleanUnusedRoutesTimer.reset();
@@ -4298,6 +4631,8 @@ namespace ortc
       hostPort->mCandidateTCPPassive.reset();
       hostPort->mCandidateTCPActive.reset();
 
+      closeUDPShards(*hostPort);
+
       if (hostPort->mBoundUDPSocket) {
         auto found = mHostPortSockets.find(hostPort->mBoundUDPSocket);
         if (found != mHostPortSockets.end()) {
@@ -4463,6 +4798,7 @@ namespace ortc
         auto found = ownerHostPort->mIPToRelayPortMapping.find(relayPort->mServerResponseIP);
         if (found != ownerHostPort->mIPToRelayPortMapping.end()) {
           ownerHostPort->mIPToRelayPortMapping.erase(found);
+          ++mUDPShardRouteCacheGeneration;
         }
       }
 
@@ -4542,7 +4878,8 @@ namespace ortc
     SocketPtr ICEGatherer::bind(
                                 bool firstAttempt,
                                 IPAddress &ioBindIP,
-                                IICETypes::Protocols protocol
+                                IICETypes::Protocols protocol,
+                                bool reusePort
                                 )
     {
       ZS_LOG_DEBUG(log("attempting to bind to IP") + ZS_PARAM("ip", ioBindIP.string()))
@@ -4557,7 +4894,18 @@ namespace ortc
           case IICETypes::Protocol_TCP: socket = Socket::createTCP(createFamily); break;
         }
 
-        if (0 != mDefaultPort) {
+#ifdef HAVE_SO_REUSEPORT
+        if (reusePort) {
+          int enable = 1;
+          if (0 != setsockopt(socket->getSocket(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable))) {
+            ZS_LOG_WARNING(Debug, log("unable to enable port reuse on socket") + ZS_PARAM("ip", ioBindIP.string()) + ZS_PARAM("error", errno))
+          }
+        }
+#endif //HAVE_SO_REUSEPORT
+
+        // an explicit port is only ever requested when sharing an already bound port
+        if ((0 != mDefaultPort) &&
+            (0 == ioBindIP.getPort())) {
           if (firstAttempt) {
             // only bind using the default port in the first attempt
             ioBindIP.setPort(mDefaultPort);
@@ -4839,6 +5187,10 @@ namespace ortc
       String localHash = candidate->hash();
       String notifyHash = candidate->hash(false);
 
+      if (mGathererRouter) {
+        mGathererRouter->removeLocalCandidate(localHash);
+      }
+
       auto foundLocal = mLocalCandidates.find(localHash);
       if (foundLocal == mLocalCandidates.end()) {
         ZS_LOG_WARNING(Debug, log("local candidate is not found (might have been filtered or was peer reflexive)") + candidate->toDebug())
@@ -4969,25 +5321,64 @@ namespace ortc
       return false;
     }
 
+#ifdef HAVE_RECVMMSG
+    //-------------------------------------------------------------------------
+    // NOTE: defined here as batch receiving is only used by this translation
+    //       unit (and only where supported by the platform)
+    struct ICEGatherer::UDPReceiveBatch
+    {
+      typedef std::vector<struct mmsghdr> MessageVector;
+      typedef std::vector<struct iovec> IOVecVector;
+      typedef std::vector<sockaddr_storage> AddressVector;
+
+      size_t mTotalSlabs {};
+      size_t mSlabSize {};
+
+      // NOTE: Slabs are allocated once and reused for every batch. The
+      //       memory is never zeroed since only received bytes are read.
+      std::unique_ptr<BYTE[]> mSlabs;
+
+      MessageVector mMessages;
+      IOVecVector mIOVecs;
+      AddressVector mAddresses;
+
+      static UDPReceiveBatchPtr create(
+                                       size_t totalSlabs,
+                                       size_t slabSize
+                                       );
+
+      int receive(SOCKET socket);
+
+      bool getPacket(
+                     int index,
+                     IPAddress &outFromIP,
+                     const BYTE * &outBuffer,
+                     size_t &outBufferSizeInBytes
+                     ) const;
+    };
+#endif //HAVE_RECVMMSG
+
     //-------------------------------------------------------------------------
     bool ICEGatherer::read(
                            HostPortPtr hostPort,
                            SocketPtr socket
                            )
     {
-      UseTURNSocketPtr turnSocket;
-      STUNPacketPtr stunPacket;
-
       size_t totalRead = 0;
       IPAddress fromIP;
-      BYTE readBuffer[0xFFFF] {};
 
-      CandidatePtr localCandidate;
+      // NOTE: The buffer is intentionally not zero initialized as only the
+      //       bytes actually received are ever consumed.
+      BYTE readBuffer[0xFFFF];
 
       {
         AutoRecursiveLock lock(*this);
 
         if (hostPort->mBoundUDPSocket == socket) {
+#ifdef HAVE_RECVMMSG
+          if (mUDPReceiveBatchSize > 1) goto read_batch;
+#endif //HAVE_RECVMMSG
+
           bool wouldBlock = false;
           try {
             totalRead = socket->receiveFrom(fromIP, readBuffer, sizeof(readBuffer), &wouldBlock);
@@ -5004,35 +5395,7 @@ namespace ortc
             }
             return false;
           }
-
-          EventWriteOrtcIceGathererUdpSocketPacketReceivedFrom(__func__, mID, fromIP.string(), SafeInt<unsigned int>(totalRead), &(readBuffer[0]));
-
-          ZS_LOG_INSANE(log("receiving incoming packet") + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("read", totalRead) + hostPort->toDebug())
-
-          stunPacket = STUNPacket::parseIfSTUN(&(readBuffer[0]), totalRead, mSTUNPacketParseOptions);
-          fixSTUNParserOptions(stunPacket);
-
-          // scope: check if for relay socket
-          {
-            auto found = hostPort->mIPToRelayPortMapping.find(fromIP);
-            if (found != hostPort->mIPToRelayPortMapping.end()) {
-              auto relayPort = (*found).second;
-              turnSocket = relayPort->mTURNSocket;
-              if (!turnSocket) {
-                ZS_LOG_WARNING(Detail, log("TURN socket was not found despite mapping being found") + relayPort->toDebug())
-                goto unknown_handler;
-              }
-              goto found_relay_port;
-            }
-          }
-
-          // this is not a relay socket, see if there is a route
-          localCandidate = hostPort->mCandidateUDP;
-          if (!localCandidate) {
-            ZS_LOG_WARNING(Trace, log("did not find local candidate"))
-            goto unknown_handler;
-          }
-          goto handle_incoming;
+          goto handle_udp_packet;
         }
 
         if (hostPort->mBoundTCPSocket == socket) {
@@ -5067,6 +5430,7 @@ namespace ortc
             tcpPort->mSocket->setDelegate(mThisWeak.lock());
 
             tcpPort->mCandidate = hostPort->mCandidateTCPPassive;
+            tcpPort->mCandidateID = hostPort->mCandidateTCPPassiveID;
 
             mTCPCandidateToTCPPorts[tcpPort->mCandidate] = tcpPort;
 
@@ -5078,35 +5442,230 @@ namespace ortc
 
       return false;
 
+#ifdef HAVE_RECVMMSG
+    read_batch:
+      {
+        // warning: do NOT call from within a lock
+        return readBatch(hostPort, UDPShardPtr(), socket);
+      }
+#endif //HAVE_RECVMMSG
+
+    handle_udp_packet:
+      {
+        handleUDPPacket(hostPort, socket, UDPShardPtr(), fromIP, &(readBuffer[0]), totalRead);
+        return true;
+      }
+    }
+
+#ifdef HAVE_RECVMMSG
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::readBatch(
+                                HostPortPtr hostPort,
+                                UDPShardPtr shard,
+                                SocketPtr socket
+                                )
+    {
+      UDPReceiveBatchPtr batch;
+
+      if (shard) {
+        // each shard is only ever read from its own queue thus the shard
+        // owns its own batch (which is never shared with the host port)
+        if (!shard->mUDPReceiveBatch) {
+          shard->mUDPReceiveBatch = UDPReceiveBatch::create(mUDPReceiveBatchSize, mUDPReceiveBatchSlabSize);
+        }
+        batch = shard->mUDPReceiveBatch;
+      } else {
+        AutoRecursiveLock lock(*this);
+
+        if (hostPort->mBoundUDPSocket != socket) {
+          ZS_LOG_WARNING(Trace, log("socket is no longer bound to host port") + ZS_PARAM("socket", string(socket)) + hostPort->toDebug())
+          return false;
+        }
+
+        if (!hostPort->mUDPReceiveBatch) {
+          hostPort->mUDPReceiveBatch = UDPReceiveBatch::create(mUDPReceiveBatchSize, mUDPReceiveBatchSlabSize);
+        }
+        batch = hostPort->mUDPReceiveBatch;
+      }
+
+      // NOTE: Socket read events for a given socket are serialized thus the
+      //       host port's batch (and its slabs) are only ever used from this
+      //       method at any one time and the socket is drained without
+      //       holding the gatherer's lock.
+      int received = batch->receive(socket->getSocket());
+      if (received < 0) {
+        int error = errno;
+        if ((EAGAIN == error) ||
+            (EWOULDBLOCK == error)) {
+          ZS_LOG_INSANE(log("socket read would block") + ZS_PARAM("socket", string(socket)))
+          return false;
+        }
+        ZS_LOG_WARNING(Debug, log("socket batch read error") + ZS_PARAM("socket", string(socket)) + ZS_PARAM("error", error))
+        return false;
+      }
+
+      if (0 == received) {
+        ZS_LOG_INSANE(log("socket batch read returned no packets") + ZS_PARAM("socket", string(socket)))
+        return false;
+      }
+
+      ZS_LOG_INSANE(log("received batch of incoming packets") + ZS_PARAM("socket", string(socket)) + ZS_PARAM("total", received))
+
+      for (int index = 0; index < received; ++index) {
+        IPAddress fromIP;
+        const BYTE *buffer = NULL;
+        size_t bufferSizeInBytes = 0;
+
+        if (!batch->getPacket(index, fromIP, buffer, bufferSizeInBytes)) {
+          ZS_LOG_WARNING(Debug, log("dropping truncated or malformed packet from batch") + ZS_PARAM("socket", string(socket)) + ZS_PARAM("index", index) + ZS_PARAM("slab size", batch->mSlabSize))
+          continue;
+        }
+
+        handleUDPPacket(hostPort, socket, shard, fromIP, buffer, bufferSizeInBytes);
+      }
+
+      // a full batch indicates more packets are likely pending
+      return (static_cast<size_t>(received) == batch->mTotalSlabs);
+    }
+#endif //HAVE_RECVMMSG
+
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::readShard(
+                                HostPortPtr hostPort,
+                                UDPShardPtr shard
+                                )
+    {
+      // NOTE: Shard sockets are read from the shard's own queue without
+      //       holding the gatherer's lock. The kernel hashes each remote
+      //       address onto exactly one SO_REUSEPORT socket so packets from
+      //       the same 5-tuple are always read and handled in order by the
+      //       same shard.
+      SocketPtr socket = shard->mSocket;
+
+#ifdef HAVE_RECVMMSG
+      if (mUDPReceiveBatchSize > 1) return readBatch(hostPort, shard, socket);
+#endif //HAVE_RECVMMSG
+
+      size_t totalRead = 0;
+      IPAddress fromIP;
+      BYTE readBuffer[0xFFFF];
+
+      bool wouldBlock = false;
+      try {
+        totalRead = socket->receiveFrom(fromIP, readBuffer, sizeof(readBuffer), &wouldBlock);
+      } catch(Socket::Exceptions::Unspecified &error) {
+        ZS_LOG_WARNING(Debug, log("shard socket read error") + ZS_PARAM("socket", string(socket)) + ZS_PARAM("error", error.errorCode()))
+        return false;
+      }
+
+      if (0 == totalRead) {
+        if (wouldBlock) {
+          ZS_LOG_INSANE(log("shard socket read would block") + ZS_PARAM("socket", string(socket)))
+        } else {
+          ZS_LOG_WARNING(Debug, log("failed to read any data from shard socket") + ZS_PARAM("socket", string(socket)))
+        }
+        return false;
+      }
+
+      handleUDPPacket(hostPort, socket, shard, fromIP, &(readBuffer[0]), totalRead);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::handleUDPPacket(
+                                      HostPortPtr hostPort,
+                                      SocketPtr socket,
+                                      UDPShardPtr shard,
+                                      const IPAddress &fromIP,
+                                      const BYTE *buffer,
+                                      size_t bufferSizeInBytes
+                                      )
+    {
+      UseTURNSocketPtr turnSocket;
+      STUNPacketPtr stunPacket;
+
+      CandidatePtr localCandidate;
+      LocalCandidateID localCandidateID {};
+
+      // scope: shards deliver non-STUN packets for known routes without the gatherer's lock
+      if ((shard) &&
+          (bufferSizeInBytes > 0) &&
+          (buffer[0] > 3)) {  // RFC 7983: STUN packets start with 0..3
+        PUID routeID {};
+        RouterRoutePtr routerRoute;
+        UseICETransportPtr transport;
+
+        if (shard->findRoute(fromIP, mUDPShardRouteCacheGeneration, routeID, routerRoute, transport)) {
+          ZS_LOG_INSANE(log("forwarding data packet to ice transport via shard route cache") + ZS_PARAM("shard", shard->mID) + ZS_PARAM("transport", transport->getID()) + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("size", bufferSizeInBytes))
+          EventWriteOrtcIceGathererDeliverIceTransportIncomingPacket(__func__, mID, transport->getID(), routeID, routerRoute->mID, false, SafeInt<unsigned int>(bufferSizeInBytes), buffer);
+          transport->notifyPacket(routerRoute, buffer, bufferSizeInBytes);
+          return;
+        }
+      }
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        EventWriteOrtcIceGathererUdpSocketPacketReceivedFrom(__func__, mID, fromIP.string(), SafeInt<unsigned int>(bufferSizeInBytes), buffer);
+
+        ZS_LOG_INSANE(log("receiving incoming packet") + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("read", bufferSizeInBytes) + hostPort->toDebug())
+
+        stunPacket = STUNPacket::parseIfSTUN(buffer, bufferSizeInBytes, mSTUNPacketParseOptions);
+        fixSTUNParserOptions(stunPacket);
+
+        // scope: check if for relay socket
+        {
+          auto found = hostPort->mIPToRelayPortMapping.find(fromIP);
+          if (found != hostPort->mIPToRelayPortMapping.end()) {
+            auto relayPort = (*found).second;
+            turnSocket = relayPort->mTURNSocket;
+            if (!turnSocket) {
+              ZS_LOG_WARNING(Detail, log("TURN socket was not found despite mapping being found") + relayPort->toDebug())
+              goto unknown_handler;
+            }
+            goto found_relay_port;
+          }
+        }
+
+        // this is not a relay socket, see if there is a route
+        localCandidate = hostPort->mCandidateUDP;
+        localCandidateID = hostPort->mCandidateUDPID;
+        if (!localCandidate) {
+          ZS_LOG_WARNING(Trace, log("did not find local candidate"))
+          goto unknown_handler;
+        }
+        goto handle_incoming;
+      }
+
     unknown_handler:
       {
         if (stunPacket) {
           if (ISTUNRequester::handleSTUNPacket(fromIP, stunPacket)) {
             ZS_LOG_TRACE(log("handled by stun requester") + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
-            return true;
+            return;
           }
         }
-        return true;
+        return;
       }
 
     found_relay_port:
       {
-        EventWriteOrtcIceGathererUdpSocketPacketForwardingToTurnSocket(__func__, mID, fromIP.string(), ((bool)stunPacket), SafeInt<unsigned int>(totalRead), &(readBuffer[0]));
+        EventWriteOrtcIceGathererUdpSocketPacketForwardingToTurnSocket(__func__, mID, fromIP.string(), ((bool)stunPacket), SafeInt<unsigned int>(bufferSizeInBytes), buffer);
 
         if (stunPacket) {
           if (ISTUNRequester::handleSTUNPacket(fromIP, stunPacket)) {
             ZS_LOG_TRACE(log("handled by stun requester") + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
-            return true;
+            return;
           }
 
           ZS_LOG_INSANE(log("forwarding stun packet to turn socket") + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
           turnSocket->handleSTUNPacket(fromIP, stunPacket);
-          return true;
+          return;
         }
 
-        ZS_LOG_INSANE(log("forwarding turn channel data to turn socket") + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("total", totalRead))
-        turnSocket->handleChannelData(fromIP, &(readBuffer[0]), totalRead);
-        return true;
+        ZS_LOG_INSANE(log("forwarding turn channel data to turn socket") + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("total", bufferSizeInBytes))
+        turnSocket->handleChannelData(fromIP, buffer, bufferSizeInBytes);
+        return;
       }
 
     handle_incoming:
@@ -5114,11 +5673,11 @@ namespace ortc
         if (stunPacket) {
           if (ISTUNRequester::handleSTUNPacket(fromIP, stunPacket)) {
             ZS_LOG_TRACE(log("handled by stun requester") + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
-            return true;
+            return;
           }
 
           ZS_LOG_INSANE(log("handling incoming stun packet") + localCandidate->toDebug() + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
-          auto response = handleIncomingPacket(localCandidate, fromIP, stunPacket);
+          auto response = handleIncomingPacket(localCandidate, localCandidateID, fromIP, stunPacket);
           if (response) {
             AutoRecursiveLock lock(*this);
 
@@ -5131,11 +5690,10 @@ namespace ortc
               ZS_LOG_WARNING(Debug, log("cannot send response as socket is gone") + localCandidate->toDebug() + ZS_PARAM("from ip", fromIP.string()) + stunPacket->toDebug())
             }
           }
-          return true;
+          return;
         }
-        ZS_LOG_INSANE(log("handling incoming packet") + localCandidate->toDebug() + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("total", totalRead))
-        handleIncomingPacket(localCandidate, fromIP, &(readBuffer[0]), totalRead);
-        return true;
+        ZS_LOG_INSANE(log("handling incoming packet") + localCandidate->toDebug() + ZS_PARAM("from ip", fromIP.string()) + ZS_PARAM("total", bufferSizeInBytes))
+        handleIncomingPacket(localCandidate, localCandidateID, fromIP, buffer, bufferSizeInBytes, shard);
       }
     }
 
@@ -5148,6 +5706,7 @@ namespace ortc
       BufferedPacketList packets;
 
       CandidatePtr localCandidate;
+      LocalCandidateID localCandidateID {};
       IPAddress fromIP;
 
       {
@@ -5193,6 +5752,7 @@ namespace ortc
             packet->mBuffer = make_shared<SecureByteBlock>(packetSize);
             if (!localCandidate) {
               localCandidate = tcpPort.mCandidate;
+              localCandidateID = tcpPort.mCandidateID;
               fromIP = tcpPort.mRemoteIP;
             }
 
@@ -5227,7 +5787,7 @@ namespace ortc
 
             ZS_LOG_TRACE(log("handling incoming TCP stun packet") + packet->toDebug() + packet->mSTUNPacket->toDebug())
 
-            auto response = handleIncomingPacket(localCandidate, fromIP, packet->mSTUNPacket);
+            auto response = handleIncomingPacket(localCandidate, localCandidateID, fromIP, packet->mSTUNPacket);
             if (response) {
               AutoRecursiveLock lock(*this);
               if (tcpPort.mSocket) {
@@ -5251,7 +5811,7 @@ namespace ortc
           }
 
           ZS_LOG_INSANE(log("handling incoming TCP packet") + packet->toDebug())
-          handleIncomingPacket(localCandidate, fromIP, *(packet->mBuffer), packet->mBuffer->SizeInBytes());
+          handleIncomingPacket(localCandidate, localCandidateID, fromIP, *(packet->mBuffer), packet->mBuffer->SizeInBytes(), UDPShardPtr());
         }
       }
     }
@@ -5365,6 +5925,10 @@ namespace ortc
 
       ZS_LOG_WARNING(Detail, log("bound UDP or TCP socket unexpectedly closed") + hostPort->toDebug() + ZS_PARAM("socket", string(socket)))
 
+      if (hostPort->mBoundUDPSocket == socket) {
+        closeUDPShards(*hostPort);
+      }
+
       auto found = mHostPortSockets.find(socket);
       if (found != mHostPortSockets.end()) {
         mHostPortSockets.erase(found);
@@ -5413,6 +5977,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     SecureByteBlockPtr ICEGatherer::handleIncomingPacket(
                                                          CandidatePtr localCandidate,
+                                                         LocalCandidateID localCandidateID,
                                                          const IPAddress &remoteIP,
                                                          STUNPacketPtr stunPacket
                                                          )
@@ -5527,7 +6092,7 @@ namespace ortc
     buffer_data_now:
       {
         if (!routerRoute) {
-          routerRoute = mGathererRouter->findRoute(localCandidate, remoteIP, true);
+          routerRoute = mGathererRouter->findRoute(localCandidateID, remoteIP, true);
         }
         if (!routerRoute) {
           ZS_LOG_WARNING(Detail, log("unable to create router route (thus must ignore incoming packet)") + localCandidate->toDebug() + ZS_PARAM("remote ip", remoteIP.string()) + stunPacket->toDebug())
@@ -5558,15 +6123,20 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICEGatherer::handleIncomingPacket(
                                            CandidatePtr localCandidate,
+                                           LocalCandidateID localCandidateID,
                                            const IPAddress &remoteIP,
                                            const BYTE *buffer,
-                                           size_t bufferSizeInBytes
+                                           size_t bufferSizeInBytes,
+                                           UDPShardPtr shard
                                            )
     {
       RoutePtr route;
       RouterRoutePtr routerRoute;
       UseICETransportPtr transport;
 
+      // read before resolving so a route removed meanwhile is never cached
+      size_t generation = mUDPShardRouteCacheGeneration;
+
       {
         AutoRecursiveLock lock(*this);
 
@@ -5588,13 +6158,14 @@ namespace ortc
       {
         ZS_LOG_DEBUG(log("forwarding data packet to ice transport") + ZS_PARAM("transport", transport->getID()) +  ZS_PARAM("from ip", remoteIP.string()) + ZS_PARAM("size", bufferSizeInBytes))
         EventWriteOrtcIceGathererDeliverIceTransportIncomingPacket(__func__, mID, transport->getID(), route->mID, routerRoute->mID, false, SafeInt<unsigned int>(bufferSizeInBytes), buffer);
+        if (shard) shard->cacheRoute(remoteIP, generation, route->mID, routerRoute, transport);
         transport->notifyPacket(routerRoute, buffer, bufferSizeInBytes);
       }
 
     buffer_data_now:
       {
         if (!routerRoute) {
-          routerRoute = mGathererRouter->findRoute(localCandidate, remoteIP, true);
+          routerRoute = mGathererRouter->findRoute(localCandidateID, remoteIP, true);
         }
         if (!routerRoute) {
           ZS_LOG_WARNING(Detail, log("unable to create router route (thus must ignore incoming packet)") + localCandidate->toDebug() + ZS_PARAM("remote ip", remoteIP.string()) + ZS_PARAM("size", bufferSizeInBytes))
@@ -5625,20 +6196,22 @@ namespace ortc
       CandidatePtr result;
 
       auto routerCandidate = routerRoute->mLocalCandidate;
-      String routerCandidateHash = routerRoute->mLocalCandidate->hash();
+      auto routerCandidateID = routerRoute->mLocalCandidateID;
 
       AutoRecursiveLock lock(*this);
 
       // NOTE: The candidates pointers from the routerer are not the same as
       //       candidate pointer used by the ice gatherer. As such, we need
-      //       to compare by hash and not by candidate pointer match.
+      //       to compare by the router's local candidate ID (which is
+      //       assigned per unique candidate hash) and not by candidate
+      //       pointer match.
 
       {
         for (auto iter = mHostPorts.begin(); iter != mHostPorts.end(); ++iter) {
           auto hostPort = (*iter).second;
           if (IICETypes::Protocol_UDP == routerCandidate->mProtocol) {
             if (hostPort->mCandidateUDP) {
-              if (hostPort->mCandidateUDP->hash() == routerCandidateHash) {
+              if (hostPort->mCandidateUDPID == routerCandidateID) {
                 result = hostPort->mCandidateUDP;
                 goto done;
               }
@@ -5647,13 +6220,13 @@ namespace ortc
             for (auto iterRelay = hostPort->mRelayPorts.begin(); iterRelay != hostPort->mRelayPorts.end(); ++iterRelay) {
               auto relayPort = (*iterRelay);
               if (relayPort->mReflexiveCandidate) {
-                if (relayPort->mReflexiveCandidate->hash() == routerCandidateHash) {
+                if (relayPort->mReflexiveCandidateID == routerCandidateID) {
                   result = hostPort->mCandidateUDP;
                   goto done;
                 }
               }
               if (relayPort->mRelayCandidate) {
-                if (relayPort->mRelayCandidate->hash() == routerCandidateHash) {
+                if (relayPort->mRelayCandidateID == routerCandidateID) {
                   result = relayPort->mRelayCandidate;
                   goto done;
                 }
@@ -5663,7 +6236,7 @@ namespace ortc
             for (auto iterRelay = hostPort->mReflexivePorts.begin(); iterRelay != hostPort->mReflexivePorts.end(); ++iterRelay) {
               auto reflexivePort = (*iterRelay);
               if (reflexivePort->mCandidate) {
-                if (reflexivePort->mCandidate->hash() == routerCandidateHash) {
+                if (reflexivePort->mCandidateID == routerCandidateID) {
                   result = hostPort->mCandidateUDP;
                   goto done;
                 }
@@ -5673,13 +6246,13 @@ namespace ortc
 
           if (IICETypes::Protocol_TCP == routerCandidate->mProtocol) {
             if (hostPort->mCandidateTCPPassive) {
-              if (hostPort->mCandidateTCPPassive->hash() == routerCandidateHash) {
+              if (hostPort->mCandidateTCPPassiveID == routerCandidateID) {
                 result = hostPort->mCandidateTCPPassive;
                 goto done;
               }
             }
             if (hostPort->mCandidateTCPActive) {
-              if (hostPort->mCandidateTCPActive->hash() == routerCandidateHash) {
+              if (hostPort->mCandidateTCPActiveID == routerCandidateID) {
                 result = hostPort->mCandidateTCPActive;
                 goto done;
               }
@@ -5710,6 +6283,7 @@ namespace ortc
                                                     )
     {
       RoutePtr route;
+      LocalCandidateID localCandidateID {};
 
       // scope: see if route already exists
       {
@@ -5816,6 +6390,7 @@ namespace ortc
 
                   route->mTransportID = transport->getID();
                 }
+                localCandidateID = tcpPort->mCandidateID;
                 goto resolved_local_candidate;
               }
             }
@@ -5842,6 +6417,7 @@ namespace ortc
 
                 if (route->mTCPPort) {
                   route->mLocalCandidate = route->mTCPPort->mCandidate;
+                  localCandidateID = route->mTCPPort->mCandidateID;
                   goto resolved_local_candidate;
                 }
 
@@ -5865,6 +6441,7 @@ namespace ortc
                   localIP = tcpPort->mSocket->getLocalAddress();
 
                   tcpPort->mCandidate = hostPort->mCandidateTCPActive;
+                  tcpPort->mCandidateID = hostPort->mCandidateTCPActiveID;
 
                   bool woudlBlock = false;
 
@@ -5878,6 +6455,7 @@ namespace ortc
                 }
 
                 route->mTCPPort = tcpPort;
+                localCandidateID = tcpPort->mCandidateID;
 
                 hostPort->mTCPPorts[tcpPort->mSocket] = HostAndTCPPortPair(hostPort, tcpPort);
                 mTCPPorts[tcpPort->mSocket] = HostAndTCPPortPair(hostPort, tcpPort);
@@ -5896,16 +6474,19 @@ namespace ortc
               auto hostPort = (*iter).second;
               if (hostPort->mCandidateUDP == sentFromLocalCandidate) {
                 route->mHostPort = hostPort;
+                localCandidateID = hostPort->mCandidateUDPID;
                 goto resolved_local_candidate;
               }
               for (auto iterRelay = hostPort->mRelayPorts.begin(); iterRelay != hostPort->mRelayPorts.end(); ++iterRelay) {
                 auto relayPort = (*iterRelay);
                 if (relayPort->mReflexiveCandidate == sentFromLocalCandidate) {
                   route->mHostPort = hostPort;
+                  localCandidateID = relayPort->mReflexiveCandidateID;
                   goto resolved_local_candidate;
                 }
                 if (relayPort->mRelayCandidate == sentFromLocalCandidate) {
                   route->mRelayPort = relayPort;
+                  localCandidateID = relayPort->mRelayCandidateID;
                   goto resolved_local_candidate;
                 }
               }
@@ -5915,6 +6496,7 @@ namespace ortc
 
                 if (reflexivePort->mCandidate == sentFromLocalCandidate) {
                   route->mHostPort = hostPort;
+                  localCandidateID = reflexivePort->mCandidateID;
                   goto resolved_local_candidate;
                 }
               }
@@ -5926,7 +6508,15 @@ namespace ortc
 
       resolved_local_candidate:
         {
-          route->mRouterRoute = mGathererRouter->findRoute(route->mLocalCandidate, remoteIP, true);
+          // NOTE: every port records its router candidate ID when the
+          //       candidate is created thus the candidate is never hashed
+          //       here; a missing ID means the port was never registered
+          if (0 == localCandidateID) {
+            ZS_LOG_WARNING(Detail, log("local candidate has no router candidate ID") + route->toDebug())
+            goto failed_resolve_local_candidate;
+          }
+
+          route->mRouterRoute = mGathererRouter->findRoute(localCandidateID, remoteIP, true);
 
           if (!route->mRouterRoute) {
             ZS_LOG_WARNING(Detail, log("failed to create router route") + route->toDebug())
@@ -6004,6 +6594,7 @@ namespace ortc
         ZS_LOG_WARNING(Detail, log("need to remove route because of unbinding previous transport") + route->toDebug())
 
         mRoutes.erase(current);
+        ++mUDPShardRouteCacheGeneration;
       }
     }
     
@@ -6038,6 +6629,227 @@ namespace ortc
       return false;
     }
 
+#ifdef HAVE_SENDMMSG
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::queueUDPPacket(
+                                     UDPSendBatch &batch,
+                                     SocketPtr socket,
+                                     const IPAddress &boundIP,
+                                     const IPAddress &remoteIP,
+                                     const BYTE *buffer,
+                                     size_t bufferSizeInBytes
+                                     )
+    {
+      if (!buffer) return true;
+      if (0 == bufferSizeInBytes) return true;
+
+      EventWriteOrtcIceGathererUdpSocketPacketSentTo(__func__, mID, boundIP.string(), remoteIP.string(), SafeInt<unsigned int>(bufferSizeInBytes), buffer);
+
+      AutoLock lock(batch.mLock);
+
+      if (batch.isFull()) {
+        flushUDPPackets(batch, socket, boundIP);
+        if (batch.isFull()) {
+          ZS_LOG_WARNING(Trace, log("udp send batch is full as socket is blocked (thus dropping packet)") + ZS_PARAM("to", remoteIP.string()) + ZS_PARAM("from", boundIP.string()) + ZS_PARAM("size", bufferSizeInBytes))
+          return false;
+        }
+      }
+
+      batch.push(remoteIP, buffer, bufferSizeInBytes);
+      mUDPSendPending = true;
+
+      ZS_LOG_INSANE(log("packet queued for batch send") + ZS_PARAM("to", remoteIP.string()) + ZS_PARAM("from", boundIP.string()) + ZS_PARAM("size", bufferSizeInBytes) + ZS_PARAM("pending", batch.size()))
+
+      if (batch.isFull()) {
+        flushUDPPackets(batch, socket, boundIP);
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::flushUDPPackets(
+                                      UDPSendBatch &batch,
+                                      SocketPtr socket,
+                                      const IPAddress &boundIP
+                                      )
+    {
+      // NOTE: called with the batch lock held (but never the gatherer lock)
+      if (batch.isEmpty()) return true;
+
+      if (!socket) {
+        ZS_LOG_WARNING(Debug, log("no UDP socket found at this time (thus discarding batched packets)") + ZS_PARAM("from", boundIP.string()) + ZS_PARAM("pending", batch.size()))
+        batch.clear();
+        return true;
+      }
+
+      while (!batch.isEmpty()) {
+        int error = 0;
+        size_t total = batch.size();
+        size_t sent = batch.send(socket->getSocket(), error);
+
+        if (sent == total) {
+          ZS_LOG_INSANE(log("batched packets sent") + ZS_PARAM("socket", string(socket)) + ZS_PARAM("from", boundIP.string()) + ZS_PARAM("total", total))
+          batch.clear();
+          return true;
+        }
+
+        batch.discard(sent);
+
+        if ((EAGAIN == error) ||
+            (EWOULDBLOCK == error)) {
+          // NOTE: the socket only monitors write readiness after one of its
+          //       own sends would block thus hand it the oldest packet; once
+          //       writable again the remainder is flushed from onWriteReady
+          bool wouldBlock = false;
+          const auto &packet = batch.front();
+          try {
+            auto packetSent = socket->sendTo(packet.mRemoteIP, batch.frontBuffer(), packet.mSize, &wouldBlock);
+            if (packetSent == packet.mSize) {
+              batch.discard(1);
+              if (!wouldBlock) continue;
+            }
+          } catch(Socket::Exceptions::Unspecified &socketError) {
+            ZS_LOG_WARNING(Debug, log("unable to send batched packet") + ZS_PARAM("error", socketError.errorCode()) + ZS_PARAM("to", packet.mRemoteIP.string()) + ZS_PARAM("from", boundIP.string()))
+            batch.discard(1);
+            continue;
+          }
+
+          ZS_LOG_TRACE(log("socket blocked (remaining batched packets kept until writable)") + ZS_PARAM("socket", string(socket)) + ZS_PARAM("from", boundIP.string()) + ZS_PARAM("sent", sent) + ZS_PARAM("pending", batch.size()))
+          return batch.isEmpty();
+        }
+
+        // NOTE: a failure for one destination (e.g. unreachable host) only
+        //       discards that packet (the rest of the batch is still sent)
+        ZS_LOG_WARNING(Trace, log("batched packet could not be sent (thus discarding)") + ZS_PARAM("socket", string(socket)) + ZS_PARAM("to", batch.front().mRemoteIP.string()) + ZS_PARAM("from", boundIP.string()) + ZS_PARAM("sent", sent) + ZS_PARAM("error", error))
+        batch.discard(1);
+      }
+
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::flushAllUDPPackets()
+    {
+      struct PendingBatch
+      {
+        UDPSendBatchPtr mBatch;
+        SocketPtr mSocket;
+        IPAddress mBoundIP;
+      };
+      typedef std::list<PendingBatch> PendingBatchList;
+
+      PendingBatchList pending;
+
+      mUDPSendPending = false;
+
+      {
+        AutoRecursiveLock lock(*this);
+        for (auto iter = mHostPorts.begin(); iter != mHostPorts.end(); ++iter) {
+          auto hostPort = (*iter).second;
+          if (!hostPort->mUDPSendBatch) continue;
+
+          PendingBatch info;
+          info.mBatch = hostPort->mUDPSendBatch;
+          info.mSocket = hostPort->mBoundUDPSocket;
+          info.mBoundIP = hostPort->mBoundUDPIP;
+          pending.push_back(info);
+        }
+      }
+
+      bool remaining = false;
+
+      // WARNING: socket I/O must not happen inside the gatherer lock
+      for (auto iter = pending.begin(); iter != pending.end(); ++iter) {
+        auto &info = (*iter);
+        AutoLock lock(info.mBatch->mLock);
+        if (!flushUDPPackets(*(info.mBatch), info.mSocket, info.mBoundIP)) remaining = true;
+      }
+
+      if (!remaining) return;
+
+      // NOTE: whatever remains is sent on write readiness or the next flush
+      mUDPSendPending = true;
+
+      AutoRecursiveLock lock(*this);
+      if (!mUDPSendFlushTimer) {
+        mUDPSendFlushTimer = Timer::create(mThisWeak.lock(), mUDPSendFlushWindow, false);
+      }
+    }
+#endif //HAVE_SENDMMSG
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::createUDPShards(HostPortPtr hostPort)
+    {
+#ifdef HAVE_SO_REUSEPORT
+      if (mUDPReusePortShards < 2) return;
+
+      for (size_t index = 0; index < mUDPReusePortShards; ++index) {
+        SocketPtr socket = hostPort->mBoundUDPSocket;
+
+        if (0 != index) {
+          IPAddress bindIP(hostPort->mBoundUDPIP);
+          socket = bind(false, bindIP, IICETypes::Protocol_UDP, true);
+          if (!socket) {
+            ZS_LOG_WARNING(Debug, log("unable to bind additional udp shard (receive load will be spread over fewer shards)") + ZS_PARAM("index", index) + hostPort->toDebug())
+            break;
+          }
+        }
+
+        auto shard = UDPShard::create(IORTCForInternal::queuePacket(), mThisWeak.lock(), hostPort, socket);
+
+        // the shard (and not the gatherer) is now notified when the socket is
+        // readable; write readiness is passed back to the gatherer
+        socket->setDelegate(shard);
+        hostPort->mUDPShards.push_back(shard);
+
+        ZS_LOG_DEBUG(log("created udp shard") + ZS_PARAM("index", index) + shard->toDebug() + hostPort->toDebug())
+      }
+#endif //HAVE_SO_REUSEPORT
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::closeUDPShards(HostPort &hostPort)
+    {
+      if (hostPort.mUDPShards.size() < 1) return;
+
+      ZS_LOG_DEBUG(log("closing udp shards") + ZS_PARAM("total", hostPort.mUDPShards.size()) + hostPort.toDebug())
+
+      for (auto iter = hostPort.mUDPShards.begin(); iter != hostPort.mUDPShards.end(); ++iter) {
+        auto shard = (*iter);
+
+        // the bound socket is closed by the caller
+        if (shard->mSocket == hostPort.mBoundUDPSocket) continue;
+
+        try {
+          shard->mSocket->close();
+        } catch(Socket::Exceptions::Unspecified &error) {
+          ZS_LOG_ERROR(Detail, log("failed to close udp shard socket") + ZS_PARAM("error", error.errorCode()) + shard->toDebug())
+        }
+      }
+
+      hostPort.mUDPShards.clear();
+      ++mUDPShardRouteCacheGeneration;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::notifyUDPShardException(HostPortPtr hostPort)
+    {
+      SocketPtr socket;
+
+      {
+        AutoRecursiveLock lock(*this);
+        socket = hostPort->mBoundUDPSocket;
+      }
+
+      if (!socket) {
+        ZS_LOG_WARNING(Trace, log("udp shard exception after host port socket was already closed") + hostPort->toDebug())
+        return;
+      }
+
+      ZS_LOG_WARNING(Debug, log("udp shard socket exception (closing all udp sockets on host port)") + hostPort->toDebug())
+      close(hostPort, socket);
+    }
+
     //-------------------------------------------------------------------------
     bool ICEGatherer::shouldKeepWarm() const
     {
@@ -6425,6 +7237,7 @@ namespace ortc
 
       UseServicesHelper::debugAppend(resultEl, "options hash", mOptionsHash);
       UseServicesHelper::debugAppend(resultEl, mCandidate ? mCandidate->toDebug() : ElementPtr());
+      UseServicesHelper::debugAppend(resultEl, "candidate id", mCandidateID);
 
       UseServicesHelper::debugAppend(resultEl, "last activity", mLastActivity);
       UseServicesHelper::debugAppend(resultEl, "inactivity timer", mInactivityTimer ? mInactivityTimer->getID() : 0);
@@ -6453,6 +7266,8 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "options hash", mOptionsHash);
       UseServicesHelper::debugAppend(resultEl, "relay candidate", mRelayCandidate ? mRelayCandidate->toDebug() : ElementPtr());
       UseServicesHelper::debugAppend(resultEl, "reflexive candidate", mRelayCandidate ? mRelayCandidate->toDebug() : ElementPtr());
+      UseServicesHelper::debugAppend(resultEl, "relay candidate id", mRelayCandidateID);
+      UseServicesHelper::debugAppend(resultEl, "reflexive candidate id", mReflexiveCandidateID);
 
       UseServicesHelper::debugAppend(resultEl, "last activity", mLastActivity);
       UseServicesHelper::debugAppend(resultEl, "inactivity timer", mInactivityTimer ? mInactivityTimer->getID() : 0);
@@ -6480,12 +7295,16 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "options hash", mBoundOptionsHash);
 
       UseServicesHelper::debugAppend(resultEl, "candidate udp", mCandidateUDP ? mCandidateUDP->toDebug() : ElementPtr());
+      UseServicesHelper::debugAppend(resultEl, "candidate udp id", mCandidateUDPID);
       UseServicesHelper::debugAppend(resultEl, "bound udp ip", mBoundUDPIP.string());
       UseServicesHelper::debugAppend(resultEl, "bound udp socket", string(mBoundUDPSocket));
       UseServicesHelper::debugAppend(resultEl, "udp back off timer", UseBackOffTimer::toDebug(mBindUDPBackOffTimer));
+      UseServicesHelper::debugAppend(resultEl, "udp shards", mUDPShards.size());
 
       UseServicesHelper::debugAppend(resultEl, "passive candidate tcp", mCandidateTCPPassive ? mCandidateTCPPassive->toDebug() : ElementPtr());
       UseServicesHelper::debugAppend(resultEl, "active candidate tcp", mCandidateTCPActive ? mCandidateTCPActive->toDebug() : ElementPtr());
+      UseServicesHelper::debugAppend(resultEl, "passive candidate tcp id", mCandidateTCPPassiveID);
+      UseServicesHelper::debugAppend(resultEl, "active candidate tcp id", mCandidateTCPActiveID);
       UseServicesHelper::debugAppend(resultEl, "bound udp ip", mBoundTCPIP.string());
       UseServicesHelper::debugAppend(resultEl, "bound tcp socket", string(mBoundTCPSocket));
       UseServicesHelper::debugAppend(resultEl, "tcp back off timer", UseBackOffTimer::toDebug(mBindTCPBackOffTimer));
@@ -6504,6 +7323,144 @@ namespace ortc
       return resultEl;
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGatherer::UDPShard
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICEGatherer::UDPShardPtr ICEGatherer::UDPShard::create(
+                                                           IMessageQueuePtr queue,
+                                                           ICEGathererPtr gatherer,
+                                                           HostPortPtr hostPort,
+                                                           SocketPtr socket
+                                                           )
+    {
+      UDPShardPtr pThis(make_shared<UDPShard>(queue));
+      pThis->mThisWeak = pThis;
+      pThis->mGatherer = gatherer;
+      pThis->mHostPort = hostPort;
+      pThis->mSocket = socket;
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::UDPShard::findRoute(
+                                          const IPAddress &remoteIP,
+                                          size_t generation,
+                                          PUID &outRouteID,
+                                          RouterRoutePtr &outRouterRoute,
+                                          UseICETransportPtr &outTransport
+                                          )
+    {
+      AutoLock lock(mLock);
+
+      auto found = mRouteCache.find(remoteIP);
+      if (found == mRouteCache.end()) return false;
+
+      auto &cached = (*found).second;
+      if (cached.mGeneration != generation) {
+        // every cached route was resolved before the routes changed
+        mRouteCache.clear();
+        return false;
+      }
+
+      if (cached.mExpires < zsLib::now()) goto expired;
+
+      outTransport = cached.mTransport.lock();
+      if (!outTransport) goto expired;
+
+      outRouteID = cached.mRouteID;
+      outRouterRoute = cached.mRouterRoute;
+      return true;
+
+    expired:
+      {
+        mRouteCache.erase(found);
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::UDPShard::cacheRoute(
+                                           const IPAddress &remoteIP,
+                                           size_t generation,
+                                           PUID routeID,
+                                           RouterRoutePtr routerRoute,
+                                           UseICETransportPtr transport
+                                           )
+    {
+      AutoLock lock(mLock);
+
+      auto &cached = mRouteCache[remoteIP];
+      cached.mRouteID = routeID;
+      cached.mRouterRoute = routerRoute;
+      cached.mTransport = transport;
+      cached.mGeneration = generation;
+
+      // NOTE: Cached routes expire quickly so the gatherer periodically
+      //       resolves the route again (which keeps the route's last used
+      //       time fresh and prevents it from being cleaned as unused).
+      cached.mExpires = zsLib::now() + Seconds(1);
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::UDPShard::onReadReady(SocketPtr socket)
+    {
+      auto gatherer = mGatherer.lock();
+      auto hostPort = mHostPort.lock();
+      if ((!gatherer) ||
+          (!hostPort)) return;
+
+      // warning: do NOT call from within a lock
+      auto pThis = mThisWeak.lock();
+      while (gatherer->readShard(hostPort, pThis)) {}
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::UDPShard::onWriteReady(SocketPtr socket)
+    {
+      auto gatherer = mGatherer.lock();
+      if (!gatherer) return;
+
+      // NOTE: the first shard owns the host port's bound socket (which is
+      //       also the socket used for sending) thus the gatherer must still
+      //       see its write readiness to flush any batched packets left
+      //       behind when the socket blocked and to notify TURN sockets
+      gatherer->onWriteReady(socket);
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::UDPShard::onException(SocketPtr socket)
+    {
+      auto gatherer = mGatherer.lock();
+      auto hostPort = mHostPort.lock();
+      if ((!gatherer) ||
+          (!hostPort)) return;
+
+      gatherer->notifyUDPShardException(hostPort);
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICEGatherer::UDPShard::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::ICEGatherer::UDPShard");
+
+      UseServicesHelper::debugAppend(resultEl, "id", mID);
+      UseServicesHelper::debugAppend(resultEl, "socket", string(mSocket));
+      UseServicesHelper::debugAppend(resultEl, "udp receive batch", (bool)mUDPReceiveBatch);
+
+      {
+        AutoLock lock(mLock);
+        UseServicesHelper::debugAppend(resultEl, "route cache", mRouteCache.size());
+      }
+
+      return resultEl;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -6522,6 +7479,7 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "connected", mConnected);
 
       UseServicesHelper::debugAppend(resultEl, "candidate", mCandidate ? mCandidate->toDebug() : ElementPtr());
+      UseServicesHelper::debugAppend(resultEl, "candidate id", mCandidateID);
 
       UseServicesHelper::debugAppend(resultEl, "remote ip", mRemoteIP.string());
       UseServicesHelper::debugAppend(resultEl, "socket", string(mSocket));
@@ -6535,6 +7493,315 @@ namespace ortc
       return resultEl;
     }
 
+#ifdef HAVE_RECVMMSG
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGatherer::UDPReceiveBatch
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICEGatherer::UDPReceiveBatchPtr ICEGatherer::UDPReceiveBatch::create(
+                                                                         size_t totalSlabs,
+                                                                         size_t slabSize
+                                                                         )
+    {
+      UDPReceiveBatchPtr pThis(make_shared<UDPReceiveBatch>());
+      pThis->mTotalSlabs = totalSlabs;
+      pThis->mSlabSize = slabSize;
+      pThis->mSlabs = std::unique_ptr<BYTE[]>(new BYTE[totalSlabs * slabSize]);
+
+      pThis->mMessages.resize(totalSlabs);
+      pThis->mIOVecs.resize(totalSlabs);
+      pThis->mAddresses.resize(totalSlabs);
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    int ICEGatherer::UDPReceiveBatch::receive(SOCKET socket)
+    {
+      for (size_t index = 0; index < mTotalSlabs; ++index) {
+        auto &iov = mIOVecs[index];
+        iov.iov_base = &(mSlabs[index * mSlabSize]);
+        iov.iov_len = mSlabSize;
+
+        auto &header = mMessages[index];
+        memset(&header, 0, sizeof(header));
+        header.msg_hdr.msg_name = &(mAddresses[index]);
+        header.msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        header.msg_hdr.msg_iov = &iov;
+        header.msg_hdr.msg_iovlen = 1;
+      }
+
+      return recvmmsg(socket, &(mMessages[0]), static_cast<unsigned int>(mTotalSlabs), MSG_DONTWAIT, NULL);
+    }
+
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::UDPReceiveBatch::getPacket(
+                                                 int index,
+                                                 IPAddress &outFromIP,
+                                                 const BYTE * &outBuffer,
+                                                 size_t &outBufferSizeInBytes
+                                                 ) const
+    {
+      auto &header = mMessages[index];
+      if (0 != (header.msg_hdr.msg_flags & MSG_TRUNC)) return false;
+      if (0 == header.msg_len) return false;
+
+      auto &address = mAddresses[index];
+      switch (address.ss_family) {
+        case AF_INET:   outFromIP = IPAddress(*reinterpret_cast<const sockaddr_in *>(&address)); break;
+        case AF_INET6:  outFromIP = IPAddress(*reinterpret_cast<const sockaddr_in6 *>(&address)); break;
+        default:        return false;
+      }
+
+      outBuffer = &(mSlabs[index * mSlabSize]);
+      outBufferSizeInBytes = header.msg_len;
+      return true;
+    }
+#endif //HAVE_RECVMMSG
+
+#ifdef HAVE_SENDMMSG
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGatherer::UDPSendBatch
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICEGatherer::UDPSendBatchPtr ICEGatherer::UDPSendBatch::create(
+                                                                   size_t maxPackets,
+                                                                   bool segmentationOffload
+                                                                   )
+    {
+      UDPSendBatchPtr pThis(make_shared<UDPSendBatch>());
+      pThis->mMaxPackets = maxPackets;
+      pThis->mSegmentationOffload = segmentationOffload;
+      pThis->mBuffer.reserve(maxPackets * 1500);
+      pThis->mPackets.reserve(maxPackets);
+      pThis->mMessages.resize(maxPackets);
+      pThis->mIOVecs.resize(maxPackets);
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::UDPSendBatch::push(
+                                         const IPAddress &remoteIP,
+                                         const BYTE *buffer,
+                                         size_t bufferSizeInBytes
+                                         )
+    {
+      Packet packet;
+      packet.mRemoteIP = remoteIP;
+      packet.mOffset = mBuffer.size();
+      packet.mSize = bufferSizeInBytes;
+
+      if (remoteIP.isIPv4()) {
+        remoteIP.getIPv4(*reinterpret_cast<sockaddr_in *>(&(packet.mAddress)));
+        packet.mAddressLength = sizeof(sockaddr_in);
+      } else {
+        remoteIP.getIPv6(*reinterpret_cast<sockaddr_in6 *>(&(packet.mAddress)));
+        packet.mAddressLength = sizeof(sockaddr_in6);
+      }
+
+      mBuffer.insert(mBuffer.end(), buffer, buffer + bufferSizeInBytes);
+      mPackets.push_back(packet);
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::UDPSendBatch::discard(size_t total)
+    {
+      if (0 == total) return;
+      if (total >= mPackets.size()) {
+        clear();
+        return;
+      }
+
+      size_t offset = mPackets[total].mOffset;
+
+      mBuffer.erase(mBuffer.begin(), mBuffer.begin() + offset);
+      mPackets.erase(mPackets.begin(), mPackets.begin() + total);
+
+      for (auto iter = mPackets.begin(); iter != mPackets.end(); ++iter) {
+        (*iter).mOffset -= offset;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGatherer::UDPSendBatch::clear()
+    {
+      mBuffer.clear();
+      mPackets.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    size_t ICEGatherer::UDPSendBatch::send(
+                                           SOCKET socket,
+                                           int &outError
+                                           )
+    {
+      outError = 0;
+
+      size_t index = 0;
+      size_t totalSent = 0;
+
+      while (index < mPackets.size()) {
+        if (mSegmentationOffload) {
+          size_t run = getSegmentRun(index);
+          if (run > 1) {
+            if (sendSegmented(socket, index, run, outError)) {
+              index += run;
+              totalSent += run;
+              continue;
+            }
+
+            // NOTE: only EINVAL / EIO mean the kernel (or device) does not
+            //       support UDP segmentation offload; anything else (e.g.
+            //       EAGAIN or an unreachable destination) is left to the
+            //       caller to handle
+            if ((EINVAL != outError) &&
+                (EIO != outError)) return totalSent;
+
+            // fall back to sending each packet individually
+            mSegmentationOffload = false;
+          }
+        }
+
+        // send everything up until the next segmentable run
+        size_t end = index + 1;
+        if (mSegmentationOffload) {
+          while ((end < mPackets.size()) &&
+                 (getSegmentRun(end) < 2)) {
+            ++end;
+          }
+        } else {
+          end = mPackets.size();
+        }
+
+        size_t sent = sendMultiple(socket, index, end - index, outError);
+        totalSent += sent;
+        if (sent != (end - index)) return totalSent;
+
+        index = end;
+      }
+
+      return totalSent;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t ICEGatherer::UDPSendBatch::getSegmentRun(size_t index) const
+    {
+      enum Limits
+      {
+        Limit_MaxSegments = 64,       // UDP_MAX_SEGMENTS
+        Limit_MaxTotalBytes = 0xFFFF - 48 - 8,
+      };
+
+      const Packet &first = mPackets[index];
+
+      size_t total = 1;
+      size_t totalBytes = first.mSize;
+
+      for (size_t next = index + 1; next < mPackets.size(); ++next) {
+        const Packet &packet = mPackets[next];
+        if (total >= Limit_MaxSegments) break;
+        if (packet.mSize > first.mSize) break;
+        if (totalBytes + packet.mSize > Limit_MaxTotalBytes) break;
+        if (packet.mRemoteIP != first.mRemoteIP) break;
+
+        ++total;
+        totalBytes += packet.mSize;
+
+        // only the final segment is allowed to be shorter
+        if (packet.mSize < first.mSize) break;
+      }
+
+      return total;
+    }
+
+    //-------------------------------------------------------------------------
+    bool ICEGatherer::UDPSendBatch::sendSegmented(
+                                                  SOCKET socket,
+                                                  size_t index,
+                                                  size_t total,
+                                                  int &outError
+                                                  )
+    {
+      const Packet &first = mPackets[index];
+      const Packet &last = mPackets[index + total - 1];
+
+      struct iovec iov {};
+      iov.iov_base = &(mBuffer[first.mOffset]);
+      iov.iov_len = (last.mOffset + last.mSize) - first.mOffset;
+
+      union {
+        char mData[CMSG_SPACE(sizeof(uint16_t))];
+        struct cmsghdr mAlign;
+      } control {};
+
+      struct msghdr header {};
+      header.msg_name = const_cast<sockaddr_storage *>(&(first.mAddress));
+      header.msg_namelen = first.mAddressLength;
+      header.msg_iov = &iov;
+      header.msg_iovlen = 1;
+      header.msg_control = control.mData;
+      header.msg_controllen = sizeof(control.mData);
+
+      struct cmsghdr *cmsg = CMSG_FIRSTHDR(&header);
+      cmsg->cmsg_level = SOL_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      uint16_t segmentSize = static_cast<uint16_t>(first.mSize);
+      memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(segmentSize));
+
+      auto result = sendmsg(socket, &header, MSG_DONTWAIT);
+      if (result < 0) {
+        outError = errno;
+        return false;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t ICEGatherer::UDPSendBatch::sendMultiple(
+                                                   SOCKET socket,
+                                                   size_t index,
+                                                   size_t total,
+                                                   int &outError
+                                                   )
+    {
+      for (size_t loop = 0; loop < total; ++loop) {
+        Packet &packet = mPackets[index + loop];
+
+        auto &iov = mIOVecs[loop];
+        iov.iov_base = &(mBuffer[packet.mOffset]);
+        iov.iov_len = packet.mSize;
+
+        auto &header = mMessages[loop];
+        memset(&header, 0, sizeof(header));
+        header.msg_hdr.msg_name = &(packet.mAddress);
+        header.msg_hdr.msg_namelen = packet.mAddressLength;
+        header.msg_hdr.msg_iov = &iov;
+        header.msg_hdr.msg_iovlen = 1;
+      }
+
+      size_t totalSent = 0;
+      while (totalSent < total) {
+        auto result = sendmmsg(socket, &(mMessages[totalSent]), static_cast<unsigned int>(total - totalSent), MSG_DONTWAIT);
+        if (result <= 0) {
+          outError = (result < 0 ? errno : 0);
+          break;
+        }
+        totalSent += static_cast<size_t>(result);
+      }
+      return totalSent;
+    }
+#endif //HAVE_SENDMMSG
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
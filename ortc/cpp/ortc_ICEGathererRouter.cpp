@@ -108,6 +108,61 @@ namespace ortc
       return pThis;
     }
 
+    //-------------------------------------------------------------------------
+    ICEGathererRouter::LocalCandidateID ICEGathererRouter::getLocalCandidateID(
+                                                                               CandidatePtr localCandidate,
+                                                                               bool registerIfNeeded
+                                                                               )
+    {
+      if (!localCandidate) return 0;
+
+      LocalCandidateHash hash = localCandidate->hash();
+
+      AutoRecursiveLock lock(*this);
+
+      auto found = mLocalCandidateIDs.find(hash);
+      if (found != mLocalCandidateIDs.end()) return (*found).second;
+
+      if (!registerIfNeeded) {
+        ZS_LOG_TRACE(log("local candidate is not registered") + localCandidate->toDebug())
+        return 0;
+      }
+
+      LocalCandidateID localCandidateID = zsLib::createPUID();
+
+      mLocalCandidateIDs[hash] = localCandidateID;
+      mLocalCandidates[localCandidateID] = make_shared<Candidate>(*localCandidate);
+
+      EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "register", hash, localCandidate->mIP, localCandidate->mPort, NULL);
+      ZS_LOG_DEBUG(log("local candidate registered") + ZS_PARAM("local candidate id", localCandidateID) + localCandidate->toDebug())
+
+      return localCandidateID;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererRouter::removeLocalCandidate(const LocalCandidateHash &localCandidateHash)
+    {
+      AutoRecursiveLock lock(*this);
+
+      auto found = mLocalCandidateIDs.find(localCandidateHash);
+      if (found == mLocalCandidateIDs.end()) {
+        ZS_LOG_TRACE(log("local candidate was never registered") + ZS_PARAM("hash", localCandidateHash))
+        return;
+      }
+
+      LocalCandidateID localCandidateID = (*found).second;
+
+      EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "unregister", localCandidateHash, NULL, 0, NULL);
+      ZS_LOG_DEBUG(log("local candidate unregistered") + ZS_PARAM("local candidate id", localCandidateID) + ZS_PARAM("hash", localCandidateHash))
+
+      mLocalCandidateIDs.erase(found);
+
+      auto foundCandidate = mLocalCandidates.find(localCandidateID);
+      if (foundCandidate != mLocalCandidates.end()) {
+        mLocalCandidates.erase(foundCandidate);
+      }
+    }
+
     //-------------------------------------------------------------------------
     ICEGathererRouter::RoutePtr ICEGathererRouter::findRoute(
                                                              CandidatePtr localCandidate,
@@ -115,42 +170,68 @@ namespace ortc
                                                              bool createRouteIfNeeded
                                                              )
     {
-      AutoRecursiveLock lock(*this);
+      if (!localCandidate) {
+        ZS_LOG_WARNING(Trace, log("cannot find route without a local candidate") + ZS_PARAM("remote ip", remoteIP.string()))
+        return RoutePtr();
+      }
+      return findRoute(getLocalCandidateID(localCandidate), remoteIP, createRouteIfNeeded);
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererRouter::RoutePtr ICEGathererRouter::findRoute(
+                                                             LocalCandidateID localCandidateID,
+                                                             const IPAddress &remoteIP,
+                                                             bool createRouteIfNeeded
+                                                             )
+    {
+      if (0 == localCandidateID) {
+        ZS_LOG_WARNING(Trace, log("cannot find route without a local candidate") + ZS_PARAM("remote ip", remoteIP.string()))
+        return RoutePtr();
+      }
 
-      LocalCandidateHash hash = localCandidate ? localCandidate->hash() : String();
+      RouteKey search(localCandidateID, remoteIP);
 
-      CandidateRemoteIPPair search(hash, remoteIP);
+      AutoRecursiveLock lock(*this);
 
       auto found = mRoutes.find(search);
-      if (found != mRoutes.end()) {
-        RoutePtr route = (*found).second.lock();
+      if (found) {
+        RoutePtr route = found->mRoute.lock();
 
         if (route) {
-          EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "found", hash, ((bool)localCandidate) ? localCandidate->mIP : String(), ((bool)localCandidate) ? localCandidate->mPort : 0, remoteIP.string());
+          EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "found", NULL, route->mLocalCandidate->mIP, route->mLocalCandidate->mPort, NULL);
           route->trace(__func__, "found");
           ZS_LOG_TRACE(log("route found") + route->toDebug() + ZS_PARAM("create route", createRouteIfNeeded))
           return route;
         }
 
-        EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "gone", hash, ((bool)localCandidate) ? localCandidate->mIP : String(), ((bool)localCandidate) ? localCandidate->mPort : 0, remoteIP.string());
-        ZS_LOG_WARNING(Debug, log("route was previously found but is now gone") + (localCandidate ? localCandidate->toDebug() : ElementPtr()) + ZS_PARAM("remote ip", remoteIP.string()) + ZS_PARAM("create route", createRouteIfNeeded))
+        EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "gone", string(localCandidateID), NULL, 0, remoteIP.string());
+        ZS_LOG_WARNING(Debug, log("route was previously found but is now gone") + ZS_PARAM("local candidate id", localCandidateID) + ZS_PARAM("remote ip", remoteIP.string()) + ZS_PARAM("create route", createRouteIfNeeded))
         mRoutes.erase(found);
       }
 
       if (!createRouteIfNeeded) {
-        EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "not found", hash, ((bool)localCandidate) ? localCandidate->mIP : String(), ((bool)localCandidate) ? localCandidate->mPort : 0, remoteIP.string());
-        ZS_LOG_WARNING(Trace, log("route does not exist") + (localCandidate ? localCandidate->toDebug() : ElementPtr()) + ZS_PARAM("remote ip", remoteIP.string()))
+        EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "not found", string(localCandidateID), NULL, 0, remoteIP.string());
+        ZS_LOG_WARNING(Trace, log("route does not exist") + ZS_PARAM("local candidate id", localCandidateID) + ZS_PARAM("remote ip", remoteIP.string()))
+        return RoutePtr();
+      }
+
+      auto foundCandidate = mLocalCandidates.find(localCandidateID);
+      if (foundCandidate == mLocalCandidates.end()) {
+        ZS_LOG_WARNING(Detail, log("local candidate id was never registered (thus cannot create route)") + ZS_PARAM("local candidate id", localCandidateID) + ZS_PARAM("remote ip", remoteIP.string()))
         return RoutePtr();
       }
 
+      auto localCandidate = (*foundCandidate).second;
+
       RoutePtr route(make_shared<Route>());
-      route->mLocalCandidate = localCandidate ? make_shared<Candidate>(*localCandidate) : CandidatePtr();
+      route->mLocalCandidateID = localCandidateID;
+      route->mLocalCandidate = make_shared<Candidate>(*localCandidate);
       route->mRemoteIP = remoteIP;
 
-      EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "created", hash, ((bool)localCandidate) ? localCandidate->mIP : String(), ((bool)localCandidate) ? localCandidate->mPort : 0, remoteIP.string());
+      EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "created", string(localCandidateID), localCandidate->mIP, localCandidate->mPort, remoteIP.string());
       route->trace(__func__, "created");
 
-      mRoutes[search] = route;
+      mRoutes.insert(search, route);
 
       ZS_LOG_DEBUG(log("route created") + route->toDebug())
 
@@ -172,27 +253,30 @@ namespace ortc
 
       AutoRecursiveLock lock(*this);
 
-      for (auto iter_doNotUse = mRoutes.begin(); iter_doNotUse != mRoutes.end(); )
+      auto &entries = mRoutes.entries();
+      for (auto iter = entries.begin(); iter != entries.end(); ++iter)
       {
-        auto current = iter_doNotUse;
-        ++iter_doNotUse;
+        auto &entry = (*iter);
+        if (!entry.isUsed()) continue;
 
-        auto route = (*current).second.lock();
+        auto route = entry.mRoute.lock();
 
-        auto candidateHash = ((*current).first).first;
-        auto remoteIP = ((*current).first).second;
+        auto localCandidateID = entry.mKey.mLocalCandidateID;
 
         if (route) {
-          EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "keep", candidateHash, NULL, 0, remoteIP.string());
+          EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "keep", string(localCandidateID), NULL, 0, route->mRemoteIP.string());
           route->trace(__func__, "keep");
-          ZS_LOG_TRACE(log("route still in use") + ZS_PARAM("candidate hash", candidateHash) + ZS_PARAM("remote ip", remoteIP.string()))
+          ZS_LOG_TRACE(log("route still in use") + ZS_PARAM("local candidate id", localCandidateID) + ZS_PARAM("remote ip", route->mRemoteIP.string()))
           continue;
         }
 
-        EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "prune", candidateHash, NULL, 0, remoteIP.string());
-        ZS_LOG_TRACE(log("pruning route") + ZS_PARAM("candidate hash", candidateHash) + ZS_PARAM("remote ip", remoteIP.string()))
-        mRoutes.erase(current);
+        EventWriteOrtcIceGathererRouterInternalEvent(__func__, mID, "prune", string(localCandidateID), NULL, 0, NULL);
+        ZS_LOG_TRACE(log("pruning route") + ZS_PARAM("local candidate id", localCandidateID))
+        mRoutes.erase(&entry);
       }
+
+      // purge tombstones left behind from pruning
+      mRoutes.rehash(mRoutes.capacity());
     }
 
     //-------------------------------------------------------------------------
@@ -233,7 +317,9 @@ namespace ortc
 
       UseServicesHelper::debugAppend(resultEl, "id", mID);
 
+      UseServicesHelper::debugAppend(resultEl, "local candidates", mLocalCandidates.size());
       UseServicesHelper::debugAppend(resultEl, "routes", mRoutes.size());
+      UseServicesHelper::debugAppend(resultEl, "routes capacity", mRoutes.capacity());
 
       UseServicesHelper::debugAppend(resultEl, "timer", mTimer ? mTimer->getID() : 0);
 
@@ -312,10 +398,174 @@ namespace ortc
     {
       ElementPtr objectEl = Element::create("ortc::ICEGathererRouter::Route");
       UseServicesHelper::debugAppend(objectEl, "id", mID);
+      UseServicesHelper::debugAppend(objectEl, "local candidate id", mLocalCandidateID);
       UseServicesHelper::debugAppend(objectEl, "local candidate", mLocalCandidate ? mLocalCandidate->toDebug() : ElementPtr());
       UseServicesHelper::debugAppend(objectEl, "remote ip", mRemoteIP.string());
       return objectEl;
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererRouter::RouteKey
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICEGathererRouter::RouteKey::RouteKey(
+                                          LocalCandidateID localCandidateID,
+                                          const IPAddress &remoteIP
+                                          ) :
+      mLocalCandidateID(localCandidateID),
+      mRemotePort(remoteIP.mPort)
+    {
+      mRemoteIP[0] = remoteIP.mIPAddress.ull[0];
+      mRemoteIP[1] = remoteIP.mIPAddress.ull[1];
+    }
+
+    //-------------------------------------------------------------------------
+    bool ICEGathererRouter::RouteKey::operator==(const RouteKey &op2) const
+    {
+      return (mLocalCandidateID == op2.mLocalCandidateID) &&
+             (mRemoteIP[0] == op2.mRemoteIP[0]) &&
+             (mRemoteIP[1] == op2.mRemoteIP[1]) &&
+             (mRemotePort == op2.mRemotePort);
+    }
+
+    //-------------------------------------------------------------------------
+    size_t ICEGathererRouter::RouteKey::hash() const
+    {
+      // 64-bit mix (splitmix64 finalizer) over the packed key
+      ULONGLONG value = static_cast<ULONGLONG>(mLocalCandidateID);
+      value ^= mRemoteIP[0] + 0x9E3779B97F4A7C15ULL + (value << 6) + (value >> 2);
+      value ^= mRemoteIP[1] + 0x9E3779B97F4A7C15ULL + (value << 6) + (value >> 2);
+      value ^= static_cast<ULONGLONG>(mRemotePort) << 32;
+
+      value ^= (value >> 30);
+      value *= 0xBF58476D1CE4E5B9ULL;
+      value ^= (value >> 27);
+      value *= 0x94D049BB133111EBULL;
+      value ^= (value >> 31);
+      return static_cast<size_t>(value);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICEGathererRouter::RouteTable
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICEGathererRouter::RouteTable::RouteTable(size_t initialCapacity)
+    {
+      size_t capacity = 8;
+      while (capacity < initialCapacity) capacity <<= 1;
+      mEntries.resize(capacity);
+    }
+
+    //-------------------------------------------------------------------------
+    ICEGathererRouter::RouteTable::Entry *ICEGathererRouter::RouteTable::find(const RouteKey &key)
+    {
+      size_t mask = mEntries.size() - 1;
+      size_t index = key.hash() & mask;
+
+      for (size_t probe = 0; probe < mEntries.size(); ++probe, index = (index + 1) & mask) {
+        Entry &entry = mEntries[index];
+        if (entry.isFree()) return NULL;
+        if (entry.mErased) continue;
+        if (entry.mKey == key) return &entry;
+      }
+      return NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererRouter::RouteTable::insert(
+                                               const RouteKey &key,
+                                               RoutePtr route
+                                               )
+    {
+      ZS_THROW_INVALID_ARGUMENT_IF(key.isEmpty())
+
+      // keep load factor (including tombstones) at or below 50%
+      if ((mSize + mTombstones + 1) * 2 > mEntries.size()) {
+        rehash(((mSize + 1) * 2 > mEntries.size()) ? mEntries.size() * 2 : mEntries.size());
+      }
+
+      Entry *existing = find(key);
+      if (existing) {
+        existing->mRoute = route;
+        return;
+      }
+
+      size_t mask = mEntries.size() - 1;
+      size_t index = key.hash() & mask;
+
+      while (true) {
+        Entry &entry = mEntries[index];
+        if ((entry.isFree()) ||
+            (entry.mErased)) {
+          if (entry.mErased) --mTombstones;
+          entry.mKey = key;
+          entry.mRoute = route;
+          entry.mErased = false;
+          ++mSize;
+          return;
+        }
+        index = (index + 1) & mask;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererRouter::RouteTable::erase(Entry *entry)
+    {
+      if (!entry) return;
+      if (!entry->isUsed()) return;
+
+      entry->mRoute.reset();
+      entry->mErased = true;
+      --mSize;
+      ++mTombstones;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererRouter::RouteTable::clear()
+    {
+      for (auto iter = mEntries.begin(); iter != mEntries.end(); ++iter) {
+        (*iter) = Entry();
+      }
+      mSize = 0;
+      mTombstones = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICEGathererRouter::RouteTable::rehash(size_t newCapacity)
+    {
+      size_t capacity = 8;
+      while (capacity < newCapacity) capacity <<= 1;
+
+      EntryVector oldEntries(capacity);
+      oldEntries.swap(mEntries);
+
+      mSize = 0;
+      mTombstones = 0;
+
+      size_t mask = mEntries.size() - 1;
+
+      for (auto iter = oldEntries.begin(); iter != oldEntries.end(); ++iter) {
+        auto &oldEntry = (*iter);
+        if (!oldEntry.isUsed()) continue;
+
+        size_t index = oldEntry.mKey.hash() & mask;
+        while (!mEntries[index].isFree()) {
+          index = (index + 1) & mask;
+        }
+        mEntries[index] = oldEntry;
+        ++mSize;
+      }
+    }
+
   }
 }
@@ -134,6 +134,10 @@ namespace ortc
       UseSettings::setBool(ORTC_SETTING_ICE_TRANSPORT_TEST_CANDIDATE_PAIRS_OF_LOWER_PREFERENCE, false);
 
       UseSettings::setUInt(ORTC_SETTING_ICE_TRANSPORT_MAX_BUFFERED_FOR_SECURE_TRANSPORT, 5);
+
+      UseSettings::setUInt(ORTC_SETTING_ICE_TRANSPORT_PACKET_PATH_REFRESH_IN_MILLISECONDS, 250);
+
+      UseSettings::setUInt(ORTC_SETTING_ICE_TRANSPORT_SCHEDULER_TICK_IN_MILLISECONDS, 20);
     }
 
     //-------------------------------------------------------------------------
@@ -167,6 +171,317 @@ namespace ortc
     #pragma mark IICETransportForSecureTransport
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICETransportScheduler
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ICETransportScheduler::ICETransportScheduler(
+                                                 const make_private &,
+                                                 IMessageQueuePtr queue
+                                                 ) :
+      MessageQueueAssociator(queue),
+      SharedRecursiveLock(SharedRecursiveLock::create()),
+      mTickDuration(UseSettings::getUInt(ORTC_SETTING_ICE_TRANSPORT_SCHEDULER_TICK_IN_MILLISECONDS)),
+      mStarted(zsLib::now())
+    {
+      if (mTickDuration < Milliseconds(1)) mTickDuration = Milliseconds(1);
+
+      ZS_LOG_BASIC(log("created") + ZS_PARAM("tick (ms)", mTickDuration))
+    }
+
+    //-------------------------------------------------------------------------
+    ICETransportScheduler::~ICETransportScheduler()
+    {
+      ZS_LOG_BASIC(log("destroyed"))
+
+      mThisWeak.reset();
+
+      if (mTimer) {
+        mTimer->cancel();
+        mTimer.reset();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    ICETransportSchedulerPtr ICETransportScheduler::create()
+    {
+      ICETransportSchedulerPtr pThis(make_shared<ICETransportScheduler>(make_private {}, IORTCForInternal::queueORTC()));
+      pThis->mThisWeak = pThis;
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    ICETransportSchedulerPtr ICETransportScheduler::singleton()
+    {
+      AutoRecursiveLock lock(*UseServicesHelper::getGlobalLock());
+      static SingletonLazySharedPtr<ICETransportScheduler> singleton(create());
+      ICETransportSchedulerPtr result = singleton.singleton();
+
+      static zsLib::SingletonManager::Register registerSingleton("ortc::ICETransportScheduler", result);
+
+      if (!result) {
+        ZS_LOG_WARNING(Detail, slog("singleton gone"))
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    ICETransportScheduler::TimerID ICETransportScheduler::schedule(
+                                                                   ICETransportPtr transport,
+                                                                   const Time &when
+                                                                   )
+    {
+      ZS_THROW_INVALID_ARGUMENT_IF(!transport)
+
+      AutoRecursiveLock lock(*this);
+
+      if (mLocations.size() < 1) {
+        // wheel is empty thus it can be re-synchronized to the current time
+        mCurrentTick = toTick(zsLib::now());
+      }
+
+      if (!mTimer) {
+        mTimer = Timer::create(mThisWeak.lock(), mTickDuration);
+      }
+
+      Entry entry;
+      entry.mID = zsLib::createPUID();
+      entry.mTransportID = transport->getID();
+      entry.mTransport = transport;
+      entry.mExpires = toTick(when);
+      if (entry.mExpires <= mCurrentTick) entry.mExpires = mCurrentTick + 1;
+
+      auto &slot = getSlot(entry.mExpires);
+      slot.push_back(entry);
+
+      Location &location = mLocations[entry.mID];
+      location.mSlot = &slot;
+      location.mEntry = --(slot.end());
+
+      ZS_LOG_INSANE(log("scheduled timer") + ZS_PARAM("timer id", entry.mID) + ZS_PARAM("transport id", entry.mTransportID) + ZS_PARAM("expires", entry.mExpires) + ZS_PARAM("current", mCurrentTick))
+      return entry.mID;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICETransportScheduler::cancel(TimerID timerID)
+    {
+      if (0 == timerID) return;
+
+      AutoRecursiveLock lock(*this);
+
+      auto found = mLocations.find(timerID);
+      if (found == mLocations.end()) return;
+
+      auto &location = (*found).second;
+      location.mSlot->erase(location.mEntry);
+      mLocations.erase(found);
+
+      ZS_LOG_INSANE(log("cancelled timer") + ZS_PARAM("timer id", timerID))
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICETransportScheduler => ITimerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICETransportScheduler::onTimer(TimerPtr timer)
+    {
+      TransportTimersMap expired;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (timer != mTimer) {
+          ZS_LOG_WARNING(Trace, log("notified about an obsolete timer") + ZS_PARAM("timer id", timer->getID()))
+          return;
+        }
+
+        auto target = toTick(zsLib::now());
+        while ((mCurrentTick < target) &&
+               (mLocations.size() > 0)) {
+          advance(expired);
+        }
+
+        if (mLocations.size() < 1) {
+          ZS_LOG_TRACE(log("no timers remain scheduled (thus stopping tick timer)"))
+          mTimer->cancel();
+          mTimer.reset();
+        }
+      }
+
+      // deliver outside the lock as each transport takes its own lock (and
+      // may schedule its next timer)
+      for (auto iter = expired.begin(); iter != expired.end(); ++iter) {
+        auto &timers = (*iter).second;
+
+        auto transport = timers.first.lock();
+        if (!transport) {
+          ZS_LOG_TRACE(log("transport is gone (thus ignoring expired timers)") + ZS_PARAM("transport id", (*iter).first) + ZS_PARAM("timers", timers.second.size()))
+          continue;
+        }
+
+        transport->notifyScheduledTimers(timers.second);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICETransportScheduler => ISingletonManagerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ICETransportScheduler::notifySingletonCleanup()
+    {
+      ZS_LOG_DEBUG(log("notify singleton cleanup"))
+
+      AutoRecursiveLock lock(*this);
+
+      if (mTimer) {
+        mTimer->cancel();
+        mTimer.reset();
+      }
+
+      for (size_t index = 0; index < WheelSize_Lower; ++index) {
+        mLowerWheel[index].clear();
+      }
+      for (size_t index = 0; index < WheelSize_Upper; ++index) {
+        mUpperWheel[index].clear();
+      }
+      mLocations.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICETransportScheduler => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params ICETransportScheduler::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::ICETransportScheduler");
+      UseServicesHelper::debugAppend(objectEl, "id", mID);
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params ICETransportScheduler::slog(const char *message)
+    {
+      return Log::Params(message, "ortc::ICETransportScheduler");
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr ICETransportScheduler::toDebug() const
+    {
+      AutoRecursiveLock lock(*this);
+
+      ElementPtr resultEl = Element::create("ortc::ICETransportScheduler");
+
+      UseServicesHelper::debugAppend(resultEl, "id", mID);
+
+      UseServicesHelper::debugAppend(resultEl, "tick duration", mTickDuration);
+      UseServicesHelper::debugAppend(resultEl, "started", mStarted);
+      UseServicesHelper::debugAppend(resultEl, "current tick", mCurrentTick);
+
+      UseServicesHelper::debugAppend(resultEl, "timer", mTimer ? mTimer->getID() : 0);
+
+      UseServicesHelper::debugAppend(resultEl, "scheduled", mLocations.size());
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    ICETransportScheduler::Tick ICETransportScheduler::toTick(const Time &when) const
+    {
+      if (when <= mStarted) return 0;
+
+      auto elapsed = zsLib::toMilliseconds(when - mStarted).count();
+      auto duration = mTickDuration.count();
+
+      // round up so a timer never fires before its requested time
+      return static_cast<Tick>((elapsed + duration - 1) / duration);
+    }
+
+    //-------------------------------------------------------------------------
+    ICETransportScheduler::EntryList &ICETransportScheduler::getSlot(Tick expires)
+    {
+      if (expires < mCurrentTick) expires = mCurrentTick;
+
+      Tick delta = expires - mCurrentTick;
+
+      if (delta < static_cast<Tick>(WheelSize_Lower)) {
+        return mLowerWheel[expires % WheelSize_Lower];
+      }
+
+      if (delta < static_cast<Tick>(WheelSize_Lower * WheelSize_Upper)) {
+        return mUpperWheel[(expires / WheelSize_Lower) % WheelSize_Upper];
+      }
+
+      // beyond the range of the wheel; park in the slot that cascades last
+      // (the entry is re-placed each time it cascades until it is in range)
+      return mUpperWheel[((mCurrentTick / WheelSize_Lower) + WheelSize_Upper - 1) % WheelSize_Upper];
+    }
+
+    //-------------------------------------------------------------------------
+    void ICETransportScheduler::place(
+                                      EntryList &fromSlot,
+                                      EntryList::iterator entry
+                                      )
+    {
+      auto &toSlot = getSlot(entry->mExpires);
+
+      toSlot.splice(toSlot.end(), fromSlot, entry);
+
+      auto found = mLocations.find(entry->mID);
+      ZS_THROW_BAD_STATE_IF(found == mLocations.end())
+
+      (*found).second.mSlot = &toSlot;
+    }
+
+    //-------------------------------------------------------------------------
+    void ICETransportScheduler::advance(TransportTimersMap &ioExpired)
+    {
+      ++mCurrentTick;
+
+      if (0 == (mCurrentTick % WheelSize_Lower)) {
+        // cascade the upper slot for this revolution into the lower wheel
+        auto &upperSlot = mUpperWheel[(mCurrentTick / WheelSize_Lower) % WheelSize_Upper];
+        while (upperSlot.size() > 0) {
+          place(upperSlot, upperSlot.begin());
+        }
+      }
+
+      auto &lowerSlot = mLowerWheel[mCurrentTick % WheelSize_Lower];
+
+      for (auto iter = lowerSlot.begin(); iter != lowerSlot.end(); ++iter) {
+        auto &entry = (*iter);
+
+        auto &timers = ioExpired[entry.mTransportID];
+        timers.first = entry.mTransport;
+        timers.second.push_back(entry.mID);
+
+        mLocations.erase(entry.mID);
+      }
+
+      lowerSlot.clear();
+    }
+
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -186,13 +501,15 @@ namespace ortc
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mGatherer(ICEGatherer::convert(gatherer)),
       mRouteStateTracker(make_shared<RouteStateTracker>(mID)),
+      mScheduler(ICETransportScheduler::singleton()),
       mNoPacketsReceivedRecheckTime(UseSettings::getUInt(ORTC_SETTING_ICE_TRANSPORT_NO_PACKETS_RECEVIED_RECHECK_CANDIDATES_IN_SECONDS)),
       mExpireRouteTime(UseSettings::getUInt(ORTC_SETTING_ICE_TRANSPORT_EXPIRE_ROUTE_IN_SECONDS)),
       mTestLowerPreferenceCandidatePairs(UseSettings::getBool(ORTC_SETTING_ICE_TRANSPORT_TEST_CANDIDATE_PAIRS_OF_LOWER_PREFERENCE)),
       mBlacklistConsent(UseSettings::getBool(ORTC_SETTING_ICE_TRANSPORT_BLACKLIST_AFTER_CONSENT_REMOVAL)),
       mKeepWarmTimeBase(UseSettings::getUInt(ORTC_SETTING_ICE_TRANSPORT_KEEP_WARM_TIME_BASE_IN_MILLISECONDS)),
       mKeepWarmTimeRandomizedAddTime(UseSettings::getUInt(ORTC_SETTING_ICE_TRANSPORT_KEEP_WARM_TIME_RANDOMIZED_ADD_TIME_IN_MILLISECONDS)),
-      mMaxBufferedPackets(UseSettings::getUInt(ORTC_SETTING_ICE_TRANSPORT_MAX_BUFFERED_FOR_SECURE_TRANSPORT))
+      mMaxBufferedPackets(UseSettings::getUInt(ORTC_SETTING_ICE_TRANSPORT_MAX_BUFFERED_FOR_SECURE_TRANSPORT)),
+      mPacketPathRefreshTime(UseSettings::getUInt(ORTC_SETTING_ICE_TRANSPORT_PACKET_PATH_REFRESH_IN_MILLISECONDS))
     {
       ZS_LOG_BASIC(debug("created"));
 
@@ -1065,6 +1382,7 @@ namespace ortc
             mLastReceivedUseCandidate = mLastReceivedPacket;
 
             if (previousRoute != mActiveRoute) {
+              resetPacketPath();
               mActiveRoute->trace(__func__, reason);
               ZS_LOG_DEBUG(log("controlling side indicates to use this route") + mActiveRoute->toDebug())
               wakeUp();
@@ -1093,6 +1411,24 @@ namespace ortc
 
       UseSecureTransportPtr transport;
 
+      {
+        // steady state: packet arrived on the validated active route thus
+        // deliver without taking the lock (the locked path below runs again
+        // once the published path is due for a refresh)
+        auto path = getPacketPath();
+        if ((path) &&
+            (path->mRouterRoute == routerRoute)) {
+          auto now = zsLib::now();
+          if (now < path->mRefreshAfter) {
+            transport = path->mSecureTransport.lock();
+            if (transport) {
+              notifyFastPathPacketReceived(now);
+              goto forward_attached_secure_transport;
+            }
+          }
+        }
+      }
+
       {
         AutoRecursiveLock lock(*this);
 
@@ -1124,6 +1460,7 @@ namespace ortc
         if (!transport) {
           ZS_LOG_WARNING(Debug, log("no secure transport attached (packet is being buffered)"))
           mMustBufferPackets = true;
+          resetPacketPath();
         }
 
         if (mMustBufferPackets) {
@@ -1141,6 +1478,8 @@ namespace ortc
           return;
         }
 
+        if (route == mActiveRoute) publishPacketPath();
+
         goto forward_attached_secure_transport;
       }
 
@@ -1334,6 +1673,8 @@ namespace ortc
       mSecureTransportID = secureTransportID;
       mSecureTransport = transport;
 
+      resetPacketPath();
+
       IICETransportAsyncDelegateProxy::create(mThisWeak.lock())->onNotifyAttached(secureTransportID);
     }
 
@@ -1382,6 +1723,15 @@ namespace ortc
       UseICEGathererPtr gatherer;
       RouterRoutePtr routerRoute;
 
+      {
+        auto path = getPacketPath();
+        if (path) {
+          gatherer = path->mGatherer;
+          routerRoute = path->mRouterRoute;
+          goto send_packet;
+        }
+      }
+
       {
         AutoRecursiveLock lock(*this);
 
@@ -1392,13 +1742,89 @@ namespace ortc
 
         gatherer = mGatherer;
         routerRoute = mActiveRoute->mGathererRoute;
+
+        publishPacketPath();
       }
 
+    send_packet:
+
       EventWriteOrtcIceTransportForwardSecureTransportPacketToGatherer(__func__, mID, gatherer->getID(), SafeInt<unsigned int>(bufferSizeInBytes), buffer);
       routerRoute->trace(__func__, "gatherer to use this route to send secure packet");
       return gatherer->sendPacket(*this, routerRoute, buffer, bufferSizeInBytes);
     }
 
+    //-------------------------------------------------------------------------
+    bool ICETransport::sendPackets(const PacketBufferList &packets)
+    {
+      UseICEGathererPtr gatherer;
+      RouterRoutePtr routerRoute;
+
+      if (packets.size() < 1) return true;
+
+      {
+        auto path = getPacketPath();
+        if (path) {
+          gatherer = path->mGatherer;
+          routerRoute = path->mRouterRoute;
+          goto send_packets;
+        }
+      }
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (!installGathererRoute(mActiveRoute)) {
+          ZS_LOG_WARNING(Trace, log("cannot install a gatherer route") + (mActiveRoute ? mActiveRoute->toDebug() : ElementPtr()) + ZS_PARAM("total packets", packets.size()))
+          return false;
+        }
+
+        gatherer = mGatherer;
+        routerRoute = mActiveRoute->mGathererRoute;
+
+        publishPacketPath();
+      }
+
+    send_packets:
+
+      routerRoute->trace(__func__, "gatherer to use this route to send secure packets");
+
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &buffer = (*iter);
+        if (!buffer) continue;
+
+        EventWriteOrtcIceTransportSecureTransportSendPacket(__func__, mID, SafeInt<unsigned int>(buffer->SizeInBytes()), buffer->BytePtr());
+        EventWriteOrtcIceTransportForwardSecureTransportPacketToGatherer(__func__, mID, gatherer->getID(), SafeInt<unsigned int>(buffer->SizeInBytes()), buffer->BytePtr());
+      }
+
+      // the gatherer resolves the route once for the entire list
+      return gatherer->sendPackets(*this, routerRoute, packets);
+    }
+
+    //-------------------------------------------------------------------------
+    void ICETransport::flushPackets()
+    {
+      UseICEGathererPtr gatherer;
+
+      {
+        auto path = getPacketPath();
+        if (path) {
+          gatherer = path->mGatherer;
+          goto flush_packets;
+        }
+      }
+
+      {
+        AutoRecursiveLock lock(*this);
+        gatherer = mGatherer;
+      }
+
+      if (!gatherer) return;
+
+    flush_packets:
+
+      gatherer->flushPackets();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1418,6 +1844,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICETransport::onNotifyPacketRetried(
                                              IICETypes::CandidatePtr localCandidate,
+                                             PUID localCandidateID,
                                              IPAddress remoteIP,
                                              STUNPacketPtr stunPacket
                                              )
@@ -1432,7 +1859,7 @@ namespace ortc
           return;
         }
 
-        routerRoute = mGathererRouter->findRoute(localCandidate, remoteIP, true);
+        routerRoute = mGathererRouter->findRoute(localCandidateID, remoteIP, true);
         if (!routerRoute) {
           ZS_LOG_WARNING(Detail, log("cannot handle packet as no route could be created") + localCandidate->toDebug() + ZS_PARAM("remote ip", remoteIP.string()) + stunPacket->toDebug())
           return;
@@ -1486,6 +1913,8 @@ namespace ortc
 
       mSecureTransportID = 0;
       mSecureTransport.reset();
+
+      resetPacketPath();
     }
 
     //-------------------------------------------------------------------------
@@ -1607,39 +2036,71 @@ namespace ortc
 
       AutoRecursiveLock lock(*this);
 
-      if (timer == mExpireRouteTimer) {
-        EventWriteOrtcIceTransportInternalTimerEventFired(__func__, mID, timer->getID(), "expire route timer");
-        handleExpireRouteTimer();
-        return;
-      }
-      if (timer == mLastReceivedPacketTimer) {
-        EventWriteOrtcIceTransportInternalTimerEventFired(__func__, mID, timer->getID(), "last received packet timer");
-        handleLastReceivedPacket();
-        return;
-      }
       if (timer == mActivationTimer) {
         EventWriteOrtcIceTransportInternalTimerEventFired(__func__, mID, timer->getID(), "activation timer");
         handleActivationTimer();
         return;
       }
 
-      // scope: check keep warm timers
-      {
-        auto found = mNextKeepWarmTimers.find(timer);
-        if (found == mNextKeepWarmTimers.end()) goto not_a_keep_warm_timer;
+      EventWriteOrtcIceTransportInternalTimerEventFired(__func__, mID, timer->getID(), "obsolete timer");
+      ZS_LOG_WARNING(Trace, log("notified about an obsolete timer") + ZS_PARAM("timer id", timer->getID()))
+    }
 
-        EventWriteOrtcIceTransportInternalTimerEventFired(__func__, mID, timer->getID(), "next keep warm timer");
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICETransport => friend ICETransportScheduler
+    #pragma mark
 
-        RoutePtr route = (*found).second;
-        mNextKeepWarmTimers.erase(found);
-        handleNextKeepWarmTimer(route);
-        return;
-      }
+    //-------------------------------------------------------------------------
+    void ICETransport::notifyScheduledTimers(const ScheduledTimerIDList &timers)
+    {
+      ZS_LOG_TRACE(log("scheduled timers fired") + ZS_PARAM("total", timers.size()))
 
-    not_a_keep_warm_timer:
-      {
-        EventWriteOrtcIceTransportInternalTimerEventFired(__func__, mID, timer->getID(), "obsolete timer");
-        ZS_LOG_WARNING(Trace, log("notified about an obsolete timer") + ZS_PARAM("timer id", timer->getID()))
+      AutoRecursiveLock lock(*this);
+
+      for (auto iter = timers.begin(); iter != timers.end(); ++iter) {
+        auto timerID = (*iter);
+
+        if (isShutdown()) {
+          ZS_LOG_WARNING(Trace, log("ignoring scheduled timer (already shutdown)") + ZS_PARAM("timer id", timerID))
+          continue;
+        }
+
+        if (timerID == mExpireRouteTimer) {
+          EventWriteOrtcIceTransportInternalTimerEventFired(__func__, mID, timerID, "expire route timer");
+          mExpireRouteTimer = scheduleTimer(zsLib::now() + mExpireRouteTime);
+          handleExpireRouteTimer();
+          continue;
+        }
+        if (timerID == mLastReceivedPacketTimer) {
+          EventWriteOrtcIceTransportInternalTimerEventFired(__func__, mID, timerID, "last received packet timer");
+          mLastReceivedPacketTimer = scheduleTimer(zsLib::now() + mNoPacketsReceivedRecheckTime);
+          handleLastReceivedPacket();
+          continue;
+        }
+
+        // scope: check keep warm timers
+        {
+          auto found = mNextKeepWarmTimers.find(timerID);
+          if (found == mNextKeepWarmTimers.end()) goto not_a_keep_warm_timer;
+
+          EventWriteOrtcIceTransportInternalTimerEventFired(__func__, mID, timerID, "next keep warm timer");
+
+          RoutePtr route = (*found).second;
+          mNextKeepWarmTimers.erase(found);
+          route->mNextKeepWarm = 0;   // already expired within the scheduler
+          handleNextKeepWarmTimer(route);
+          continue;
+        }
+
+      not_a_keep_warm_timer:
+        {
+          EventWriteOrtcIceTransportInternalTimerEventFired(__func__, mID, timerID, "obsolete timer");
+          ZS_LOG_WARNING(Trace, log("notified about an obsolete scheduled timer") + ZS_PARAM("timer id", timerID))
+        }
       }
     }
 
@@ -1948,6 +2409,9 @@ namespace ortc
 
       ZS_LOG_TRACE(log("sending stun packet") + ZS_PARAM("stun requester", requester->getID()) + ZS_PARAM("destination ip", destination.string()) + ZS_PARAM("packet size", packet->SizeInBytes()) + routerRoute->toDebug())
       gatherer->sendPacket(*this, routerRoute, packet->BytePtr(), packet->SizeInBytes());
+
+      // connectivity checks are never held for a flush window
+      gatherer->flushPackets();
     }
 
     //-------------------------------------------------------------------------
@@ -2075,9 +2539,9 @@ namespace ortc
       }
 
       if ((keptWarm) &&
-          (!route->mNextKeepWarm)) {
-        route->mNextKeepWarm = Timer::create(mThisWeak.lock(), zsLib::now() + mKeepWarmTimeBase + Milliseconds(UseServicesHelper::random(0, static_cast<size_t>(mKeepWarmTimeRandomizedAddTime.count()))));
-        mNextKeepWarmTimers[route->mNextKeepWarm] = route;
+          (0 == route->mNextKeepWarm)) {
+        route->mNextKeepWarm = scheduleTimer(zsLib::now() + mKeepWarmTimeBase + Milliseconds(UseServicesHelper::random(0, static_cast<size_t>(mKeepWarmTimeRandomizedAddTime.count()))));
+        if (0 != route->mNextKeepWarm) mNextKeepWarmTimers[route->mNextKeepWarm] = route;
 
         ZS_LOG_TRACE(log("installed keep warm timer") + route->toDebug())
       }
@@ -2220,12 +2684,12 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "use candidate request", mUseCandidateRequest ? mUseCandidateRequest->getID() : 0);
       UseServicesHelper::debugAppend(resultEl, "last received use candidate", mLastReceivedUseCandidate);
 
-      UseServicesHelper::debugAppend(resultEl, "last received packet", mLastReceivedPacket);
-      UseServicesHelper::debugAppend(resultEl, "last received packet timer", mLastReceivedPacketTimer ? mLastReceivedPacketTimer->getID() : 0);
+      UseServicesHelper::debugAppend(resultEl, "last received packet", getLastReceivedPacket());
+      UseServicesHelper::debugAppend(resultEl, "last received packet timer", mLastReceivedPacketTimer);
       UseServicesHelper::debugAppend(resultEl, "no packets received recheck time", mNoPacketsReceivedRecheckTime);
 
       UseServicesHelper::debugAppend(resultEl, "expire route time", mExpireRouteTime);
-      UseServicesHelper::debugAppend(resultEl, "expire route timer", mExpireRouteTimer ? mExpireRouteTimer->getID() : 0);
+      UseServicesHelper::debugAppend(resultEl, "expire route timer", mExpireRouteTimer);
       UseServicesHelper::debugAppend(resultEl, "blacklist consent", mBlacklistConsent);
 
       UseServicesHelper::debugAppend(resultEl, "keep warm time base", mKeepWarmTimeBase);
@@ -2239,6 +2703,12 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "must buffer packets", mMustBufferPackets);
       UseServicesHelper::debugAppend(resultEl, "buffered packets", mBufferedPackets.size());
 
+      {
+        auto path = getPacketPath();
+        UseServicesHelper::debugAppend(resultEl, "packet path", path ? static_cast<PUID>(path->mRoute->mID) : 0);
+        UseServicesHelper::debugAppend(resultEl, "packet path refresh time", mPacketPathRefreshTime);
+      }
+
       UseServicesHelper::debugAppend(resultEl, "received username on ICE response packet", mSTUNPacketOptions.mBindResponseRequiresUsernameAttribute);
 
       return resultEl;
@@ -2492,8 +2962,9 @@ namespace ortc
       }
 
       if (isContinousGathering()) {
-        if (Time() != mLastReceivedPacket) {
-          if (mLastReceivedPacket + mNoPacketsReceivedRecheckTime < now) {
+        auto lastReceivedPacket = getLastReceivedPacket();
+        if (Time() != lastReceivedPacket) {
+          if (lastReceivedPacket + mNoPacketsReceivedRecheckTime < now) {
             ZS_LOG_TRACE(log("needs activation timer as no remote packet has been received for a while"))
             goto need_activation_timer;
           }
@@ -2621,6 +3092,7 @@ namespace ortc
         }
 
         mActiveRoute = chosenRoute;
+        resetPacketPath();
         EventWriteOrtcIceTransportCandidatePairChangedEventFired(__func__, mID, mActiveRoute->mID);
         mActiveRoute->trace(__func__, reason);
         ZS_LOG_DETAIL(log("new route chosen") + mActiveRoute->toDebug())
@@ -2775,7 +3247,7 @@ namespace ortc
             ZS_LOG_INSANE(log("already have outgoing check (thus do not need timer)") + route->toDebug())
             continue;
           }
-          if (route->mNextKeepWarm) {
+          if (0 != route->mNextKeepWarm) {
             ZS_LOG_INSANE(log("already have next keep warm timer (thus do not need timer)") + route->toDebug())
             continue;
           }
@@ -2784,8 +3256,8 @@ namespace ortc
 
           ZS_LOG_DEBUG(log("installing keep warm timer") + route->toDebug())
 
-          route->mNextKeepWarm = Timer::create(mThisWeak.lock(), zsLib::now() + mKeepWarmTimeBase + Milliseconds(UseServicesHelper::random(0, static_cast<size_t>(mKeepWarmTimeRandomizedAddTime.count()))));
-          mNextKeepWarmTimers[route->mNextKeepWarm] = route;
+          route->mNextKeepWarm = scheduleTimer(zsLib::now() + mKeepWarmTimeBase + Milliseconds(UseServicesHelper::random(0, static_cast<size_t>(mKeepWarmTimeRandomizedAddTime.count()))));
+          if (0 != route->mNextKeepWarm) mNextKeepWarmTimers[route->mNextKeepWarm] = route;
           continue;
         }
       do_not_keep_warm:
@@ -2815,24 +3287,23 @@ namespace ortc
 
       if ((mWarmRoutes.size() < 1) &&
           (!mActiveRoute)) {
-        if (!mExpireRouteTimer) {
+        if (0 == mExpireRouteTimer) {
           ZS_LOG_TRACE(log("no expire route timer to shutdown (timer is not needed)"))
           return true;
         }
         ZS_LOG_DEBUG(log("shutting down expire route timer (as no warm routes to shutdown)"))
-        mExpireRouteTimer->cancel();
-        mExpireRouteTimer.reset();
+        cancelScheduledTimer(mExpireRouteTimer);
         return true;
       }
 
-      if (mExpireRouteTimer) {
+      if (0 != mExpireRouteTimer) {
         ZS_LOG_TRACE(log("already have an expire route timer (thus no need to setup again)"))
         return true;
       }
 
       ZS_LOG_DEBUG(log("setting up expire route timer") + ZS_PARAM("expire (s)", mExpireRouteTime))
 
-      mExpireRouteTimer = Timer::create(mThisWeak.lock(), mExpireRouteTime);
+      mExpireRouteTimer = scheduleTimer(zsLib::now() + mExpireRouteTime);
       return true;
     }
     
@@ -2866,26 +3337,25 @@ namespace ortc
 
     do_not_need_last_received_packet_timer:
       {
-        if (!mLastReceivedPacketTimer) {
+        if (0 == mLastReceivedPacketTimer) {
           ZS_LOG_TRACE(log("last received packet timer is already gone"))
           return true;
         }
 
         ZS_LOG_DEBUG(log("removing last received packet timer (no longer needed)"))
-        mLastReceivedPacketTimer->cancel();
-        mLastReceivedPacketTimer.reset();
+        cancelScheduledTimer(mLastReceivedPacketTimer);
         return true;
       }
 
     needs_last_received_packet_timer:
       {
-        if (mLastReceivedPacketTimer) {
+        if (0 != mLastReceivedPacketTimer) {
           ZS_LOG_TRACE(log("already have last received packet timer"))
           return true;
         }
 
         ZS_LOG_DEBUG(log("setting up last received packet timer") + ZS_PARAM("no packets received recheck time", mNoPacketsReceivedRecheckTime))
-        mLastReceivedPacketTimer = Timer::create(mThisWeak.lock(), mNoPacketsReceivedRecheckTime);
+        mLastReceivedPacketTimer = scheduleTimer(zsLib::now() + mNoPacketsReceivedRecheckTime);
       }
       
       return true;
@@ -3030,6 +3500,8 @@ namespace ortc
         mGatherer.reset();
       }
 
+      resetPacketPath();
+
       if (mGathererSubscription) {
         mGathererSubscription->cancel();
         mGathererSubscription.reset();
@@ -3076,6 +3548,11 @@ namespace ortc
       mGathererRoutes.clear();
 
       mOutgoingChecks.clear();
+
+      for (auto iter = mNextKeepWarmTimers.begin(); iter != mNextKeepWarmTimers.end(); ++iter) {
+        auto route = (*iter).second;
+        cancelScheduledTimer(route->mNextKeepWarm);
+      }
       mNextKeepWarmTimers.clear();
 
       mUseCandidateRoute.reset();
@@ -3084,15 +3561,8 @@ namespace ortc
         mUseCandidateRequest.reset();
       }
 
-      if (mLastReceivedPacketTimer) {
-        mLastReceivedPacketTimer->cancel();
-        mLastReceivedPacketTimer.reset();
-      }
-
-      if (mExpireRouteTimer) {
-        mExpireRouteTimer->cancel();
-        mExpireRouteTimer.reset();
-      }
+      cancelScheduledTimer(mLastReceivedPacketTimer);
+      cancelScheduledTimer(mExpireRouteTimer);
 
       mSecureTransportID = 0;
       mSecureTransport.reset();
@@ -3193,6 +3663,7 @@ namespace ortc
             }
 
             mActiveRoute.reset();
+            resetPacketPath();
             expired = true;
           }
         }
@@ -3247,9 +3718,11 @@ namespace ortc
 
       stepActivationTimer();  // the need for the activation timer might have changed
 
-      if (Time() != mLastReceivedPacket) {
-        if (mLastReceivedPacket + mNoPacketsReceivedRecheckTime > now) {
-          ZS_LOG_TRACE(log("have received packet inside expecting window") + ZS_PARAMIZE(now) + ZS_PARAMIZE(mLastReceivedPacket) + ZS_PARAM("no packet received window (s)", mNoPacketsReceivedRecheckTime))
+      auto lastReceivedPacket = getLastReceivedPacket();
+
+      if (Time() != lastReceivedPacket) {
+        if (lastReceivedPacket + mNoPacketsReceivedRecheckTime > now) {
+          ZS_LOG_TRACE(log("have received packet inside expecting window") + ZS_PARAMIZE(now) + ZS_PARAMIZE(lastReceivedPacket) + ZS_PARAM("no packet received window (s)", mNoPacketsReceivedRecheckTime))
           return;
         }
       }
@@ -3420,17 +3893,21 @@ namespace ortc
         goto check_activation_timer;
       }
 
-      if (Time() == mLastReceivedPacket) {
-        ZS_LOG_TRACE(log("no packet received just yet (check if activation timer is needed)"))
-        goto check_activation_timer;
-      }
+      {
+        auto lastReceivedPacket = getLastReceivedPacket();
 
-      if (mLastReceivedPacket + mNoPacketsReceivedRecheckTime > now) {
-        ZS_LOG_TRACE(log("packet received recently (thus no need to re-activate anything)") + ZS_PARAM("difference", (now - mLastReceivedPacket)))
-        goto check_activation_timer;
-      }
+        if (Time() == lastReceivedPacket) {
+          ZS_LOG_TRACE(log("no packet received just yet (check if activation timer is needed)"))
+          goto check_activation_timer;
+        }
+
+        if (lastReceivedPacket + mNoPacketsReceivedRecheckTime > now) {
+          ZS_LOG_TRACE(log("packet received recently (thus no need to re-activate anything)") + ZS_PARAM("difference", (now - lastReceivedPacket)))
+          goto check_activation_timer;
+        }
 
-      ZS_LOG_WARNING(Debug, log("packet was not received recently (thus need to re-activate something)") + ZS_PARAM("difference", (now - mLastReceivedPacket)))
+        ZS_LOG_WARNING(Debug, log("packet was not received recently (thus need to re-activate something)") + ZS_PARAM("difference", (now - lastReceivedPacket)))
+      }
 
       // scope: try to activate an old route just in case something can be resolved
       {
@@ -3487,10 +3964,7 @@ namespace ortc
     //-----------------------------------------------------------------------
     void ICETransport::handleNextKeepWarmTimer(RoutePtr route)
     {
-      if (route->mNextKeepWarm) {
-        route->mNextKeepWarm->cancel();
-        route->mNextKeepWarm.reset();
-      }
+      cancelScheduledTimer(route->mNextKeepWarm);
 
       if (route->mOutgoingCheck) {
         ZS_LOG_TRACE(log("already have outgoing check (thus send a retry packet now)"))
@@ -3510,19 +3984,43 @@ namespace ortc
       ZS_LOG_INSANE(log("installed outgoing stun binding keep alive") + route->toDebug())
     }
 
+    //-----------------------------------------------------------------------
+    ICETransport::ScheduledTimerID ICETransport::scheduleTimer(const Time &when)
+    {
+      auto pThis = mThisWeak.lock();
+      if ((!mScheduler) ||
+          (!pThis)) {
+        ZS_LOG_WARNING(Detail, log("cannot schedule timer (scheduler or transport is gone)"))
+        return 0;
+      }
+
+      return mScheduler->schedule(pThis, when);
+    }
+
+    //-----------------------------------------------------------------------
+    void ICETransport::cancelScheduledTimer(ScheduledTimerID &ioTimerID)
+    {
+      if (0 == ioTimerID) return;
+
+      if (mScheduler) {
+        mScheduler->cancel(ioTimerID);
+      }
+      ioTimerID = 0;
+    }
+
     //-----------------------------------------------------------------------
     void ICETransport::forceActive(RoutePtr route)
     {
       if (!route) return;
       if (route->mPrune) return;
 
-      if (route->mNextKeepWarm) return;
+      if (0 != route->mNextKeepWarm) return;
 
       route->trace(__func__, "forced active");
 
       // install a temporary keep warm timer (to force route activate sooner)
-      route->mNextKeepWarm = Timer::create(mThisWeak.lock(), zsLib::now() + Milliseconds(UseServicesHelper::random(0, static_cast<size_t>(mKeepWarmTimeRandomizedAddTime.count()))));
-      mNextKeepWarmTimers[route->mNextKeepWarm] = route;
+      route->mNextKeepWarm = scheduleTimer(zsLib::now() + Milliseconds(UseServicesHelper::random(0, static_cast<size_t>(mKeepWarmTimeRandomizedAddTime.count()))));
+      if (0 != route->mNextKeepWarm) mNextKeepWarmTimers[route->mNextKeepWarm] = route;
 
       ZS_LOG_TRACE(log("forcing route to generate activity") + route->toDebug())
     }
@@ -3571,6 +4069,9 @@ namespace ortc
 
       mLastReceivedUseCandidate = Time();
       mLastReceivedPacket = Time();
+      mLastReceivedPacketFastPath.store(0, std::memory_order_relaxed);
+
+      resetPacketPath();
 
       RoutePtr currentRoute;
 
@@ -4031,6 +4532,8 @@ namespace ortc
       }
 
       if (oldActiveRoute != mActiveRoute) {
+        resetPacketPath();
+
         ZS_LOG_DETAIL(log("new route chosen") + mActiveRoute->toDebug())
         EventWriteOrtcIceTransportCandidatePairChangedEventFired(__func__, mID, mActiveRoute->mID);
         mSubscriptions.delegate()->onICETransportCandidatePairChanged(mThisWeak.lock(), cloneCandidatePair(mActiveRoute));
@@ -4069,7 +4572,14 @@ namespace ortc
       }
 
       auto ip = route->mCandidatePair->mRemote->ip();
-      route->mGathererRoute = mGathererRouter->findRoute(route->mCandidatePair->mLocal, ip, true);
+      if (0 == route->mGathererLocalCandidateID) {
+        route->mGathererLocalCandidateID = mGathererRouter->getLocalCandidateID(route->mCandidatePair->mLocal, false);
+        if (0 == route->mGathererLocalCandidateID) {
+          ZS_LOG_WARNING(Debug, log("local candidate is no longer offered by gatherer") + route->toDebug())
+          return false;
+        }
+      }
+      route->mGathererRoute = mGathererRouter->findRoute(route->mGathererLocalCandidateID, ip, true);
       if (!route->mGathererRoute) {
         ZS_LOG_WARNING(Debug, log("failed to install gatherer route") + route->toDebug())
         return false;
@@ -4081,6 +4591,65 @@ namespace ortc
       return true;
     }
 
+    //-------------------------------------------------------------------------
+    void ICETransport::publishPacketPath()
+    {
+      if (isShuttingDown()) goto reset_path;
+      if (isShutdown()) goto reset_path;
+      if (!mActiveRoute) goto reset_path;
+      if (!mActiveRoute->mGathererRoute) goto reset_path;
+      if (mActiveRoute->isBlacklisted()) goto reset_path;
+      if (!mGatherer) goto reset_path;
+      if (mMustBufferPackets) goto reset_path;
+      if (!mSecureTransport.lock()) goto reset_path;
+
+      {
+        auto path = make_shared<PacketPath>();
+        path->mRoute = mActiveRoute;
+        path->mRouterRoute = mActiveRoute->mGathererRoute;
+        path->mGatherer = mGatherer;
+        path->mSecureTransport = mSecureTransport;
+        path->mRefreshAfter = zsLib::now() + mPacketPathRefreshTime;
+
+        ZS_LOG_INSANE(log("publishing packet path") + mActiveRoute->toDebug())
+        std::atomic_store(&mPacketPath, path);
+        return;
+      }
+
+    reset_path:
+      {
+        resetPacketPath();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ICETransport::resetPacketPath()
+    {
+      std::atomic_store(&mPacketPath, PacketPathPtr());
+    }
+
+    //-------------------------------------------------------------------------
+    ICETransport::PacketPathPtr ICETransport::getPacketPath() const
+    {
+      return std::atomic_load(&mPacketPath);
+    }
+
+    //-------------------------------------------------------------------------
+    void ICETransport::notifyFastPathPacketReceived(const Time &now)
+    {
+      // activity is only a hint for the timers; the locked path folds it
+      // back into the route state each time the packet path is refreshed
+      mLastReceivedPacketFastPath.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------
+    Time ICETransport::getLastReceivedPacket() const
+    {
+      auto fastPath = mLastReceivedPacketFastPath.load(std::memory_order_relaxed);
+      if (0 == fastPath) return mLastReceivedPacket;
+      return getLatest(mLastReceivedPacket, Time(Time::duration(fastPath)));
+    }
+
     //-------------------------------------------------------------------------
     void ICETransport::installFoundation(RoutePtr route)
     {
@@ -4184,6 +4753,7 @@ namespace ortc
     {
       if (route == mActiveRoute) {
         mActiveRoute.reset();
+        resetPacketPath();
         wakeUp();
       }
       if (route == mUseCandidateRoute) {
@@ -4227,6 +4797,8 @@ namespace ortc
     {
       if (!route->mGathererRoute) return;
 
+      resetPacketPath();
+
       auto found = mGathererRoutes.find(route->mGathererRoute->mID);
       if (found != mGathererRoutes.end()) {
         mGathererRoutes.erase(found);
@@ -4242,7 +4814,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     void ICETransport::removeKeepWarmTimer(RoutePtr route)
     {
-      if (!route->mNextKeepWarm) return;
+      if (0 == route->mNextKeepWarm) return;
 
       auto found = mNextKeepWarmTimers.find(route->mNextKeepWarm);
 
@@ -4250,8 +4822,7 @@ namespace ortc
         mNextKeepWarmTimers.erase(found);
       }
 
-      route->mNextKeepWarm->cancel();
-      route->mNextKeepWarm.reset();
+      cancelScheduledTimer(route->mNextKeepWarm);
     }
 
     //-------------------------------------------------------------------------
@@ -4453,6 +5024,7 @@ namespace ortc
       EventWriteOrtcIceTransportSendStunPacket(__func__, mID, mGatherer->getID(), SafeInt<unsigned int>(packetized->SizeInBytes()), packetized->BytePtr());
       packet->trace(__func__);
       mGatherer->sendPacket(*this, routerRoute, packetized->BytePtr(), packetized->SizeInBytes());
+      mGatherer->flushPackets();
     }
 
     //-------------------------------------------------------------------------
@@ -4508,7 +5080,7 @@ namespace ortc
         wakeUp();
 
         ZS_LOG_WARNING(Debug, log("will retry conflicting packet again after recomputing candidate pairings") + routerRoute->toDebug() + packet->toDebug())
-        IICETransportAsyncDelegateProxy::create(mThisWeak.lock())->onNotifyPacketRetried(routerRoute->mLocalCandidate, routerRoute->mRemoteIP, packet);
+        IICETransportAsyncDelegateProxy::create(mThisWeak.lock())->onNotifyPacketRetried(routerRoute->mLocalCandidate, routerRoute->mLocalCandidateID, routerRoute->mRemoteIP, packet);
       }
       return true;
     }
@@ -4724,6 +5296,7 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "state", toString(mState));
 
       UseServicesHelper::debugAppend(resultEl, "gatherer route", mGathererRoute ? mGathererRoute->toDebug() : ElementPtr());
+      UseServicesHelper::debugAppend(resultEl, "gatherer local candidate id", mGathererLocalCandidateID);
 
       UseServicesHelper::debugAppend(resultEl, "last received check", mLastReceivedCheck);
       UseServicesHelper::debugAppend(resultEl, "last sent check", mLastSentCheck);
@@ -4734,7 +5307,7 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "prune", mPrune);
       UseServicesHelper::debugAppend(resultEl, "keep warm", mKeepWarm);
       UseServicesHelper::debugAppend(resultEl, "outgoing check", mOutgoingCheck ? mOutgoingCheck->getID() : 0);
-      UseServicesHelper::debugAppend(resultEl, "keep warm timer", mNextKeepWarm ? mNextKeepWarm->getID() : 0);
+      UseServicesHelper::debugAppend(resultEl, "keep warm timer", mNextKeepWarm);
 
       UseServicesHelper::debugAppend(resultEl, "last round trip check", mLastRoundTripCheck);
       UseServicesHelper::debugAppend(resultEl, "last round trip measurement", mLastRoundTripMeasurement);
@@ -4833,7 +5406,7 @@ namespace ortc
                                            mPrune,
                                            mKeepWarm,
                                            ((bool)mOutgoingCheck) ? mOutgoingCheck->getID() : 0,
-                                           ((bool)mNextKeepWarm) ? mNextKeepWarm->getID() : 0,
+                                           mNextKeepWarm,
                                            (bool)mFrozenPromise,
                                            mDependentPromises.size(),
                                            zsLib::timeSinceEpoch<Milliseconds>(mLastReceivedCheck).count(),
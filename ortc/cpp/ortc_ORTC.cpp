@@ -32,20 +32,30 @@
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_Tracing.h>
 #include <ortc/internal/ortc_RTPMediaEngine.h>
+#include <ortc/internal/platform.h>
 
 #include <openpeer/services/IHelper.h>
 #include <openpeer/services/ILogger.h>
 #include <openpeer/services/IMessageQueueManager.h>
+#include <openpeer/services/ISettings.h>
 
 #include <zsLib/Log.h>
 #include <zsLib/XML.h>
 
+#include <webrtc/system_wrappers/include/cpu_info.h>
+
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+#include <pthread.h>
+#include <sched.h>
+#endif //HAVE_PTHREAD_SETAFFINITY_NP
+
 namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib) }
 
 namespace ortc
 {
   ZS_DECLARE_TYPEDEF_PTR(openpeer::services::IHelper, UseServicesHelper);
   ZS_DECLARE_TYPEDEF_PTR(openpeer::services::ILogger, UseServicesLogger);
+  ZS_DECLARE_TYPEDEF_PTR(openpeer::services::ISettings, UseSettings);
 
   namespace internal
   {
@@ -53,6 +63,112 @@ namespace ortc
 
     void initSubsystems();
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ORTCPacketQueue
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ORTCPacketQueue::ORTCPacketQueue(
+                                     size_t index,
+                                     IMessageQueuePtr queue
+                                     ) :
+      mIndex(index),
+      mQueue(queue)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    void ORTCPacketQueue::notifyAssigned()
+    {
+      ++mTotalAssigned;
+    }
+
+    //-------------------------------------------------------------------------
+    void ORTCPacketQueue::notifyUnassigned()
+    {
+      --mTotalAssigned;
+    }
+
+    //-------------------------------------------------------------------------
+    void ORTCPacketQueue::notifyQueued()
+    {
+      size_t depth = ++mDepth;
+      ++mTotalQueued;
+
+      size_t maxDepth = mMaxDepth;
+      while ((depth > maxDepth) &&
+             (!mMaxDepth.compare_exchange_weak(maxDepth, depth))) {
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ORTCPacketQueue::notifyProcessed(Microseconds latency)
+    {
+      --mDepth;
+      ++mTotalProcessed;
+
+      ULONGLONG value = static_cast<ULONGLONG>(latency.count() > 0 ? latency.count() : 0);
+      mTotalLatencyInMicroseconds += value;
+
+      ULONGLONG maxValue = mMaxLatencyInMicroseconds;
+      while ((value > maxValue) &&
+             (!mMaxLatencyInMicroseconds.compare_exchange_weak(maxValue, value))) {
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void ORTCPacketQueue::notifyDropped()
+    {
+      ++mTotalDropped;
+    }
+
+    //-------------------------------------------------------------------------
+    void ORTCPacketQueue::notifyDiscarded()
+    {
+      --mDepth;
+      ++mTotalDropped;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr ORTCPacketQueue::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::ORTCPacketQueue");
+
+      ULONGLONG totalProcessed = mTotalProcessed;
+
+      UseServicesHelper::debugAppend(resultEl, "index", mIndex);
+      UseServicesHelper::debugAppend(resultEl, "queue", (bool)mQueue);
+      UseServicesHelper::debugAppend(resultEl, "assigned", mTotalAssigned.load());
+      UseServicesHelper::debugAppend(resultEl, "depth", mDepth.load());
+      UseServicesHelper::debugAppend(resultEl, "max depth", mMaxDepth.load());
+      UseServicesHelper::debugAppend(resultEl, "queued", mTotalQueued.load());
+      UseServicesHelper::debugAppend(resultEl, "processed", totalProcessed);
+      UseServicesHelper::debugAppend(resultEl, "dropped", mTotalDropped.load());
+      UseServicesHelper::debugAppend(resultEl, "average latency (us)", 0 != totalProcessed ? (mTotalLatencyInMicroseconds.load() / totalProcessed) : 0);
+      UseServicesHelper::debugAppend(resultEl, "max latency (us)", mMaxLatencyInMicroseconds.load());
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IORTCForSettings
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void IORTCForSettings::applyDefaults()
+    {
+      UseSettings::setUInt(ORTC_SETTING_ORTC_PACKET_THREADS, 0);
+      UseSettings::setBool(ORTC_SETTING_ORTC_PACKET_THREADS_PIN_TO_CPU, false);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -85,6 +201,18 @@ namespace ortc
       return (ORTC::singleton())->queuePacket();
     }
 
+    //-------------------------------------------------------------------------
+    ORTCPacketQueuePtr IORTCForInternal::packetQueue()
+    {
+      return (ORTC::singleton())->packetQueue();
+    }
+
+    //-------------------------------------------------------------------------
+    IORTCForInternal::PacketQueueList IORTCForInternal::packetQueues()
+    {
+      return (ORTC::singleton())->packetQueues();
+    }
+
     //-------------------------------------------------------------------------
     IMessageQueuePtr IORTCForInternal::queueBlockingMediaStartStopThread()
     {
@@ -97,6 +225,12 @@ namespace ortc
       return (ORTC::singleton())->queueCertificateGeneration();
     }
 
+    //-------------------------------------------------------------------------
+    IMessageQueuePtr IORTCForInternal::queueDTLSHandshake()
+    {
+      return (ORTC::singleton())->queueDTLSHandshake();
+    }
+
     //-------------------------------------------------------------------------
     Optional<Log::Level> IORTCForInternal::webrtcLogLevel()
     {
@@ -287,16 +421,99 @@ namespace ortc
     //-------------------------------------------------------------------------
     IMessageQueuePtr ORTC::queuePacket() const
     {
+      // NOTE: users of a raw packet queue (e.g. UDP socket shards) never
+      //       release the queue thus they are not counted as assigned (or
+      //       the load balancing counts would only ever grow); their load
+      //       is still seen through the queue's depth.
+      return selectPacketQueue()->mQueue;
+    }
+
+    //-------------------------------------------------------------------------
+    ORTCPacketQueuePtr ORTC::packetQueue() const
+    {
+      // NOTE: the caller must call notifyUnassigned() on the returned queue
+      //       once it no longer posts to it
+      auto queue = selectPacketQueue();
+      queue->notifyAssigned();
+      return queue;
+    }
+
+    //-------------------------------------------------------------------------
+    ORTCPacketQueuePtr ORTC::selectPacketQueue() const
+    {
+      size_t totalCores = totalCPUCores();
+
+      size_t totalThreads = UseSettings::getUInt(ORTC_SETTING_ORTC_PACKET_THREADS);
+      if (0 == totalThreads) totalThreads = totalCores;
+      if (totalThreads > ORTC_QUEUE_MAX_PACKET_THREADS) totalThreads = ORTC_QUEUE_MAX_PACKET_THREADS;
+
       AutoRecursiveLock lock(*this);
 
-      size_t index = mNextPacketQueueThread % ORTC_QUEUE_TOTAL_PACKET_THREADS;
+      ORTCPacketQueuePtr leastLoaded;
+      size_t unusedIndex = totalThreads;
+
+      for (size_t index = 0; index < totalThreads; ++index) {
+        auto &queue = mPacketQueues[index];
+        if (!queue) {
+          if (unusedIndex == totalThreads) unusedIndex = index;
+          continue;
+        }
 
-      if (!mPacketQueues[index]) {
-        mPacketQueues[index] = UseMessageQueueManager::getMessageQueue((String(ORTC_QUEUE_PACKET_THREAD_NAME) + string(index)).c_str());
+        if (!leastLoaded) {
+          leastLoaded = queue;
+          continue;
+        }
+
+        size_t assigned = queue->mTotalAssigned;
+        size_t leastAssigned = leastLoaded->mTotalAssigned;
+
+        if (assigned > leastAssigned) continue;
+        if ((assigned == leastAssigned) &&
+            (queue->mDepth.load() >= leastLoaded->mDepth.load())) continue;
+
+        leastLoaded = queue;
+      }
+
+      // NOTE: threads are only started once every existing packet thread is
+      //       in use (and the pool is not yet full).
+      if ((unusedIndex < totalThreads) &&
+          ((!leastLoaded) ||
+           (0 != leastLoaded->mTotalAssigned))) {
+        leastLoaded = make_shared<ORTCPacketQueue>(unusedIndex, UseMessageQueueManager::getMessageQueue((String(ORTC_QUEUE_PACKET_THREAD_NAME) + string(unusedIndex)).c_str()));
+        mPacketQueues[unusedIndex] = leastLoaded;
+
+        ZS_LOG_DEBUG(log("created packet thread") + ZS_PARAM("index", unusedIndex) + ZS_PARAM("total threads", totalThreads))
+
+        if (UseSettings::getBool(ORTC_SETTING_ORTC_PACKET_THREADS_PIN_TO_CPU)) {
+          IORTCAsyncDelegateProxy::createUsingQueue(leastLoaded->mQueue, mThisWeak.lock())->onPinPacketThread(unusedIndex % totalCores);
+        }
+      }
+
+      if (!leastLoaded) {
+        // NOTE: only possible if the pool size shrank below every thread
+        //       already started; fall back to the first packet thread.
+        for (size_t index = 0; index < ORTC_QUEUE_MAX_PACKET_THREADS; ++index) {
+          if (!mPacketQueues[index]) continue;
+          leastLoaded = mPacketQueues[index];
+          break;
+        }
       }
 
-      ++mNextPacketQueueThread;
-      return mPacketQueues[index];
+      return leastLoaded;
+    }
+
+    //-------------------------------------------------------------------------
+    IORTCForInternal::PacketQueueList ORTC::packetQueues() const
+    {
+      PacketQueueList result;
+
+      AutoRecursiveLock lock(*this);
+
+      for (size_t index = 0; index < ORTC_QUEUE_MAX_PACKET_THREADS; ++index) {
+        if (!mPacketQueues[index]) continue;
+        result.push_back(mPacketQueues[index]);
+      }
+      return result;
     }
 
     //-------------------------------------------------------------------------
@@ -319,6 +536,25 @@ namespace ortc
       return mCertificateGeneration;
     }
 
+    //-------------------------------------------------------------------------
+    IMessageQueuePtr ORTC::queueDTLSHandshake() const
+    {
+      size_t totalThreads = UseSettings::getUInt(ORTC_SETTING_ORTC_DTLS_HANDSHAKE_THREADS);
+      if (totalThreads < 1) return queueORTC();
+      if (totalThreads > ORTC_QUEUE_MAX_DTLS_HANDSHAKE_THREADS) totalThreads = ORTC_QUEUE_MAX_DTLS_HANDSHAKE_THREADS;
+
+      AutoRecursiveLock lock(*this);
+
+      size_t index = mNextDTLSHandshakeQueueThread % totalThreads;
+
+      if (!mDTLSHandshakeQueues[index]) {
+        mDTLSHandshakeQueues[index] = UseMessageQueueManager::getMessageQueue((String(ORTC_QUEUE_DTLS_HANDSHAKE_THREAD_NAME) + string(index)).c_str());
+      }
+
+      ++mNextDTLSHandshakeQueueThread;
+      return mDTLSHandshakeQueues[index];
+    }
+
     //-------------------------------------------------------------------------
     Optional<Log::Level> ORTC::webrtcLogLevel() const
     {
@@ -327,6 +563,46 @@ namespace ortc
       return mDefaultWebRTCLogLevel;
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ORTC => IORTCAsyncDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void ORTC::onPinPacketThread(size_t cpu)
+    {
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      CPU_SET(static_cast<int>(cpu), &cpuSet);
+
+      int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+      if (0 != result) {
+        ZS_LOG_WARNING(Detail, log("unable to pin packet thread to cpu") + ZS_PARAM("cpu", cpu) + ZS_PARAM("error", result))
+        return;
+      }
+#elif defined(HAVE_SETTHREADAFFINITYMASK)
+      if (cpu >= (sizeof(DWORD_PTR) * 8)) {
+        ZS_LOG_WARNING(Detail, log("unable to pin packet thread to cpu (outside of affinity mask range)") + ZS_PARAM("cpu", cpu))
+        return;
+      }
+
+      DWORD_PTR mask = (static_cast<DWORD_PTR>(1) << cpu);
+      if (0 == SetThreadAffinityMask(GetCurrentThread(), mask)) {
+        ZS_LOG_WARNING(Detail, log("unable to pin packet thread to cpu") + ZS_PARAM("cpu", cpu) + ZS_PARAM("error", GetLastError()))
+        return;
+      }
+#else
+      ZS_LOG_WARNING(Detail, log("pinning packet threads to a cpu is not supported on this platform") + ZS_PARAM("cpu", cpu))
+      return;
+#endif //HAVE_PTHREAD_SETAFFINITY_NP
+
+      ZS_LOG_DEBUG(log("pinned packet thread to cpu") + ZS_PARAM("cpu", cpu))
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -349,6 +625,13 @@ namespace ortc
       ElementPtr objectEl = Element::create("ortc::ORTC");
       return Log::Params(message, objectEl);
     }
+
+    //-------------------------------------------------------------------------
+    size_t ORTC::totalCPUCores()
+    {
+      int numCpuCores = webrtc::CpuInfo::DetectNumberOfCores();
+      return (numCpuCores > 0 ? static_cast<size_t>(numCpuCores) : 1);
+    }
   }
 
   //---------------------------------------------------------------------------
@@ -53,6 +53,11 @@
 #define RTCP_GET_BITS(xByte, xBitPattern, xLowestBit) (((xByte) >> (xLowestBit)) & (xBitPattern))
 #define RTCP_PACK_BITS(xByte, xBitPattern, xLowestBit) (((xByte) & (xBitPattern)) << (xLowestBit))
 
+#define ORTC_RTCPPACKET_MAX_POOLED_BUFFERS_PER_THREAD (64)
+#define ORTC_RTCPPACKET_POOLED_BUFFER_CAPACITY_IN_BYTES (1500)
+#define ORTC_RTCPPACKET_MAX_POOLED_ARENAS_PER_THREAD (64)
+#define ORTC_RTCPPACKET_POOLED_ARENA_CAPACITY_IN_BYTES (4096)
+
 namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_rtp_rtcp_packet) }
 
 namespace ortc
@@ -124,6 +129,36 @@ namespace ortc
       return result;
     }
 
+    //-------------------------------------------------------------------------
+    struct RTCPPacketPools
+    {
+      RTPBufferPoolPtr mBufferPool;
+      RTPBufferPoolPtr mArenaPool;
+    };
+
+    //-------------------------------------------------------------------------
+    static RTCPPacketPools *getPools()
+    {
+      static thread_local bool destroyed {false};  // trivial thus still valid during thread exit
+
+      struct Holder
+      {
+        RTCPPacketPools mPools;
+
+        Holder()
+        {
+          mPools.mBufferPool = RTPBufferPool::create(ORTC_RTCPPACKET_POOLED_BUFFER_CAPACITY_IN_BYTES, ORTC_RTCPPACKET_MAX_POOLED_BUFFERS_PER_THREAD);
+          mPools.mArenaPool = RTPBufferPool::create(ORTC_RTCPPACKET_POOLED_ARENA_CAPACITY_IN_BYTES, ORTC_RTCPPACKET_MAX_POOLED_ARENAS_PER_THREAD);
+        }
+        ~Holder() {destroyed = true;}
+      };
+
+      if (destroyed) return NULL;
+
+      static thread_local Holder holder;
+      return &(holder.mPools);
+    }
+
     //-------------------------------------------------------------------------
     static size_t boundarySize(
                                size_t size,
@@ -157,6 +192,226 @@ namespace ortc
       return true;
     }
 
+    //-------------------------------------------------------------------------
+    static bool decodeTransportCC(
+                                  const BYTE *pos,
+                                  size_t remaining,
+                                  BYTE *outPacketStatuses,      // can be NULL to validate only
+                                  LONG *outRecvDeltas,          // can be NULL to validate only
+                                  size_t &outRecvDeltaCount
+                                  )
+    {
+      typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
+
+      outRecvDeltaCount = 0;
+
+      if (remaining < (sizeof(DWORD)*2)) return false;
+
+      size_t statusCount = static_cast<size_t>(RTPUtils::getBE16(&(pos[2])));
+
+      advancePos(pos, remaining, sizeof(DWORD)*2);
+
+      size_t statusIndex = 0;
+      size_t recvDeltaSize = 0;
+
+      while (statusIndex < statusCount) {
+        if (remaining < sizeof(WORD)) return false;
+
+        WORD chunk = RTPUtils::getBE16(pos);
+        advancePos(pos, remaining, sizeof(WORD));
+
+        size_t symbolBits = 0;
+        size_t total = 0;
+        BYTE runSymbol = 0;
+
+        if (0 == (chunk & 0x8000)) {
+          // run length chunk
+          runSymbol = static_cast<BYTE>(RTCP_GET_BITS(chunk, 0x3, 13));
+          total = static_cast<size_t>(RTCP_GET_BITS(chunk, 0x1FFF, 0));
+        } else if (0 == (chunk & 0x4000)) {
+          // status vector chunk of 14 one bit symbols
+          symbolBits = 1;
+          total = 14;
+        } else {
+          // status vector chunk of 7 two bit symbols
+          symbolBits = 2;
+          total = 7;
+        }
+
+        for (size_t index = 0; (index < total) && (statusIndex < statusCount); ++index, ++statusIndex) {
+          BYTE symbol = (0 != symbolBits ? static_cast<BYTE>(RTCP_GET_BITS(chunk, (1 << symbolBits) - 1, 14 - (symbolBits * (index + 1)))) : runSymbol);
+
+          switch (symbol) {
+            case TransportCC::PacketStatusSymbol_NotReceived:                   break;
+            case TransportCC::PacketStatusSymbol_ReceivedSmallDelta:            recvDeltaSize += sizeof(BYTE); ++outRecvDeltaCount; break;
+            case TransportCC::PacketStatusSymbol_ReceivedLargeOrNegativeDelta:  recvDeltaSize += sizeof(WORD); ++outRecvDeltaCount; break;
+            default:                                                            return false;
+          }
+
+          if (NULL != outPacketStatuses) outPacketStatuses[statusIndex] = symbol;
+        }
+      }
+
+      if (remaining < recvDeltaSize) return false;
+
+      if (NULL == outRecvDeltas) return true;
+
+      ASSERT(NULL != outPacketStatuses)
+
+      LONG *delta = outRecvDeltas;
+
+      for (size_t index = 0; index < statusCount; ++index) {
+        switch (outPacketStatuses[index]) {
+          case TransportCC::PacketStatusSymbol_ReceivedSmallDelta: {
+            *delta = static_cast<LONG>(pos[0]);
+            ++delta;
+            advancePos(pos, remaining, sizeof(BYTE));
+            break;
+          }
+          case TransportCC::PacketStatusSymbol_ReceivedLargeOrNegativeDelta: {
+            *delta = static_cast<LONG>(static_cast<signed short>(RTPUtils::getBE16(pos)));
+            ++delta;
+            advancePos(pos, remaining, sizeof(WORD));
+            break;
+          }
+          default: break;
+        }
+      }
+
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    static size_t encodeTransportCCChunks(
+                                          const RTCPPacket::TransportLayerFeedbackMessage::TransportCC *transportCC,
+                                          BYTE *pos                     // can be NULL to calculate size only
+                                          )
+    {
+      const BYTE *statuses = transportCC->mPacketStatuses;
+      size_t count = transportCC->packetStatusCount();
+
+      size_t result = 0;
+      size_t index = 0;
+
+      while (index < count) {
+        BYTE symbol = statuses[index];
+        size_t remaining = count - index;
+
+        size_t runLength = 1;
+        while ((runLength < remaining) &&
+               (runLength < 0x1FFF) &&
+               (statuses[index + runLength] == symbol)) {
+          ++runLength;
+        }
+
+        bool oneBitOnly = true;
+        for (size_t check = 0; (check < 14) && (check < remaining); ++check) {
+          if (statuses[index + check] > 1) {
+            oneBitOnly = false;
+            break;
+          }
+        }
+
+        WORD chunk = 0;
+        size_t consumed = 0;
+
+        if ((runLength >= 14) ||
+            (runLength == remaining) ||
+            ((!oneBitOnly) && (runLength >= 7))) {
+          chunk = static_cast<WORD>(RTCP_PACK_BITS(symbol, 0x3, 13) | RTCP_PACK_BITS(runLength, 0x1FFF, 0));
+          consumed = runLength;
+        } else if (oneBitOnly) {
+          chunk = 0x8000;
+          consumed = (remaining < 14 ? remaining : 14);
+          for (size_t sub = 0; sub < consumed; ++sub) {
+            chunk |= static_cast<WORD>(RTCP_PACK_BITS(statuses[index + sub], 0x1, 13 - sub));
+          }
+        } else {
+          chunk = 0xC000;
+          consumed = (remaining < 7 ? remaining : 7);
+          for (size_t sub = 0; sub < consumed; ++sub) {
+            chunk |= static_cast<WORD>(RTCP_PACK_BITS(statuses[index + sub], 0x3, 12 - (sub * 2)));
+          }
+        }
+
+        if (NULL != pos) {
+          RTPUtils::setBE16(&(pos[result]), chunk);
+        }
+
+        result += sizeof(WORD);
+        index += consumed;
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    static size_t encodeTransportCCRecvDeltas(
+                                              const RTCPPacket::TransportLayerFeedbackMessage::TransportCC *transportCC,
+                                              BYTE *pos
+                                              )
+    {
+      typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
+
+      size_t result = 0;
+      size_t deltaIndex = 0;
+
+      for (size_t index = 0; index < transportCC->packetStatusCount(); ++index) {
+        switch (transportCC->packetStatusAtIndex(index)) {
+          case TransportCC::PacketStatusSymbol_NotReceived:                   break;
+          case TransportCC::PacketStatusSymbol_ReceivedSmallDelta:            {
+            pos[result] = static_cast<BYTE>(transportCC->recvDeltaAtIndex(deltaIndex));
+            ++deltaIndex;
+            result += sizeof(BYTE);
+            break;
+          }
+          case TransportCC::PacketStatusSymbol_ReceivedLargeOrNegativeDelta:  {
+            RTPUtils::setBE16(&(pos[result]), static_cast<WORD>(static_cast<signed short>(transportCC->recvDeltaAtIndex(deltaIndex))));
+            ++deltaIndex;
+            result += sizeof(WORD);
+            break;
+          }
+        }
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    static size_t getTransportCCRecvDeltaSize(const RTCPPacket::TransportLayerFeedbackMessage::TransportCC *transportCC)
+    {
+      typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
+
+      size_t result = 0;
+      size_t deltaCount = 0;
+
+      for (size_t index = 0; index < transportCC->packetStatusCount(); ++index) {
+        switch (transportCC->mPacketStatuses[index]) {
+          case TransportCC::PacketStatusSymbol_NotReceived:                   break;
+          case TransportCC::PacketStatusSymbol_ReceivedSmallDelta:            {
+            ORTC_THROW_INVALID_PARAMETERS_IF(deltaCount >= transportCC->recvDeltaCount())
+            ORTC_THROW_INVALID_PARAMETERS_IF((transportCC->mRecvDeltas[deltaCount] < 0) || (transportCC->mRecvDeltas[deltaCount] > 0xFF))
+            result += sizeof(BYTE);
+            ++deltaCount;
+            break;
+          }
+          case TransportCC::PacketStatusSymbol_ReceivedLargeOrNegativeDelta:  {
+            ORTC_THROW_INVALID_PARAMETERS_IF(deltaCount >= transportCC->recvDeltaCount())
+            ORTC_THROW_INVALID_PARAMETERS_IF((transportCC->mRecvDeltas[deltaCount] < -0x8000) || (transportCC->mRecvDeltas[deltaCount] > 0x7FFF))
+            result += sizeof(WORD);
+            ++deltaCount;
+            break;
+          }
+          default: {
+            ORTC_THROW_INVALID_PARAMETERS("transport-cc packet status symbol is not legal")
+          }
+        }
+      }
+
+      ORTC_THROW_INVALID_PARAMETERS_IF(deltaCount != transportCC->recvDeltaCount())
+      return result;
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -344,6 +599,7 @@ namespace ortc
             case TransportLayerFeedbackMessage::GenericNACK::kFmt:  return "GenericNACK";
             case TransportLayerFeedbackMessage::TMMBR::kFmt:        return "TMMBR";
             case TransportLayerFeedbackMessage::TMMBN::kFmt:        return "TMMBN";
+            case TransportLayerFeedbackMessage::TransportCC::kFmt:  return "TransportCC";
             default:                                                break;
           }
           break;
@@ -418,6 +674,46 @@ namespace ortc
       return &(mFirstTMMBN[index]);
     }
 
+    //-------------------------------------------------------------------------
+    RTCPPacket::TransportLayerFeedbackMessage::TransportCC *RTCPPacket::TransportLayerFeedbackMessage::transportCC() const
+    {
+      if (!mHasTransportCC) return NULL;
+      return const_cast<TransportCC *>(&mTransportCC);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPPacket::TransportLayerFeedbackMessage::TransportCC
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    const char *RTCPPacket::TransportLayerFeedbackMessage::TransportCC::toString(PacketStatusSymbols symbol)
+    {
+      switch (symbol) {
+        case PacketStatusSymbol_NotReceived:                  return "not received";
+        case PacketStatusSymbol_ReceivedSmallDelta:           return "received small delta";
+        case PacketStatusSymbol_ReceivedLargeOrNegativeDelta: return "received large or negative delta";
+      }
+      return "UNDEFINED";
+    }
+
+    //-------------------------------------------------------------------------
+    RTCPPacket::TransportLayerFeedbackMessage::TransportCC::PacketStatusSymbols RTCPPacket::TransportLayerFeedbackMessage::TransportCC::packetStatusAtIndex(size_t index) const
+    {
+      ASSERT(index < packetStatusCount())
+      return static_cast<PacketStatusSymbols>(mPacketStatuses[index]);
+    }
+
+    //-------------------------------------------------------------------------
+    LONG RTCPPacket::TransportLayerFeedbackMessage::TransportCC::recvDeltaAtIndex(size_t index) const
+    {
+      ASSERT(index < mRecvDeltaCount)
+      return mRecvDeltas[index];
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -832,12 +1128,26 @@ namespace ortc
     {
     }
 
+    //-------------------------------------------------------------------------
+    const char *RTCPPacket::toString(ParseModes mode)
+    {
+      switch (mode) {
+        case ParseMode_Full:  return "full";
+        case ParseMode_Fast:  return "fast";
+      }
+      return "UNDEFINED";
+    }
+
     //-------------------------------------------------------------------------
     RTCPPacketPtr RTCPPacket::create(const BYTE *buffer, size_t bufferLengthInBytes)
     {
       ORTC_THROW_INVALID_PARAMETERS_IF(!buffer)
       ORTC_THROW_INVALID_PARAMETERS_IF(0 == bufferLengthInBytes)
-      return RTCPPacket::create(UseServicesHelper::convertToBuffer(buffer, bufferLengthInBytes));
+
+      SecureByteBlockPtr packetBuffer = allocatePacketBuffer(bufferLengthInBytes);
+      memcpy(packetBuffer->BytePtr(), buffer, bufferLengthInBytes);
+
+      return RTCPPacket::create(packetBuffer);
     }
 
     //-------------------------------------------------------------------------
@@ -848,8 +1158,18 @@ namespace ortc
 
     //-------------------------------------------------------------------------
     RTCPPacketPtr RTCPPacket::create(SecureByteBlockPtr buffer)
+    {
+      return RTCPPacket::create(buffer, ParseMode_Full);
+    }
+
+    //-------------------------------------------------------------------------
+    RTCPPacketPtr RTCPPacket::create(
+                                     SecureByteBlockPtr buffer,
+                                     ParseModes mode
+                                     )
     {
       RTCPPacketPtr pThis(make_shared<RTCPPacket>(make_private{}));
+      pThis->mParseMode = mode;
       pThis->mBuffer = buffer;
       if (!pThis->parse()) {
         ZS_LOG_WARNING(Debug, pThis->log("packet could not be parsed"))
@@ -965,6 +1285,125 @@ namespace ortc
       return &(mFirstUnknownReport[index]);
     }
 
+    //-------------------------------------------------------------------------
+    static void appendFeedbackEntrySSRCs(
+                                         const BYTE *fci,
+                                         size_t fciSize,
+                                         size_t entrySize,
+                                         RTCPPacket::SSRCList &outMediaSSRCs
+                                         )
+    {
+      for (; fciSize >= entrySize; fci += entrySize, fciSize -= entrySize) {
+        outMediaSSRCs.push_back(RTPUtils::getBE32(fci));
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::getReferencedSSRCs(
+                                        SSRCList &outSenderSSRCs,
+                                        SSRCList &outMediaSSRCs
+                                        ) const
+    {
+      outSenderSSRCs.clear();
+      outMediaSSRCs.clear();
+
+      const BYTE *pos = ptr();
+      size_t remaining = size();
+
+      while (remaining >= sizeof(DWORD)) {
+        size_t length = (static_cast<size_t>(RTPUtils::getBE16(&(pos[2]))) + 1) * sizeof(DWORD);
+        if (length > remaining) return false;
+
+        BYTE reportSpecific = RTCP_GET_BITS(*pos, 0x1F, 0);
+        BYTE pt = pos[1];
+
+        const BYTE *body = &(pos[sizeof(DWORD)]);
+        size_t bodySize = length - sizeof(DWORD);
+
+        if (0 != RTCP_GET_BITS(*pos, 0x1, 5)) {
+          size_t padding = static_cast<size_t>(pos[length - 1]);
+          if (padding > bodySize) return false;
+          bodySize -= padding;
+        }
+
+        switch (pt) {
+          case SenderReport::kPayloadType:
+          case ReceiverReport::kPayloadType:
+          {
+            size_t headerSize = (SenderReport::kPayloadType == pt ? (sizeof(DWORD)*6) : sizeof(DWORD));
+            if (bodySize < headerSize) return false;
+
+            outSenderSSRCs.push_back(RTPUtils::getBE32(body));
+            appendFeedbackEntrySSRCs(&(body[headerSize]), std::min(bodySize - headerSize, static_cast<size_t>(reportSpecific) * (sizeof(DWORD)*6)), sizeof(DWORD)*6, outMediaSSRCs);
+            break;
+          }
+          case SDES::kPayloadType:  break; // NOTE: SDES is processed centrally
+          case Bye::kPayloadType:
+          {
+            appendFeedbackEntrySSRCs(body, std::min(bodySize, static_cast<size_t>(reportSpecific) * sizeof(DWORD)), sizeof(DWORD), outSenderSSRCs);
+            break;
+          }
+          case App::kPayloadType:
+          {
+            if (bodySize < sizeof(DWORD)) return false;
+            outSenderSSRCs.push_back(RTPUtils::getBE32(body));
+            break;
+          }
+          case TransportLayerFeedbackMessage::kPayloadType:
+          case PayloadSpecificFeedbackMessage::kPayloadType:
+          {
+            if (bodySize < (sizeof(DWORD)*2)) return false;
+
+            outSenderSSRCs.push_back(RTPUtils::getBE32(body));
+
+            DWORD mediaSSRC = RTPUtils::getBE32(&(body[sizeof(DWORD)]));
+            const BYTE *fci = &(body[sizeof(DWORD)*2]);
+            size_t fciSize = bodySize - (sizeof(DWORD)*2);
+
+            if (TransportLayerFeedbackMessage::kPayloadType == pt) {
+              switch (reportSpecific) {
+                case TransportLayerFeedbackMessage::TMMBR::kFmt:
+                case TransportLayerFeedbackMessage::TMMBN::kFmt:        appendFeedbackEntrySSRCs(fci, fciSize, sizeof(DWORD)*2, outMediaSSRCs); goto next_report;
+                default:                                                break;
+              }
+            } else {
+              switch (reportSpecific) {
+                case PayloadSpecificFeedbackMessage::FIR::kFmt:
+                case PayloadSpecificFeedbackMessage::TSTR::kFmt:
+                case PayloadSpecificFeedbackMessage::TSTN::kFmt:  appendFeedbackEntrySSRCs(fci, fciSize, sizeof(DWORD)*2, outMediaSSRCs); goto next_report;
+                case PayloadSpecificFeedbackMessage::VBCM::kFmt:  return false;
+                case PayloadSpecificFeedbackMessage::AFB::kFmt:
+                {
+                  if ((fciSize < (sizeof(DWORD)*2)) ||
+                      (0 != memcmp(fci, reinterpret_cast<const BYTE *>("REMB"), sizeof(DWORD)))) return false;
+
+                  size_t count = static_cast<size_t>(fci[sizeof(DWORD)]);
+                  fci += (sizeof(DWORD)*2);
+                  fciSize -= (sizeof(DWORD)*2);
+                  appendFeedbackEntrySSRCs(fci, std::min(fciSize, count * sizeof(DWORD)), sizeof(DWORD), outMediaSSRCs);
+                  goto next_report;
+                }
+                default:                                          break;
+              }
+            }
+
+            if (0 == mediaSSRC) return false;
+            outMediaSSRCs.push_back(mediaSSRC);
+            break;
+          }
+          default:                  return false;
+        }
+
+      next_report:
+        {
+          pos += length;
+          remaining -= length;
+        }
+      }
+
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     static void toDebug(
                         ElementPtr &subEl,
@@ -1358,6 +1797,21 @@ namespace ortc
         }
       }
 
+      {
+        auto transportCC = fm->transportCC();
+        if (NULL != transportCC) {
+          ElementPtr formatEl = Element::create("TransportCC");
+
+          UseServicesHelper::debugAppend(formatEl, "base sequence number", transportCC->baseSequenceNumber());
+          UseServicesHelper::debugAppend(formatEl, "packet status count", transportCC->packetStatusCount());
+          UseServicesHelper::debugAppend(formatEl, "reference time", transportCC->referenceTime());
+          UseServicesHelper::debugAppend(formatEl, "fb pkt count", transportCC->fbPktCount());
+          UseServicesHelper::debugAppend(formatEl, "recv delta count", transportCC->recvDeltaCount());
+
+          UseServicesHelper::debugAppend(subEl, formatEl);
+        }
+      }
+
       UseServicesHelper::debugAppend(subEl, "unknown", NULL != fm->unknown());
 
       UseServicesHelper::debugAppend(subEl, "next transport layer feedback message", (NULL != fm->nextTransportLayerFeedbackMessage()));
@@ -1795,6 +2249,7 @@ namespace ortc
     {
       ElementPtr objectEl = Element::create("ortc::RTCPPacket");
 
+      UseServicesHelper::debugAppend(objectEl, "parse mode", toString(mParseMode));
       UseServicesHelper::debugAppend(objectEl, "buffer", mBuffer ? mBuffer->SizeInBytes() : 0);
       UseServicesHelper::debugAppend(objectEl, "allocate buffer", mAllocationBuffer ? mAllocationBuffer->SizeInBytes() : 0);
 
@@ -1911,7 +2366,7 @@ namespace ortc
 
       bool foundPaddingBit = false;
 
-      // scope: calculate total memory allocation size needed to parse entire RTCP packet
+      // scope: pass 1 - validate blocks and calculate total memory allocation size needed to parse entire RTCP packet
       {
         size_t remaining = size;
         const BYTE *pos = buffer;
@@ -1955,6 +2410,12 @@ namespace ortc
 
           advancePos(pos, remaining, sizeof(DWORD));
 
+          if (!shouldDecode(pt)) {
+            ZS_LOG_INSANE(log("skipping report (not decoded in this parse mode)") + ZS_PARAM("pt", Report::ptToString(pt)) + ZS_PARAM("mode", toString(mParseMode)))
+            advancePos(pos, remaining, length - sizeof(DWORD) + padding);
+            continue;
+          }
+
           size_t preAllocationSize = mAllocationSize;
 
           if (!getAllocationSize(version, static_cast<BYTE>(padding), reportSpecific, pt, pos, length - sizeof(DWORD))) return false;
@@ -1978,11 +2439,11 @@ namespace ortc
         return true;
       }
 
-      mAllocationBuffer = make_shared<SecureByteBlock>(alignedSize(mAllocationSize));
+      mAllocationBuffer = allocateArena(alignedSize(mAllocationSize));
 
       mAllocationPos = mAllocationBuffer->BytePtr();
 
-      // scope: allocation size is now established; begin parsing all reports contained in RTCP packet
+      // scope: pass 2 - allocation size is now established; begin parsing all reports contained in RTCP packet into the arena
       {
         size_t remaining = size;
         const BYTE *pos = buffer;
@@ -2047,6 +2508,11 @@ namespace ortc
 
           advancePos(pos, remaining, sizeof(DWORD));
 
+          if (!shouldDecode(pt)) {
+            advancePos(pos, remaining, length - sizeof(DWORD) + padding);
+            continue;
+          }
+
           size_t preAllocationSize = mAllocationSize;
 
           if (!parse(lastReport, version, static_cast<BYTE>(padding), reportSpecific, pt, pos, length - sizeof(DWORD))) return false;
@@ -2075,6 +2541,23 @@ namespace ortc
       return true;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::shouldDecode(BYTE pt) const
+    {
+      // NOTE: fast mode decodes SR, RR, SDES and BYE only; APP, RTPFB, PSFB,
+      //       XR and unknown report types are skipped in both passes.
+      if (ParseMode_Full == mParseMode) return true;
+
+      switch (pt) {
+        case SenderReport::kPayloadType:
+        case ReceiverReport::kPayloadType:
+        case SDES::kPayloadType:
+        case Bye::kPayloadType:             return true;
+        default:                            break;
+      }
+      return false;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2359,6 +2842,7 @@ namespace ortc
         case TransportLayerFeedbackMessage::GenericNACK::kFmt:  result = getTransportLayerFeedbackMessageGenericNACKAllocationSize(reportSpecific, pos, remaining); break;
         case TransportLayerFeedbackMessage::TMMBR::kFmt:        result = getTransportLayerFeedbackMessageTMMBRAllocationSize(reportSpecific, pos, remaining); break;
         case TransportLayerFeedbackMessage::TMMBN::kFmt:        result = getTransportLayerFeedbackMessageTMMBNAllocationSize(reportSpecific, pos, remaining); break;
+        case TransportLayerFeedbackMessage::TransportCC::kFmt:  result = getTransportLayerFeedbackMessageTransportCCAllocationSize(reportSpecific, pos, remaining); break;
         default: {
           break;
         }
@@ -2570,6 +3054,30 @@ namespace ortc
       mAllocationSize += (alignedSize(sizeof(TransportLayerFeedbackMessage::TMMBN)) * possibleTMMBNs);
       return true;
     }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::getTransportLayerFeedbackMessageTransportCCAllocationSize(
+                                                                               BYTE fmt,
+                                                                               const BYTE *contents,
+                                                                               size_t contentSize
+                                                                               )
+    {
+      size_t recvDeltaCount = 0;
+
+      if (!decodeTransportCC(contents, contentSize, NULL, NULL, recvDeltaCount)) {
+        // NOTE: the parse pass falls back to treating a malformed report as
+        //       an unknown report (see parseTransportCC) which requires no
+        //       additional allocation beyond the report itself.
+        ZS_LOG_WARNING(Trace, debug("malformed transport-cc transport layer feedback message (sized as unknown)") + ZS_PARAM("remaining", contentSize))
+        return true;
+      }
+
+      size_t statusCount = static_cast<size_t>(RTPUtils::getBE16(&(contents[2])));
+
+      mAllocationSize += alignedSize(sizeof(BYTE)*statusCount);
+      mAllocationSize += alignedSize(sizeof(LONG)*recvDeltaCount);
+      return true;
+    }
     
     //-------------------------------------------------------------------------
     bool RTCPPacket::getPayloadSpecificFeedbackMessagePLIAllocationSize(
@@ -3522,6 +4030,7 @@ namespace ortc
           case TransportLayerFeedbackMessage::GenericNACK::kFmt:  result = parseGenericNACK(report); break;
           case TransportLayerFeedbackMessage::TMMBR::kFmt:        result = parseTMMBR(report); break;
           case TransportLayerFeedbackMessage::TMMBN::kFmt:        result = parseTMMBN(report); break;
+          case TransportLayerFeedbackMessage::TransportCC::kFmt:  result = parseTransportCC(report); break;
           default: {
             result = parseUnknown(report);
             break;
@@ -3977,6 +4486,49 @@ namespace ortc
       return true;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTCPPacket::parseTransportCC(TransportLayerFeedbackMessage *report)
+    {
+      typedef TransportLayerFeedbackMessage::TransportCC TransportCC;
+
+      const BYTE *pos = report->fci();
+      size_t remaining = report->fciSize();
+
+      size_t recvDeltaCount = 0;
+
+      // NOTE: validated again as the allocation pass does not reject the
+      //       report when the FCI is malformed (treated as unknown instead)
+      if ((NULL == pos) ||
+          (!decodeTransportCC(pos, remaining, NULL, NULL, recvDeltaCount))) {
+        ZS_LOG_WARNING(Trace, debug("malformed transport-cc (treating as unknown)") + ZS_PARAM("remaining", remaining))
+        return parseUnknown(report);
+      }
+
+      TransportCC &transportCC = report->mTransportCC;
+
+      transportCC.mBaseSequenceNumber = RTPUtils::getBE16(&(pos[0]));
+      transportCC.mPacketStatusCount = RTPUtils::getBE16(&(pos[2]));
+
+      DWORD referenceTime = RTCP_GET_BITS(RTPUtils::getBE32(&(pos[4])), 0xFFFFFF, 8);
+      transportCC.mReferenceTime = (0 != (referenceTime & 0x800000) ? static_cast<LONG>(referenceTime) - static_cast<LONG>(0x1000000) : static_cast<LONG>(referenceTime));
+      transportCC.mFBPktCount = pos[7];
+
+      size_t statusCount = transportCC.packetStatusCount();
+
+      if (0 != statusCount) {
+        transportCC.mPacketStatuses = new (allocateBuffer(alignedSize(sizeof(BYTE)*statusCount))) BYTE[statusCount];
+      }
+      if (0 != recvDeltaCount) {
+        transportCC.mRecvDeltas = new (allocateBuffer(alignedSize(sizeof(LONG)*recvDeltaCount))) LONG[recvDeltaCount];
+      }
+
+      decodeTransportCC(pos, remaining, transportCC.mPacketStatuses, transportCC.mRecvDeltas, transportCC.mRecvDeltaCount);
+      ASSERT(recvDeltaCount == transportCC.mRecvDeltaCount)
+
+      report->mHasTransportCC = true;
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     bool RTCPPacket::parseUnknown(TransportLayerFeedbackMessage *report)
     {
@@ -4560,6 +5112,22 @@ namespace ortc
       return internal::allocateBuffer(mAllocationPos, mAllocationSize, size);
     }
 
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTCPPacket::allocatePacketBuffer(size_t size)
+    {
+      auto pools = getPools();
+      if (!pools) return make_shared<SecureByteBlock>(size);
+      return pools->mBufferPool->obtain(size);
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTCPPacket::allocateArena(size_t size)
+    {
+      auto pools = getPools();
+      if (!pools) return make_shared<SecureByteBlock>(size);
+      return pools->mArenaPool->obtain(size);
+    }
+
     //-------------------------------------------------------------------------
     static size_t getPacketSizeSenderReport(const RTCPPacket::SenderReport *report)
     {
@@ -4746,6 +5314,7 @@ namespace ortc
       typedef RTCPPacket::TransportLayerFeedbackMessage::GenericNACK GenericNACK;
       typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBR TMMBR;
       typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBN TMMBN;
+      typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
 
       size_t result = (sizeof(DWORD)*3);
 
@@ -4770,6 +5339,18 @@ namespace ortc
           result += ((sizeof(DWORD)*2)*(count));
           break;
         }
+        case TransportCC::kFmt:
+        {
+          auto transportCC = fm->transportCC();
+          ORTC_THROW_INVALID_PARAMETERS_IF(NULL == transportCC)
+          ORTC_THROW_INVALID_PARAMETERS_IF((0 != transportCC->packetStatusCount()) && (NULL == transportCC->mPacketStatuses))
+          ORTC_THROW_INVALID_PARAMETERS_IF((0 != transportCC->recvDeltaCount()) && (NULL == transportCC->mRecvDeltas))
+
+          result += (sizeof(DWORD)*2);
+          result += encodeTransportCCChunks(transportCC, NULL);
+          result += getTransportCCRecvDeltaSize(transportCC);
+          break;
+        }
         default:
         {
           auto fciSize = fm->fciSize();
@@ -5417,6 +5998,7 @@ namespace ortc
       typedef RTCPPacket::TransportLayerFeedbackMessage::GenericNACK GenericNACK;
       typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBR TMMBR;
       typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBN TMMBN;
+      typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
 
       pos[1] = TransportLayerFeedbackMessage::kPayloadType;
 
@@ -5477,6 +6059,23 @@ namespace ortc
           }
           break;
         }
+        case TransportCC::kFmt:
+        {
+          auto transportCC = report->transportCC();
+          ASSERT(NULL != transportCC)
+
+          RTPUtils::setBE16(&(pos[0]), transportCC->baseSequenceNumber());
+          RTPUtils::setBE16(&(pos[2]), static_cast<WORD>(transportCC->packetStatusCount()));
+          RTPUtils::setBE32(&(pos[4]), RTCP_PACK_BITS(static_cast<DWORD>(transportCC->referenceTime()), 0xFFFFFF, 8) | static_cast<DWORD>(transportCC->fbPktCount()));
+          advancePos(pos, remaining, sizeof(DWORD)*2);
+
+          size_t chunkSize = encodeTransportCCChunks(transportCC, pos);
+          advancePos(pos, remaining, chunkSize);
+
+          size_t deltaSize = encodeTransportCCRecvDeltas(transportCC, pos);
+          advancePos(pos, remaining, deltaSize);
+          break;
+        }
         default:
         {
           auto fciSize = report->fciSize();
@@ -5992,6 +6591,567 @@ namespace ortc
       ASSERT(0 == remaining)
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPPacketWriter
+    #pragma mark
+
+    static const size_t kMaxReportCount = 0x1F;
+    static const size_t kReportBlockSize = sizeof(DWORD)*6;
+
+    //-------------------------------------------------------------------------
+    RTCPPacketWriter::RTCPPacketWriter(
+                                       IRTCPPacketWriterDelegate *delegate,
+                                       BYTE *buffer,
+                                       size_t bufferSizeInBytes
+                                       ) :
+      mDelegate(delegate),
+      mBuffer(buffer),
+      mBufferSize(bufferSizeInBytes - (bufferSizeInBytes % sizeof(DWORD)))
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(NULL == delegate)
+      ORTC_THROW_INVALID_PARAMETERS_IF(NULL == buffer)
+      ORTC_THROW_INVALID_PARAMETERS_IF(mBufferSize < kMinRtcpPacketLen)
+    }
+
+    //-------------------------------------------------------------------------
+    RTCPPacketWriter::~RTCPPacketWriter()
+    {
+      if (0 != mSize) {
+        ZS_LOG_WARNING(Debug, log("discarding unflushed compound packet") + ZS_PARAM("size", mSize))
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writeSenderReport(
+                                             DWORD ssrcOfSender,
+                                             DWORD ntpTimestampMS,
+                                             DWORD ntpTimestampLS,
+                                             DWORD rtpTimestamp,
+                                             DWORD senderPacketCount,
+                                             DWORD senderOctetCount,
+                                             const ReportBlock *reportBlocks,
+                                             size_t reportBlockCount
+                                             )
+    {
+      size_t count = (reportBlockCount > kMaxReportCount ? kMaxReportCount : reportBlockCount);
+
+      BYTE *pos = reserve(static_cast<BYTE>(count), RTCPPacket::SenderReport::kPayloadType, (sizeof(DWORD)*7) + (kReportBlockSize*count));
+      if (NULL == pos) return false;
+
+      RTPUtils::setBE32(&(pos[4]), ssrcOfSender);
+      RTPUtils::setBE32(&(pos[8]), ntpTimestampMS);
+      RTPUtils::setBE32(&(pos[12]), ntpTimestampLS);
+      RTPUtils::setBE32(&(pos[16]), rtpTimestamp);
+      RTPUtils::setBE32(&(pos[20]), senderPacketCount);
+      RTPUtils::setBE32(&(pos[24]), senderOctetCount);
+
+      writeReportBlocks(&(pos[28]), reportBlocks, count);
+
+      if (count == reportBlockCount) return true;
+
+      // remaining report blocks are carried in follow-on receiver reports
+      return writeReceiverReport(ssrcOfSender, &(reportBlocks[count]), reportBlockCount - count);
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writeReceiverReport(
+                                               DWORD ssrcOfPacketSender,
+                                               const ReportBlock *reportBlocks,
+                                               size_t reportBlockCount
+                                               )
+    {
+      do
+      {
+        size_t count = (reportBlockCount > kMaxReportCount ? kMaxReportCount : reportBlockCount);
+
+        BYTE *pos = reserve(static_cast<BYTE>(count), RTCPPacket::ReceiverReport::kPayloadType, (sizeof(DWORD)*2) + (kReportBlockSize*count));
+        if (NULL == pos) return false;
+
+        RTPUtils::setBE32(&(pos[4]), ssrcOfPacketSender);
+
+        writeReportBlocks(&(pos[8]), reportBlocks, count);
+
+        reportBlocks += count;
+        reportBlockCount -= count;
+      } while (0 != reportBlockCount);
+
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writeSDES(
+                                     DWORD ssrc,
+                                     const char *cname,
+                                     const char *mid,
+                                     const char *rid
+                                     )
+    {
+      typedef RTCPPacket::SDES::Chunk Chunk;
+
+      struct Item
+      {
+        BYTE mType;
+        const char *mValue;
+        size_t mLength;
+      };
+
+      Item items[] = {
+        {Chunk::CName::kItemType, cname, (NULL != cname ? strlen(cname) : 0)},
+        {Chunk::Mid::kItemType, mid, (NULL != mid ? strlen(mid) : 0)},
+        {Chunk::Rid::kItemType, rid, (NULL != rid ? strlen(rid) : 0)},
+      };
+
+      size_t chunkSize = sizeof(DWORD) + sizeof(BYTE);  // SSRC + terminating null item
+
+      for (size_t index = 0; index < (sizeof(items)/sizeof(items[0])); ++index)
+      {
+        auto &item = items[index];
+        if (0 == item.mLength) continue;
+
+        if (item.mLength > 0xFF) {
+          ZS_LOG_WARNING(Debug, log("SDES item is too long") + ZS_PARAM("type", item.mType) + ZS_PARAM("length", item.mLength))
+          return false;
+        }
+        chunkSize += sizeof(WORD) + item.mLength;
+      }
+
+      BYTE *pos = reserve(1, RTCPPacket::SDES::kPayloadType, sizeof(DWORD) + boundarySize(chunkSize));
+      if (NULL == pos) return false;
+
+      RTPUtils::setBE32(&(pos[4]), ssrc);
+      pos += (sizeof(DWORD)*2);
+
+      for (size_t index = 0; index < (sizeof(items)/sizeof(items[0])); ++index)
+      {
+        auto &item = items[index];
+        if (0 == item.mLength) continue;
+
+        pos[0] = item.mType;
+        pos[1] = static_cast<BYTE>(item.mLength);
+        memcpy(&(pos[2]), item.mValue, item.mLength);
+        pos += sizeof(WORD) + item.mLength;
+      }
+
+      // NOTE: terminating null item and padding were zeroed by reserve()
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writeBye(
+                                    const DWORD *ssrcs,
+                                    size_t ssrcCount,
+                                    const char *reasonForLeaving
+                                    )
+    {
+      size_t len = (NULL != reasonForLeaving ? strlen(reasonForLeaving) : 0);
+
+      if ((ssrcCount > kMaxReportCount) ||
+          (len > 0xFF)) {
+        ZS_LOG_WARNING(Debug, log("BYE cannot be encoded") + ZS_PARAM("ssrcs", ssrcCount) + ZS_PARAM("reason length", len))
+        return false;
+      }
+
+      size_t size = sizeof(DWORD) + (sizeof(DWORD)*ssrcCount) + (0 != len ? boundarySize(sizeof(BYTE) + len) : 0);
+
+      BYTE *pos = reserve(static_cast<BYTE>(ssrcCount), RTCPPacket::Bye::kPayloadType, size);
+      if (NULL == pos) return false;
+
+      pos += sizeof(DWORD);
+
+      for (size_t index = 0; index < ssrcCount; ++index, pos += sizeof(DWORD))
+      {
+        RTPUtils::setBE32(pos, ssrcs[index]);
+      }
+
+      if (0 != len) {
+        pos[0] = static_cast<BYTE>(len);
+        memcpy(&(pos[1]), reasonForLeaving, len);
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writeGenericNACK(
+                                            DWORD ssrcOfPacketSender,
+                                            DWORD ssrcOfMediaSource,
+                                            const GenericNACK *nacks,
+                                            size_t nackCount
+                                            )
+    {
+      const size_t headerSize = sizeof(DWORD)*3;
+
+      while (0 != nackCount)
+      {
+        if (remaining() < headerSize + sizeof(DWORD)) {
+          continueCompound(RTCPPacket::TransportLayerFeedbackMessage::kPayloadType);
+          if (remaining() < headerSize + sizeof(DWORD)) {
+            ZS_LOG_WARNING(Debug, log("buffer cannot hold a generic NACK") + ZS_PARAM("buffer size", mBufferSize))
+            return false;
+          }
+        }
+
+        size_t count = (remaining() - headerSize) / sizeof(DWORD);
+        if (count > nackCount) count = nackCount;
+
+        BYTE *pos = reserve(RTCPPacket::TransportLayerFeedbackMessage::GenericNACK::kFmt, RTCPPacket::TransportLayerFeedbackMessage::kPayloadType, headerSize + (sizeof(DWORD)*count));
+        if (NULL == pos) return false;
+
+        RTPUtils::setBE32(&(pos[4]), ssrcOfPacketSender);
+        RTPUtils::setBE32(&(pos[8]), ssrcOfMediaSource);
+        pos += headerSize;
+
+        for (size_t index = 0; index < count; ++index, pos += sizeof(DWORD))
+        {
+          RTPUtils::setBE16(&(pos[0]), nacks[index].pid());
+          RTPUtils::setBE16(&(pos[2]), nacks[index].blp());
+        }
+
+        nacks += count;
+        nackCount -= count;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writeTransportCC(
+                                            DWORD ssrcOfPacketSender,
+                                            DWORD ssrcOfMediaSource,
+                                            const TransportCC &transportCC
+                                            )
+    {
+      size_t chunkSize = encodeTransportCCChunks(&transportCC, NULL);
+      size_t deltaSize = getTransportCCRecvDeltaSize(&transportCC);
+      size_t contentSize = (sizeof(DWORD)*5) + chunkSize + deltaSize;
+      size_t totalSize = boundarySize(contentSize);
+
+      BYTE *pos = reserve(TransportCC::kFmt, RTCPPacket::TransportLayerFeedbackMessage::kPayloadType, totalSize);
+      if (NULL == pos) return false;
+
+      // NOTE: the transport-cc draft pads the feedback data itself with
+      //       zeros up to the 32-bit boundary (counted in the RTCP length)
+      //       so the RTCP P bit is never set here; the P bit is only legal
+      //       on the last report of a compound packet (RFC 3550 6.4.1) and
+      //       this report may be followed by others.
+      memset(&(pos[contentSize]), 0, totalSize - contentSize);
+
+      RTPUtils::setBE32(&(pos[4]), ssrcOfPacketSender);
+      RTPUtils::setBE32(&(pos[8]), ssrcOfMediaSource);
+      RTPUtils::setBE16(&(pos[12]), transportCC.baseSequenceNumber());
+      RTPUtils::setBE16(&(pos[14]), static_cast<WORD>(transportCC.packetStatusCount()));
+      RTPUtils::setBE32(&(pos[16]), RTCP_PACK_BITS(static_cast<DWORD>(transportCC.referenceTime()), 0xFFFFFF, 8) | static_cast<DWORD>(transportCC.fbPktCount()));
+
+      pos += (sizeof(DWORD)*5);
+      pos += encodeTransportCCChunks(&transportCC, pos);
+
+      encodeTransportCCRecvDeltas(&transportCC, pos);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writePLI(
+                                    DWORD ssrcOfPacketSender,
+                                    DWORD ssrcOfMediaSource
+                                    )
+    {
+      BYTE *pos = reserve(RTCPPacket::PayloadSpecificFeedbackMessage::PLI::kFmt, RTCPPacket::PayloadSpecificFeedbackMessage::kPayloadType, sizeof(DWORD)*3);
+      if (NULL == pos) return false;
+
+      RTPUtils::setBE32(&(pos[4]), ssrcOfPacketSender);
+      RTPUtils::setBE32(&(pos[8]), ssrcOfMediaSource);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writeFIR(
+                                    DWORD ssrcOfPacketSender,
+                                    const FIR *firs,
+                                    size_t firCount
+                                    )
+    {
+      const size_t headerSize = sizeof(DWORD)*3;
+      const size_t entrySize = sizeof(DWORD)*2;
+
+      while (0 != firCount)
+      {
+        if (remaining() < headerSize + entrySize) {
+          continueCompound(RTCPPacket::PayloadSpecificFeedbackMessage::kPayloadType);
+          if (remaining() < headerSize + entrySize) {
+            ZS_LOG_WARNING(Debug, log("buffer cannot hold a FIR") + ZS_PARAM("buffer size", mBufferSize))
+            return false;
+          }
+        }
+
+        size_t count = (remaining() - headerSize) / entrySize;
+        if (count > firCount) count = firCount;
+
+        BYTE *pos = reserve(RTCPPacket::PayloadSpecificFeedbackMessage::FIR::kFmt, RTCPPacket::PayloadSpecificFeedbackMessage::kPayloadType, headerSize + (entrySize*count));
+        if (NULL == pos) return false;
+
+        RTPUtils::setBE32(&(pos[4]), ssrcOfPacketSender);
+        RTPUtils::setBE32(&(pos[8]), 0);  // SSRC of media source is always zero for FIR
+        pos += headerSize;
+
+        for (size_t index = 0; index < count; ++index, pos += entrySize)
+        {
+          RTPUtils::setBE32(&(pos[0]), firs[index].ssrc());
+          pos[4] = firs[index].seqNr();
+          pos[5] = 0;
+          pos[6] = 0;
+          pos[7] = 0;
+        }
+
+        firs += count;
+        firCount -= count;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writeREMB(
+                                     DWORD ssrcOfPacketSender,
+                                     BYTE brExp,
+                                     DWORD brMantissa,
+                                     const DWORD *ssrcs,
+                                     size_t ssrcCount
+                                     )
+    {
+      if ((ssrcCount > 0xFF) ||
+          (brExp > 0x3F) ||
+          (brMantissa > 0x3FFFF)) {
+        ZS_LOG_WARNING(Debug, log("REMB cannot be encoded") + ZS_PARAM("ssrcs", ssrcCount) + ZS_PARAM("br exp", brExp) + ZS_PARAM("br mantissa", brMantissa))
+        return false;
+      }
+
+      BYTE *pos = reserve(RTCPPacket::PayloadSpecificFeedbackMessage::REMB::kFmt, RTCPPacket::PayloadSpecificFeedbackMessage::kPayloadType, (sizeof(DWORD)*5) + (sizeof(DWORD)*ssrcCount));
+      if (NULL == pos) return false;
+
+      RTPUtils::setBE32(&(pos[4]), ssrcOfPacketSender);
+      RTPUtils::setBE32(&(pos[8]), 0);  // SSRC of media source is always zero for REMB
+
+      memcpy(&(pos[12]), "REMB", sizeof(DWORD));
+
+      DWORD merged = RTCP_PACK_BITS(static_cast<DWORD>(brExp), 0x3F, 18) |
+                     RTCP_PACK_BITS(brMantissa, 0x3FFFF, 0);
+      RTPUtils::setBE32(&(pos[16]), merged);
+      pos[16] = static_cast<BYTE>(ssrcCount);
+
+      pos += sizeof(DWORD)*5;
+      for (size_t index = 0; index < ssrcCount; ++index, pos += sizeof(DWORD))
+      {
+        RTPUtils::setBE32(pos, ssrcs[index]);
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writeXRReceiverReferenceTime(
+                                                        DWORD ssrc,
+                                                        DWORD ntpTimestampMS,
+                                                        DWORD ntpTimestampLS
+                                                        )
+    {
+      BYTE *pos = reserve(0, RTCPPacket::XR::kPayloadType, sizeof(DWORD)*5);
+      if (NULL == pos) return false;
+
+      RTPUtils::setBE32(&(pos[4]), ssrc);
+
+      pos[8] = RTCPPacket::XR::ReceiverReferenceTimeReportBlock::kBlockType;
+      pos[9] = 0;
+      RTPUtils::setBE16(&(pos[10]), 2);
+      RTPUtils::setBE32(&(pos[12]), ntpTimestampMS);
+      RTPUtils::setBE32(&(pos[16]), ntpTimestampLS);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTCPPacketWriter::writeXRDLRR(
+                                       DWORD ssrc,
+                                       const DLRRSubBlock *subBlocks,
+                                       size_t subBlockCount
+                                       )
+    {
+      const size_t subBlockSize = sizeof(DWORD)*3;
+
+      if ((subBlockSize * subBlockCount) / sizeof(DWORD) > 0xFFFF) {
+        ZS_LOG_WARNING(Debug, log("DLRR cannot be encoded") + ZS_PARAM("sub blocks", subBlockCount))
+        return false;
+      }
+
+      BYTE *pos = reserve(0, RTCPPacket::XR::kPayloadType, (sizeof(DWORD)*3) + (subBlockSize*subBlockCount));
+      if (NULL == pos) return false;
+
+      RTPUtils::setBE32(&(pos[4]), ssrc);
+
+      pos[8] = RTCPPacket::XR::DLRRReportBlock::kBlockType;
+      pos[9] = 0;
+      RTPUtils::setBE16(&(pos[10]), static_cast<WORD>((subBlockSize * subBlockCount) / sizeof(DWORD)));
+
+      pos += sizeof(DWORD)*3;
+      for (size_t index = 0; index < subBlockCount; ++index, pos += subBlockSize)
+      {
+        RTPUtils::setBE32(&(pos[0]), subBlocks[index].ssrc());
+        RTPUtils::setBE32(&(pos[4]), subBlocks[index].lrr());
+        RTPUtils::setBE32(&(pos[8]), subBlocks[index].dlrr());
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTCPPacketWriter::flush()
+    {
+      if (0 == mSize) return;
+
+      ZS_LOG_INSANE(log("flushing compound packet") + ZS_PARAM("size", mSize))
+
+      ++mTotalPacketsFlushed;
+
+      // NOTE: size is reset after the delegate returns since the delegate is
+      //       handed the writer's buffer directly.
+      mDelegate->onRTCPPacketWriterPacket(mBuffer, mSize);
+      mSize = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTCPPacketWriter::toDebug() const
+    {
+      ElementPtr objectEl = Element::create("ortc::RTCPPacketWriter");
+
+      UseServicesHelper::debugAppend(objectEl, "buffer size", mBufferSize);
+      UseServicesHelper::debugAppend(objectEl, "size", mSize);
+      UseServicesHelper::debugAppend(objectEl, "total packets flushed", mTotalPacketsFlushed);
+      UseServicesHelper::debugAppend(objectEl, "total reports written", mTotalReportsWritten);
+
+      return objectEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPPacketWriter => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params RTCPPacketWriter::slog(const char *message)
+    {
+      return Log::Params(message, "ortc::RTCPPacketWriter");
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params RTCPPacketWriter::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::RTCPPacketWriter");
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params RTCPPacketWriter::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    BYTE *RTCPPacketWriter::reserve(
+                                    BYTE reportSpecific,
+                                    BYTE pt,
+                                    size_t sizeInBytes
+                                    )
+    {
+      ASSERT(0 == (sizeInBytes % sizeof(DWORD)))
+      ASSERT(sizeInBytes >= sizeof(DWORD))
+      ASSERT(reportSpecific <= kMaxReportCount)
+
+      if (sizeInBytes > mBufferSize) {
+        ZS_LOG_WARNING(Debug, log("report is larger than the writer's buffer") + ZS_PARAM("pt", pt) + ZS_PARAM("size", sizeInBytes) + ZS_PARAM("buffer size", mBufferSize))
+        return NULL;
+      }
+
+      if (sizeInBytes > remaining()) {
+        continueCompound(pt);
+        if (sizeInBytes > remaining()) {
+          ZS_LOG_WARNING(Debug, log("report does not fit after the leading receiver report") + ZS_PARAM("pt", pt) + ZS_PARAM("size", sizeInBytes) + ZS_PARAM("buffer size", mBufferSize))
+          return NULL;
+        }
+      }
+
+      BYTE *pos = &(mBuffer[mSize]);
+
+      // padding, reserved fields and SDES null items live in the last word
+      memset(&(pos[sizeInBytes - sizeof(DWORD)]), 0, sizeof(DWORD));
+
+      pos[0] = RTCP_PACK_BITS(kRtpVersion, 0x3, 6) |
+               RTCP_PACK_BITS(reportSpecific, 0x1F, 0);
+      pos[1] = pt;
+      RTPUtils::setBE16(&(pos[2]), static_cast<WORD>((sizeInBytes/sizeof(DWORD))-1));
+
+      mSize += sizeInBytes;
+      ++mTotalReportsWritten;
+
+      return pos;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTCPPacketWriter::continueCompound(BYTE nextPT)
+    {
+      // NOTE: RFC3550 section 6.1 requires every compound packet to begin
+      //       with a SR or RR; when the compound packet being continued
+      //       began with one the continuation starts with an empty RR from
+      //       the same sender (unless the next report is a SR / RR itself)
+      bool leadingReport = false;
+      DWORD ssrc = 0;
+
+      if (mSize >= (sizeof(DWORD)*2)) {
+        BYTE pt = mBuffer[1];
+        if ((RTCPPacket::SenderReport::kPayloadType == pt) ||
+            (RTCPPacket::ReceiverReport::kPayloadType == pt)) {
+          leadingReport = true;
+          ssrc = RTPUtils::getBE32(&(mBuffer[4]));
+        }
+      }
+
+      flush();
+
+      if (!leadingReport) return;
+      if ((RTCPPacket::SenderReport::kPayloadType == nextPT) ||
+          (RTCPPacket::ReceiverReport::kPayloadType == nextPT)) return;
+
+      BYTE *pos = mBuffer;
+
+      pos[0] = RTCP_PACK_BITS(kRtpVersion, 0x3, 6);
+      pos[1] = RTCPPacket::ReceiverReport::kPayloadType;
+      RTPUtils::setBE16(&(pos[2]), 1);
+      RTPUtils::setBE32(&(pos[4]), ssrc);
+
+      mSize = sizeof(DWORD)*2;
+      ++mTotalReportsWritten;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTCPPacketWriter::writeReportBlocks(
+                                             BYTE *pos,
+                                             const ReportBlock *reportBlocks,
+                                             size_t reportBlockCount
+                                             )
+    {
+      for (size_t index = 0; index < reportBlockCount; ++index, pos += kReportBlockSize)
+      {
+        const ReportBlock &block = reportBlocks[index];
+
+        RTPUtils::setBE32(&(pos[0]), block.ssrc());
+        RTPUtils::setBE32(&(pos[4]), block.cumulativeNumberOfPacketsLost());
+        pos[4] = block.fractionLost();
+        RTPUtils::setBE32(&(pos[8]), block.extendedHighestSequenceNumberReceived());
+        RTPUtils::setBE32(&(pos[12]), block.interarrivalJitter());
+        RTPUtils::setBE32(&(pos[16]), block.lsr());
+        RTPUtils::setBE32(&(pos[20]), block.dlsr());
+      }
+    }
+
   }
 
 }
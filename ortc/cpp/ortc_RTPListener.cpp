@@ -37,6 +37,7 @@
 #include <ortc/internal/ortc_RTCPPacket.h>
 #include <ortc/internal/ortc_SRTPSDESTransport.h>
 #include <ortc/internal/ortc_RTPTypes.h>
+#include <ortc/internal/ortc_RTPUtils.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_Tracing.h>
 #include <ortc/internal/platform.h>
@@ -113,6 +114,7 @@ namespace ortc
     {
       UseSettings::setUInt(ORTC_SETTING_RTP_LISTENER_MAX_RTP_PACKETS_IN_BUFFER, 100);
       UseSettings::setUInt(ORTC_SETTING_RTP_LISTENER_MAX_AGE_RTP_PACKETS_IN_SECONDS, 30);
+      UseSettings::setUInt(ORTC_SETTING_RTP_LISTENER_MAX_RTP_PACKETS_PER_SSRC_IN_BUFFER, 50);
 
       UseSettings::setUInt(ORTC_SETTING_RTP_LISTENER_MAX_RTCP_PACKETS_IN_BUFFER, 100);
       UseSettings::setUInt(ORTC_SETTING_RTP_LISTENER_MAX_AGE_RTCP_PACKETS_IN_SECONDS, 30);
@@ -121,6 +123,9 @@ namespace ortc
       UseSettings::setUInt(ORTC_SETTING_RTP_LISTENER_UNHANDLED_EVENTS_TIMEOUT_IN_SECONDS, 60);
 
       UseSettings::setUInt(ORTC_SETTING_RTP_LISTENER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS, 5*1000);
+
+      UseSettings::setUInt(ORTC_SETTING_RTP_LISTENER_TRANSPORT_CC_FEEDBACK_INTERVAL_IN_MILLISECONDS, 100);
+      UseSettings::setUInt(ORTC_SETTING_RTP_LISTENER_TRANSPORT_CC_MAX_RECORDED_PACKETS, 10000);
     }
 
     //-------------------------------------------------------------------------
@@ -321,13 +326,84 @@ namespace ortc
       ElementPtr resultEl = Element::create("ortc::RTPListener::SSRCInfo");
 
       UseServicesHelper::debugAppend(resultEl, "ssrc", mSSRC);
-      UseServicesHelper::debugAppend(resultEl, "last usage", mLastUsage);
+      UseServicesHelper::debugAppend(resultEl, "last usage", mLastUsage.load());
       UseServicesHelper::debugAppend(resultEl, "mux id", mMuxID);
       UseServicesHelper::debugAppend(resultEl, mReceiverInfo ? mReceiverInfo->toDebug() : ElementPtr());
 
       return resultEl;
     }
-    
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPListener::SSRCRoutes
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPListener::SSRCRoutes::SSRCRoutes(size_t totalRoutes)
+    {
+      size_t capacity = 8;
+      while (capacity < (totalRoutes * 2)) capacity <<= 1;
+      mRoutes.resize(capacity);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::SSRCRoutes::insert(
+                                         SSRCInfoPtr ssrcInfo,
+                                         bool active
+                                         )
+    {
+      ASSERT((bool)ssrcInfo)
+      ASSERT((mSize + 1) * 2 <= mRoutes.size())
+
+      size_t mask = mRoutes.size() - 1;
+      size_t index = hash(ssrcInfo->mSSRC) & mask;
+
+      while (mRoutes[index].mInUse) {
+        if (mRoutes[index].mSSRC == ssrcInfo->mSSRC) break;
+        index = (index + 1) & mask;
+      }
+
+      Route &route = mRoutes[index];
+      if (!route.mInUse) ++mSize;
+
+      route.mInUse = true;
+      route.mActive = active;
+      route.mSSRC = ssrcInfo->mSSRC;
+      route.mSSRCInfo = ssrcInfo;
+      route.mReceiverInfo = ssrcInfo->mReceiverInfo;
+    }
+
+    //-------------------------------------------------------------------------
+    const RTPListener::SSRCRoutes::Route *RTPListener::SSRCRoutes::find(SSRCType ssrc) const
+    {
+      size_t mask = mRoutes.size() - 1;
+      size_t index = hash(ssrc) & mask;
+
+      for (size_t probe = 0; probe < mRoutes.size(); ++probe, index = (index + 1) & mask) {
+        const Route &route = mRoutes[index];
+        if (!route.mInUse) return NULL;
+        if (route.mSSRC == ssrc) return &route;
+      }
+      return NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    size_t RTPListener::SSRCRoutes::hash(SSRCType ssrc)
+    {
+      // NOTE: SSRCs are random but may be chosen sequentially by some
+      //       implementations thus mix the bits before masking
+      ULONGLONG value = static_cast<ULONGLONG>(ssrc);
+      value ^= (value >> 16);
+      value *= 0x7FEB352DULL;
+      value ^= (value >> 15);
+      value *= 0x846CA68BULL;
+      value ^= (value >> 16);
+      return static_cast<size_t>(value);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -365,6 +441,148 @@ namespace ortc
       return resultEl;
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPListener::TransportCCRecorder
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPListener::TransportCCRecorder::record(
+                                                  WORD sequenceNumber,
+                                                  SSRCType ssrc,
+                                                  const Time &arrival
+                                                  )
+    {
+      LONGLONG unwrapped = static_cast<LONGLONG>(sequenceNumber);
+
+      if (mHasLastSequenceNumber) {
+        WORD lastSequenceNumber = static_cast<WORD>(mLastSequenceNumber & 0xFFFF);
+        SHORT diff = static_cast<SHORT>(static_cast<WORD>(sequenceNumber - lastSequenceNumber));
+        unwrapped = mLastSequenceNumber + static_cast<LONGLONG>(diff);
+      }
+
+      if ((!mHasLastSequenceNumber) ||
+          (unwrapped > mLastSequenceNumber)) {
+        mHasLastSequenceNumber = true;
+        mLastSequenceNumber = unwrapped;
+      }
+
+      mMediaSSRC = ssrc;
+
+      if (mArrivals.size() >= mMaxArrivals) {
+        ++mTotalDropped;
+        return;
+      }
+
+      Arrival info;
+      info.mSequenceNumber = unwrapped;
+      info.mTime = arrival;
+      mArrivals.push_back(info);
+
+      ++mTotalRecorded;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPListener::TransportCCRecorder::fillFeedback(TransportCC &outTransportCC)
+    {
+      typedef TransportCC::PacketStatusSymbols PacketStatusSymbols;
+
+      if (mArrivals.size() < 1) return false;
+
+      // NOTE: packets may arrive out of order (or be duplicated) but
+      //       feedback must be given in sequence number order.
+      std::stable_sort(mArrivals.begin(), mArrivals.end());
+
+      const LONGLONG baseSequenceNumber = mArrivals.front().mSequenceNumber;
+
+      size_t statusCount = SafeInt<size_t>(mArrivals.back().mSequenceNumber - baseSequenceNumber) + 1;
+      if (statusCount > kMaxPacketStatusesPerFeedback) statusCount = kMaxPacketStatusesPerFeedback;
+
+      mPacketStatuses.clear();
+      mRecvDeltas.clear();
+      mPacketStatuses.resize(statusCount, TransportCC::PacketStatusSymbol_NotReceived);
+      mRecvDeltas.reserve(statusCount);
+
+      const LONGLONG referenceResolution = static_cast<LONGLONG>(TransportCC::kReferenceTimeResolutionInMilliseconds) * 1000;
+      const LONGLONG deltaResolution = static_cast<LONGLONG>(TransportCC::kDeltaResolutionInMicroseconds);
+
+      LONGLONG referenceTime = zsLib::timeSinceEpoch<Microseconds>(mArrivals.front().mTime).count() / referenceResolution;
+      LONGLONG previousTime = referenceTime * referenceResolution;
+
+      size_t consumed = 0;
+      LONGLONG lastSequenceNumber = baseSequenceNumber - 1;
+
+      for (auto iter = mArrivals.begin(); iter != mArrivals.end(); ++iter, ++consumed) {
+        auto &arrival = (*iter);
+
+        size_t index = SafeInt<size_t>(arrival.mSequenceNumber - baseSequenceNumber);
+        if (index >= statusCount) break;
+
+        if (arrival.mSequenceNumber == lastSequenceNumber) continue;  // duplicate
+        lastSequenceNumber = arrival.mSequenceNumber;
+
+        LONGLONG delta = (zsLib::timeSinceEpoch<Microseconds>(arrival.mTime).count() - previousTime) / deltaResolution;
+
+        PacketStatusSymbols symbol = TransportCC::PacketStatusSymbol_ReceivedLargeOrNegativeDelta;
+        if ((delta >= 0) &&
+            (delta <= 0xFF)) {
+          symbol = TransportCC::PacketStatusSymbol_ReceivedSmallDelta;
+        } else if ((delta < -0x8000) ||
+                   (delta > 0x7FFF)) {
+          // NOTE: not representable; report as lost rather than lie
+          continue;
+        }
+
+        mPacketStatuses[index] = static_cast<BYTE>(symbol);
+        mRecvDeltas.push_back(static_cast<LONG>(delta));
+        previousTime += (delta * deltaResolution);
+      }
+
+      mArrivals.erase(mArrivals.begin(), mArrivals.begin() + consumed);
+
+      outTransportCC.mBaseSequenceNumber = static_cast<WORD>(baseSequenceNumber & 0xFFFF);
+      outTransportCC.mPacketStatusCount = static_cast<WORD>(statusCount);
+      outTransportCC.mReferenceTime = static_cast<LONG>(referenceTime & 0x7FFFFF);
+      outTransportCC.mFBPktCount = mFeedbackPacketCount;
+      outTransportCC.mPacketStatuses = &(mPacketStatuses[0]);
+      outTransportCC.mRecvDeltaCount = mRecvDeltas.size();
+      outTransportCC.mRecvDeltas = (mRecvDeltas.size() > 0 ? &(mRecvDeltas[0]) : NULL);
+
+      ++mFeedbackPacketCount;
+      ++mTotalFeedbackPackets;
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::TransportCCRecorder::reset()
+    {
+      mArrivals.clear();
+      mPacketStatuses.clear();
+      mRecvDeltas.clear();
+      mHasLastSequenceNumber = false;
+      mLastSequenceNumber = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPListener::TransportCCRecorder::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPListener::TransportCCRecorder");
+
+      UseServicesHelper::debugAppend(resultEl, "max arrivals", mMaxArrivals);
+      UseServicesHelper::debugAppend(resultEl, "arrivals", mArrivals.size());
+      UseServicesHelper::debugAppend(resultEl, "last sequence number", mHasLastSequenceNumber ? string(mLastSequenceNumber) : String());
+      UseServicesHelper::debugAppend(resultEl, "media ssrc", mMediaSSRC);
+      UseServicesHelper::debugAppend(resultEl, "feedback packet count", mFeedbackPacketCount);
+      UseServicesHelper::debugAppend(resultEl, "total recorded", mTotalRecorded);
+      UseServicesHelper::debugAppend(resultEl, "total dropped", mTotalDropped);
+      UseServicesHelper::debugAppend(resultEl, "total feedback packets", mTotalFeedbackPackets);
+
+      return resultEl;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -396,6 +614,7 @@ namespace ortc
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mRTPTransport(transport),
       mMaxBufferedRTPPackets(SafeInt<decltype(mMaxBufferedRTPPackets)>(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_MAX_RTP_PACKETS_IN_BUFFER))),
+      mMaxBufferedRTPPacketsPerSSRC(SafeInt<decltype(mMaxBufferedRTPPacketsPerSSRC)>(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_MAX_RTP_PACKETS_PER_SSRC_IN_BUFFER))),
       mMaxRTPPacketAge(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_MAX_AGE_RTP_PACKETS_IN_SECONDS)),
       mMaxBufferedRTCPPackets(SafeInt<decltype(mMaxBufferedRTCPPackets)>(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_MAX_RTCP_PACKETS_IN_BUFFER))),
       mMaxRTCPPacketAge(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_MAX_AGE_RTCP_PACKETS_IN_SECONDS)),
@@ -403,8 +622,13 @@ namespace ortc
       mSenders(make_shared<SenderObjectMap>()),
       mAmbigousPayloadMappingMinDifference(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS)),
       mSSRCTableExpires(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_SSRC_TIMEOUT_IN_SECONDS)),
-      mUnhanldedEventsExpires(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_UNHANDLED_EVENTS_TIMEOUT_IN_SECONDS))
+      mUnhanldedEventsExpires(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_UNHANDLED_EVENTS_TIMEOUT_IN_SECONDS)),
+      mTransportCCFeedbackInterval(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_TRANSPORT_CC_FEEDBACK_INTERVAL_IN_MILLISECONDS)),
+      mTransportCCSenderSSRC(SafeInt<SSRCType>(UseServicesHelper::random(1, 0xFFFFFFFF)))
     {
+      mBufferedRTPPackets.setLimits(mMaxBufferedRTPPackets, mMaxBufferedRTPPacketsPerSSRC, mMaxRTPPacketAge);
+      mTransportCCRecorder.mMaxArrivals = SafeInt<decltype(mTransportCCRecorder.mMaxArrivals)>(UseSettings::getUInt(ORTC_SETTING_RTP_LISTENER_TRANSPORT_CC_MAX_RECORDED_PACKETS));
+
       EventWriteOrtcRtpListenerCreate(
                                       __func__,
                                       mID,
@@ -631,6 +855,24 @@ namespace ortc
                                       size_t bufferLengthInBytes
                                       )
     {
+      return handleRTPPacket(viaComponent, packetType, UseServicesHelper::convertToBuffer(buffer, bufferLengthInBytes));
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPListener::handleRTPPacket(
+                                      IICETypes::Components viaComponent,
+                                      IICETypes::Components packetType,
+                                      SecureByteBlockPtr packetBuffer
+                                      )
+    {
+      if (!packetBuffer) {
+        ZS_LOG_WARNING(Trace, log("no packet buffer received (thus dropping)"))
+        return false;
+      }
+
+      const BYTE *buffer = packetBuffer->BytePtr();
+      size_t bufferLengthInBytes = packetBuffer->SizeInBytes();
+
       EventWriteOrtcRtpListenerReceivedIncomingPacket(__func__, mID, zsLib::to_underlying(viaComponent), zsLib::to_underlying(packetType), SafeInt<unsigned int>(bufferLengthInBytes), buffer);
 
       bool result = false;
@@ -643,20 +885,30 @@ namespace ortc
       RTPPacketPtr rtpPacket;
       RTCPPacketPtr rtcpPacket;
 
-      // parse packet outside of a lock
+      // NOTE: RTP packets are demuxed using a non-owning view over the
+      //       buffer; an RTPPacket is only materialized (taking ownership of
+      //       the buffer) once the packet is buffered or delivered.
+      RTPPacketView rtpView(IICETypes::Component_RTCP != packetType ? buffer : NULL, bufferLengthInBytes);
+
+      // parse packet outside of a lock (packets take ownership of the buffer)
       if (IICETypes::Component_RTCP == packetType) {
-        rtcpPacket = RTCPPacket::create(buffer, bufferLengthInBytes);
+        // NOTE: the listener and receivers only inspect SR/RR/SDES/BYE (the
+        //       media engine consumes the raw buffer) thus skip decoding
+        //       other reports.
+        rtcpPacket = RTCPPacket::create(packetBuffer, RTCPPacket::ParseMode_Fast);
         if (!rtcpPacket) {
           ZS_LOG_WARNING(Trace, log("invalid rtcp packet received (thus dropping)"))
           return false;
         }
       } else {
-        rtpPacket = RTPPacket::create(buffer, bufferLengthInBytes);
-
-        if (!rtpPacket) {
+        if (!rtpView.isValid()) {
           ZS_LOG_WARNING(Trace, log("invalid RTP packet received (thus dropping)"))
           return false;
         }
+
+        // NOTE: packets for SSRCs already latched to a receiver are routed
+        //       using the published snapshot (without the listener lock)
+        if (findRoute(rtpView, receiverInfo)) goto process_rtp;
       }
 
       {
@@ -670,6 +922,11 @@ namespace ortc
         if (IICETypes::Component_RTCP == packetType) {
           expireRTCPPackets();
 
+          // NOTE: target before processing BYEs (which purge SSRC mappings)
+          receivers = mReceivers;
+          senders = mSenders;
+          targetRTCPDelivery(*rtcpPacket, receivers, senders);
+
           processByes(*rtcpPacket);
           processSDESMid(*rtcpPacket);
           processSenderReports(*rtcpPacket);
@@ -677,14 +934,15 @@ namespace ortc
           EventWriteOrtcRtpListenerBufferIncomingPacket(__func__, mID, zsLib::to_underlying(viaComponent), zsLib::to_underlying(packetType), SafeInt<unsigned int>(bufferLengthInBytes), buffer);
 
           mBufferedRTCPPackets.push_back(TimeRTCPPacketPair(zsLib::now(), rtcpPacket));
-
-          receivers = mReceivers;
-          senders = mSenders;
           goto process_rtcp;
         }
 
+        if (mTransportCCReceivers.size() > 0) {
+          recordTransportArrival(mHeaderExtensionLookup, rtpView);
+        }
+
         String muxID;
-        if (findMapping(*rtpPacket, receiverInfo, muxID)) goto process_rtp;
+        if (findMapping(rtpView, receiverInfo, muxID)) goto process_rtp;
 
         if (isShuttingDown()) {
           ZS_LOG_WARNING(Debug, log("ignoring unhandled packet (during shutdown process)"))
@@ -699,12 +957,19 @@ namespace ortc
 
         EventWriteOrtcRtpListenerBufferIncomingPacket(__func__, mID, zsLib::to_underlying(viaComponent), zsLib::to_underlying(packetType), SafeInt<unsigned int>(bufferLengthInBytes), buffer);
 
+        rtpPacket = RTPPacket::create(packetBuffer);
+        if (!rtpPacket) {
+          ZS_LOG_WARNING(Trace, log("invalid RTP packet received (thus dropping)"))
+          return false;
+        }
+
         // provide some modest buffering
-        mBufferedRTPPackets.push_back(TimeRTPPacketPair(tick, rtpPacket));
+        RTPPacketPtr overwritten = mBufferedRTPPackets.push(tick, rtpPacket);
+        if (overwritten) disposeBufferedRTPPacket(overwritten, "overwriting buffered rtp packet");
 
-        String rid = extractRID(*rtpPacket);
+        String rid = extractRID(rtpView);
 
-        processUnhandled(muxID, rid, rtpPacket->ssrc(), rtpPacket->pt(), tick);
+        processUnhandled(muxID, rid, rtpView.ssrc(), rtpView.pt(), tick);
         return true;
       }
 
@@ -717,6 +982,12 @@ namespace ortc
           return false;
         }
 
+        rtpPacket = RTPPacket::create(packetBuffer);
+        if (!rtpPacket) {
+          ZS_LOG_WARNING(Trace, log("invalid RTP packet received (thus dropping)"))
+          return false;
+        }
+
         ZS_LOG_TRACE(log("forwarding RTP packet to receiver") + ZS_PARAM("receiver id", receiver->getID()) + ZS_PARAM("ssrc", rtpPacket->ssrc()))
         EventWriteOrtcRtpListenerForwardIncomingPacket(__func__, mID, receiver->getID(), zsLib::to_underlying(viaComponent), zsLib::to_underlying(packetType), SafeInt<unsigned int>(rtpPacket->buffer()->SizeInBytes()), rtpPacket->buffer()->BytePtr());
         return receiver->handlePacket(viaComponent, rtpPacket);
@@ -926,6 +1197,7 @@ namespace ortc
           receivers->erase(found);
 
           mReceivers = receivers;
+          rebuildReceiverIndexes();
         }
       }
 
@@ -945,10 +1217,12 @@ namespace ortc
 
         ZS_LOG_TRACE(log("removing SSRC mapping to receiver") + ZS_PARAM("ssrc", ssrc) + receiverInfo->toDebug())
 
-        EventWriteOrtcRtpListenerSsrcTableEntryRemoved(__func__, mID, ((bool)ssrcInfo->mReceiverInfo) ? ssrcInfo->mReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage).count(), ssrcInfo->mMuxID, "receiver removed");
+        EventWriteOrtcRtpListenerSsrcTableEntryRemoved(__func__, mID, ((bool)ssrcInfo->mReceiverInfo) ? ssrcInfo->mReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage.load()).count(), ssrcInfo->mMuxID, "receiver removed");
         mSSRCTable.erase(current);
       }
 
+      publishSSRCRoutes();
+
       // purge from mux id table
       for (auto iter_doNotUse = mMuxIDTable.begin(); iter_doNotUse != mMuxIDTable.end(); )
       {
@@ -1029,6 +1303,9 @@ namespace ortc
       (*senders)[inSender->getID()] = inSender;
       mSenders = senders;
 
+      mSenderParameters[inSender->getID()] = inParams;
+      rebuildSenderIndexes();
+
       expireRTCPPackets();
 
       for (auto iter = mBufferedRTCPPackets.begin(); iter != mBufferedRTCPPackets.end(); ++iter)
@@ -1071,7 +1348,9 @@ namespace ortc
           mSenders = senders;
         }
       }
-      
+
+      mSenderParameters.erase(senderID);
+      rebuildSenderIndexes();
     }
 
     //-------------------------------------------------------------------------
@@ -1106,6 +1385,21 @@ namespace ortc
       EventWriteOrtcRtpListenerInternalTimerEventFired(__func__, mID, timer->getID(), NULL);
       ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()))
 
+      bool isTransportCCTimer = false;
+
+      {
+        AutoLock lock(mTransportCCLock);
+        isTransportCCTimer = (timer == mTransportCCTimer);
+      }
+
+      if (isTransportCCTimer) {
+        EventWriteOrtcRtpListenerInternalTimerEventFired(__func__, mID, timer->getID(), "transport-cc timer");
+
+        // NOTE: feedback is sent outside the lock
+        sendTransportCCFeedback();
+        return;
+      }
+
       AutoRecursiveLock lock(*this);
 
       if (timer == mSSRCTableTimer) {
@@ -1127,15 +1421,16 @@ namespace ortc
 
           auto &ssrcInfo = (*current).second;
 
-          const Time &lastReceived = ssrcInfo->mLastUsage;
+          Time lastReceived = ssrcInfo->mLastUsage.load();
 
           if (!(adjustedTick > lastReceived)) continue;
 
           ZS_LOG_TRACE(log("expiring SSRC mapping") + ssrcInfo->toDebug() + ZS_PARAM("adjusted tick", adjustedTick))
-          EventWriteOrtcRtpListenerSsrcTableEntryRemoved(__func__, mID, ((bool)ssrcInfo->mReceiverInfo) ? ssrcInfo->mReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage).count(), ssrcInfo->mMuxID, "expired");
+          EventWriteOrtcRtpListenerSsrcTableEntryRemoved(__func__, mID, ((bool)ssrcInfo->mReceiverInfo) ? ssrcInfo->mReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage.load()).count(), ssrcInfo->mMuxID, "expired");
           mSSRCTable.erase(current);
         }
 
+        publishSSRCRoutes();
         return;
       }
 
@@ -1240,6 +1535,23 @@ namespace ortc
       auto rtpTransport = mRTPTransport.lock();
       UseServicesHelper::debugAppend(resultEl, "rtp transport", rtpTransport ? rtpTransport->getID() : 0);
 
+      UseServicesHelper::debugAppend(resultEl, "buffered rtp packets", mBufferedRTPPackets.toDebug());
+
+      UseServicesHelper::debugAppend(resultEl, "transport-cc feedback interval", mTransportCCFeedbackInterval);
+      UseServicesHelper::debugAppend(resultEl, "transport-cc receivers", mTransportCCReceivers.size());
+      UseServicesHelper::debugAppend(resultEl, "transport-cc sender ssrc", mTransportCCSenderSSRC);
+
+      auto routes = std::atomic_load(&mSSRCRoutes);
+      UseServicesHelper::debugAppend(resultEl, "ssrc routes", routes ? routes->size() : 0);
+      UseServicesHelper::debugAppend(resultEl, "ssrc routes capacity", routes ? routes->capacity() : 0);
+      UseServicesHelper::debugAppend(resultEl, "rid index", mRIDIndex.size());
+
+      {
+        AutoLock lock(mTransportCCLock);
+        UseServicesHelper::debugAppend(resultEl, "transport-cc recorder", mTransportCCRecorder.toDebug());
+        UseServicesHelper::debugAppend(resultEl, "transport-cc timer", mTransportCCTimer ? mTransportCCTimer->getID() : 0);
+      }
+
       return resultEl;
     }
 
@@ -1309,24 +1621,47 @@ namespace ortc
       do
       {
         previousSize = mBufferedRTPPackets.size();
-        for (auto iter_doNotUse = mBufferedRTPPackets.begin(); iter_doNotUse != mBufferedRTPPackets.end();) {
-          auto current = iter_doNotUse;
-          ++iter_doNotUse;
 
-          RTPPacketPtr packet = (*current).second;
+        // NOTE: only the oldest packet of each SSRC is tested; once an SSRC
+        //       maps all of its packets are drained (in order) without
+        //       visiting packets belonging to other SSRCs
+        mBufferedRTPPackets.getSSRCs(mBufferedSSRCs);
 
-          ReceiverInfoPtr receiverInfo;
-          String muxID;
-          if (!findMapping(*packet, receiverInfo, muxID)) continue;
+        for (auto iterSSRC = mBufferedSSRCs.begin(); iterSSRC != mBufferedSSRCs.end(); ++iterSSRC) {
+          RTPPacketPtr firstPacket = mBufferedRTPPackets.front(*iterSSRC);
+          if (!firstPacket) continue;
 
-          auto receiver = receiverInfo->mReceiver.lock();
-
-          if (receiver) {
-            ZS_LOG_TRACE(log("will attempt to deliver buffered RTP packet") + ZS_PARAM("receiver", receiver->getID()) + ZS_PARAM("ssrc", packet->ssrc()))
-            IRTPListenerAsyncDelegateProxy::create(mThisWeak.lock())->onDeliverPacket(IICETypes::Component_RTP, receiver, packet);
+          {
+            ReceiverInfoPtr receiverInfo;
+            String muxID;
+            RTPPacketView view(*firstPacket);
+            if (!findMapping(view, receiverInfo, muxID)) continue;
           }
 
-          mBufferedRTPPackets.erase(current);
+          BufferedRTPPacketList packets;
+          mBufferedRTPPackets.drain(*iterSSRC, packets);
+
+          for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+            auto &buffered = (*iter);
+            RTPPacketPtr packet = buffered.mPacket;
+
+            ReceiverInfoPtr receiverInfo;
+            String muxID;
+            RTPPacketView view(*packet);
+            if (!findMapping(view, receiverInfo, muxID)) {
+              // NOTE: rare (e.g. a different mux id on the same SSRC)
+              RTPPacketPtr overwritten = mBufferedRTPPackets.restore(buffered);
+              if (overwritten) disposeBufferedRTPPacket(overwritten, "overwriting buffered rtp packet");
+              continue;
+            }
+
+            auto receiver = receiverInfo->mReceiver.lock();
+
+            if (receiver) {
+              ZS_LOG_TRACE(log("will attempt to deliver buffered RTP packet") + ZS_PARAM("receiver", receiver->getID()) + ZS_PARAM("ssrc", packet->ssrc()))
+              IRTPListenerAsyncDelegateProxy::create(mThisWeak.lock())->onDeliverPacket(IICETypes::Component_RTP, receiver, packet);
+            }
+          }
         }
 
       // NOTE: need to repetitively attempt to deliver packets as it's possible
@@ -1370,14 +1705,25 @@ namespace ortc
       mBufferedRTCPPackets.clear();
 
       mRegisteredExtensions.clear();
+      mHeaderExtensionLookup.clear();
 
       mReceivers = make_shared<ReceiverObjectMap>();
       mSenders = make_shared<SenderObjectMap>();
 
+      mEncodingSSRCIndex.clear();
+      mPayloadTypeIndex.clear();
+      mRIDIndex.clear();
+
+      mSenderParameters.clear();
+      mSenderSSRCIndex.clear();
+      mUnindexedSenders.clear();
+
       mSSRCTable.clear();
       mMuxIDTable.clear();
       mUnhandledEvents.clear();
 
+      std::atomic_store(&mSSRCRoutes, SSRCRoutesPtr());
+
       if (mSSRCTableTimer) {
         mSSRCTableTimer->cancel();
         mSSRCTableTimer.reset();
@@ -1388,6 +1734,16 @@ namespace ortc
         mUnhanldedEventsTimer.reset();
       }
 
+      {
+        AutoLock ccLock(mTransportCCLock);
+        if (mTransportCCTimer) {
+          mTransportCCTimer->cancel();
+          mTransportCCTimer.reset();
+        }
+        mTransportCCRecorder.reset();
+      }
+      mTransportCCReceivers.clear();
+
       // make sure to cleanup any final reference to self
       mGracefulShutdownReference.reset();
     }
@@ -1433,26 +1789,22 @@ namespace ortc
     {
       auto tick = zsLib::now();
 
-      while (mBufferedRTPPackets.size() > 0) {
-        auto &info = mBufferedRTPPackets.front();
-        auto &packetTime = info.first;
-        auto &packet = info.second;
-        (void)packet;
-
-        {
-          if (mBufferedRTPPackets.size() > mMaxBufferedRTPPackets) goto expire_packet;
-          if (packetTime + mMaxRTPPacketAge < tick) goto expire_packet;
-          break;
-        }
-
-      expire_packet:
-        {
-          EventWriteOrtcRtpListenerDisposeBufferedIncomingPacket(__func__, mID, zsLib::to_underlying(IICETypes::Component_RTP), SafeInt<unsigned int>(packet->buffer()->SizeInBytes()), packet->buffer()->BytePtr());
-          ZS_LOG_TRACE(log("expiring buffered rtp packet") + ZS_PARAM("tick", tick) + ZS_PARAM("packet time (s)", packetTime) + ZS_PARAM("total", mBufferedRTPPackets.size()))
-          mBufferedRTPPackets.pop_front();
-        }
+      TimeRTPPacketPair info;
+      while (mBufferedRTPPackets.popExpired(tick, info)) {
+        ZS_LOG_TRACE(log("buffered rtp packet expired") + ZS_PARAM("tick", tick) + ZS_PARAM("packet time (s)", info.first))
+        disposeBufferedRTPPacket(info.second, "expiring buffered rtp packet");
       }
     }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::disposeBufferedRTPPacket(
+                                               RTPPacketPtr packet,
+                                               const char *reason
+                                               )
+    {
+      EventWriteOrtcRtpListenerDisposeBufferedIncomingPacket(__func__, mID, zsLib::to_underlying(IICETypes::Component_RTP), SafeInt<unsigned int>(packet->buffer()->SizeInBytes()), packet->buffer()->BytePtr());
+      ZS_LOG_TRACE(log(reason) + ZS_PARAM("ssrc", packet->ssrc()) + ZS_PARAM("sequence number", packet->sequenceNumber()) + ZS_PARAM("total", mBufferedRTPPackets.size()))
+    }
     
     //-------------------------------------------------------------------------
     void RTPListener::expireRTCPPackets()
@@ -1502,6 +1854,8 @@ namespace ortc
         extension.mReferences[objectID] = true;
         mRegisteredExtensions[localID] = extension;
 
+        rebuildHeaderExtensionLookup();
+
         EventWriteOrtcRtpListenerRegisterHeaderExtension(__func__, mID, objectID, IRTPTypes::toString(extension.mHeaderExtensionURI), extension.mLocalID, extension.mEncrypted, extension.mReferences.size());
 
         ZS_LOG_DEBUG(log("registered header extension") + ZS_PARAM("object id", objectID) + extension.toDebug())
@@ -1546,24 +1900,41 @@ namespace ortc
 
         mRegisteredExtensions.erase(current);
       }
+
+      rebuildHeaderExtensionLookup();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::rebuildHeaderExtensionLookup()
+    {
+      mHeaderExtensionLookup.clear();
+
+      for (auto iter = mRegisteredExtensions.begin(); iter != mRegisteredExtensions.end(); ++iter) {
+        auto &extension = (*iter).second;
+        mHeaderExtensionLookup.add(extension.mLocalID, extension.mHeaderExtensionURI);
+      }
+
+      publishSSRCRoutes();
     }
 
     //-------------------------------------------------------------------------
     bool RTPListener::findMapping(
-                                  const RTPPacket &rtpPacket,
+                                  const RTPPacketView &rtpPacket,
                                   ReceiverInfoPtr &outReceiverInfo,
                                   String &outMuxID
                                   )
     {
       outMuxID = extractMuxID(rtpPacket, outReceiverInfo);
 
-      EventWriteOrtcRtpListenerFindMapping(__func__, mID, outMuxID, SafeInt<unsigned int>(rtpPacket.buffer()->SizeInBytes()), rtpPacket.buffer()->BytePtr());
+      EventWriteOrtcRtpListenerFindMapping(__func__, mID, outMuxID, SafeInt<unsigned int>(rtpPacket.size()), rtpPacket.ptr());
 
       {
         if (outReceiverInfo) goto fill_mux_id;
 
         if (findMappingUsingMuxID(outMuxID, rtpPacket, outReceiverInfo)) return true;
 
+        if (findMappingUsingRID(outMuxID, rtpPacket, outReceiverInfo)) goto fill_mux_id;
+
         if (findMappingUsingSSRCInEncodingParams(outMuxID, rtpPacket, outReceiverInfo)) goto fill_mux_id;
 
         if (findMappingUsingPayloadType(outMuxID, rtpPacket, outReceiverInfo)) goto fill_mux_id;
@@ -1586,7 +1957,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPListener::findMappingUsingMuxID(
                                             const String &muxID,
-                                            const RTPPacket &rtpPacket,
+                                            const RTPPacketView &rtpPacket,
                                             ReceiverInfoPtr &outReceiverInfo
                                             )
     {
@@ -1606,18 +1977,63 @@ namespace ortc
       return true;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPListener::findMappingUsingRID(
+                                          const String &muxID,
+                                          const RTPPacketView &rtpPacket,
+                                          ReceiverInfoPtr &outReceiverInfo
+                                          )
+    {
+      if (mRIDIndex.size() < 1) return false;
+
+      RID rid = extractRID(rtpPacket);
+      if (!rid.hasData()) return false;
+
+      auto found = mRIDIndex.find(rid);
+      if (found == mRIDIndex.end()) return false;
+
+      auto &receivers = (*found).second;
+
+      for (auto iter = receivers.begin(); iter != receivers.end(); ++iter) {
+        const ReceiverInfoPtr &info = (*iter);
+
+        if ((info->mFilledParameters.mMuxID.hasData()) &&
+            (muxID.hasData())) {
+          // cannot consider any receiver which has a mux id but does not
+          // match this receiver's mux id
+          if (muxID != info->mFilledParameters.mMuxID) continue;
+        }
+
+        outReceiverInfo = info;
+
+        ZS_LOG_DEBUG(log("creating a new SSRC entry in SSRC table (based on rid mapping to existing receiver)") + ZS_PARAM("rid", rid) + outReceiverInfo->toDebug())
+
+        String inMuxID = muxID;
+        setSSRCUsage(rtpPacket.ssrc(), inMuxID, outReceiverInfo);
+        return true;
+      }
+
+      return false;
+    }
+
     //-------------------------------------------------------------------------
     bool RTPListener::findMappingUsingSSRCInEncodingParams(
                                                            const String &muxID,
-                                                           const RTPPacket &rtpPacket,
+                                                           const RTPPacketView &rtpPacket,
                                                            ReceiverInfoPtr &outReceiverInfo
                                                            )
     {
-      ReceiverObjectMapPtr receivers = mReceivers;
+      // check to see if this SSRC is inside any receiver's encoding
+      // parameters if this value was auto-filled in those encoding
+      // paramters or set by the application developer.
+      auto found = mEncodingSSRCIndex.find(rtpPacket.ssrc());
+      if (found == mEncodingSSRCIndex.end()) return false;
 
-      for (auto iter = receivers->begin(); iter != receivers->end(); ++iter)
+      auto &receivers = (*found).second;
+
+      for (auto iter = receivers.begin(); iter != receivers.end(); ++iter)
       {
-        ReceiverInfoPtr &info = (*iter).second;
+        const ReceiverInfoPtr &info = (*iter);
 
         if ((info->mFilledParameters.mMuxID.hasData()) &&
             (muxID.hasData())) {
@@ -1628,47 +2044,15 @@ namespace ortc
           }
         }
 
-        // first check to see if this SSRC is inside this receiver's
-        // encoding parameters if this value was auto-filled in those encoding
-        // paramters or set by the application developer.
-        {
-          auto iterParm = info->mFilledParameters.mEncodings.begin();
-
-          for (; iterParm != info->mFilledParameters.mEncodings.end(); ++iterParm)
-          {
-            EncodingParameters &encParams = (*iterParm);
-
-            if (encParams.mSSRC.hasValue()) {
-              if (rtpPacket.ssrc() == encParams.mSSRC.value()) goto map_ssrc;
-            }
-
-            if ((encParams.mRTX.hasValue()) &&
-                (encParams.mRTX.value().mSSRC.hasValue())) {
-              if (rtpPacket.ssrc() == encParams.mRTX.value().mSSRC.value()) goto map_ssrc;
-            }
-
-            if ((encParams.mFEC.hasValue()) &&
-                (encParams.mFEC.value().mSSRC.hasValue())) {
-              if (rtpPacket.ssrc() == encParams.mFEC.value().mSSRC.value()) goto map_ssrc;
-            }
-          }
-
-          // no SSRC match was found
-          continue;
-        }
-
-      map_ssrc:
-        {
-          outReceiverInfo = info;
+        outReceiverInfo = info;
 
-          ZS_LOG_DEBUG(log("creating a new SSRC entry in SSRC table (based on associated SSRC being found)") + outReceiverInfo->toDebug())
+        ZS_LOG_DEBUG(log("creating a new SSRC entry in SSRC table (based on associated SSRC being found)") + outReceiverInfo->toDebug())
 
-          // the associated SSRC was found in table thus must route to same receiver
-          String inMuxID = muxID;
-          setSSRCUsage(rtpPacket.ssrc(), inMuxID, outReceiverInfo);
-          EventWriteOrtcRtpListenerFoundMappingBySsrc(__func__, mID, ((bool)outReceiverInfo) ? outReceiverInfo->mReceiverID : 0, rtpPacket.ssrc());
-          return true;
-        }
+        // the associated SSRC was found in table thus must route to same receiver
+        String inMuxID = muxID;
+        setSSRCUsage(rtpPacket.ssrc(), inMuxID, outReceiverInfo);
+        EventWriteOrtcRtpListenerFoundMappingBySsrc(__func__, mID, ((bool)outReceiverInfo) ? outReceiverInfo->mReceiverID : 0, rtpPacket.ssrc());
+        return true;
       }
 
       return false;
@@ -1677,7 +2061,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPListener::findMappingUsingPayloadType(
                                                   const String &muxID,
-                                                  const RTPPacket &rtpPacket,
+                                                  const RTPPacketView &rtpPacket,
                                                   ReceiverInfoPtr &outReceiverInfo
                                                   )
     {
@@ -1686,8 +2070,13 @@ namespace ortc
 
       Time lastMatchUsageTime {};
 
-      for (auto iter = mReceivers->begin(); iter != mReceivers->end(); ++iter) {
-        auto &receiverInfo = (*iter).second;
+      auto foundPayloadType = mPayloadTypeIndex.find(rtpPacket.pt());
+      if (foundPayloadType == mPayloadTypeIndex.end()) return false;
+
+      const ReceiverInfoList &candidates = (*foundPayloadType).second;
+
+      for (auto iter = candidates.begin(); iter != candidates.end(); ++iter) {
+        auto &receiverInfo = (*iter);
 
         if ((receiverInfo->mFilledParameters.mMuxID.hasData()) &&
             (muxID.hasData())) {
@@ -1742,7 +2131,7 @@ namespace ortc
                 auto tick = zsLib::now();
 
                 auto diffLast = tick - lastMatchUsageTime;
-                auto diffCurrent = tick - ssrcInfo->mLastUsage;
+                auto diffCurrent = tick - ssrcInfo->mLastUsage.load();
 
                 if ((diffLast < mAmbigousPayloadMappingMinDifference) &&
                     (diffCurrent < mAmbigousPayloadMappingMinDifference)) {
@@ -1750,21 +2139,21 @@ namespace ortc
                   return false;
                 }
 
-                if (ssrcInfo->mLastUsage < lastMatchUsageTime) {
+                if (ssrcInfo->mLastUsage.load() < lastMatchUsageTime) {
                   ZS_LOG_WARNING(Trace, log("possible ambiguity in match (but going with previous more recent usage)") + ZS_PARAM("match time", lastMatchUsageTime) + ssrcInfo->toDebug())
                   continue;
                 }
 
                 ZS_LOG_WARNING(Trace, log("possible ambiguity in match (going with this as more recent in usage)") + ZS_PARAM("match time", lastMatchUsageTime) + ssrcInfo->toDebug() + ZS_PARAM("using", receiverInfo->toDebug()) + ZS_PARAM("previous found", outReceiverInfo->toDebug()))
 
-                lastMatchUsageTime = ssrcInfo->mLastUsage;
+                lastMatchUsageTime = ssrcInfo->mLastUsage.load();
                 outReceiverInfo = receiverInfo;
                 foundEncoding = matchEncoding;
                 foundDecodedCodec = decodedCodec;
               } else {
                 ZS_LOG_TRACE(log("found likely match") + receiverInfo->toDebug() + ssrcInfo->toDebug())
 
-                lastMatchUsageTime = ssrcInfo->mLastUsage;
+                lastMatchUsageTime = ssrcInfo->mLastUsage.load();
                 outReceiverInfo = receiverInfo;
                 foundEncoding = matchEncoding;
                 foundDecodedCodec = decodedCodec;
@@ -1871,55 +2260,30 @@ namespace ortc
 
     //-------------------------------------------------------------------------
     String RTPListener::extractMuxID(
-                                     const RTPPacket &rtpPacket,
+                                     const RTPPacketView &rtpPacket,
                                      ReceiverInfoPtr &ioReceiverInfo
                                      )
     {
-      for (auto ext = rtpPacket.firstHeaderExtension(); NULL != ext; ext = ext->mNext) {
-        LocalID localID = static_cast<LocalID>(ext->mID);
-        auto found = mRegisteredExtensions.find(localID);
-        if (found == mRegisteredExtensions.end()) continue; // header extension is not understood
-
-        RegisteredHeaderExtension &headerInfo = (*found).second;
-
-        if (IRTPTypes::HeaderExtensionURI_MuxID != headerInfo.mHeaderExtensionURI) continue;
+      String muxID;
 
+      auto ext = mHeaderExtensionLookup.find(rtpPacket, IRTPTypes::HeaderExtensionURI_MuxID);
+      if (NULL != ext) {
         RTPPacket::MidHeaderExtension mid(*ext);
-
-        String muxID(mid.mid());
-        if (!muxID.hasData()) continue;
-
-        setSSRCUsage(rtpPacket.ssrc(), muxID, ioReceiverInfo);
-        return muxID;
+        muxID = String(mid.mid());
       }
 
-      String muxID;
       setSSRCUsage(rtpPacket.ssrc(), muxID, ioReceiverInfo);
-
       return muxID;
     }
 
     //-------------------------------------------------------------------------
-    String RTPListener::extractRID(const RTPPacket &rtpPacket)
+    String RTPListener::extractRID(const RTPPacketView &rtpPacket)
     {
-      for (auto ext = rtpPacket.firstHeaderExtension(); NULL != ext; ext = ext->mNext) {
-        LocalID localID = static_cast<LocalID>(ext->mID);
-        auto found = mRegisteredExtensions.find(localID);
-        if (found == mRegisteredExtensions.end()) continue; // header extension is not understood
-
-        RegisteredHeaderExtension &headerInfo = (*found).second;
-
-        if (IRTPTypes::HeaderExtensionURI_RID != headerInfo.mHeaderExtensionURI) continue;
+      auto ext = mHeaderExtensionLookup.find(rtpPacket, IRTPTypes::HeaderExtensionURI_RID);
+      if (NULL == ext) return String();
 
-        RTPPacket::RidHeaderExtension rid(*ext);
-
-        String ridStr(rid.rid());
-        if (!ridStr.hasData()) continue;
-
-        return ridStr;
-      }
-
-      return String();
+      RTPPacket::RidHeaderExtension rid(*ext);
+      return String(rid.rid());
     }
 
     //-------------------------------------------------------------------------
@@ -2023,6 +2387,166 @@ namespace ortc
 
       // point to replacement list
       mReceivers = receivers;
+      rebuildReceiverIndexes();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::rebuildReceiverIndexes()
+    {
+      mEncodingSSRCIndex.clear();
+      mPayloadTypeIndex.clear();
+      mRIDIndex.clear();
+      mTransportCCReceivers.clear();
+
+      for (auto iter = mReceivers->begin(); iter != mReceivers->end(); ++iter) {
+        auto &receiverInfo = (*iter).second;
+
+        if (hasTransportCCFeedback(receiverInfo->mFilledParameters)) {
+          mTransportCCReceivers.push_back(receiverInfo);
+        }
+
+        for (auto iterEncoding = receiverInfo->mFilledParameters.mEncodings.begin(); iterEncoding != receiverInfo->mFilledParameters.mEncodings.end(); ++iterEncoding) {
+          auto &encParams = (*iterEncoding);
+
+          if (encParams.mSSRC.hasValue()) {
+            auto &list = mEncodingSSRCIndex[encParams.mSSRC.value()];
+            if ((list.size() < 1) || (list.back() != receiverInfo)) list.push_back(receiverInfo);
+          }
+          if ((encParams.mRTX.hasValue()) &&
+              (encParams.mRTX.value().mSSRC.hasValue())) {
+            auto &list = mEncodingSSRCIndex[encParams.mRTX.value().mSSRC.value()];
+            if ((list.size() < 1) || (list.back() != receiverInfo)) list.push_back(receiverInfo);
+          }
+          if ((encParams.mFEC.hasValue()) &&
+              (encParams.mFEC.value().mSSRC.hasValue())) {
+            auto &list = mEncodingSSRCIndex[encParams.mFEC.value().mSSRC.value()];
+            if ((list.size() < 1) || (list.back() != receiverInfo)) list.push_back(receiverInfo);
+          }
+          if (encParams.mEncodingID.hasData()) {
+            auto &list = mRIDIndex[encParams.mEncodingID];
+            if ((list.size() < 1) || (list.back() != receiverInfo)) list.push_back(receiverInfo);
+          }
+        }
+
+        // NOTE: a packet can only decode against a receiver's parameters if
+        //       its payload type is one of the receiver's codecs
+        for (auto iterCodec = receiverInfo->mFilledParameters.mCodecs.begin(); iterCodec != receiverInfo->mFilledParameters.mCodecs.end(); ++iterCodec) {
+          auto &list = mPayloadTypeIndex[(*iterCodec).mPayloadType];
+          if ((list.size() < 1) || (list.back() != receiverInfo)) list.push_back(receiverInfo);
+        }
+      }
+
+      publishSSRCRoutes();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::rebuildSenderIndexes()
+    {
+      mSenderSSRCIndex.clear();
+      mUnindexedSenders.clear();
+
+      for (auto iter = mSenderParameters.begin(); iter != mSenderParameters.end(); ++iter) {
+        SenderID senderID = (*iter).first;
+        auto &params = (*iter).second;
+
+        bool indexed = (params.mEncodings.size() > 0);
+
+        for (auto iterEncoding = params.mEncodings.begin(); iterEncoding != params.mEncodings.end(); ++iterEncoding) {
+          auto &encParams = (*iterEncoding);
+
+          if (encParams.mSSRC.hasValue()) {
+            mSenderSSRCIndex[encParams.mSSRC.value()].push_back(senderID);
+          } else {
+            indexed = false;
+          }
+
+          if (encParams.mRTX.hasValue()) {
+            if (encParams.mRTX.value().mSSRC.hasValue()) {
+              mSenderSSRCIndex[encParams.mRTX.value().mSSRC.value()].push_back(senderID);
+            } else {
+              indexed = false;
+            }
+          }
+
+          if (encParams.mFEC.hasValue()) {
+            if (encParams.mFEC.value().mSSRC.hasValue()) {
+              mSenderSSRCIndex[encParams.mFEC.value().mSSRC.value()].push_back(senderID);
+            } else {
+              indexed = false;
+            }
+          }
+        }
+
+        // NOTE: senders which choose their own SSRCs cannot be targeted
+        if (!indexed) mUnindexedSenders.push_back(senderID);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::targetRTCPDelivery(
+                                         const RTCPPacket &rtcpPacket,
+                                         ReceiverObjectMapPtr &ioReceivers,
+                                         SenderObjectMapPtr &ioSenders
+                                         )
+    {
+      if (!rtcpPacket.getReferencedSSRCs(mRTCPSenderSSRCs, mRTCPMediaSSRCs)) {
+        ZS_LOG_INSANE(log("rtcp packet cannot be targeted (thus delivering to all receivers and senders)"))
+        return;
+      }
+
+      ReceiverObjectMapPtr receivers(make_shared<ReceiverObjectMap>());
+      SenderObjectMapPtr senders(make_shared<SenderObjectMap>());
+
+      // reports / feedback sent by a remote source go to the receiver
+      // receiving that source
+      for (auto iter = mRTCPSenderSSRCs.begin(); iter != mRTCPSenderSSRCs.end(); ++iter) {
+        SSRCInfoPtr ssrcInfo;
+
+        auto found = mSSRCTable.find(*iter);
+        if (found != mSSRCTable.end()) {
+          ssrcInfo = (*found).second;
+        } else {
+          // NOTE: the SSRC table entry may have expired while the SSRC is
+          //       still registered (and routed by the published snapshot)
+          auto foundWeak = mRegisteredSSRCs.find(*iter);
+          if (foundWeak != mRegisteredSSRCs.end()) ssrcInfo = (*foundWeak).second.lock();
+        }
+
+        if (!ssrcInfo) continue;
+        if (!ssrcInfo->mReceiverInfo) continue;
+
+        auto foundReceiver = ioReceivers->find(ssrcInfo->mReceiverInfo->mReceiverID);
+        if (foundReceiver == ioReceivers->end()) continue;
+
+        (*receivers)[(*foundReceiver).first] = (*foundReceiver).second;
+      }
+
+      // reports / feedback about a media source go to the sender sending
+      // that source
+      for (auto iter = mRTCPMediaSSRCs.begin(); iter != mRTCPMediaSSRCs.end(); ++iter) {
+        auto found = mSenderSSRCIndex.find(*iter);
+        if (found == mSenderSSRCIndex.end()) continue;
+
+        auto &senderIDs = (*found).second;
+        for (auto iterID = senderIDs.begin(); iterID != senderIDs.end(); ++iterID) {
+          auto foundSender = ioSenders->find(*iterID);
+          if (foundSender == ioSenders->end()) continue;
+
+          (*senders)[(*foundSender).first] = (*foundSender).second;
+        }
+      }
+
+      for (auto iter = mUnindexedSenders.begin(); iter != mUnindexedSenders.end(); ++iter) {
+        auto foundSender = ioSenders->find(*iter);
+        if (foundSender == ioSenders->end()) continue;
+
+        (*senders)[(*foundSender).first] = (*foundSender).second;
+      }
+
+      ZS_LOG_INSANE(log("targeted rtcp delivery") + ZS_PARAM("receivers", receivers->size()) + ZS_PARAM("of receivers", ioReceivers->size()) + ZS_PARAM("senders", senders->size()) + ZS_PARAM("of senders", ioSenders->size()))
+
+      ioReceivers = receivers;
+      ioSenders = senders;
     }
 
     //-------------------------------------------------------------------------
@@ -2038,8 +2562,9 @@ namespace ortc
             if (found != mSSRCTable.end()) {
               auto &ssrcInfo = (*found).second;
               ZS_LOG_TRACE(log("removing ssrc table entry due to BYE") + ZS_PARAM("ssrc", byeSSRC) + ssrcInfo->toDebug())
-              EventWriteOrtcRtpListenerSsrcTableEntryRemoved(__func__, mID, ((bool)ssrcInfo->mReceiverInfo) ? ssrcInfo->mReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage).count(), ssrcInfo->mMuxID, "bye");
+              EventWriteOrtcRtpListenerSsrcTableEntryRemoved(__func__, mID, ((bool)ssrcInfo->mReceiverInfo) ? ssrcInfo->mReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage.load()).count(), ssrcInfo->mMuxID, "bye");
               mSSRCTable.erase(found);
+              publishSSRCRoutes();
             }
           }
 
@@ -2238,6 +2763,8 @@ namespace ortc
     {
       SSRCInfoPtr ssrcInfo;
 
+      bool changed = false;
+
       auto found = mSSRCTable.find(ssrc);
 
       if (found == mSSRCTable.end()) {
@@ -2246,6 +2773,11 @@ namespace ortc
           ssrcInfo = (*foundWeak).second.lock();
           if (!ssrcInfo) {
             mRegisteredSSRCs.erase(foundWeak);
+          } else {
+            // recreate the expired SSRC table entry from the registration
+            EventWriteOrtcRtpListenerSsrcTableEntryAdded(__func__, mID, ((bool)ssrcInfo->mReceiverInfo) ? ssrcInfo->mReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage.load()).count(), ssrcInfo->mMuxID);
+            mSSRCTable[ssrc] = ssrcInfo;
+            changed = true;
           }
         }
       } else {
@@ -2261,8 +2793,9 @@ namespace ortc
           ioMuxID = ssrcInfo->mMuxID = ioReceiverInfo->mFilledParameters.mMuxID;
         }
         ssrcInfo->mReceiverInfo = ioReceiverInfo;
-        EventWriteOrtcRtpListenerSsrcTableEntryAdded(__func__, mID, ((bool)ioReceiverInfo) ? ioReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage).count(), ssrcInfo->mMuxID);
+        EventWriteOrtcRtpListenerSsrcTableEntryAdded(__func__, mID, ((bool)ioReceiverInfo) ? ioReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage.load()).count(), ssrcInfo->mMuxID);
         mSSRCTable[ssrc] = ssrcInfo;
+        if (ioReceiverInfo) publishSSRCRoutes();
         reattemptDelivery();
         return ssrcInfo;
       }
@@ -2270,24 +2803,31 @@ namespace ortc
       ssrcInfo->mLastUsage = zsLib::now();
 
       if (ioReceiverInfo) {
+        changed = changed || (ssrcInfo->mReceiverInfo != ioReceiverInfo);
         ssrcInfo->mReceiverInfo = ioReceiverInfo;
       } else {
         ioReceiverInfo = ssrcInfo->mReceiverInfo;
       }
 
       if (ioMuxID.hasData()) {
-        if (ioMuxID != ssrcInfo->mMuxID) ssrcInfo->mMuxID = ioMuxID;
+        if (ioMuxID != ssrcInfo->mMuxID) {
+          ssrcInfo->mMuxID = ioMuxID;
+          changed = true;
+        }
       } else if (ssrcInfo->mReceiverInfo) {
         if (ssrcInfo->mReceiverInfo->mFilledParameters.mMuxID.hasData()) {
           if (ssrcInfo->mMuxID != ssrcInfo->mReceiverInfo->mFilledParameters.mMuxID) {
             ioMuxID = ssrcInfo->mMuxID = ssrcInfo->mReceiverInfo->mFilledParameters.mMuxID;
+            changed = true;
           } else {
             ioMuxID = ssrcInfo->mMuxID;
           }
         }
       }
 
-      EventWriteOrtcRtpListenerSsrcTableEntryUpdated(__func__, mID, ((bool)ssrcInfo->mReceiverInfo) ? ssrcInfo->mReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage).count(), ssrcInfo->mMuxID);
+      EventWriteOrtcRtpListenerSsrcTableEntryUpdated(__func__, mID, ((bool)ssrcInfo->mReceiverInfo) ? ssrcInfo->mReceiverInfo->mReceiverID : 0, ssrcInfo->mSSRC, zsLib::timeSinceEpoch<Seconds>(ssrcInfo->mLastUsage.load()).count(), ssrcInfo->mMuxID);
+
+      if (changed) publishSSRCRoutes();
 
       return ssrcInfo;
     }
@@ -2336,7 +2876,213 @@ namespace ortc
 
       mSubscriptions.delegate()->onRTPListenerUnhandledRTP(mThisWeak.lock(), unhandled.mSSRC, unhandled.mCodecPayloadType, unhandled.mMuxID.c_str(), unhandled.mRID.c_str());
     }
-    
+
+    //-------------------------------------------------------------------------
+    bool RTPListener::findRoute(
+                                const RTPPacketView &rtpPacket,
+                                ReceiverInfoPtr &outReceiverInfo
+                                )
+    {
+      SSRCRoutesPtr routes = std::atomic_load(&mSSRCRoutes);
+      if (!routes) return false;
+
+      auto route = routes->find(rtpPacket.ssrc());
+      if (NULL == route) return false;
+
+      // NOTE: a registered SSRC whose SSRC table entry expired must take the
+      //       slow path to recreate the entry (otherwise RTCP for the SSRC
+      //       cannot be targeted to its receiver)
+      if (!route->mActive) return false;
+
+      auto ext = routes->mHeaderExtensionLookup.find(rtpPacket, IRTPTypes::HeaderExtensionURI_MuxID);
+      if (NULL != ext) {
+        // NOTE: a packet announcing a different mux ID must be re-mapped
+        //       (under the lock) by the slow path
+        RTPPacket::MidHeaderExtension mid(*ext);
+        if (route->mReceiverInfo->mFilledParameters.mMuxID != mid.mid()) return false;
+      }
+
+      if (routes->mTransportCC) {
+        recordTransportArrival(routes->mHeaderExtensionLookup, rtpPacket);
+      }
+
+      route->mSSRCInfo->mLastUsage = zsLib::now();
+
+      outReceiverInfo = route->mReceiverInfo;
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::publishSSRCRoutes()
+    {
+      if (isShutdown()) {
+        std::atomic_store(&mSSRCRoutes, SSRCRoutesPtr());
+        return;
+      }
+
+      SSRCRoutesPtr routes(make_shared<SSRCRoutes>(mSSRCTable.size() + mRegisteredSSRCs.size()));
+
+      // NOTE: only SSRCs whose mux ID already agrees with their receiver are
+      //       published; any other SSRC needs the slow path to settle it
+      for (auto iter = mRegisteredSSRCs.begin(); iter != mRegisteredSSRCs.end(); ++iter) {
+        auto ssrcInfo = (*iter).second.lock();
+        if (!ssrcInfo) continue;
+        if (!ssrcInfo->mReceiverInfo) continue;
+        if (ssrcInfo->mMuxID != ssrcInfo->mReceiverInfo->mFilledParameters.mMuxID) continue;
+        routes->insert(ssrcInfo, false);
+      }
+
+      // NOTE: the active SSRC table takes precedence over registered SSRCs
+      for (auto iter = mSSRCTable.begin(); iter != mSSRCTable.end(); ++iter) {
+        auto &ssrcInfo = (*iter).second;
+        if (!ssrcInfo->mReceiverInfo) continue;
+        if (ssrcInfo->mMuxID != ssrcInfo->mReceiverInfo->mFilledParameters.mMuxID) continue;
+        routes->insert(ssrcInfo, true);
+      }
+
+      routes->mHeaderExtensionLookup = mHeaderExtensionLookup;
+      routes->mTransportCC = (mTransportCCReceivers.size() > 0);
+
+      ZS_LOG_INSANE(log("publishing ssrc routes") + ZS_PARAM("routes", routes->size()) + ZS_PARAM("capacity", routes->capacity()))
+
+      std::atomic_store(&mSSRCRoutes, routes);
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPListener::hasTransportCCFeedback(const Parameters &params)
+    {
+      for (auto iter = params.mCodecs.begin(); iter != params.mCodecs.end(); ++iter) {
+        auto &codec = (*iter);
+        for (auto iterFeedback = codec.mRTCPFeedback.begin(); iterFeedback != codec.mRTCPFeedback.end(); ++iterFeedback) {
+          if (IRTPTypes::KnownFeedbackType_transport_cc == IRTPTypes::toKnownFeedbackType((*iterFeedback).mType)) return true;
+        }
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::recordTransportArrival(
+                                             const RTPHeaderExtensionLookup &lookup,
+                                             const RTPPacketView &rtpPacket
+                                             )
+    {
+      // NOTE: callers only record arrivals if a receiver negotiated
+      //       "transport-cc" RTCP feedback (otherwise the remote party would
+      //       not understand the feedback); this may be called without the
+      //       listener lock (but always with a consistent lookup table)
+      if (mTransportCCFeedbackInterval < Milliseconds(1)) return;
+
+      auto ext = lookup.find(rtpPacket, IRTPTypes::HeaderExtensionURI_TransportSequenceNumber);
+      if (!ext) return;
+      if (ext->mDataSizeInBytes < sizeof(WORD)) return;
+
+      AutoLock lock(mTransportCCLock);
+
+      mTransportCCRecorder.record(RTPUtils::getBE16(ext->mData), rtpPacket.ssrc(), zsLib::now());
+
+      if (mTransportCCTimer) return;
+
+      mTransportCCTimer = Timer::create(mThisWeak.lock(), mTransportCCFeedbackInterval);
+      ZS_LOG_TRACE(log("transport-cc feedback timer started") + ZS_PARAM("timer", mTransportCCTimer->getID()) + ZS_PARAM("interval", mTransportCCFeedbackInterval))
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPListener::sendTransportCCFeedback()
+    {
+      typedef TransportCCRecorder::TransportCC TransportCC;
+
+      class FeedbackCollector : public IRTCPPacketWriterDelegate
+      {
+      public:
+        FeedbackCollector(PacketBufferList &packets) : mPackets(packets) {}
+
+        virtual void onRTCPPacketWriterPacket(
+                                              const BYTE *packet,
+                                              size_t packetSizeInBytes
+                                              ) override
+        {
+          mPackets.push_back(UseServicesHelper::convertToBuffer(packet, packetSizeInBytes));
+        }
+
+      protected:
+        PacketBufferList &mPackets;
+      };
+
+      UseRTPReceiverPtr receiver;
+      PacketBufferList packets;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        {
+          AutoLock ccLock(mTransportCCLock);
+          if (mTransportCCTimer) {
+            mTransportCCTimer->cancel();
+            mTransportCCTimer.reset();
+          }
+        }
+
+        if (isShutdown()) return;
+
+        // NOTE: feedback is sent via a receiver which negotiated
+        //       "transport-cc" so it goes out over that receiver's RTCP
+        //       transport (which is not necessarily muxed with RTP)
+        SSRCType senderSSRC {};
+        for (auto iter = mTransportCCReceivers.begin(); iter != mTransportCCReceivers.end(); ++iter) {
+          auto &receiverInfo = (*iter);
+          auto possibleReceiver = receiverInfo->mReceiver.lock();
+          if (!possibleReceiver) continue;
+
+          if (!receiver) receiver = possibleReceiver;
+
+          if (!receiverInfo->mFilledParameters.mRTCP.mSSRC) continue;
+
+          receiver = possibleReceiver;
+          senderSSRC = receiverInfo->mFilledParameters.mRTCP.mSSRC;
+          break;
+        }
+
+        if (!receiver) {
+          ZS_LOG_TRACE(log("no receiver negotiated transport-cc (thus discarding recorded arrivals)"))
+          AutoLock ccLock(mTransportCCLock);
+          mTransportCCRecorder.reset();
+          return;
+        }
+
+        if (0 == senderSSRC) {
+          // NOTE: prefer an SSRC this side sends media with before falling
+          //       back to a random SSRC allocated for this listener
+          senderSSRC = (mSenderSSRCIndex.size() > 0 ? (*mSenderSSRCIndex.begin()).first : mTransportCCSenderSSRC);
+        }
+
+        BYTE buffer[TransportCCRecorder::kMaxFeedbackPacketSize];
+        FeedbackCollector collector(packets);
+        RTCPPacketWriter writer(&collector, buffer, sizeof(buffer));
+
+        AutoLock ccLock(mTransportCCLock);
+
+        TransportCC transportCC;
+        while (mTransportCCRecorder.fillFeedback(transportCC)) {
+          if (!writer.writeTransportCC(senderSSRC, mTransportCCRecorder.mMediaSSRC, transportCC)) {
+            ZS_LOG_WARNING(Debug, log("transport-cc feedback too large for packet (thus dropping)") + ZS_PARAM("status count", transportCC.packetStatusCount()))
+          }
+        }
+        writer.flush();
+      }
+
+      if (packets.size() < 1) return;
+
+      ZS_LOG_INSANE(log("sending transport-cc feedback") + ZS_PARAM("receiver", receiver->getID()) + ZS_PARAM("packets", packets.size()))
+
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto rtcpPacket = RTCPPacket::create(*iter, RTCPPacket::ParseMode_Fast);
+        if (!rtcpPacket) {
+          ZS_LOG_WARNING(Debug, log("generated transport-cc feedback failed to parse (thus dropping)"))
+          continue;
+        }
+        receiver->sendPacket(rtcpPacket);
+      }
+    }
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
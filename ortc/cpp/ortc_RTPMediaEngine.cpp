@@ -37,6 +37,7 @@
 #include <ortc/internal/ortc_RTPSenderChannelVideo.h>
 #include <ortc/internal/ortc_RTPPacket.h>
 #include <ortc/internal/ortc_RTCPPacket.h>
+#include <ortc/internal/ortc_RTPUtils.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_StatsReport.h>
 #include <ortc/internal/ortc_Tracing.h>
@@ -69,6 +70,7 @@
 #include <webrtc/webrtc/base/scoped_ptr.h>
 #include <webrtc/webrtc/voice_engine/include/voe_audio_processing.h>
 #include <webrtc/modules/video_capture/video_capture_factory.h>
+#include <webrtc/modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h>
 #ifdef WINRT
 #include <third_party/h264_winrt/h264_winrt_factory.h>
 #endif
@@ -347,7 +349,9 @@ namespace ortc
     //-------------------------------------------------------------------------
     void IRTPMediaEngineForSettings::applyDefaults()
     {
-//      UseSettings::setUInt(ORTC_SETTING_SCTP_TRANSPORT_MAX_MESSAGE_SIZE, 5*1024);
+      UseSettings::setUInt(ORTC_SETTING_RTP_MEDIA_ENGINE_PROCESS_THREAD_POOL_SIZE, 0);
+      UseSettings::setUInt(ORTC_SETTING_RTP_MEDIA_ENGINE_PACKET_QUEUE_REBALANCE_INTERVAL_IN_SECONDS, 5);
+      UseSettings::setUInt(ORTC_SETTING_RTP_MEDIA_ENGINE_CHANNEL_PACKET_RING_SIZE, 1024);
     }
 
     //-------------------------------------------------------------------------
@@ -375,6 +379,7 @@ namespace ortc
     PromiseWithRTPMediaEngineChannelResourcePtr IRTPMediaEngineForRTPReceiverChannelMediaBase::setupChannel(
                                                                                                             UseReceiverChannelMediaBasePtr channel,
                                                                                                             TransportPtr transport,
+                                                                                                            PUID secureTransportID,
                                                                                                             UseMediaStreamTrackPtr track,
                                                                                                             ParametersPtr parameters,
                                                                                                             RTPPacketPtr packet
@@ -385,6 +390,7 @@ namespace ortc
       return singleton->getEngineRegistration()->getRTPEngine()->setupChannel(
                                                                               channel,
                                                                               transport,
+                                                                              secureTransportID,
                                                                               track,
                                                                               parameters,
                                                                               packet
@@ -415,6 +421,7 @@ namespace ortc
     PromiseWithRTPMediaEngineChannelResourcePtr IRTPMediaEngineForRTPSenderChannelMediaBase::setupChannel(
                                                                                                           UseSenderChannelMediaBasePtr channel,
                                                                                                           TransportPtr transport,
+                                                                                                          PUID secureTransportID,
                                                                                                           UseMediaStreamTrackPtr track,
                                                                                                           ParametersPtr parameters,
                                                                                                           IDTMFSenderDelegatePtr dtmfDelegate
@@ -425,6 +432,7 @@ namespace ortc
       return singleton->getEngineRegistration()->getRTPEngine()->setupChannel(
                                                                               channel,
                                                                               transport,
+                                                                              secureTransportID,
                                                                               track,
                                                                               parameters,
                                                                               dtmfDelegate
@@ -459,6 +467,371 @@ namespace ortc
       return singleton->getEngineRegistration()->getRTPEngine()->setupDevice(track);
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPMediaEngineForRTPSender
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngineCongestionContextPtr IRTPMediaEngineForRTPSender::acquireCongestionContext(PUID secureTransportID)
+    {
+      // NOTE: a sender only forwarding packets never starts the media engine
+      auto engine = RTPMediaEngineSingleton::getEngineIfAlive();
+      if (!engine) return RTPMediaEngineCongestionContextPtr();
+      return engine->acquireCongestionContext(secureTransportID);
+    }
+
+    //-------------------------------------------------------------------------
+    void IRTPMediaEngineForRTPSender::releaseCongestionContext(RTPMediaEngineCongestionContextPtr context)
+    {
+      if (!context) return;
+
+      auto engine = RTPMediaEngineSingleton::getEngineIfAlive();
+      if (!engine) return;
+      engine->releaseCongestionContext(context);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngineProcessThreads
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngineProcessThreads::RTPMediaEngineProcessThreads(size_t index) :
+      mIndex(index)
+    {
+      String moduleName = String("RTPMediaEngineModuleProcessThread") + string(index);
+      String pacerName = String("RTPMediaEnginePacerThread") + string(index);
+
+      mModuleProcessThread = webrtc::ProcessThread::Create(moduleName.c_str());
+      mPacerThread = webrtc::ProcessThread::Create(pacerName.c_str());
+
+      mModuleProcessThread->Start();
+      mPacerThread->Start();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngineProcessThreads::~RTPMediaEngineProcessThreads()
+    {
+      mPacerThread->Stop();
+      mModuleProcessThread->Stop();
+
+      mPacerThread.reset();
+      mModuleProcessThread.reset();
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPMediaEngineProcessThreads::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPMediaEngineProcessThreads");
+
+      UseServicesHelper::debugAppend(resultEl, "index", mIndex);
+      UseServicesHelper::debugAppend(resultEl, "total users", mTotalUsers);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngineCongestionContext
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngineCongestionContext::RTPMediaEngineCongestionContext(
+                                                                     PUID secureTransportID,
+                                                                     RTPMediaEngineProcessThreadsPtr processThreads
+                                                                     ) :
+      mSecureTransportID(secureTransportID),
+      mProcessThreads(processThreads),
+      mClock(webrtc::Clock::GetRealTimeClock()),
+      mRemb(mClock)
+    {
+      mBitrateAllocator = rtc::scoped_ptr<webrtc::BitrateAllocator>(new webrtc::BitrateAllocator());
+      mCallStats = rtc::scoped_ptr<webrtc::CallStats>(new webrtc::CallStats(mClock));
+      mCongestionController =
+        rtc::scoped_ptr<webrtc::CongestionController>(new webrtc::CongestionController(
+                                                                                       mClock,
+                                                                                       this,
+                                                                                       &mRemb
+                                                                                       ));
+
+      mCallStats->RegisterStatsObserver(mCongestionController.get());
+
+      mProcessThreads->mModuleProcessThread->RegisterModule(mCallStats.get());
+      mProcessThreads->mModuleProcessThread->RegisterModule(mCongestionController.get());
+      mProcessThreads->mPacerThread->RegisterModule(mCongestionController->pacer());
+      mProcessThreads->mPacerThread->RegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
+    }
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngineCongestionContext::~RTPMediaEngineCongestionContext()
+    {
+      mProcessThreads->mPacerThread->DeRegisterModule(mCongestionController->pacer());
+      mProcessThreads->mPacerThread->DeRegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
+      mProcessThreads->mModuleProcessThread->DeRegisterModule(mCongestionController.get());
+      mProcessThreads->mModuleProcessThread->DeRegisterModule(mCallStats.get());
+
+      mCallStats->DeregisterStatsObserver(mCongestionController.get());
+
+      mCongestionController.reset();
+      mCallStats.reset();
+      mBitrateAllocator.reset();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngineCongestionContext::registerChannel(
+                                                          ChannelID channelID,
+                                                          IRTPMediaEngineCongestionContextDelegatePtr delegate
+                                                          )
+    {
+      AutoLock lock(mLock);
+
+      ChannelInfo &info = mChannels[channelID];
+      info.mDelegate = delegate;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngineCongestionContext::unregisterChannel(ChannelID channelID)
+    {
+      {
+        AutoLock lock(mLock);
+
+        auto found = mChannels.find(channelID);
+        if (found == mChannels.end()) return;
+
+        mChannels.erase(found);
+      }
+
+      updateBweBitrates();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngineCongestionContext::setBweBitrates(
+                                                         ChannelID channelID,
+                                                         int minBitrateBps,
+                                                         int startBitrateBps,
+                                                         int maxBitrateBps
+                                                         )
+    {
+      {
+        AutoLock lock(mLock);
+
+        ChannelInfo &info = mChannels[channelID];
+        info.mMinBitrateBps = minBitrateBps;
+        info.mStartBitrateBps = startBitrateBps;
+        info.mMaxBitrateBps = maxBitrateBps;
+      }
+
+      updateBweBitrates();
+    }
+
+    //-------------------------------------------------------------------------
+    WORD RTPMediaEngineCongestionContext::allocateTransportSequenceNumber()
+    {
+      return static_cast<WORD>(mCongestionController->packet_router()->AllocateSequenceNumber());
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngineCongestionContext::notifyPacketSent(
+                                                           WORD transportSequenceNumber,
+                                                           size_t packetSizeInBytes
+                                                           )
+    {
+      // NOTE: the packet is registered as not paced by the controller's pacer
+      //       (the forwarding sender paces on its own)
+      mCongestionController->GetTransportFeedbackObserver()->AddPacket(transportSequenceNumber, packetSizeInBytes, false);
+      mCongestionController->OnSentPacket(rtc::SentPacket(transportSequenceNumber, mClock->TimeInMilliseconds()));
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngineCongestionContext::handleTransportFeedback(
+                                                                  const BYTE *buffer,
+                                                                  size_t bufferSizeInBytes
+                                                                  )
+    {
+      auto feedback = webrtc::rtcp::TransportFeedback::ParseFrom(buffer, bufferSizeInBytes);
+      if (!feedback) {
+        ZS_LOG_WARNING(Trace, Log::Params("transport feedback could not be parsed", toDebug()) + ZS_PARAM("size", bufferSizeInBytes))
+        return;
+      }
+
+      mCongestionController->GetTransportFeedbackObserver()->OnTransportFeedback(*feedback);
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPMediaEngineCongestionContext::toDebug() const
+    {
+      AutoLock lock(mLock);
+
+      ElementPtr resultEl = Element::create("ortc::RTPMediaEngineCongestionContext");
+
+      UseServicesHelper::debugAppend(resultEl, "id", mID);
+      UseServicesHelper::debugAppend(resultEl, "secure transport id", mSecureTransportID);
+      UseServicesHelper::debugAppend(resultEl, "total channels", mTotalChannels);
+      UseServicesHelper::debugAppend(resultEl, "registered channels", mChannels.size());
+      UseServicesHelper::debugAppend(resultEl, "process threads", mProcessThreads ? mProcessThreads->mIndex : 0);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngineCongestionContext => webrtc::BitrateObserver
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngineCongestionContext::OnNetworkChanged(uint32_t targetBitrateBps, uint8_t fractionLoss, int64_t rttMs)
+    {
+      // NOTE: called from the module process thread. Only weak references to
+      //       the channel resources are held (and each is promoted just for
+      //       the duration of its call) so the process thread never keeps a
+      //       channel resource alive, and every delegate is called outside of
+      //       the context lock as they acquire their own channel resource
+      //       lock.
+      ChannelAllocationList allocations;
+
+      {
+        AutoLock lock(mLock);
+        for (auto iter = mChannels.begin(); iter != mChannels.end(); ++iter) {
+          auto &info = (*iter).second;
+
+          ChannelAllocation allocation;
+          allocation.mDelegate = info.mDelegate;
+          allocation.mMinBitrateBps = info.mMinBitrateBps;
+          allocation.mMaxBitrateBps = info.mMaxBitrateBps;
+          allocations.push_back(allocation);
+        }
+      }
+
+      uint32_t allocatedBitrateBps = mBitrateAllocator->OnNetworkChanged(
+                                                                         targetBitrateBps,
+                                                                         fractionLoss,
+                                                                         rttMs
+                                                                         );
+
+      int padUpToBitrateBps = 0;
+      for (auto iter = allocations.begin(); iter != allocations.end(); ++iter) {
+        auto delegate = (*iter).mDelegate.lock();
+        if (!delegate) continue;
+        padUpToBitrateBps += delegate->getPaddingNeededBps();
+      }
+      uint32_t pacerBitrateBps = std::max(targetBitrateBps, allocatedBitrateBps);
+
+      mCongestionController->UpdatePacerBitrate(
+                                                targetBitrateBps / 1000,
+                                                webrtc::PacedSender::kDefaultPaceMultiplier * pacerBitrateBps / 1000,
+                                                padUpToBitrateBps / 1000
+                                                );
+
+      allocateBitrates(targetBitrateBps, allocations);
+
+      for (auto iter = allocations.begin(); iter != allocations.end(); ++iter) {
+        auto delegate = (*iter).mDelegate.lock();
+        if (!delegate) continue;
+        delegate->notifyTargetBitrate((*iter).mAllocatedBitrateBps);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngineCongestionContext => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngineCongestionContext::updateBweBitrates()
+    {
+      // NOTE: the shared estimator is bounded by the sum of every channel's
+      //       configured bitrates. The controller is updated outside of the
+      //       context lock as it may call back into OnNetworkChanged.
+      int totalMinBitrateBps = 0;
+      int totalStartBitrateBps = 0;
+      int totalMaxBitrateBps = 0;
+
+      {
+        AutoLock lock(mLock);
+
+        for (auto iter = mChannels.begin(); iter != mChannels.end(); ++iter) {
+          auto &info = (*iter).second;
+          if (0 == info.mMaxBitrateBps) continue;
+
+          totalMinBitrateBps += info.mMinBitrateBps;
+          totalStartBitrateBps += info.mStartBitrateBps;
+          totalMaxBitrateBps += info.mMaxBitrateBps;
+        }
+      }
+
+      if (0 == totalMaxBitrateBps) return;
+
+      mCongestionController->SetBweBitrates(totalMinBitrateBps, totalStartBitrateBps, totalMaxBitrateBps);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngineCongestionContext::allocateBitrates(
+                                                           uint32_t targetBitrateBps,
+                                                           ChannelAllocationList &ioAllocations
+                                                           )
+    {
+      // NOTE: each sending channel gets its configured minimum (scaled down
+      //       evenly if the estimate cannot cover every minimum) then the
+      //       remainder is split in proportion to each channel's headroom up
+      //       to its configured maximum. Channels without configured bitrates
+      //       (i.e. receivers) are allocated nothing.
+      ULONGLONG totalMinBitrateBps = 0;
+      ULONGLONG totalHeadroomBps = 0;
+
+      for (auto iter = ioAllocations.begin(); iter != ioAllocations.end(); ++iter) {
+        auto &allocation = (*iter);
+        allocation.mAllocatedBitrateBps = 0;
+        if (allocation.mMaxBitrateBps <= 0) continue;
+
+        totalMinBitrateBps += static_cast<ULONGLONG>(std::max(allocation.mMinBitrateBps, 0));
+        totalHeadroomBps += static_cast<ULONGLONG>(std::max(allocation.mMaxBitrateBps - std::max(allocation.mMinBitrateBps, 0), 0));
+      }
+
+      ULONGLONG target = static_cast<ULONGLONG>(targetBitrateBps);
+
+      if (target <= totalMinBitrateBps) {
+        if (0 == totalMinBitrateBps) return;
+
+        for (auto iter = ioAllocations.begin(); iter != ioAllocations.end(); ++iter) {
+          auto &allocation = (*iter);
+          if (allocation.mMaxBitrateBps <= 0) continue;
+
+          ULONGLONG minBitrateBps = static_cast<ULONGLONG>(std::max(allocation.mMinBitrateBps, 0));
+          allocation.mAllocatedBitrateBps = static_cast<uint32_t>((minBitrateBps * target) / totalMinBitrateBps);
+        }
+        return;
+      }
+
+      ULONGLONG remaining = std::min(target - totalMinBitrateBps, totalHeadroomBps);
+
+      for (auto iter = ioAllocations.begin(); iter != ioAllocations.end(); ++iter) {
+        auto &allocation = (*iter);
+        if (allocation.mMaxBitrateBps <= 0) continue;
+
+        ULONGLONG minBitrateBps = static_cast<ULONGLONG>(std::max(allocation.mMinBitrateBps, 0));
+        ULONGLONG headroomBps = static_cast<ULONGLONG>(std::max(allocation.mMaxBitrateBps - std::max(allocation.mMinBitrateBps, 0), 0));
+
+        ULONGLONG extraBps = (0 == totalHeadroomBps ? 0 : (headroomBps * remaining) / totalHeadroomBps);
+        allocation.mAllocatedBitrateBps = static_cast<uint32_t>(minBitrateBps + extraBps);
+      }
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -491,6 +864,12 @@ namespace ortc
       mTraceCallback(new WebRtcTraceCallback()),
       mLogSink(new WebRtcLogSink())
     {
+      mProcessThreadPoolSize = UseSettings::getUInt(ORTC_SETTING_RTP_MEDIA_ENGINE_PROCESS_THREAD_POOL_SIZE);
+      if (0 == mProcessThreadPoolSize) {
+        int numCpuCores = webrtc::CpuInfo::DetectNumberOfCores();
+        mProcessThreadPoolSize = (numCpuCores > 0 ? static_cast<size_t>(numCpuCores) : 1);
+      }
+
       EventWriteOrtcRtpMediaEngineCreate(__func__, mID);
       ZS_LOG_DETAIL(debug("created"))
     }
@@ -512,6 +891,11 @@ namespace ortc
 
       AutoRecursiveLock lock(*this);
 
+      auto rebalanceInterval = UseSettings::getUInt(ORTC_SETTING_RTP_MEDIA_ENGINE_PACKET_QUEUE_REBALANCE_INTERVAL_IN_SECONDS);
+      if (0 != rebalanceInterval) {
+        mPacketQueueRebalanceTimer = Timer::create(mThisWeak.lock(), Seconds(rebalanceInterval));
+      }
+
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
     }
 
@@ -743,6 +1127,7 @@ namespace ortc
     PromiseWithRTPMediaEngineChannelResourcePtr RTPMediaEngine::setupChannel(
                                                                              UseReceiverChannelMediaBasePtr channel,
                                                                              TransportPtr transport,
+                                                                             PUID secureTransportID,
                                                                              UseMediaStreamTrackPtr track,
                                                                              ParametersPtr parameters,
                                                                              RTPPacketPtr packet
@@ -755,6 +1140,7 @@ namespace ortc
       setup->mPromise = PromiseWithRTPMediaEngineChannelResource::create(IORTCForInternal::queueORTC());
       setup->mChannel = channel;
       setup->mTransport = transport;
+      setup->mSecureTransportID = secureTransportID;
       setup->mTrack = track;
       setup->mParameters = parameters;
       setup->mPacket = packet;
@@ -801,6 +1187,7 @@ namespace ortc
     PromiseWithRTPMediaEngineChannelResourcePtr RTPMediaEngine::setupChannel(
                                                                              UseSenderChannelMediaBasePtr channel,
                                                                              TransportPtr transport,
+                                                                             PUID secureTransportID,
                                                                              UseMediaStreamTrackPtr track,
                                                                              ParametersPtr parameters,
                                                                              IDTMFSenderDelegatePtr dtmfDelegate
@@ -811,6 +1198,7 @@ namespace ortc
       setup->mPromise = PromiseWithRTPMediaEngineChannelResource::create(IORTCForInternal::queueORTC());
       setup->mChannel = channel;
       setup->mTransport = transport;
+      setup->mSecureTransportID = secureTransportID;
       setup->mTrack = track;
       setup->mParameters = parameters;
       setup->mDTMFDelegate = dtmfDelegate;
@@ -917,6 +1305,63 @@ namespace ortc
       return mAudioState;
     }
 
+    //-------------------------------------------------------------------------
+    RTPMediaEngineCongestionContextPtr RTPMediaEngine::acquireCongestionContext(PUID secureTransportID)
+    {
+      AutoRecursiveLock lock(*this);
+
+      RTPMediaEngineCongestionContextPtr context;
+
+      if (0 != secureTransportID) {
+        auto found = mCongestionContexts.find(secureTransportID);
+        if (found != mCongestionContexts.end()) {
+          context = (*found).second.lock();
+        }
+      }
+
+      if (!context) {
+        // NOTE: a channel without a known transport (ID 0) is given a private
+        //       context that is never shared with any other channel.
+        context = make_shared<RTPMediaEngineCongestionContext>(secureTransportID, acquireProcessThreads());
+        if (0 != secureTransportID) {
+          mCongestionContexts[secureTransportID] = context;
+        }
+        ZS_LOG_DEBUG(log("created congestion context") + context->toDebug())
+      }
+
+      ++(context->mTotalChannels);
+
+      ZS_LOG_TRACE(log("acquired congestion context") + context->toDebug())
+      return context;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::releaseCongestionContext(RTPMediaEngineCongestionContextPtr context)
+    {
+      if (!context) return;
+
+      AutoRecursiveLock lock(*this);
+
+      if (context->mTotalChannels > 0) --(context->mTotalChannels);
+
+      ZS_LOG_TRACE(log("released congestion context") + context->toDebug())
+
+      if (0 != context->mTotalChannels) return;
+
+      if (0 != context->mSecureTransportID) {
+        auto found = mCongestionContexts.find(context->mSecureTransportID);
+        if (found != mCongestionContexts.end()) {
+          auto existing = (*found).second.lock();
+          if ((!existing) ||
+              (existing == context)) {
+            mCongestionContexts.erase(found);
+          }
+        }
+      }
+
+      releaseProcessThreads(context->mProcessThreads);
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -949,6 +1394,12 @@ namespace ortc
       ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()))
 
       AutoRecursiveLock lock(*this);
+
+      if (timer == mPacketQueueRebalanceTimer) {
+        rebalancePacketQueues();
+        return;
+      }
+
       // NOTE: ADD IF NEEDED...
     }
 
@@ -973,6 +1424,7 @@ namespace ortc
                                                                          setup->mParameters,
                                                                          setup->mDTMFDelegate
                                                                          );
+        resource->setSecureTransportID(setup->mSecureTransportID);
         resource->registerPromise(setup->mPromise);
         mChannelResources[resource->getID()] = resource;
         mPendingSetupChannelResources.push_back(resource);
@@ -983,6 +1435,7 @@ namespace ortc
                                                                          setup->mTrack,
                                                                          setup->mParameters
                                                                          );
+        resource->setSecureTransportID(setup->mSecureTransportID);
         resource->registerPromise(setup->mPromise);
         mChannelResources[resource->getID()] = resource;
         mPendingSetupChannelResources.push_back(resource);
@@ -1004,6 +1457,7 @@ namespace ortc
                                                                                         setup->mParameters,
                                                                                         setup->mPacket
                                                                                         );
+        resource->setSecureTransportID(setup->mSecureTransportID);
         resource->registerPromise(setup->mPromise);
         mChannelResources[resource->getID()] = resource;
         mPendingSetupChannelResources.push_back(resource);
@@ -1015,6 +1469,7 @@ namespace ortc
                                                                                         setup->mParameters,
                                                                                         setup->mPacket
                                                                                         );
+        resource->setSecureTransportID(setup->mSecureTransportID);
         resource->registerPromise(setup->mPromise);
         mChannelResources[resource->getID()] = resource;
         mPendingSetupChannelResources.push_back(resource);
@@ -1161,6 +1616,31 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "pending setup channel resources", mPendingSetupChannelResources.size());
       UseServicesHelper::debugAppend(resultEl, "pending close channel resources", mPendingCloseChannelResources.size());
 
+      UseServicesHelper::debugAppend(resultEl, "congestion contexts", mCongestionContexts.size());
+
+      UseServicesHelper::debugAppend(resultEl, "packet queue rebalance timer", mPacketQueueRebalanceTimer ? mPacketQueueRebalanceTimer->getID() : 0);
+      {
+        auto queues = IORTCForInternal::packetQueues();
+        if (queues.size() > 0) {
+          ElementPtr queuesEl = Element::create("packet queues");
+          for (auto iter = queues.begin(); iter != queues.end(); ++iter) {
+            auto &queue = (*iter);
+            UseServicesHelper::debugAppend(queuesEl, queue->toDebug());
+          }
+          UseServicesHelper::debugAppend(resultEl, queuesEl);
+        }
+      }
+
+      UseServicesHelper::debugAppend(resultEl, "process thread pool size", mProcessThreadPoolSize);
+      if (mProcessThreadPool.size() > 0) {
+        ElementPtr poolEl = Element::create("process thread pool");
+        for (auto iter = mProcessThreadPool.begin(); iter != mProcessThreadPool.end(); ++iter) {
+          auto &threads = (*iter);
+          UseServicesHelper::debugAppend(poolEl, threads->toDebug());
+        }
+        UseServicesHelper::debugAppend(resultEl, poolEl);
+      }
+
       return resultEl;
     }
 
@@ -1441,6 +1921,18 @@ namespace ortc
         }
       }
 
+      // NOTE: channel resources still alive hold their own reference to their
+      //       congestion context (and its process threads); those are
+      //       stopped when released.
+      mCongestionContexts.clear();
+      mProcessThreadPool.clear();
+
+      if (mPacketQueueRebalanceTimer) {
+        mPacketQueueRebalanceTimer->cancel();
+        mPacketQueueRebalanceTimer.reset();
+      }
+      mPacketQueueSamples.clear();
+
       // make sure to cleanup any final reference to self
       mGracefulShutdownReference.reset();
     }
@@ -1518,6 +2010,129 @@ namespace ortc
       ZS_LOG_WARNING(Detail, debug("error set") + ZS_PARAM("error", mLastError) + ZS_PARAM("reason", mLastErrorReason))
     }
 
+    //-------------------------------------------------------------------------
+    RTPMediaEngineProcessThreadsPtr RTPMediaEngine::acquireProcessThreads()
+    {
+      AutoRecursiveLock lock(*this);
+
+      RTPMediaEngineProcessThreadsPtr leastLoaded;
+
+      for (auto iter = mProcessThreadPool.begin(); iter != mProcessThreadPool.end(); ++iter) {
+        auto &threads = (*iter);
+        if (!leastLoaded) {
+          leastLoaded = threads;
+          continue;
+        }
+        if (threads->mTotalUsers < leastLoaded->mTotalUsers) leastLoaded = threads;
+      }
+
+      // NOTE: threads are only added to the pool once every existing pair is
+      //       in use (and the pool is not yet full) so a handful of contexts
+      //       does not spin up a pair of threads per core.
+      if ((!leastLoaded) ||
+          ((0 != leastLoaded->mTotalUsers) &&
+           (mProcessThreadPool.size() < mProcessThreadPoolSize))) {
+        leastLoaded = make_shared<RTPMediaEngineProcessThreads>(mProcessThreadPool.size());
+        mProcessThreadPool.push_back(leastLoaded);
+        ZS_LOG_DEBUG(log("created process threads") + ZS_PARAM("index", leastLoaded->mIndex) + ZS_PARAM("pool size", mProcessThreadPoolSize))
+      }
+
+      ++(leastLoaded->mTotalUsers);
+
+      ZS_LOG_TRACE(log("acquired process threads") + leastLoaded->toDebug())
+      return leastLoaded;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::releaseProcessThreads(RTPMediaEngineProcessThreadsPtr threads)
+    {
+      if (!threads) return;
+
+      AutoRecursiveLock lock(*this);
+
+      if (threads->mTotalUsers > 0) --(threads->mTotalUsers);
+
+      ZS_LOG_TRACE(log("released process threads") + threads->toDebug())
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::rebalancePacketQueues()
+    {
+      auto queues = IORTCForInternal::packetQueues();
+
+      PacketQueueSampleMap samples;
+      bool hasPreviousSamples = true;
+
+      ORTCPacketQueuePtr hottest;
+      ORTCPacketQueuePtr coldest;
+      ULONGLONG hottestProcessed {};
+      ULONGLONG coldestProcessed {};
+
+      for (auto iter = queues.begin(); iter != queues.end(); ++iter) {
+        auto &queue = (*iter);
+
+        ULONGLONG totalProcessed = queue->mTotalProcessed;
+        samples[queue->mIndex] = totalProcessed;
+
+        auto found = mPacketQueueSamples.find(queue->mIndex);
+        if (found == mPacketQueueSamples.end()) {
+          hasPreviousSamples = false;
+          continue;
+        }
+
+        ULONGLONG processed = totalProcessed - (*found).second;
+
+        if ((!hottest) || (processed > hottestProcessed)) {
+          hottest = queue;
+          hottestProcessed = processed;
+        }
+        if ((!coldest) || (processed < coldestProcessed)) {
+          coldest = queue;
+          coldestProcessed = processed;
+        }
+      }
+
+      mPacketQueueSamples = samples;
+
+      ULONGLONG imbalance = hottestProcessed - coldestProcessed;
+      ULONGLONG target = imbalance / 2;
+
+      ChannelResourcePtr candidate;
+      ULONGLONG candidateDistance {};
+
+      for (auto iter = mChannelResources.begin(); iter != mChannelResources.end(); ++iter) {
+        auto resource = (*iter).second.lock();
+        if (!resource) continue;
+
+        // NOTE: every channel is sampled each interval even if nothing is
+        //       moved so the next interval starts from a fresh baseline.
+        ULONGLONG queued = resource->samplePacketsQueued();
+
+        if (!hasPreviousSamples) continue;
+        if (hottest == coldest) continue;
+        if (0 == queued) continue;
+        if (queued >= imbalance) continue;    // moving would only make the cold queue the hot queue
+        if (resource->getPacketQueue() != hottest) continue;
+
+        ULONGLONG distance = (queued > target ? queued - target : target - queued);
+        if ((candidate) &&
+            (distance >= candidateDistance)) continue;
+
+        candidate = resource;
+        candidateDistance = distance;
+      }
+
+      if (!candidate) return;
+
+      // NOTE: ignore small imbalances to avoid channels bouncing between
+      //       packet threads.
+      if ((hottestProcessed * 2) <= (coldestProcessed * 3)) return;
+
+      ZS_LOG_DEBUG(log("rebalancing packet queues") + ZS_PARAM("channel resource", candidate->getID()) + ZS_PARAM("from", hottest->toDebug()) + ZS_PARAM("to", coldest->toDebug()))
+
+      candidate->migratePacketQueue(coldest);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2456,6 +3071,61 @@ namespace ortc
       }
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::ChannelResource::PacketRing
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    static size_t toPacketRingCapacity(size_t capacity)
+    {
+      size_t result = 1;
+      while (result < capacity) result <<= 1;
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPMediaEngine::ChannelResource::PacketRing::PacketRing(size_t capacity) :
+      mSlots(toPacketRingCapacity(capacity)),
+      mMask(mSlots.size() - 1)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::ChannelResource::PacketRing::isEmpty() const
+    {
+      return mHead == mTail;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::ChannelResource::PacketRing::isFull() const
+    {
+      return (mTail - mHead) > mMask;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::PacketRing::push(QueuedPacket &packet)
+    {
+      // NOTE: caller (the only producer) must have checked isFull() first
+      size_t tail = mTail;
+      mSlots[tail & mMask] = std::move(packet);
+      mTail = tail + 1;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::ChannelResource::PacketRing::pop(QueuedPacket &outPacket)
+    {
+      size_t head = mHead;
+      if (head == mTail) return false;
+
+      outPacket = std::move(mSlots[head & mMask]);
+      mHead = head + 1;
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2470,9 +3140,8 @@ namespace ortc
                                                      IRTPMediaEngineRegistrationPtr registration
                                                      ) : 
       BaseResource(priv, registration, registration ? registration->getRTPEngine() : RTPMediaEnginePtr()),
-      mHandlePacketQueue(IORTCForInternal::queuePacket()),
-      mClock(webrtc::Clock::GetRealTimeClock()),
-      mRemb(mClock)
+      mPacketQueue(IORTCForInternal::packetQueue()),
+      mPacketRing(UseSettings::getUInt(ORTC_SETTING_RTP_MEDIA_ENGINE_CHANNEL_PACKET_RING_SIZE))
     {
     }
 
@@ -2480,6 +3149,14 @@ namespace ortc
     RTPMediaEngine::ChannelResource::~ChannelResource()
     {
       mThisWeak.reset();
+
+      QueuedPacket packet;
+      while (mPacketRing.pop(packet)) {
+        packet.mPacketQueue->notifyDiscarded();
+      }
+
+      if (mPacketQueue) mPacketQueue->notifyUnassigned();
+
       UseEnginePtr engine = getEngine<UseEngine>();
       if (engine) {
         engine->notifyResourceGone(*this);
@@ -2526,22 +3203,130 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPMediaEngine::ChannelResource::notifyTransportState(ISecureTransportTypes::States state)
     {
-      auto pThis = ZS_DYNAMIC_PTR_CAST(ChannelResource, mThisWeak.lock());
-      IRTPMediaEngineChannelResourceAsyncDelegateProxy::create(pThis)->onSecureTransportState(state);
+      auto pThis = ZS_DYNAMIC_PTR_CAST(ChannelResource, mThisWeak.lock());
+      IRTPMediaEngineChannelResourceAsyncDelegateProxy::create(pThis)->onSecureTransportState(state);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::notifyUpdate(ParametersPtr param)
+    {
+      auto pThis = ZS_DYNAMIC_PTR_CAST(ChannelResource, mThisWeak.lock());
+      IRTPMediaEngineChannelResourceAsyncDelegateProxy::create(pThis)->onUpdate(param);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::requestStats(PromiseWithStatsReportPtr promise, const StatsTypeSet &stats)
+    {
+      auto pThis = ZS_DYNAMIC_PTR_CAST(ChannelResource, mThisWeak.lock());
+      IRTPMediaEngineChannelResourceAsyncDelegateProxy::create(pThis)->onProvideStats(promise, stats);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::ChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::onDrainPackets()
+    {
+      size_t maxPackets = mPacketRing.mMask + 1;
+      size_t totalPackets = 0;
+
+      QueuedPacket packet;
+
+      do {
+        while (mPacketRing.pop(packet)) {
+          Microseconds latency = std::chrono::duration_cast<Microseconds>(zsLib::now() - packet.mQueued);
+
+          switch (packet.mType) {
+            case QueuedPacket::Type_RTP:        processRTPPacket(packet.mTimestamp, packet.mBuffer); break;
+            case QueuedPacket::Type_RTCP:       processRTCPPacket(packet.mBuffer); break;
+            case QueuedPacket::Type_VideoFrame: processVideoFrame(packet.mVideoFrame); break;
+          }
+
+          packet.mPacketQueue->notifyProcessed(latency);
+          packet.mBuffer.reset();
+          packet.mVideoFrame.reset();
+
+          ++totalPackets;
+          if (totalPackets >= maxPackets) {
+            // NOTE: yield to other channels sharing this packet thread; the
+            //       drain stays scheduled so ordering is unaffected.
+            postDrainPackets();
+            return;
+          }
+        }
+
+        mDrainScheduled = false;
+
+        // NOTE: a producer may have pushed after the ring was found empty
+        //       but before the drain was unscheduled.
+      } while ((!mPacketRing.isEmpty()) &&
+               (!mDrainScheduled.exchange(true)));
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::ChannelResource => IRTPMediaEngineCongestionContextDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::notifyTargetBitrate(uint32_t targetBitrateBps)
+    {
+      // NOTE: called from the module process thread with this channel's
+      //       share of the transport's estimate; never take the shared
+      //       lock here as the shared lock is held while modules are
+      //       deregistered from that same thread.
+      mCurrentTargetBitrate = targetBitrateBps;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngine::ChannelResource => (friend RTPMediaEngine)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ORTCPacketQueuePtr RTPMediaEngine::ChannelResource::getPacketQueue() const
+    {
+      AutoLock lock(mPacketQueueLock);
+      return mPacketQueue;
     }
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::ChannelResource::notifyUpdate(ParametersPtr param)
+    ULONGLONG RTPMediaEngine::ChannelResource::samplePacketsQueued()
     {
-      auto pThis = ZS_DYNAMIC_PTR_CAST(ChannelResource, mThisWeak.lock());
-      IRTPMediaEngineChannelResourceAsyncDelegateProxy::create(pThis)->onUpdate(param);
+      ULONGLONG totalQueued = mTotalPacketsQueued;
+      ULONGLONG result = totalQueued - mLastSampledPacketsQueued;
+      mLastSampledPacketsQueued = totalQueued;
+      return result;
     }
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::ChannelResource::requestStats(PromiseWithStatsReportPtr promise, const StatsTypeSet &stats)
+    bool RTPMediaEngine::ChannelResource::migratePacketQueue(ORTCPacketQueuePtr queue)
     {
-      auto pThis = ZS_DYNAMIC_PTR_CAST(ChannelResource, mThisWeak.lock());
-      IRTPMediaEngineChannelResourceAsyncDelegateProxy::create(pThis)->onProvideStats(promise, stats);
+      if (!queue) return false;
+
+      AutoLock lock(mPacketQueueLock);
+
+      if (!mPacketQueue) return false;
+      if (queue == mPacketQueue) return false;
+
+      // NOTE: only one drain is ever outstanding and it always empties the
+      //       ring in order; the next drain is simply scheduled on the new
+      //       queue thus packets can never be reordered by the move.
+      queue->notifyAssigned();
+      mPacketQueue->notifyUnassigned();
+      mPacketQueue = queue;
+      return true;
     }
 
     //-------------------------------------------------------------------------
@@ -2567,6 +3352,40 @@ namespace ortc
       mShutdownPromises.clear();
     }
 
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::postRTPPacket(
+                                                        DWORD timestamp,
+                                                        SecureByteBlockPtr buffer
+                                                        )
+    {
+      QueuedPacket packet;
+      packet.mType = QueuedPacket::Type_RTP;
+      packet.mQueued = zsLib::now();
+      packet.mTimestamp = timestamp;
+      packet.mBuffer = buffer;
+      postPacket(packet);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::postRTCPPacket(SecureByteBlockPtr buffer)
+    {
+      QueuedPacket packet;
+      packet.mType = QueuedPacket::Type_RTCP;
+      packet.mQueued = zsLib::now();
+      packet.mBuffer = buffer;
+      postPacket(packet);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::postVideoFrame(VideoFramePtr videoFrame)
+    {
+      QueuedPacket packet;
+      packet.mType = QueuedPacket::Type_VideoFrame;
+      packet.mQueued = zsLib::now();
+      packet.mVideoFrame = videoFrame;
+      postPacket(packet);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2586,6 +3405,89 @@ namespace ortc
       return promise;
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPMediaEngine::ChannelResource::acquireCongestionContext()
+    {
+      auto engine = mMediaEngine.lock();
+      if (!engine) return false;
+
+      mCongestionContext = engine->acquireCongestionContext(mSecureTransportID);
+      if (!mCongestionContext) return false;
+
+      mCongestionContext->registerChannel(mID, ZS_DYNAMIC_PTR_CAST(IRTPMediaEngineCongestionContextDelegate, mThisWeak.lock()));
+
+      mModuleProcessThread = mCongestionContext->mProcessThreads->mModuleProcessThread.get();
+      mPacerThread = mCongestionContext->mProcessThreads->mPacerThread.get();
+      mRemb = &(mCongestionContext->mRemb);
+      mCallStats = mCongestionContext->mCallStats.get();
+      mCongestionController = mCongestionContext->mCongestionController.get();
+      mBitrateAllocator = mCongestionContext->mBitrateAllocator.get();
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::releaseCongestionContext()
+    {
+      if (!mCongestionContext) return;
+
+      mCongestionContext->unregisterChannel(mID);
+
+      auto engine = mMediaEngine.lock();
+      if (engine) {
+        engine->releaseCongestionContext(mCongestionContext);
+      }
+
+      mModuleProcessThread = NULL;
+      mPacerThread = NULL;
+      mRemb = NULL;
+      mCallStats = NULL;
+      mCongestionController = NULL;
+      mBitrateAllocator = NULL;
+      mCongestionContext.reset();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::postPacket(QueuedPacket &packet)
+    {
+      ++mTotalPacketsQueued;
+
+      {
+        AutoLock lock(mPacketQueueLock);
+
+        if (!mPacketQueue) return;
+
+        if (mPacketRing.isFull()) {
+          mPacketQueue->notifyDropped();
+          return;
+        }
+
+        packet.mPacketQueue = mPacketQueue.get();
+        mPacketQueue->notifyQueued();
+        mPacketRing.push(packet);
+      }
+
+      // NOTE: only the first packet of a batch wakes the consumer
+      if (mDrainScheduled.exchange(true)) return;
+
+      postDrainPackets();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPMediaEngine::ChannelResource::postDrainPackets()
+    {
+      auto pThis = ZS_DYNAMIC_PTR_CAST(ChannelResource, mThisWeak.lock());
+
+      AutoLock lock(mPacketQueueLock);
+
+      if ((!pThis) ||
+          (!mPacketQueue)) {
+        mDrainScheduled = false;
+        return;
+      }
+
+      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mPacketQueue->mQueue, pThis)->onDrainPackets();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2626,14 +3528,15 @@ namespace ortc
                                                                                                          RTPPacketPtr packet  
                                                                                                          )
     {
-      auto pThis = make_shared<AudioReceiverChannelResource>(
-                                                             make_private{},
-                                                             registration,
-                                                             transport,
-                                                             track,
-                                                             parameters,
-                                                             packet
-                                                             );
+      auto pThis = allocate_shared<AudioReceiverChannelResource>(
+                                                                 AlignedAllocator<AudioReceiverChannelResource>(),
+                                                                 make_private{},
+                                                                 registration,
+                                                                 transport,
+                                                                 track,
+                                                                 parameters,
+                                                                 packet
+                                                                 );
       pThis->mThisWeak = pThis;
       pThis->init();
       return pThis;
@@ -2784,14 +3687,14 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPMediaEngine::AudioReceiverChannelResource::handlePacket(const RTPPacket &packet)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<AudioReceiverChannelResource>())->onHandleRTPPacket(packet.timestamp(), packet.buffer());
+      postRTPPacket(packet.timestamp(), packet.buffer());
       return true;
     }
 
     //-------------------------------------------------------------------------
     bool RTPMediaEngine::AudioReceiverChannelResource::handlePacket(const RTCPPacket &packet)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<AudioReceiverChannelResource>())->onHandleRTCPPacket(packet.buffer());
+      postRTCPPacket(packet.buffer());
       return true;
     }
 
@@ -2800,11 +3703,14 @@ namespace ortc
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     #pragma mark
-    #pragma mark RTPMediaEngine::AudioReceiverChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
+    #pragma mark RTPMediaEngine::AudioReceiverChannelResource => ChannelResource
     #pragma mark
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::AudioReceiverChannelResource::onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer)
+    void RTPMediaEngine::AudioReceiverChannelResource::processRTPPacket(
+                                                                        DWORD timestamp,
+                                                                        SecureByteBlockPtr buffer
+                                                                        )
     {
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
@@ -2822,7 +3728,7 @@ namespace ortc
     }
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::AudioReceiverChannelResource::onHandleRTCPPacket(SecureByteBlockPtr buffer)
+    void RTPMediaEngine::AudioReceiverChannelResource::processRTCPPacket(SecureByteBlockPtr buffer)
     {
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
       
@@ -2837,38 +3743,6 @@ namespace ortc
       webrtc::VoENetwork::GetInterface(voiceEngine)->ReceivedRTCPPacket(getChannel(), buffer->BytePtr(), buffer->SizeInBytes());
     }
 
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark RTPMediaEngine::AudioReceiverChannelResource => webrtc::BitrateObserver
-    #pragma mark
-
-    //-------------------------------------------------------------------------
-    void RTPMediaEngine::AudioReceiverChannelResource::OnNetworkChanged(uint32_t targetBitrateBps, uint8_t fractionLoss, int64_t rttMs)
-    {
-      AutoRecursiveLock lock(*this);
-
-      mCurrentTargetBitrate = targetBitrateBps;
-
-      uint32_t allocatedBitrateBps = mBitrateAllocator->OnNetworkChanged(
-                                                                         targetBitrateBps,
-                                                                         fractionLoss,
-                                                                         rttMs
-                                                                         );
-
-      int padUpToBitrateBps = 0;
-      uint32_t pacerBitrateBps = std::max(targetBitrateBps, allocatedBitrateBps);
-
-      if (mCongestionController)
-        mCongestionController->UpdatePacerBitrate(
-                                                  targetBitrateBps / 1000,
-                                                  webrtc::PacedSender::kDefaultPaceMultiplier * pacerBitrateBps / 1000,
-                                                  padUpToBitrateBps / 1000
-                                                  );
-    }
-
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -2896,19 +3770,10 @@ namespace ortc
 
       auto audioState = engine->getAudioState();
 
-      mModuleProcessThread = webrtc::ProcessThread::Create("AudioReceiverChannelResourceModuleProcessThread");
-      mPacerThread = webrtc::ProcessThread::Create("AudioReceiverChannelResourcePacerThread");
-
-      mBitrateAllocator = rtc::scoped_ptr<webrtc::BitrateAllocator>(new webrtc::BitrateAllocator());
-      mCallStats = rtc::scoped_ptr<webrtc::CallStats>(new webrtc::CallStats(mClock));
-      mCongestionController =
-        rtc::scoped_ptr<webrtc::CongestionController>(new webrtc::CongestionController(
-                                                                                       mClock,
-                                                                                       this,
-                                                                                       &mRemb
-                                                                                       ));
-
-      mCallStats->RegisterStatsObserver(mCongestionController.get());
+      if (!acquireCongestionContext()) {
+        notifyPromisesReject();
+        return;
+      }
 
       mChannel = webrtc::VoEBase::GetInterface(voiceEngine)->CreateChannel();
 
@@ -3008,16 +3873,10 @@ namespace ortc
       config.receive_transport = mTransport.get();
       config.rtcp_send_transport = mTransport.get();
 
-      mModuleProcessThread->Start();
-      mModuleProcessThread->RegisterModule(mCallStats.get());
-      mModuleProcessThread->RegisterModule(mCongestionController.get());
-      mPacerThread->RegisterModule(mCongestionController->pacer());
-      mPacerThread->RegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
-      mPacerThread->Start();
 
       mReceiveStream = rtc::scoped_ptr<webrtc::AudioReceiveStream>(
         new webrtc::internal::AudioReceiveStream(
-                                                 mCongestionController.get(),
+                                                 mCongestionController,
                                                  config,
                                                  audioState
                                                  ));
@@ -3059,21 +3918,8 @@ namespace ortc
         }
       }
 
-      mPacerThread->Stop();
-      mPacerThread->DeRegisterModule(mCongestionController->pacer());
-      mPacerThread->DeRegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
-      mModuleProcessThread->DeRegisterModule(mCongestionController.get());
-      mModuleProcessThread->DeRegisterModule(mCallStats.get());
-      mModuleProcessThread->Stop();
-
-      mCallStats->DeregisterStatsObserver(mCongestionController.get());
-
       mReceiveStream.reset();
-      mCongestionController.reset();
-      mCallStats.reset();
-      mBitrateAllocator.reset();
-      mModuleProcessThread.reset();
-      mPacerThread.reset();
+      releaseCongestionContext();
 
       notifyPromisesShutdown();
     }
@@ -3153,14 +3999,15 @@ namespace ortc
                                                                                                      IDTMFSenderDelegatePtr dtmfDelegate
                                                                                                      )
     {
-      auto pThis = make_shared<AudioSenderChannelResource>(
-                                                           make_private{},
-                                                           registration,
-                                                           transport,
-                                                           track,
-                                                           parameters,
-                                                           dtmfDelegate
-                                                           );
+      auto pThis = allocate_shared<AudioSenderChannelResource>(
+                                                               AlignedAllocator<AudioSenderChannelResource>(),
+                                                               make_private{},
+                                                               registration,
+                                                               transport,
+                                                               track,
+                                                               parameters,
+                                                               dtmfDelegate
+                                                               );
       pThis->mThisWeak = pThis;
       pThis->init();
       return pThis;
@@ -3341,7 +4188,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPMediaEngine::AudioSenderChannelResource::handlePacket(const RTCPPacket &packet)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<AudioSenderChannelResource>())->onHandleRTCPPacket(packet.buffer());
+      postRTCPPacket(packet.buffer());
       return true;
     }
 
@@ -3390,11 +4237,11 @@ namespace ortc
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     #pragma mark
-    #pragma mark RTPMediaEngine::AudioSenderChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
+    #pragma mark RTPMediaEngine::AudioSenderChannelResource => ChannelResource
     #pragma mark
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::AudioSenderChannelResource::onHandleRTCPPacket(SecureByteBlockPtr buffer)
+    void RTPMediaEngine::AudioSenderChannelResource::processRTCPPacket(SecureByteBlockPtr buffer)
     {
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
@@ -3426,38 +4273,6 @@ namespace ortc
       mDTMFTimer.reset();
     }
 
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark RTPMediaEngine::AudioSenderChannelResource => webrtc::BitrateObserver
-    #pragma mark
-
-    //-------------------------------------------------------------------------
-    void RTPMediaEngine::AudioSenderChannelResource::OnNetworkChanged(uint32_t targetBitrateBps, uint8_t fractionLoss, int64_t rttMs)
-    {
-      AutoRecursiveLock lock(*this);
-
-      mCurrentTargetBitrate = targetBitrateBps;
-
-      uint32_t allocatedBitrateBps = mBitrateAllocator->OnNetworkChanged(
-                                                                         targetBitrateBps,
-                                                                         fractionLoss,
-                                                                         rttMs
-                                                                         );
-
-      int padUpToBitrateBps = 0;
-      uint32_t pacerBitrateBps = std::max(targetBitrateBps, allocatedBitrateBps);
-
-      if (mCongestionController)
-        mCongestionController->UpdatePacerBitrate(
-                                                  targetBitrateBps / 1000,
-                                                  webrtc::PacedSender::kDefaultPaceMultiplier * pacerBitrateBps / 1000,
-                                                  padUpToBitrateBps / 1000
-                                                  );
-    }
-
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -3485,19 +4300,10 @@ namespace ortc
 
       auto audioState = engine->getAudioState();
 
-      mModuleProcessThread = webrtc::ProcessThread::Create("AudioSenderChannelResourceModuleProcessThread");
-      mPacerThread = webrtc::ProcessThread::Create("AudioSenderChannelResourcePacerThread");
-
-      mBitrateAllocator = rtc::scoped_ptr<webrtc::BitrateAllocator>(new webrtc::BitrateAllocator());
-      mCallStats = rtc::scoped_ptr<webrtc::CallStats>(new webrtc::CallStats(mClock));
-      mCongestionController =
-        rtc::scoped_ptr<webrtc::CongestionController>(new webrtc::CongestionController(
-                                                                                       mClock,
-                                                                                       this,
-                                                                                       &mRemb
-                                                                                       ));
-
-      mCallStats->RegisterStatsObserver(mCongestionController.get());
+      if (!acquireCongestionContext()) {
+        notifyPromisesReject();
+        return;
+      }
 
       mChannel = webrtc::VoEBase::GetInterface(voiceEngine)->CreateChannel();
 
@@ -3607,20 +4413,14 @@ namespace ortc
       webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetRTCPStatus(mChannel, true);
       webrtc::VoERTP_RTCP::GetInterface(voiceEngine)->SetRTCP_CNAME(mChannel, mParameters->mRTCP.mCName);
 
-      mCongestionController->SetBweBitrates(10000, 40000, 100000);
+      mCongestionContext->setBweBitrates(mID, 10000, 40000, 100000);
 
-      mModuleProcessThread->Start();
-      mModuleProcessThread->RegisterModule(mCallStats.get());
-      mModuleProcessThread->RegisterModule(mCongestionController.get());
-      mPacerThread->RegisterModule(mCongestionController->pacer());
-      mPacerThread->RegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
-      mPacerThread->Start();
 
       mSendStream = rtc::scoped_ptr<webrtc::AudioSendStream>(
         new webrtc::internal::AudioSendStream(
                                               config,
                                               audioState,
-                                              mCongestionController.get()
+                                              mCongestionController
                                               ));
 
       webrtc::VoENetwork::GetInterface(voiceEngine)->RegisterExternalTransport(mChannel, *mTransport);
@@ -3655,21 +4455,8 @@ namespace ortc
         }
       }
 
-      mPacerThread->Stop();
-      mPacerThread->DeRegisterModule(mCongestionController->pacer());
-      mPacerThread->DeRegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
-      mModuleProcessThread->DeRegisterModule(mCongestionController.get());
-      mModuleProcessThread->DeRegisterModule(mCallStats.get());
-      mModuleProcessThread->Stop();
-
-      mCallStats->DeregisterStatsObserver(mCongestionController.get());
-
       mSendStream.reset();
-      mCongestionController.reset();
-      mCallStats.reset();
-      mBitrateAllocator.reset();
-      mModuleProcessThread.reset();
-      mPacerThread.reset();
+      releaseCongestionContext();
 
       notifyPromisesShutdown();
     }
@@ -3781,14 +4568,15 @@ namespace ortc
                                                                                                          RTPPacketPtr packet
                                                                                                          )
     {
-      auto pThis = make_shared<VideoReceiverChannelResource>(
-                                                             make_private{},
-                                                             registration,
-                                                             transport,
-                                                             track,
-                                                             parameters,
-                                                             packet
-                                                             );
+      auto pThis = allocate_shared<VideoReceiverChannelResource>(
+                                                                 AlignedAllocator<VideoReceiverChannelResource>(),
+                                                                 make_private{},
+                                                                 registration,
+                                                                 transport,
+                                                                 track,
+                                                                 parameters,
+                                                                 packet
+                                                                 );
       pThis->mThisWeak = pThis;
       pThis->init();
       return pThis;
@@ -3939,14 +4727,14 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPMediaEngine::VideoReceiverChannelResource::handlePacket(const RTPPacket &packet)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<VideoReceiverChannelResource>())->onHandleRTPPacket(packet.timestamp(), packet.buffer());
+      postRTPPacket(packet.timestamp(), packet.buffer());
       return true;
     }
 
     //-------------------------------------------------------------------------
     bool RTPMediaEngine::VideoReceiverChannelResource::handlePacket(const RTCPPacket &packet)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<VideoReceiverChannelResource>())->onHandleRTCPPacket(packet.buffer());
+      postRTCPPacket(packet.buffer());
       return true;
     }
 
@@ -3955,11 +4743,14 @@ namespace ortc
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     #pragma mark
-    #pragma mark RTPMediaEngine::VideoReceiverChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
+    #pragma mark RTPMediaEngine::VideoReceiverChannelResource => ChannelResource
     #pragma mark
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::VideoReceiverChannelResource::onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer)
+    void RTPMediaEngine::VideoReceiverChannelResource::processRTPPacket(
+                                                                        DWORD timestamp,
+                                                                        SecureByteBlockPtr buffer
+                                                                        )
     {
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
@@ -3973,7 +4764,7 @@ namespace ortc
     }
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::VideoReceiverChannelResource::onHandleRTCPPacket(SecureByteBlockPtr buffer)
+    void RTPMediaEngine::VideoReceiverChannelResource::processRTCPPacket(SecureByteBlockPtr buffer)
     {
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
@@ -3985,38 +4776,6 @@ namespace ortc
       bool result = stream->DeliverRtcp(buffer->BytePtr(), buffer->SizeInBytes());
     }
 
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark RTPMediaEngine::VideoReceiverChannelResource => webrtc::BitrateObserver
-    #pragma mark
-
-    //-------------------------------------------------------------------------
-    void RTPMediaEngine::VideoReceiverChannelResource::OnNetworkChanged(uint32_t targetBitrateBps, uint8_t fractionLoss, int64_t rttMs)
-    {
-      AutoRecursiveLock lock(*this);
-
-      mCurrentTargetBitrate = targetBitrateBps;
-
-      uint32_t allocatedBitrateBps = mBitrateAllocator->OnNetworkChanged(
-                                                                         targetBitrateBps,
-                                                                         fractionLoss,
-                                                                         rttMs
-                                                                         );
-
-      int padUpToBitrateBps = 0;
-      uint32_t pacerBitrateBps = std::max(targetBitrateBps, allocatedBitrateBps);
-
-      if (mCongestionController)
-        mCongestionController->UpdatePacerBitrate(
-                                                  targetBitrateBps / 1000,
-                                                  webrtc::PacedSender::kDefaultPaceMultiplier * pacerBitrateBps / 1000,
-                                                  padUpToBitrateBps / 1000
-                                                  );
-    }
-
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -4035,22 +4794,13 @@ namespace ortc
         return;
       }
 
-      mModuleProcessThread = webrtc::ProcessThread::Create("VideoReceiverChannelResourceModuleProcessThread");
-      mPacerThread = webrtc::ProcessThread::Create("VideoReceiverChannelResourcePacerThread");
+      if (!acquireCongestionContext()) {
+        notifyPromisesReject();
+        return;
+      }
 
       mReceiverVideoRenderer.setMediaStreamTrack(track);
 
-      mBitrateAllocator = rtc::scoped_ptr<webrtc::BitrateAllocator>(new webrtc::BitrateAllocator());
-      mCallStats = rtc::scoped_ptr<webrtc::CallStats>(new webrtc::CallStats(mClock));
-      mCongestionController =
-        rtc::scoped_ptr<webrtc::CongestionController>(new webrtc::CongestionController(
-                                                                                       mClock,
-                                                                                       this,
-                                                                                       &mRemb
-                                                                                       ));
-
-      mCallStats->RegisterStatsObserver(mCongestionController.get());
-
       int numCpuCores = webrtc::CpuInfo::DetectNumberOfCores();
 
       webrtc::Transport* transport = mTransport.get();
@@ -4204,22 +4954,16 @@ namespace ortc
       config.decoders.push_back(decoder);
       config.renderer = &mReceiverVideoRenderer;
 
-      mModuleProcessThread->Start();
-      mModuleProcessThread->RegisterModule(mCallStats.get());
-      mModuleProcessThread->RegisterModule(mCongestionController.get());
-      mPacerThread->RegisterModule(mCongestionController->pacer());
-      mPacerThread->RegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
-      mPacerThread->Start();
 
       mReceiveStream = rtc::scoped_ptr<webrtc::VideoReceiveStream>(
         new webrtc::internal::VideoReceiveStream(
                                                  numCpuCores,
-                                                 mCongestionController.get(),
+                                                 mCongestionController,
                                                  config,
                                                  NULL,
-                                                 mModuleProcessThread.get(),
-                                                 mCallStats.get(),
-                                                 &mRemb
+                                                 mModuleProcessThread,
+                                                 mCallStats,
+                                                 mRemb
                                                  ));
 
       if (mTransportState == ISecureTransport::State_Connected)
@@ -4245,21 +4989,8 @@ namespace ortc
       if (mReceiveStream && mTransportState == ISecureTransport::State_Connected)
         mReceiveStream->Stop();
 
-      mPacerThread->Stop();
-      mPacerThread->DeRegisterModule(mCongestionController->pacer());
-      mPacerThread->DeRegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
-      mModuleProcessThread->DeRegisterModule(mCongestionController.get());
-      mModuleProcessThread->DeRegisterModule(mCallStats.get());
-      mModuleProcessThread->Stop();
-
-      mCallStats->DeregisterStatsObserver(mCongestionController.get());
-
       mReceiveStream.reset();
-      mCongestionController.reset();
-      mCallStats.reset();
-      mBitrateAllocator.reset();
-      mModuleProcessThread.reset();
-      mPacerThread.reset();
+      releaseCongestionContext();
 
       notifyPromisesShutdown();
     }
@@ -4302,13 +5033,14 @@ namespace ortc
                                                                                                      ParametersPtr parameters
                                                                                                      )
     {
-      auto pThis = make_shared<VideoSenderChannelResource>(
-                                                           make_private{},
-                                                           registration,
-                                                           transport,
-                                                           track,
-                                                           parameters
-                                                           );
+      auto pThis = allocate_shared<VideoSenderChannelResource>(
+                                                               AlignedAllocator<VideoSenderChannelResource>(),
+                                                               make_private{},
+                                                               registration,
+                                                               transport,
+                                                               track,
+                                                               parameters
+                                                               );
       pThis->mThisWeak = pThis;
       pThis->init();
       return pThis;
@@ -4458,14 +5190,14 @@ namespace ortc
     //-------------------------------------------------------------------------
     bool RTPMediaEngine::VideoSenderChannelResource::handlePacket(const RTCPPacket &packet)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<VideoSenderChannelResource>())->onHandleRTCPPacket(packet.buffer());
+      postRTCPPacket(packet.buffer());
       return true;
     }
 
     //-------------------------------------------------------------------------
     void RTPMediaEngine::VideoSenderChannelResource::sendVideoFrame(VideoFramePtr videoFrame)
     {
-      IRTPMediaEngineHandlePacketAsyncDelegateProxy::createUsingQueue(mHandlePacketQueue, getThis<VideoSenderChannelResource>())->onSendVideoFrame(videoFrame);
+      postVideoFrame(videoFrame);
     }
 
     //-------------------------------------------------------------------------
@@ -4473,11 +5205,11 @@ namespace ortc
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     #pragma mark
-    #pragma mark RTPMediaEngine::VideoSenderChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
+    #pragma mark RTPMediaEngine::VideoSenderChannelResource => ChannelResource
     #pragma mark
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::VideoSenderChannelResource::onHandleRTCPPacket(SecureByteBlockPtr buffer)
+    void RTPMediaEngine::VideoSenderChannelResource::processRTCPPacket(SecureByteBlockPtr buffer)
     {
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
@@ -4490,7 +5222,7 @@ namespace ortc
     }
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::VideoSenderChannelResource::onSendVideoFrame(VideoFramePtr videoFrame)
+    void RTPMediaEngine::VideoSenderChannelResource::processVideoFrame(VideoFramePtr videoFrame)
     {
       AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
@@ -4507,33 +5239,20 @@ namespace ortc
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     #pragma mark
-    #pragma mark RTPMediaEngine::VideoSenderChannelResource => webrtc::BitrateObserver
+    #pragma mark RTPMediaEngine::VideoSenderChannelResource => IRTPMediaEngineCongestionContextDelegate
     #pragma mark
 
     //-------------------------------------------------------------------------
-    void RTPMediaEngine::VideoSenderChannelResource::OnNetworkChanged(uint32_t targetBitrateBps, uint8_t fractionLoss, int64_t rttMs)
+    int RTPMediaEngine::VideoSenderChannelResource::getPaddingNeededBps()
     {
-      AutoRecursiveLock lock(*this);
-
-      mCurrentTargetBitrate = targetBitrateBps;
+      AutoIncrementLock incLock(mAccessFromNonLockedMethods);
 
-      uint32_t allocatedBitrateBps = mBitrateAllocator->OnNetworkChanged(
-                                                                         targetBitrateBps,
-                                                                         fractionLoss,
-                                                                         rttMs
-                                                                         );
+      if (mDenyNonLockedAccess) return 0;
 
-      int padUpToBitrateBps = 0;
-      if (mSendStream)
-        padUpToBitrateBps = static_cast<webrtc::internal::VideoSendStream *>(mSendStream.get())->GetPaddingNeededBps();
-      uint32_t pacerBitrateBps = std::max(targetBitrateBps, allocatedBitrateBps);
+      auto stream = mSendStream.get();
+      if (NULL == stream) return 0;
 
-      if (mCongestionController)
-        mCongestionController->UpdatePacerBitrate(
-                                                  targetBitrateBps / 1000,
-                                                  webrtc::PacedSender::kDefaultPaceMultiplier * pacerBitrateBps / 1000,
-                                                  padUpToBitrateBps / 1000
-                                                  );
+      return static_cast<webrtc::internal::VideoSendStream *>(stream)->GetPaddingNeededBps();
     }
 
     //-------------------------------------------------------------------------
@@ -4554,19 +5273,10 @@ namespace ortc
         return;
       }
 
-      mModuleProcessThread = webrtc::ProcessThread::Create("VideoSenderChannelResourceModuleProcessThread");
-      mPacerThread = webrtc::ProcessThread::Create("VideoSenderChannelResourcePacerThread");
-
-      mBitrateAllocator = rtc::scoped_ptr<webrtc::BitrateAllocator>(new webrtc::BitrateAllocator());
-      mCallStats = rtc::scoped_ptr<webrtc::CallStats>(new webrtc::CallStats(mClock));
-      mCongestionController =
-        rtc::scoped_ptr<webrtc::CongestionController>(new webrtc::CongestionController(
-                                                                                       mClock,
-                                                                                       this,
-                                                                                       &mRemb
-                                                                                       ));
-
-      mCallStats->RegisterStatsObserver(mCongestionController.get());
+      if (!acquireCongestionContext()) {
+        notifyPromisesReject();
+        return;
+      }
 
       int numCpuCores = webrtc::CpuInfo::DetectNumberOfCores();
 
@@ -4763,23 +5473,17 @@ namespace ortc
 
       config.rtp.c_name = mParameters->mRTCP.mCName;
 
-      mCongestionController->SetBweBitrates(totalMinBitrate, totalTargetBitrate, totalMaxBitrate);
+      mCongestionContext->setBweBitrates(mID, totalMinBitrate, totalTargetBitrate, totalMaxBitrate);
 
-      mModuleProcessThread->Start();
-      mModuleProcessThread->RegisterModule(mCallStats.get());
-      mModuleProcessThread->RegisterModule(mCongestionController.get());
-      mPacerThread->RegisterModule(mCongestionController->pacer());
-      mPacerThread->RegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
-      mPacerThread->Start();
 
       mSendStream = rtc::scoped_ptr<webrtc::VideoSendStream>(
         new webrtc::internal::VideoSendStream(
                                               numCpuCores,
-                                              mModuleProcessThread.get(),
-                                              mCallStats.get(),
-                                              mCongestionController.get(),
-                                              &mRemb,
-                                              mBitrateAllocator.get(),
+                                              mModuleProcessThread,
+                                              mCallStats,
+                                              mCongestionController,
+                                              mRemb,
+                                              mBitrateAllocator,
                                               config,
                                               encoderConfig,
                                               suspendedSSRCs
@@ -4808,21 +5512,8 @@ namespace ortc
       if (mSendStream && mTransportState == ISecureTransport::State_Connected)
         mSendStream->Stop();
 
-      mPacerThread->Stop();
-      mPacerThread->DeRegisterModule(mCongestionController->pacer());
-      mPacerThread->DeRegisterModule(mCongestionController->GetRemoteBitrateEstimator(true));
-      mModuleProcessThread->DeRegisterModule(mCongestionController.get());
-      mModuleProcessThread->DeRegisterModule(mCallStats.get());
-      mModuleProcessThread->Stop();
-
-      mCallStats->DeregisterStatsObserver(mCongestionController.get());
-
       mSendStream.reset();
-      mCongestionController.reset();
-      mCallStats.reset();
-      mBitrateAllocator.reset();
-      mModuleProcessThread.reset();
-      mPacerThread.reset();
+      releaseCongestionContext();
 
       notifyPromisesShutdown();
     }
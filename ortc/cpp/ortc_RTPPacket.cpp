@@ -35,6 +35,7 @@
 #include <ortc/internal/platform.h>
 
 #include <openpeer/services/IHelper.h>
+#include <openpeer/services/ISettings.h>
 
 //#include <openpeer/services/IHTTP.h>
 //
@@ -44,6 +45,8 @@
 
 #include <cryptopp/integer.h>
 
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 
 #ifdef _DEBUG
@@ -65,11 +68,15 @@
 #define RTP_GET_BITS(xByte, xBitPattern, xLowestBit) (((xByte) >> (xLowestBit)) & (xBitPattern))
 #define RTP_PACK_BITS(xByte, xBitPattern, xLowestBit) (((xByte) & (xBitPattern)) << (xLowestBit))
 
+#define ORTC_RTPPACKET_POOL_SHARDS (16)
+#define ORTC_RTPPACKET_MAX_INPLACE_HEADER_EXTENSION_SIZE (256)
+
 namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_rtp_rtcp_packet) }
 
 namespace ortc
 {
   ZS_DECLARE_TYPEDEF_PTR(openpeer::services::IHelper, UseServicesHelper)
+  ZS_DECLARE_TYPEDEF_PTR(openpeer::services::ISettings, UseSettings)
 //  ZS_DECLARE_TYPEDEF_PTR(openpeer::services::IHTTP, UseHTTP)
 //
 //  typedef openpeer::services::Hasher<CryptoPP::SHA1> SHA1Hasher;
@@ -91,6 +98,145 @@ namespace ortc
     static const size_t kMinRtpPacketLen = 12;
     static const BYTE kRtpVersion = 2;
 
+    //-------------------------------------------------------------------------
+    static size_t getThreadPoolShard()
+    {
+      static std::atomic<size_t> nextShard {};
+      static thread_local size_t shard = ((nextShard++) % ORTC_RTPPACKET_POOL_SHARDS);
+      return shard;
+    }
+
+    //-------------------------------------------------------------------------
+    // Every pooled block is prefixed with the shard of the thread that
+    // allocated it. Released blocks always go back to that shard thus a
+    // packet created on the socket thread and released on a media thread
+    // is recycled by the socket thread again (rather than migrating to the
+    // releasing thread and forcing the socket thread back to the heap).
+    // Each shard has its own lock which is only contended by its owning
+    // thread(s) and threads releasing blocks it handed out.
+    template <size_t blockSize>
+    class RTPPacketBlockPool
+    {
+    protected:
+      struct alignas(std::max_align_t) BlockHeader
+      {
+        size_t mShard {};
+      };
+
+      struct Shard
+      {
+        Lock mLock;
+        std::vector<BlockHeader *> mBlocks;
+      };
+
+    public:
+      static RTPPacketBlockPool &singleton()
+      {
+        // NOTE: intentionally never destroyed as blocks can be released
+        //       during thread exit or static destruction
+        static RTPPacketBlockPool *pool = new RTPPacketBlockPool;
+        return *pool;
+      }
+
+      void *allocate()
+      {
+        size_t shardIndex = getThreadPoolShard();
+        Shard &shard = mShards[shardIndex];
+
+        BlockHeader *header {};
+
+        {
+          AutoLock lock(shard.mLock);
+          if (shard.mBlocks.size() > 0) {
+            header = shard.mBlocks.back();
+            shard.mBlocks.pop_back();
+          }
+        }
+
+        if (!header) {
+          header = new (::operator new(sizeof(BlockHeader) + blockSize)) BlockHeader;
+          header->mShard = shardIndex;
+        }
+
+        return static_cast<void *>(header + 1);
+      }
+
+      void deallocate(void *block)
+      {
+        BlockHeader *header = (static_cast<BlockHeader *>(block) - 1);
+        Shard &shard = mShards[header->mShard];
+
+        {
+          AutoLock lock(shard.mLock);
+          if (shard.mBlocks.size() < mMaxBlocksPerShard) {
+            shard.mBlocks.push_back(header);
+            return;
+          }
+        }
+
+        ::operator delete(static_cast<void *>(header));
+      }
+
+    protected:
+      RTPPacketBlockPool() :
+        mMaxBlocksPerShard(UseSettings::getUInt(ORTC_SETTING_RTP_PACKET_MAX_POOLED_PACKETS_PER_SHARD))
+      {}
+
+    protected:
+      Shard mShards[ORTC_RTPPACKET_POOL_SHARDS];
+      size_t mMaxBlocksPerShard {};
+    };
+
+    //-------------------------------------------------------------------------
+    // Recycles the combined shared pointer control block and RTPPacket
+    // allocation through the sharded block pool (see RTPPacketBlockPool).
+    template <typename T>
+    class RTPPacketAllocator
+    {
+    public:
+      typedef T value_type;
+
+      RTPPacketAllocator() {}
+      template <typename U> RTPPacketAllocator(const RTPPacketAllocator<U> &) {}
+
+      T *allocate(size_t total)
+      {
+        if (1 == total) return static_cast<T *>(RTPPacketBlockPool<sizeof(T)>::singleton().allocate());
+        return static_cast<T *>(::operator new(total * sizeof(T)));
+      }
+
+      void deallocate(T *block, size_t total)
+      {
+        if (1 == total) {
+          RTPPacketBlockPool<sizeof(T)>::singleton().deallocate(block);
+          return;
+        }
+        ::operator delete(block);
+      }
+
+      template <typename U> bool operator==(const RTPPacketAllocator<U> &) const {return true;}
+      template <typename U> bool operator!=(const RTPPacketAllocator<U> &) const {return false;}
+    };
+
+    //-------------------------------------------------------------------------
+    static RTPBufferPoolPtr getPacketBufferPool()
+    {
+      static thread_local bool destroyed {false};  // trivial thus still valid during thread exit
+
+      struct Holder
+      {
+        RTPBufferPoolPtr mPool;
+
+        Holder() : mPool(RTPBufferPool::create(UseSettings::getUInt(ORTC_SETTING_RTP_PACKET_POOLED_BUFFER_CAPACITY_IN_BYTES), UseSettings::getUInt(ORTC_SETTING_RTP_PACKET_MAX_POOLED_BUFFERS_PER_THREAD))) {}
+        ~Holder() {destroyed = true;}
+      };
+
+      if (destroyed) return RTPBufferPoolPtr();
+
+      static thread_local Holder holder;
+      return holder.mPool;
+    }
+
     //-------------------------------------------------------------------------
     static bool requiredExtension(
                                   RTPPacket::HeaderExtension *firstExtension,
@@ -132,6 +278,23 @@ namespace ortc
       }
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPPacketForSettings
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void IRTPPacketForSettings::applyDefaults()
+    {
+      // NOTE: the pools read these values when first used
+      UseSettings::setUInt(ORTC_SETTING_RTP_PACKET_MAX_POOLED_PACKETS_PER_SHARD, 256);
+      UseSettings::setUInt(ORTC_SETTING_RTP_PACKET_MAX_POOLED_BUFFERS_PER_THREAD, 256);
+      UseSettings::setUInt(ORTC_SETTING_RTP_PACKET_POOLED_BUFFER_CAPACITY_IN_BYTES, 1500);
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -687,16 +850,14 @@ namespace ortc
     //-------------------------------------------------------------------------
     RTPPacket::~RTPPacket()
     {
-      if (mHeaderExtensions) {
-        delete [] mHeaderExtensions;
-        mHeaderExtensions = NULL;
-      }
+      freeHeaderExtensions(mHeaderExtensions);
+      mHeaderExtensions = NULL;
     }
 
     //-------------------------------------------------------------------------
     RTPPacketPtr RTPPacket::create(const RTPPacket &packet)
     {
-      RTPPacketPtr pThis(make_shared<RTPPacket>(make_private{}));
+      RTPPacketPtr pThis(allocate());
       pThis->generate(packet);
       return pThis;
     }
@@ -704,7 +865,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     RTPPacketPtr RTPPacket::create(const CreationParams &params)
     {
-      RTPPacketPtr pThis(make_shared<RTPPacket>(make_private{}));
+      RTPPacketPtr pThis(allocate());
       pThis->generate(params);
       return pThis;
     }
@@ -714,7 +875,30 @@ namespace ortc
     {
       ORTC_THROW_INVALID_PARAMETERS_IF(!buffer)
       ORTC_THROW_INVALID_PARAMETERS_IF(0 == bufferLengthInBytes)
-      return RTPPacket::create(UseServicesHelper::convertToBuffer(buffer, bufferLengthInBytes));
+
+      SecureByteBlockPtr packetBuffer = allocateBuffer(bufferLengthInBytes);
+      memcpy(packetBuffer->BytePtr(), buffer, bufferLengthInBytes);
+
+      return RTPPacket::create(packetBuffer);
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketPtr RTPPacket::create(
+                                   const BYTE *buffer,
+                                   size_t bufferLengthInBytes,
+                                   size_t reserveHeadroomInBytes
+                                   )
+    {
+      ORTC_THROW_INVALID_PARAMETERS_IF(!buffer)
+      ORTC_THROW_INVALID_PARAMETERS_IF(0 == bufferLengthInBytes)
+
+      size_t capacity = 0;
+      SecureByteBlockPtr packetBuffer = allocateBuffer(bufferLengthInBytes, reserveHeadroomInBytes, capacity);
+      memcpy(packetBuffer->BytePtr(), buffer, bufferLengthInBytes);
+
+      RTPPacketPtr pThis = RTPPacket::create(packetBuffer);
+      if (pThis) pThis->mBufferCapacity = capacity;
+      return pThis;
     }
 
     //-------------------------------------------------------------------------
@@ -726,7 +910,7 @@ namespace ortc
     //-------------------------------------------------------------------------
     RTPPacketPtr RTPPacket::create(SecureByteBlockPtr buffer)
     {
-      RTPPacketPtr pThis(make_shared<RTPPacket>(make_private{}));
+      RTPPacketPtr pThis(allocate());
       pThis->mBuffer = buffer;
       if (!pThis->parse()) {
         ZS_LOG_WARNING(Debug, pThis->log("packet could not be parsed"))
@@ -816,6 +1000,20 @@ namespace ortc
       return objectEl;
     }
 
+    //-------------------------------------------------------------------------
+    static void validateHeaderExtensions(RTPPacket::HeaderExtension *firstExtension)
+    {
+      typedef RTPPacket::HeaderExtension HeaderExtension;
+
+      // NOTE: even the two byte header format (RFC5285 4.3) cannot express
+      //       an ID of 0 or more than 255 bytes of element data
+      for (HeaderExtension *current = firstExtension; NULL != current; current = current->mNext) {
+        ORTC_THROW_INVALID_PARAMETERS_IF(0 == current->mID)
+        ORTC_THROW_INVALID_PARAMETERS_IF(current->mDataSizeInBytes > 0xFF)
+        ORTC_THROW_INVALID_PARAMETERS_IF((NULL == current->mData) && (0 != current->mDataSizeInBytes))
+      }
+    }
+
     //-------------------------------------------------------------------------
     static bool requiresTwoByteHeader(
                                       RTPPacket::HeaderExtension *firstExtension,
@@ -824,11 +1022,11 @@ namespace ortc
     {
       typedef RTPPacket::HeaderExtension HeaderExtension;
 
+      validateHeaderExtensions(firstExtension);
+
       bool twoByteHeader = (0 != headerExtensionAppBits);
       if (!twoByteHeader) {
         for (HeaderExtension *current = firstExtension; NULL != current; current = current->mNext) {
-          ASSERT(0 != current->mID) // not legal
-
           if (current->mID > 14) {
             twoByteHeader = true;
             break;
@@ -838,7 +1036,6 @@ namespace ortc
             break;
           }
           if (current->mDataSizeInBytes > 16) {
-            ASSERT(current->mDataSizeInBytes < 255)
             twoByteHeader = true;
             break;
           }
@@ -879,7 +1076,7 @@ namespace ortc
 
         size_t newSize = mHeaderSize + postHeaderExtensionSize;
 
-        SecureByteBlockPtr tempBuffer(make_shared<SecureByteBlock>(newSize));
+        SecureByteBlockPtr tempBuffer(allocateBuffer(newSize));
 
         BYTE *newBuffer = tempBuffer->BytePtr();
 
@@ -893,14 +1090,13 @@ namespace ortc
         newBuffer[0] = newBuffer[0] & (0xFF ^ RTP_HEADER_EXTENSION_BIT);
 
         mBuffer = tempBuffer;
+        mBufferCapacity = 0;
 
         mHeaderExtensionSize = 0;
 
         mTotalHeaderExtensions = 0;
-        if (mHeaderExtensions) {
-          delete [] mHeaderExtensions;
-          mHeaderExtensions = NULL;
-        }
+        freeHeaderExtensions(mHeaderExtensions);
+        mHeaderExtensions = NULL;
         mHeaderExtensionAppBits = 0;
         mHeaderExtensionPrepaddedSize = 0;
         mHeaderExtensionParseStoppedPos = NULL;
@@ -918,7 +1114,8 @@ namespace ortc
 
       SecureByteBlockPtr oldBuffer = mBuffer; // temporary to keep previous allocation alive during swap
 
-      mBuffer = make_shared<SecureByteBlock>(newSize);
+      mBuffer = allocateBuffer(newSize);
+      mBufferCapacity = 0;
 
       BYTE *newBuffer = mBuffer->BytePtr();
 
@@ -933,6 +1130,125 @@ namespace ortc
       ZS_LOG_INSANE(debug("header extension changed"))
     }
 
+    //-------------------------------------------------------------------------
+    void RTPPacket::insertHeaderExtensions(HeaderExtension *firstExtension)
+    {
+      if (NULL == firstExtension) return;
+
+      validateHeaderExtensions(firstExtension);   // before anything is allocated
+
+      size_t totalInserted = 0;
+      for (HeaderExtension *current = firstExtension; NULL != current; current = current->mNext) {
+        ++totalInserted;
+      }
+
+      size_t totalMerged = mTotalHeaderExtensions + totalInserted;
+
+      HeaderExtension inlineMerged[ORTC_RTPPACKET_MAX_INLINE_HEADER_EXTENSIONS] {};
+      HeaderExtension *merged = (totalMerged > ORTC_RTPPACKET_MAX_INLINE_HEADER_EXTENSIONS ? new HeaderExtension[totalMerged] {} : &(inlineMerged[0]));
+
+      size_t index = 0;
+
+      // existing extensions keep their order (replaced by any inserted
+      // extension having the same ID)
+      for (HeaderExtension *existing = mHeaderExtensions; NULL != existing; existing = existing->mNext, ++index) {
+        HeaderExtension *source = existing;
+        for (HeaderExtension *current = firstExtension; NULL != current; current = current->mNext) {
+          if (current->mID == existing->mID) {
+            source = current;
+            break;
+          }
+        }
+        merged[index].mID = source->mID;
+        merged[index].mData = source->mData;
+        merged[index].mDataSizeInBytes = source->mDataSizeInBytes;
+        merged[index].mPostPaddingSize = (source == existing ? existing->mPostPaddingSize : 0);
+      }
+
+      // any inserted extensions not replacing an existing extension follow
+      for (HeaderExtension *current = firstExtension; NULL != current; current = current->mNext) {
+        bool found = false;
+        for (HeaderExtension *existing = mHeaderExtensions; NULL != existing; existing = existing->mNext) {
+          if (current->mID == existing->mID) {
+            found = true;
+            break;
+          }
+        }
+        if (found) continue;
+
+        merged[index].mID = current->mID;
+        merged[index].mData = current->mData;
+        merged[index].mDataSizeInBytes = current->mDataSizeInBytes;
+        ++index;
+      }
+
+      for (size_t loop = 1; loop < index; ++loop) {
+        merged[loop-1].mNext = &(merged[loop]);
+      }
+
+      bool twoByteHeader = requiresTwoByteHeader(merged, mHeaderExtensionAppBits);
+      if (twoByteHeader) {
+        ORTC_THROW_INVALID_STATE_IF(NULL != mHeaderExtensionParseStoppedPos)  // requires a 1 byte header to append this data
+      }
+
+      size_t existingHeaderExtensionSize = mHeaderExtensionSize;
+      size_t postHeaderExtensionSize = mPayloadSize + mPadding;
+
+      size_t newHeaderExtensionSize = 0;
+      size_t newTotalHeaderExtensions = 0;
+      getHeaderExtensionSize(merged, twoByteHeader, mHeaderExtensionPrepaddedSize, mHeaderExtensionParseStoppedSize, newHeaderExtensionSize, newTotalHeaderExtensions);
+
+      size_t newSize = mHeaderSize + newHeaderExtensionSize + postHeaderExtensionSize;
+
+      if ((newSize > mBufferCapacity) ||
+          (existingHeaderExtensionSize > ORTC_RTPPACKET_MAX_INPLACE_HEADER_EXTENSION_SIZE)) {
+        ZS_LOG_INSANE(log("insufficient headroom to insert header extensions in place") + ZS_PARAM("new size", newSize) + ZS_PARAM("capacity", mBufferCapacity))
+        changeHeaderExtensions(merged);
+        goto cleanup;
+      }
+
+      {
+        BYTE *buffer = mBuffer->BytePtr();
+        BYTE *existingProfilePos = &(buffer[mHeaderSize]);
+
+        // the existing extension data is about to be overwritten thus
+        // preserve a copy and re-point the existing extensions at the copy
+        BYTE existingHeaderExtension[ORTC_RTPPACKET_MAX_INPLACE_HEADER_EXTENSION_SIZE];
+        if (0 != existingHeaderExtensionSize) {
+          memcpy(&(existingHeaderExtension[0]), existingProfilePos, existingHeaderExtensionSize);
+        }
+
+        for (size_t loop = 0; loop < index; ++loop) {
+          const BYTE *data = merged[loop].mData;
+          if ((data >= existingProfilePos) &&
+              (data < existingProfilePos + existingHeaderExtensionSize)) {
+            merged[loop].mData = &(existingHeaderExtension[data - existingProfilePos]);
+          }
+        }
+        if (NULL != mHeaderExtensionParseStoppedPos) {
+          mHeaderExtensionParseStoppedPos = &(existingHeaderExtension[mHeaderExtensionParseStoppedPos - existingProfilePos]);
+        }
+
+        if (0 != postHeaderExtensionSize) {
+          memmove(&(buffer[mHeaderSize + newHeaderExtensionSize]), &(buffer[mHeaderSize + existingHeaderExtensionSize]), postHeaderExtensionSize);
+        }
+
+        RTPBufferPool::resize(mBuffer, newSize);
+
+        mHeaderExtensionSize = newHeaderExtensionSize;
+        mTotalHeaderExtensions = newTotalHeaderExtensions;
+
+        writeHeaderExtensions(merged, twoByteHeader);
+      }
+
+      ZS_LOG_INSANE(debug("header extensions inserted in place"))
+
+    cleanup:
+      {
+        if (merged != &(inlineMerged[0])) delete [] merged;
+      }
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -961,6 +1277,65 @@ namespace ortc
       return Log::Params(message, toDebug());
     }
 
+    //-------------------------------------------------------------------------
+    RTPPacketPtr RTPPacket::allocate()
+    {
+      return std::allocate_shared<RTPPacket>(RTPPacketAllocator<RTPPacket>(), make_private{});
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTPPacket::allocateBuffer(size_t sizeInBytes)
+    {
+      auto pool = getPacketBufferPool();
+      if (!pool) return make_shared<SecureByteBlock>(sizeInBytes);
+      return pool->obtain(sizeInBytes);
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTPPacket::allocateBuffer(
+                                                 size_t sizeInBytes,
+                                                 size_t reserveHeadroomInBytes,
+                                                 size_t &outCapacityInBytes
+                                                 )
+    {
+      outCapacityInBytes = 0;
+
+      auto pool = getPacketBufferPool();
+      if (!pool) return make_shared<SecureByteBlock>(sizeInBytes);
+
+      size_t capacity = sizeInBytes + reserveHeadroomInBytes;
+      if (capacity < pool->bufferCapacity()) capacity = pool->bufferCapacity();
+
+      SecureByteBlockPtr buffer = pool->obtain(capacity);
+      RTPBufferPool::resize(buffer, sizeInBytes);
+
+      outCapacityInBytes = capacity;
+      return buffer;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacket::HeaderExtension *RTPPacket::allocateHeaderExtensions(size_t totalExtensions)
+    {
+      if (totalExtensions > ORTC_RTPPACKET_MAX_INLINE_HEADER_EXTENSIONS) return new HeaderExtension[totalExtensions] {};
+
+      // never hand out the bank currently in use since the extensions being
+      // written might be sourced from it
+      HeaderExtension *bank = (mHeaderExtensions == &(mInlineHeaderExtensions[0][0]) ? &(mInlineHeaderExtensions[1][0]) : &(mInlineHeaderExtensions[0][0]));
+      for (size_t index = 0; index < totalExtensions; ++index) {
+        bank[index] = HeaderExtension {};
+      }
+      return bank;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPPacket::freeHeaderExtensions(HeaderExtension *extensions)
+    {
+      if (NULL == extensions) return;
+      if (extensions == &(mInlineHeaderExtensions[0][0])) return;
+      if (extensions == &(mInlineHeaderExtensions[1][0])) return;
+      delete [] extensions;
+    }
+
     //-------------------------------------------------------------------------
     bool RTPPacket::parse()
     {
@@ -1057,16 +1432,83 @@ namespace ortc
 
       const BYTE *pos = &(profilePos[4]);
 
-      size_t totalPossibleHeaderExtensions = (remaining / sizeof(WORD)) + ((0 != (remaining % sizeof(WORD))) ? 1 : 0);
+      // NOTE: counting first keeps typical packets within the inline
+      //       extension bank (sizing from the remaining bytes would assume
+      //       an extension every two bytes and overflow to the heap)
+      size_t totalHeaderExtensions {};
+      if (!countHeaderExtensions(pos, remaining, oneByte, totalHeaderExtensions)) return false;
+
+      if (0 != totalHeaderExtensions) {
+        mHeaderExtensions = allocateHeaderExtensions(totalHeaderExtensions);
+      }
 
-      mHeaderExtensions = new HeaderExtension[totalPossibleHeaderExtensions] {};
+      if (!parseHeaderExtensions(pos, remaining, oneByte, mHeaderExtensions, totalHeaderExtensions, mTotalHeaderExtensions, mHeaderExtensionPrepaddedSize, mHeaderExtensionParseStoppedPos, mHeaderExtensionParseStoppedSize)) return false;
 
-      size_t totalFound = 0;
+      ZS_LOG_INSANE(debug("parsed"))
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPPacket::countHeaderExtensions(
+                                          const BYTE *pos,
+                                          size_t remaining,
+                                          bool oneByte,
+                                          size_t &outTotalExtensions
+                                          )
+    {
+      // NOTE: follows the same rules as parseHeaderExtensions but only
+      //       validates and counts the elements
+      outTotalExtensions = 0;
+
+      while (remaining > 0) {
+        if (0 == pos[0]) {
+          ++pos;
+          --remaining;
+          continue;
+        }
+
+        size_t elementSize {};
+
+        if (oneByte) {
+          if (0xF == ((pos[0] & 0xF0) >> 4)) break;
+          elementSize = 1 + static_cast<size_t>((pos[0] & 0x0F) + 1);
+        } else {
+          if (remaining < sizeof(WORD)) {
+            ZS_LOG_WARNING(Trace, slog("extension header is not valid") + ZS_PARAM("remaining", remaining))
+            return false;
+          }
+          elementSize = sizeof(WORD) + static_cast<size_t>(pos[1]);
+        }
+
+        if (remaining < elementSize) {
+          ZS_LOG_WARNING(Trace, slog("extension header is not valid") + ZS_PARAM("remaining", remaining) + ZS_PARAM("element size", elementSize))
+          return false;
+        }
+
+        remaining -= elementSize;
+        pos += elementSize;
+        ++outTotalExtensions;
+      }
+
+      return true;
+    }
 
-      while ((remaining > 0) &&
-             (totalFound < totalPossibleHeaderExtensions)) {
+    //-------------------------------------------------------------------------
+    bool RTPPacket::parseHeaderExtensions(
+                                          const BYTE *pos,
+                                          size_t remaining,
+                                          bool oneByte,
+                                          HeaderExtension *extensions,
+                                          size_t maxExtensions,
+                                          size_t &outTotalExtensions,
+                                          size_t &outPrepaddedSize,
+                                          const BYTE * &outParseStoppedPos,
+                                          size_t &outParseStoppedSize
+                                          )
+    {
+      size_t totalFound = 0;
 
-        HeaderExtension *current = &(mHeaderExtensions[totalFound]);
+      while (remaining > 0) {
 
         if (0 == pos[0]) {
           // see https://tools.ietf.org/html/rfc5285 4.1
@@ -1092,13 +1534,23 @@ namespace ortc
           ++pos;
           --remaining;
           if (0 == totalFound) {
-            ++mHeaderExtensionPrepaddedSize;
+            ++outPrepaddedSize;
           } else {
-            ++(mHeaderExtensions[totalFound-1].mPostPaddingSize);
+            ++(extensions[totalFound-1].mPostPaddingSize);
           }
           continue;
         }
 
+        if (totalFound >= maxExtensions) {
+          // NOTE: the remaining elements are kept as unparsed data (thus
+          //       are preserved when the packet is regenerated)
+          outParseStoppedPos = pos;
+          outParseStoppedSize = remaining;
+          break;
+        }
+
+        HeaderExtension *current = &(extensions[totalFound]);
+
         if (oneByte) {
           BYTE id = ((pos[0] & 0xF0) >> 4);
           if (id == 0xF) {
@@ -1110,8 +1562,8 @@ namespace ortc
             // entire extension should terminate at that point, and only the
             // extension elements present prior to the element with ID 15
             // considered.
-            mHeaderExtensionParseStoppedPos = pos;
-            mHeaderExtensionParseStoppedSize = remaining;
+            outParseStoppedPos = pos;
+            outParseStoppedSize = remaining;
             break;
           }
 
@@ -1126,7 +1578,7 @@ namespace ortc
           size_t length = static_cast<size_t>((pos[0] & 0x0F) + 1);
 
           if (remaining < (1 + length)) {
-            ZS_LOG_WARNING(Trace, log("extension header is not valid") + ZS_PARAM("id", id) + ZS_PARAM("remaining", remaining) + ZS_PARAM("length", length))
+            ZS_LOG_WARNING(Trace, slog("extension header is not valid") + ZS_PARAM("id", id) + ZS_PARAM("remaining", remaining) + ZS_PARAM("length", length))
             return false;
           }
 
@@ -1134,7 +1586,7 @@ namespace ortc
           current->mDataSizeInBytes = length;
           current->mData = &(pos[1]);
           if (0 != totalFound) {
-            mHeaderExtensions[totalFound-1].mNext = current;
+            extensions[totalFound-1].mNext = current;
           }
 
           remaining -= (1 + length);
@@ -1146,7 +1598,7 @@ namespace ortc
         // must be a two byte header format
 
         if (remaining < sizeof(WORD)) {
-          ZS_LOG_WARNING(Trace, log("extension header is not valid") + ZS_PARAM("remaining", remaining))
+          ZS_LOG_WARNING(Trace, slog("extension header is not valid") + ZS_PARAM("remaining", remaining))
           return false;
         }
 
@@ -1154,7 +1606,7 @@ namespace ortc
         size_t length = (pos[1]);
 
         if (remaining < (sizeof(WORD) + length)) {
-          ZS_LOG_WARNING(Trace, log("extension header is not valid") + ZS_PARAM("id", id) + ZS_PARAM("remaining", remaining) + ZS_PARAM("length", length))
+          ZS_LOG_WARNING(Trace, slog("extension header is not valid") + ZS_PARAM("id", id) + ZS_PARAM("remaining", remaining) + ZS_PARAM("length", length))
           return false;
         }
 
@@ -1164,7 +1616,7 @@ namespace ortc
           current->mData = &(pos[2]);
         }
         if (0 != totalFound) {
-          mHeaderExtensions[totalFound-1].mNext = current;
+          extensions[totalFound-1].mNext = current;
         }
 
         remaining -= (2 + length);
@@ -1173,9 +1625,7 @@ namespace ortc
         continue;
       }
 
-      mTotalHeaderExtensions = totalFound;
-      
-      ZS_LOG_INSANE(debug("parsed"))
+      outTotalExtensions = totalFound;
       return true;
     }
     
@@ -1203,6 +1653,10 @@ namespace ortc
 
       BYTE *newProfilePos = &(newBuffer[mHeaderSize]);
 
+      // padding within the extension is skipped over below (and buffers
+      // may be recycled) thus clear the extension area first
+      memset(newProfilePos, 0, mHeaderExtensionSize);
+
       if (twoByteHeader) {
         WORD profileType = (0x100 << 4) | (mHeaderExtensionAppBits & 0xF);
         newProfilePos[0] = static_cast<BYTE>((profileType & 0xFF00) >> 8);
@@ -1220,7 +1674,7 @@ namespace ortc
 
       HeaderExtension *newExtensions = NULL;
       if (0 != mTotalHeaderExtensions) {
-        newExtensions = new HeaderExtension[mTotalHeaderExtensions] {};
+        newExtensions = allocateHeaderExtensions(mTotalHeaderExtensions);
       }
 
       size_t index = 0;
@@ -1263,10 +1717,7 @@ namespace ortc
       ASSERT(index == mTotalHeaderExtensions)
 
       mTotalHeaderExtensions = index;
-      if (NULL != mHeaderExtensions) {
-        delete [] mHeaderExtensions;
-        mHeaderExtensions = NULL;
-      }
+      freeHeaderExtensions(mHeaderExtensions);
       mHeaderExtensions = newExtensions;
     }
 
@@ -1356,7 +1807,7 @@ namespace ortc
 
       size_t newSize = mHeaderSize + mHeaderExtensionSize + postHeaderExtensionSize;
 
-      mBuffer = make_shared<SecureByteBlock>(newSize);
+      mBuffer = allocateBuffer(newSize);
 
       BYTE *newBuffer = mBuffer->BytePtr();
 
@@ -1388,11 +1839,668 @@ namespace ortc
       }
 
       if (0 != mPadding) {
+        memset(&(newBuffer[newSize-mPadding]), 0, mPadding);
         newBuffer[newSize-1] = static_cast<BYTE>(mPadding);
       }
 
       ZS_LOG_INSANE(debug("generated RTP packet"))
     }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPPacketView
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPPacketView::RTPPacketView(
+                                 const BYTE *buffer,
+                                 size_t bufferLengthInBytes
+                                 ) :
+      mBuffer(buffer),
+      mSize(bufferLengthInBytes)
+    {
+      if (NULL == mBuffer) {
+        mSize = 0;
+        return;
+      }
+      mValid = parse();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketView::RTPPacketView(const RTPPacket &packet) :
+      mBuffer(packet.ptr()),
+      mSize(packet.size()),
+      mValid(true),
+      mVersion(packet.mVersion),
+      mCC(packet.mCC),
+      mM(packet.mM),
+      mPT(packet.mPT),
+      mSequenceNumber(packet.mSequenceNumber),
+      mTimestamp(packet.mTimestamp),
+      mSSRC(packet.mSSRC),
+      mHeaderExtensionsParsed(true),
+      mTotalHeaderExtensions(packet.mTotalHeaderExtensions),
+      mFirstHeaderExtension(packet.mHeaderExtensions)
+    {
+      // NOTE: the packet has already decoded its extensions so they are
+      //       referenced directly rather than being decoded a second time.
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketView::~RTPPacketView()
+    {
+      delete [] mOverflowHeaderExtensions;
+      mOverflowHeaderExtensions = NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    DWORD RTPPacketView::getCSRC(size_t index) const
+    {
+      ASSERT(index < cc())
+      return RTPUtils::getBE32(&(mBuffer[kMinRtpPacketLen + (sizeof(DWORD)*index)]));
+    }
+
+    //-------------------------------------------------------------------------
+    size_t RTPPacketView::totalHeaderExtensions() const
+    {
+      parseHeaderExtensionsIfNeeded();
+      return mTotalHeaderExtensions;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketView::HeaderExtension *RTPPacketView::firstHeaderExtension() const
+    {
+      parseHeaderExtensionsIfNeeded();
+      return mFirstHeaderExtension;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketView::HeaderExtension *RTPPacketView::findHeaderExtension(BYTE id) const
+    {
+      indexHeaderExtensionsIfNeeded();
+
+      BYTE index = mHeaderExtensionIndexByID[id];
+      if (0 != index) return &(mFirstHeaderExtension[index-1]);
+
+      if (mTotalHeaderExtensions < 0xFF) return NULL;
+
+      // too many extensions to index (only possible for views of a packet)
+      for (auto current = mFirstHeaderExtension; NULL != current; current = current->mNext) {
+        if (id == current->mID) return current;
+      }
+      return NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPPacketView::toDebug() const
+    {
+      ElementPtr objectEl = Element::create("ortc::RTPPacketView");
+
+      UseServicesHelper::debugAppend(objectEl, "size", mSize);
+      UseServicesHelper::debugAppend(objectEl, "valid", mValid);
+
+      UseServicesHelper::debugAppend(objectEl, "version", mVersion);
+      UseServicesHelper::debugAppend(objectEl, "cc", mCC);
+      UseServicesHelper::debugAppend(objectEl, "m", mM);
+      UseServicesHelper::debugAppend(objectEl, "pt", mPT);
+      UseServicesHelper::debugAppend(objectEl, "sequence number", mSequenceNumber);
+      UseServicesHelper::debugAppend(objectEl, "timestamp", mTimestamp);
+      UseServicesHelper::debugAppend(objectEl, "ssrc", mSSRC);
+
+      UseServicesHelper::debugAppend(objectEl, "one byte header", mOneByteHeader);
+      UseServicesHelper::debugAppend(objectEl, "header extension remaining", mHeaderExtensionRemaining);
+      UseServicesHelper::debugAppend(objectEl, "header extensions parsed", mHeaderExtensionsParsed);
+      UseServicesHelper::debugAppend(objectEl, "counted header extensions", mCountedHeaderExtensions);
+      UseServicesHelper::debugAppend(objectEl, "total header extensions", mTotalHeaderExtensions);
+      UseServicesHelper::debugAppend(objectEl, "overflow header extensions", NULL != mOverflowHeaderExtensions);
+
+      return objectEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPPacketView => (internal)
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    Log::Params RTPPacketView::log(const char *message) const
+    {
+      ElementPtr objectEl = Element::create("ortc::RTPPacketView");
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params RTPPacketView::debug(const char *message) const
+    {
+      return Log::Params(message, toDebug());
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPPacketView::parse()
+    {
+      // NOTE: validates the packet with the same rules as RTPPacket::parse()
+      //       (including every header extension element) so a valid view
+      //       can always be materialized into an RTPPacket; callers rely on
+      //       this to apply routing side effects before materializing.
+
+      if (mSize < kMinRtpPacketLen) {
+        ZS_LOG_WARNING(Trace, log("packet length is too short") + ZS_PARAM("length", mSize))
+        return false;
+      }
+
+      mVersion = RTP_HEADER_VERSION(mBuffer);
+      if (mVersion != kRtpVersion) {
+        ZS_LOG_WARNING(Trace, log("not an RTP packet"))
+        return false;
+      }
+
+      if (RTPUtils::isRTCPPacketType(mBuffer, mSize)) {
+        ZS_LOG_WARNING(Trace, log("packet is RTCP not RTP") + ZS_PARAM("length", mSize))
+        return false;
+      }
+
+      mCC = RTP_HEADER_CC(mBuffer);
+      mM = RTP_HEADER_M(mBuffer);
+      mPT = RTP_HEADER_PT(mBuffer);
+      mSequenceNumber = RTPUtils::getBE16(&(mBuffer[2]));
+      mTimestamp = RTPUtils::getBE32(&(mBuffer[4]));
+      mSSRC = RTPUtils::getBE32(&(mBuffer[8]));
+
+      size_t headerSize = kMinRtpPacketLen + (static_cast<size_t>(mCC) * sizeof(DWORD));
+      size_t headerExtensionSize = 0;
+      size_t padding = 0;
+
+      if (mSize < headerSize) {
+        ZS_LOG_WARNING(Trace, debug("illegal RTP packet"))
+        return false;
+      }
+
+      if (RTP_HEADER_EXTENSION(mBuffer)) {
+        if (mSize < (headerSize + sizeof(DWORD))) {
+          ZS_LOG_WARNING(Trace, debug("illegal RTP packet"))
+          return false;
+        }
+
+        headerExtensionSize = (static_cast<size_t>(RTPUtils::getBE16(&(mBuffer[headerSize + 2]))) * sizeof(DWORD)) + sizeof(DWORD);
+        if (mSize < (headerSize + headerExtensionSize)) {
+          ZS_LOG_WARNING(Trace, debug("illegal RTP packet"))
+          return false;
+        }
+      }
+
+      if (RTP_HEADER_PADDING(mBuffer)) {
+        padding = static_cast<size_t>(mBuffer[mSize-1]);
+        if (0 == padding) {
+          ZS_LOG_WARNING(Trace, debug("illegal RTP packet (no padding size)"))
+          return false;
+        }
+
+        if (mSize < (headerSize + headerExtensionSize + padding)) {
+          ZS_LOG_WARNING(Trace, debug("illegal RTP packet"))
+          return false;
+        }
+      }
+
+      if (0 == headerExtensionSize) {
+        mHeaderExtensionsParsed = true;
+        return true;
+      }
+
+      const BYTE *profilePos = &(mBuffer[headerSize]);
+
+      if ((0xBE == profilePos[0]) &&
+          (0xDE == profilePos[1])) {
+        mOneByteHeader = true;
+      } else {
+        WORD twoByteHeader = RTPUtils::getBE16(profilePos);
+        if (0x100 != ((twoByteHeader & 0xFFF0) >> 4)) {
+          ZS_LOG_WARNING(Trace, log("header extension profile is not understood") + ZS_PARAM("profile", twoByteHeader))
+          return false;
+        }
+      }
+
+      mHeaderExtensionPos = &(profilePos[4]);
+      mHeaderExtensionRemaining = headerExtensionSize - sizeof(DWORD);
+      if (0 == mHeaderExtensionRemaining) {
+        mHeaderExtensionsParsed = true;
+        return true;
+      }
+
+      // NOTE: elements are only validated and counted here (decoding is
+      //       deferred until an extension is actually needed)
+      if (!RTPPacket::countHeaderExtensions(mHeaderExtensionPos, mHeaderExtensionRemaining, mOneByteHeader, mCountedHeaderExtensions)) {
+        ZS_LOG_WARNING(Trace, log("header extensions are not valid"))
+        return false;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPPacketView::parseHeaderExtensionsIfNeeded() const
+    {
+      if (mHeaderExtensionsParsed) return;
+      mHeaderExtensionsParsed = true;
+
+      size_t prepaddedSize = 0;
+      const BYTE *parseStoppedPos = NULL;
+      size_t parseStoppedSize = 0;
+
+      HeaderExtension *extensions = &(mHeaderExtensions[0]);
+      if (mCountedHeaderExtensions > ORTC_RTPPACKET_VIEW_MAX_HEADER_EXTENSIONS) {
+        // NOTE: rare thus the extensions are decoded into a heap array
+        //       rather than silently truncating
+        mOverflowHeaderExtensions = new HeaderExtension[mCountedHeaderExtensions] {};
+        extensions = mOverflowHeaderExtensions;
+      }
+
+      if (!RTPPacket::parseHeaderExtensions(mHeaderExtensionPos, mHeaderExtensionRemaining, mOneByteHeader, extensions, mCountedHeaderExtensions, mTotalHeaderExtensions, prepaddedSize, parseStoppedPos, parseStoppedSize)) {
+        ZS_LOG_WARNING(Trace, debug("header extensions are not valid"))
+        mTotalHeaderExtensions = 0;
+        return;
+      }
+
+      ASSERT(mTotalHeaderExtensions == mCountedHeaderExtensions)
+
+      if (0 != mTotalHeaderExtensions) mFirstHeaderExtension = extensions;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPPacketView::indexHeaderExtensionsIfNeeded() const
+    {
+      if (mHeaderExtensionsIndexed) return;
+      mHeaderExtensionsIndexed = true;
+
+      parseHeaderExtensionsIfNeeded();
+
+      // NOTE: extensions are always held contiguously (see
+      //       RTPPacket::getHeaderExtensionAtIndex)
+      size_t index = 0;
+      for (auto current = mFirstHeaderExtension; (NULL != current) && (index < 0xFF); current = current->mNext, ++index) {
+        if (0 != mHeaderExtensionIndexByID[current->mID]) continue;   // first occurrence wins
+        mHeaderExtensionIndexByID[current->mID] = static_cast<BYTE>(index + 1);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPHeaderExtensionLookup
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPHeaderExtensionLookup::clear()
+    {
+      for (size_t index = 0; index < ORTC_RTPPACKET_MAX_HEADER_EXTENSION_IDS; ++index) {
+        mURIs[index] = IRTPTypes::HeaderExtensionURI_Unknown;
+      }
+      for (size_t index = 0; index <= IRTPTypes::HeaderExtensionURI_Last; ++index) {
+        mLocalIDs[index] = kNoLocalID;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPHeaderExtensionLookup::add(
+                                       WORD localID,
+                                       HeaderExtensionURIs uri
+                                       )
+    {
+      if ((kNoLocalID == localID) ||
+          (localID >= ORTC_RTPPACKET_MAX_HEADER_EXTENSION_IDS)) {
+        ZS_LOG_WARNING(Debug, slog("header extension local ID cannot appear in an RTP packet") + ZS_PARAM("local id", localID))
+        return;
+      }
+
+      mURIs[localID] = uri;
+
+      if (IRTPTypes::HeaderExtensionURI_Unknown == uri) return;
+
+      WORD &existing = mLocalIDs[uri];
+      if ((kNoLocalID == existing) ||
+          (localID == existing)) {
+        existing = localID;
+        return;
+      }
+      existing = kMultipleLocalIDs;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPHeaderExtensionLookup::HeaderExtension *RTPHeaderExtensionLookup::find(
+                                                                              const RTPPacketView &packet,
+                                                                              HeaderExtensionURIs uri
+                                                                              ) const
+    {
+      WORD localID = mLocalIDs[uri];
+      if (kNoLocalID == localID) return NULL;
+
+      if (kMultipleLocalIDs != localID) return packet.findHeaderExtension(static_cast<BYTE>(localID));
+
+      // the same URI was negotiated under more than one local ID
+      for (auto current = packet.firstHeaderExtension(); NULL != current; current = current->mNext) {
+        if (uri == mURIs[current->mID]) return current;
+      }
+      return NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPHeaderExtensionLookup::HeaderExtension *RTPHeaderExtensionLookup::find(
+                                                                              const RTPPacket &packet,
+                                                                              HeaderExtensionURIs uri
+                                                                              ) const
+    {
+      if (kNoLocalID == mLocalIDs[uri]) return NULL;
+
+      // NOTE: a parsed packet already holds its decoded extensions thus
+      //       they are scanned directly (no view needs to be built)
+      for (auto current = packet.firstHeaderExtension(); NULL != current; current = current->mNext) {
+        if (uri == mURIs[current->mID]) return current;
+      }
+      return NULL;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPHeaderExtensionLookup::toDebug() const
+    {
+      ElementPtr objectEl = Element::create("ortc::RTPHeaderExtensionLookup");
+
+      for (size_t index = 0; index < ORTC_RTPPACKET_MAX_HEADER_EXTENSION_IDS; ++index) {
+        if (IRTPTypes::HeaderExtensionURI_Unknown == mURIs[index]) continue;
+
+        ElementPtr extensionEl = Element::create("extension");
+        UseServicesHelper::debugAppend(extensionEl, "local id", index);
+        UseServicesHelper::debugAppend(extensionEl, "uri", IRTPTypes::toString(mURIs[index]));
+        UseServicesHelper::debugAppend(objectEl, extensionEl);
+      }
+
+      return objectEl;
+    }
+
+    //-------------------------------------------------------------------------
+    Log::Params RTPHeaderExtensionLookup::slog(const char *message)
+    {
+      ElementPtr objectEl = Element::create("ortc::RTPHeaderExtensionLookup");
+      return Log::Params(message, objectEl);
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPPacketRingBuffer::Ring
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPPacketRingBuffer::Ring::popHead()
+    {
+      ASSERT(mCount > 0)
+
+      mEntries[mHead] = Entry();
+      mHead = (mHead + 1) % mEntries.size();
+      --mCount;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPPacketRingBuffer
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPPacketRingBuffer::setLimits(
+                                        size_t maxPackets,
+                                        size_t maxPacketsPerSSRC,
+                                        Seconds maxAge
+                                        )
+    {
+      clear();
+
+      mMaxPackets = maxPackets;
+      mMaxPacketsPerSSRC = maxPacketsPerSSRC;
+      mMaxAge = maxAge;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketPtr RTPPacketRingBuffer::push(
+                                           const Time &tick,
+                                           RTPPacketPtr packet
+                                           )
+    {
+      if ((0 == mMaxPackets) ||
+          (0 == mMaxPacketsPerSSRC)) return packet;
+
+      SSRCType ssrc = packet->ssrc();
+
+      auto &ring = mRings[ssrc];
+      if (ring.mEntries.size() < 1) {
+        ring.mEntries.resize(mMaxPacketsPerSSRC);
+      }
+
+      RTPPacketPtr overwritten;
+
+      if (ring.mCount == ring.mEntries.size()) {
+        // oldest packet for this SSRC is overwritten (its arrival queue entry
+        // becomes stale)
+        overwritten = ring.head().mPacket;
+        ring.popHead();
+        --mTotal;
+        ++mTotalOverwritten;
+      }
+
+      Entry &entry = ring.at(ring.mCount);
+      entry.mSerial = ++mNextSerial;
+      entry.mTime = tick;
+      entry.mPacket = packet;
+
+      ++ring.mCount;
+      ++mTotal;
+
+      OrderEntry order;
+      order.mSSRC = ssrc;
+      order.mSerial = entry.mSerial;
+      mOrder.push_back(order);
+
+      if (mOrder.size() > ((mTotal * 2) + mMaxPacketsPerSSRC)) compactOrder();
+
+      return overwritten;
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketPtr RTPPacketRingBuffer::restore(const Entry &entry)
+    {
+      if ((0 == mMaxPackets) ||
+          (0 == mMaxPacketsPerSSRC)) return entry.mPacket;
+
+      SSRCType ssrc = entry.mPacket->ssrc();
+
+      auto &ring = mRings[ssrc];
+      if (ring.mEntries.size() < 1) {
+        ring.mEntries.resize(mMaxPacketsPerSSRC);
+      }
+
+      RTPPacketPtr overwritten;
+
+      if (ring.mCount == ring.mEntries.size()) {
+        if (entry.mSerial < ring.head().mSerial) {
+          // restored packet is older than everything kept for this SSRC
+          ++mTotalOverwritten;
+          return entry.mPacket;
+        }
+
+        overwritten = ring.head().mPacket;
+        ring.popHead();
+        --mTotal;
+        ++mTotalOverwritten;
+      }
+
+      // NOTE: ring entries are kept in arrival order so shift newer entries
+      //       towards the tail to make room at the original position
+      size_t position = ring.mCount;
+      while ((position > 0) &&
+             (ring.at(position - 1).mSerial > entry.mSerial)) {
+        ring.at(position) = ring.at(position - 1);
+        --position;
+      }
+      ring.at(position) = entry;
+
+      ++ring.mCount;
+      ++mTotal;
+
+      // NOTE: the arrival queue entry may have been compacted away after the
+      //       packet was drained
+      auto found = std::lower_bound(mOrder.begin(), mOrder.end(), entry.mSerial, [](const OrderEntry &order, ULONGLONG serial) -> bool {return order.mSerial < serial;});
+      if ((found == mOrder.end()) ||
+          ((*found).mSerial != entry.mSerial)) {
+        OrderEntry order;
+        order.mSSRC = ssrc;
+        order.mSerial = entry.mSerial;
+        mOrder.insert(found, order);
+      }
+
+      return overwritten;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPPacketRingBuffer::popExpired(
+                                         const Time &tick,
+                                         TimeRTPPacketPair &outExpired
+                                         )
+    {
+      while (mOrder.size() > 0) {
+        auto &order = mOrder.front();
+
+        auto found = mRings.find(order.mSSRC);
+        if (found == mRings.end()) {
+          mOrder.pop_front();
+          continue;
+        }
+
+        auto &ring = (*found).second;
+        if ((ring.mCount < 1) ||
+            (ring.head().mSerial != order.mSerial)) {
+          // stale entry (packet was drained or overwritten)
+          mOrder.pop_front();
+          continue;
+        }
+
+        auto &entry = ring.head();
+
+        if ((mTotal <= mMaxPackets) &&
+            (!(entry.mTime + mMaxAge < tick))) return false;
+
+        outExpired = TimeRTPPacketPair(entry.mTime, entry.mPacket);
+
+        ring.popHead();
+        --mTotal;
+        mOrder.pop_front();
+
+        if (ring.mCount < 1) mRings.erase(found);
+        return true;
+      }
+
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPPacketRingBuffer::getSSRCs(SSRCList &outSSRCs) const
+    {
+      outSSRCs.clear();
+      outSSRCs.reserve(mRings.size());
+
+      for (auto iter = mRings.begin(); iter != mRings.end(); ++iter) {
+        outSSRCs.push_back((*iter).first);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    RTPPacketPtr RTPPacketRingBuffer::front(SSRCType ssrc) const
+    {
+      auto found = mRings.find(ssrc);
+      if (found == mRings.end()) return RTPPacketPtr();
+
+      auto &ring = (*found).second;
+      if (ring.mCount < 1) return RTPPacketPtr();
+
+      return ring.mEntries[ring.mHead].mPacket;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPPacketRingBuffer::drain(
+                                    SSRCType ssrc,
+                                    EntryList &outPackets
+                                    )
+    {
+      auto found = mRings.find(ssrc);
+      if (found == mRings.end()) return;
+
+      auto &ring = (*found).second;
+
+      while (ring.mCount > 0) {
+        outPackets.push_back(ring.head());
+        ring.popHead();
+        --mTotal;
+      }
+
+      mRings.erase(found);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPPacketRingBuffer::clear()
+    {
+      mRings.clear();
+      mOrder.clear();
+      mTotal = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPPacketRingBuffer::toDebug() const
+    {
+      ElementPtr objectEl = Element::create("ortc::RTPPacketRingBuffer");
+
+      UseServicesHelper::debugAppend(objectEl, "max packets", mMaxPackets);
+      UseServicesHelper::debugAppend(objectEl, "max packets per ssrc", mMaxPacketsPerSSRC);
+      UseServicesHelper::debugAppend(objectEl, "max age", mMaxAge);
+
+      UseServicesHelper::debugAppend(objectEl, "total", mTotal);
+      UseServicesHelper::debugAppend(objectEl, "ssrcs", mRings.size());
+      UseServicesHelper::debugAppend(objectEl, "order entries", mOrder.size());
+      UseServicesHelper::debugAppend(objectEl, "next serial", mNextSerial);
+      UseServicesHelper::debugAppend(objectEl, "total overwritten", mTotalOverwritten);
+
+      return objectEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPPacketRingBuffer::compactOrder()
+    {
+      OrderQueue live;
+
+      for (auto iter = mOrder.begin(); iter != mOrder.end(); ++iter) {
+        auto &order = (*iter);
+
+        auto found = mRings.find(order.mSSRC);
+        if (found == mRings.end()) continue;
+
+        auto &ring = (*found).second;
+        if (ring.mCount < 1) continue;
+
+        // NOTE: live entries for a SSRC are at least as new as its head
+        if (order.mSerial < ring.head().mSerial) continue;
+
+        live.push_back(order);
+      }
+
+      mOrder.swap(live);
+    }
   }
 
 }
@@ -31,6 +31,7 @@
 
 #include <ortc/internal/ortc_RTPReceiver.h>
 #include <ortc/internal/ortc_RTPReceiverChannel.h>
+#include <ortc/internal/ortc_RTPSender.h>
 #include <ortc/internal/ortc_DTLSTransport.h>
 #include <ortc/internal/ortc_RTPListener.h>
 #include <ortc/internal/ortc_MediaStreamTrack.h>
@@ -85,6 +86,26 @@ namespace ortc
     #pragma mark (helpers)
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    class ForwardedReceiverReportCollector : public IRTCPPacketWriterDelegate
+    {
+    public:
+      typedef std::list<RTCPPacketPtr> RTCPPacketList;
+
+      ForwardedReceiverReportCollector(RTCPPacketList &packets) : mPackets(packets) {}
+
+      virtual void onRTCPPacketWriterPacket(
+                                            const BYTE *packet,
+                                            size_t packetSizeInBytes
+                                            ) override
+      {
+        mPackets.push_back(RTCPPacket::create(packet, packetSizeInBytes));
+      }
+
+    protected:
+      RTCPPacketList &mPackets;
+    };
+
     //-------------------------------------------------------------------------
     static bool shouldFilter(IRTPTypes::HeaderExtensionURIs extensionURI)
     {
@@ -117,12 +138,17 @@ namespace ortc
 
       UseSettings::setUInt(ORTC_SETTING_RTP_RECEIVER_MAX_RTP_PACKETS_IN_BUFFER, 100);
       UseSettings::setUInt(ORTC_SETTING_RTP_RECEIVER_MAX_AGE_RTP_PACKETS_IN_SECONDS, 30);
+      UseSettings::setUInt(ORTC_SETTING_RTP_RECEIVER_MAX_RTP_PACKETS_PER_SSRC_IN_BUFFER, 50);
 
       UseSettings::setUInt(ORTC_SETTING_RTP_RECEIVER_CSRC_EXPIRY_TIME_IN_SECONDS, 10);
 
       UseSettings::setUInt(ORTC_SETTING_RTP_RECEIVER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS, 5*1000);
 
       UseSettings::setUInt(ORTC_SETTING_RTP_RECEIVER_LOCK_TO_RECEIVER_CHANNEL_AFTER_SWITCH_EXCLUSIVELY_FOR_IN_MILLISECONDS, 3*1000);
+
+      UseSettings::setBool(ORTC_SETTING_RTP_RECEIVER_DELIVER_TO_CHANNEL_WHILE_FORWARDING, false);
+
+      UseSettings::setUInt(ORTC_SETTING_RTP_RECEIVER_FORWARDED_RECEIVER_REPORT_INTERVAL_IN_MILLISECONDS, 1000);
     }
 
     //-------------------------------------------------------------------------
@@ -170,6 +196,21 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object)->toDebug();
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPReceiverForRTPSender
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPReceiverForRTPSender::toDebug(ForRTPSenderPtr object)
+    {
+      if (!object) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object)->toDebug();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -451,6 +492,204 @@ namespace ortc
 
       return resultEl;
     }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPReceiver::ForwarderInfo
+    #pragma mark
+
+    //---------------------------------------------------------------------------
+    ElementPtr RTPReceiver::ForwarderInfo::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPReceiver::ForwarderInfo");
+
+      auto forwarder = mForwarder.lock();
+      UseServicesHelper::debugAppend(resultEl, "forwarder", forwarder ? forwarder->getID() : 0);
+      UseServicesHelper::debugAppend(resultEl, "rid", mRID);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPReceiver::ForwardedReception
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::ForwardedReception::start(
+                                                WORD sequenceNumber,
+                                                const Time &tick
+                                                )
+    {
+      // NOTE: a new source is on probation until kMinSequential packets
+      //       arrive in sequence (see RFC3550 A.1)
+      restart(sequenceNumber, tick);
+      mMaxSequenceNumber = static_cast<WORD>(sequenceNumber - 1);
+      mProbation = kMinSequential;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::ForwardedReception::restart(
+                                                  WORD sequenceNumber,
+                                                  const Time &tick
+                                                  )
+    {
+      mBaseSequenceNumber = sequenceNumber;
+      mMaxSequenceNumber = sequenceNumber;
+      mBadSequenceNumber = kSequenceNumberMod + 1;   // so a sequence number never matches
+      mCycles = 0;
+      mReceived = 0;
+      mExpectedPrior = 0;
+      mReceivedPrior = 0;
+      mFirstArrival = tick;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPReceiver::ForwardedReception::updateSequenceNumber(
+                                                               WORD sequenceNumber,
+                                                               const Time &tick
+                                                               )
+    {
+      // see https://tools.ietf.org/html/rfc3550#appendix-A.1
+      WORD delta = static_cast<WORD>(sequenceNumber - mMaxSequenceNumber);
+
+      if (0 != mProbation) {
+        if (sequenceNumber == static_cast<WORD>(mMaxSequenceNumber + 1)) {
+          --mProbation;
+          mMaxSequenceNumber = sequenceNumber;
+          if (0 == mProbation) {
+            restart(sequenceNumber, tick);
+            ++mReceived;
+            return true;
+          }
+        } else {
+          mProbation = kMinSequential - 1;
+          mMaxSequenceNumber = sequenceNumber;
+        }
+        return false;
+      }
+
+      if (delta < kMaxDropout) {
+        // in order (with a permissible gap)
+        if (sequenceNumber < mMaxSequenceNumber) mCycles += kSequenceNumberMod;
+        mMaxSequenceNumber = sequenceNumber;
+      } else if (delta <= static_cast<WORD>(kSequenceNumberMod - kMaxMisorder)) {
+        // NOTE: a very large jump is only taken as the source restarting its
+        //       sequence numbering once the following packet arrives in
+        //       sequence after it (a lone stray packet is ignored)
+        if (static_cast<DWORD>(sequenceNumber) != mBadSequenceNumber) {
+          mBadSequenceNumber = static_cast<DWORD>(static_cast<WORD>(sequenceNumber + 1));
+          return false;
+        }
+        restart(sequenceNumber, tick);
+      }
+      // otherwise a duplicate or reordered packet
+
+      ++mReceived;
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::ForwardedReception::received(
+                                                   const RTPPacket &packet,
+                                                   const Time &tick
+                                                   )
+    {
+      mLastReceived = tick;
+
+      if (!updateSequenceNumber(packet.sequenceNumber(), tick)) return;
+
+      if (0 == mClockRate) return;
+
+      // arrival time expressed in the stream's timestamp units
+      auto elapsed = zsLib::toMilliseconds(tick - mFirstArrival).count();
+      DWORD arrival = static_cast<DWORD>((static_cast<ULONGLONG>(elapsed) * static_cast<ULONGLONG>(mClockRate)) / 1000);
+      DWORD transit = arrival - packet.timestamp();
+
+      if (mReceived > 1) {
+        int32_t difference = static_cast<int32_t>(transit - mTransit);
+        if (difference < 0) difference = -difference;
+        mJitter += static_cast<DWORD>(difference) - ((mJitter + 8) >> 4);
+      }
+      mTransit = transit;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::ForwardedReception::report(
+                                                 ReportBlock &outBlock,
+                                                 const Time &tick
+                                                 )
+    {
+      DWORD extendedMax = mCycles + mMaxSequenceNumber;
+      DWORD expected = extendedMax - mBaseSequenceNumber + 1;
+
+      int32_t lost = static_cast<int32_t>(expected - mReceived);
+      if (lost > 0x7FFFFF) lost = 0x7FFFFF;
+      if (lost < -0x800000) lost = -0x800000;
+
+      DWORD expectedInterval = expected - mExpectedPrior;
+      DWORD receivedInterval = mReceived - mReceivedPrior;
+      mExpectedPrior = expected;
+      mReceivedPrior = mReceived;
+
+      int32_t lostInterval = static_cast<int32_t>(expectedInterval - receivedInterval);
+
+      DWORD fraction = 0;
+      if ((0 != expectedInterval) &&
+          (lostInterval > 0)) {
+        fraction = (static_cast<DWORD>(lostInterval) << 8) / expectedInterval;
+        if (fraction > 0xFF) fraction = 0xFF;
+      }
+
+      outBlock.mSSRC = mSSRC;
+      outBlock.mFractionLost = static_cast<BYTE>(fraction);
+      outBlock.mCumulativeNumberOfPacketsLost = (static_cast<DWORD>(lost) & 0xFFFFFF);
+      outBlock.mExtendedHighestSequenceNumberReceived = extendedMax;
+      outBlock.mInterarrivalJitter = (mJitter >> 4);
+      outBlock.mLSR = mLSR;
+      outBlock.mDLSR = 0;
+
+      if (0 != mLSR) {
+        // delay since the last SR expressed in units of 1/65536 seconds
+        auto delay = zsLib::toMilliseconds(tick - mLastSenderReport).count();
+        outBlock.mDLSR = static_cast<DWORD>((static_cast<ULONGLONG>(delay) << 16) / 1000);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPReceiver::ForwardedReception::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPReceiver::ForwardedReception");
+
+      UseServicesHelper::debugAppend(resultEl, "ssrc", mSSRC);
+      UseServicesHelper::debugAppend(resultEl, "clock rate", mClockRate);
+
+      UseServicesHelper::debugAppend(resultEl, "max sequence number", mMaxSequenceNumber);
+      UseServicesHelper::debugAppend(resultEl, "cycles", mCycles);
+      UseServicesHelper::debugAppend(resultEl, "base sequence number", mBaseSequenceNumber);
+      UseServicesHelper::debugAppend(resultEl, "bad sequence number", mBadSequenceNumber);
+      UseServicesHelper::debugAppend(resultEl, "probation", mProbation);
+      UseServicesHelper::debugAppend(resultEl, "received", mReceived);
+      UseServicesHelper::debugAppend(resultEl, "expected prior", mExpectedPrior);
+      UseServicesHelper::debugAppend(resultEl, "received prior", mReceivedPrior);
+
+      UseServicesHelper::debugAppend(resultEl, "first arrival", mFirstArrival);
+      UseServicesHelper::debugAppend(resultEl, "transit", mTransit);
+      UseServicesHelper::debugAppend(resultEl, "jitter", mJitter >> 4);
+
+      UseServicesHelper::debugAppend(resultEl, "lsr", mLSR);
+      UseServicesHelper::debugAppend(resultEl, "last sender report", mLastSenderReport);
+
+      UseServicesHelper::debugAppend(resultEl, "last received", mLastReceived);
+
+      return resultEl;
+    }
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -485,14 +724,21 @@ namespace ortc
       mKind(kind),
       mChannels(make_shared<ChannelWeakMap>()),
       mMaxBufferedRTPPackets(SafeInt<decltype(mMaxBufferedRTPPackets)>(UseSettings::getUInt(ORTC_SETTING_RTP_RECEIVER_MAX_RTP_PACKETS_IN_BUFFER))),
+      mMaxBufferedRTPPacketsPerSSRC(SafeInt<decltype(mMaxBufferedRTPPacketsPerSSRC)>(UseSettings::getUInt(ORTC_SETTING_RTP_RECEIVER_MAX_RTP_PACKETS_PER_SSRC_IN_BUFFER))),
       mMaxRTPPacketAge(UseSettings::getUInt(ORTC_SETTING_RTP_RECEIVER_MAX_AGE_RTP_PACKETS_IN_SECONDS)),
       mLockAfterSwitchTime(UseSettings::getUInt(ORTC_SETTING_RTP_RECEIVER_LOCK_TO_RECEIVER_CHANNEL_AFTER_SWITCH_EXCLUSIVELY_FOR_IN_MILLISECONDS)),
       mAmbigousPayloadMappingMinDifference(UseSettings::getUInt(ORTC_SETTING_RTP_RECEIVER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS)),
       mSSRCTableExpires(Seconds(UseSettings::getUInt(ORTC_SETTING_RTP_RECEIVER_SSRC_TIMEOUT_IN_SECONDS))),
-      mContributingSourcesExpiry(Seconds(UseSettings::getUInt(ORTC_SETTING_RTP_RECEIVER_CSRC_EXPIRY_TIME_IN_SECONDS)))
+      mContributingSourcesExpiry(Seconds(UseSettings::getUInt(ORTC_SETTING_RTP_RECEIVER_CSRC_EXPIRY_TIME_IN_SECONDS))),
+      mForwarders(make_shared<ForwarderMap>()),
+      mDeliverToChannelWhileForwarding(UseSettings::getBool(ORTC_SETTING_RTP_RECEIVER_DELIVER_TO_CHANNEL_WHILE_FORWARDING)),
+      mForwardedReceiverReportInterval(UseSettings::getUInt(ORTC_SETTING_RTP_RECEIVER_FORWARDED_RECEIVER_REPORT_INTERVAL_IN_MILLISECONDS)),
+      mForwardedReceiverReportSSRC(SafeInt<SSRCType>(UseServicesHelper::random(1, 0xFFFFFFFF)))
     {
       ZS_LOG_DETAIL(debug("created"))
 
+      mBufferedRTPPackets.setLimits(mMaxBufferedRTPPackets, mMaxBufferedRTPPacketsPerSSRC, mMaxRTPPacketAge);
+
       mListener = UseListener::getListener(transport);
       ORTC_THROW_INVALID_PARAMETERS_IF(!mListener)
 
@@ -538,6 +784,10 @@ namespace ortc
       }
       mContributingSourcesTimer = Timer::create(mThisWeak.lock(), (zsLib::toMilliseconds(mContributingSourcesExpiry) / 2));
 
+      if (mForwardedReceiverReportInterval < Milliseconds(100)) {
+        mForwardedReceiverReportInterval = Milliseconds(100);
+      }
+
       mRTCPTransportSubscription = mRTCPTransport->subscribe(mThisWeak.lock());
 
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
@@ -585,6 +835,12 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object);
     }
 
+    //-------------------------------------------------------------------------
+    RTPReceiverPtr RTPReceiver::convert(ForRTPSenderPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPReceiver, object);
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1462,6 +1718,9 @@ namespace ortc
       ZS_LOG_TRACE(log("received packet") + ZS_PARAM("via", IICETypes::toString(viaTransport)) + packet->toDebug())
 
       ChannelHolderPtr channelHolder;
+      ForwarderMapPtr forwarders;
+      ParametersPtr params;
+      String rid;
 
       {
         AutoRecursiveLock lock(*this);
@@ -1471,9 +1730,17 @@ namespace ortc
           return false;
         }
 
-        String rid;
         if (findMapping(*packet, channelHolder, rid)) {
           postFindMappingProcessPacket(*packet, channelHolder);
+          forwarders = mForwarders; // obtain pointer to COW list while inside a lock
+          params = mParameters;
+
+          // NOTE: no receiver channel sees a forwarded only stream thus the
+          //       receiver reports for the stream are generated here
+          if ((!mDeliverToChannelWhileForwarding) &&
+              (isForwarded(rid))) {
+            recordForwardedReception(*packet);
+          }
           goto process_rtp;
         }
 
@@ -1487,7 +1754,10 @@ namespace ortc
         Time tick = zsLib::now();
 
         // provide some modest buffering
-        mBufferedRTPPackets.push_back(TimeRTPPacketPair(tick, packet));
+        RTPPacketPtr overwritten = mBufferedRTPPackets.push(tick, packet);
+        if (overwritten) {
+          ZS_LOG_TRACE(log("overwriting buffered rtp packet") + ZS_PARAM("ssrc", overwritten->ssrc()) + ZS_PARAM("sequence number", overwritten->sequenceNumber()) + ZS_PARAM("total", mBufferedRTPPackets.size()))
+        }
 
         String muxID = extractMuxID(*packet);
 
@@ -1497,6 +1767,20 @@ namespace ortc
 
     process_rtp:
       {
+        if (forwarders->size() > 0) {
+          bool clean = false;
+          auto forwarded = forwardPacket(*forwarders, params, rid, packet, clean);
+          if (clean) {
+            AutoRecursiveLock lock(*this);
+            cleanForwarders();
+          }
+          if ((forwarded) &&
+              (!mDeliverToChannelWhileForwarding)) {
+            ZS_LOG_INSANE(log("RTP packet forwarded without delivery to channel") + ZS_PARAM("ssrc", packet->ssrc()) + ZS_PARAM("rid", rid))
+            return true;
+          }
+        }
+
         ZS_LOG_TRACE(log("forwarding RTP packet to channel") + ZS_PARAM("channel id", channelHolder->getID()) + ZS_PARAM("ssrc", packet->ssrc()))
         EventWriteOrtcRtpReceiverDeliverIncomingPacketToChannel(__func__, mID, channelHolder->getID(), zsLib::to_underlying(viaTransport), zsLib::to_underlying(IICETypes::Component_RTP), SafeInt<unsigned int>(packet->buffer()->SizeInBytes()), packet->buffer()->BytePtr());
         return channelHolder->handle(packet);
@@ -1521,6 +1805,9 @@ namespace ortc
         AutoRecursiveLock lock(*this);
         channels = mChannels; // obtain pointer to COW list while inside a lock
 
+        // NOTE: target before processing BYEs (which purge SSRC mappings)
+        targetRTCPDelivery(*packet, channels);
+
         processByes(*packet);
         processSenderReports(*packet);
       }
@@ -1548,14 +1835,6 @@ namespace ortc
       return result;
     }
 
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    //-------------------------------------------------------------------------
-    #pragma mark
-    #pragma mark RTPReceiver => IRTPReceiverForRTPReceiverChannel
-    #pragma mark
-
     //-------------------------------------------------------------------------
     bool RTPReceiver::sendPacket(RTCPPacketPtr packet)
     {
@@ -1580,7 +1859,12 @@ namespace ortc
       ZS_LOG_TRACE(log("sending rtcp packet over secure transport") + ZS_PARAM("size", packet->size()))
 
       EventWriteOrtcRtpReceiverSendOutgoingPacket(__func__, mID, zsLib::to_underlying(mSendRTCPOverTransport), zsLib::to_underlying(IICETypes::Component_RTCP), SafeInt<unsigned int>(packet->buffer()->SizeInBytes()), packet->buffer()->BytePtr());
-      return rtcpTransport->sendPacket(mSendRTCPOverTransport, IICETypes::Component_RTCP, packet->ptr(), packet->size());
+      auto result = rtcpTransport->sendPacket(mSendRTCPOverTransport, IICETypes::Component_RTCP, packet->ptr(), packet->size());
+
+      // rtcp is never part of a burst so do not hold it for a flush window
+      rtcpTransport->flushPackets(mSendRTCPOverTransport);
+
+      return result;
     }
 
     //-------------------------------------------------------------------------
@@ -1591,6 +1875,87 @@ namespace ortc
     #pragma mark RTPReceiver => IRTPReceiverForRTPReceiverChannel
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    PUID RTPReceiver::getSecureTransportID() const
+    {
+      AutoRecursiveLock lock(*this);
+      if (!mRTPTransport) return 0;
+      return mRTPTransport->getID();
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPReceiver => IRTPReceiverForRTPSender
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    IMediaStreamTrackTypes::Kinds RTPReceiver::getKind() const
+    {
+      return mKind;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::registerForwarder(
+                                        UseForwarderPtr forwarder,
+                                        const char *rid
+                                        )
+    {
+      ZS_LOG_DEBUG(log("register forwarder") + ZS_PARAM("forwarder", forwarder ? forwarder->getID() : 0) + ZS_PARAM("rid", rid))
+
+      if (!forwarder) return;
+
+      AutoRecursiveLock lock(*this);
+
+      if (isShutdown()) {
+        ZS_LOG_WARNING(Detail, log("cannot register forwarder while shutdown") + ZS_PARAM("forwarder", forwarder->getID()))
+        return;
+      }
+
+      ForwarderInfo info;
+      info.mForwarder = forwarder;
+      info.mRID = String(rid);
+
+      ForwarderMapPtr forwarders = make_shared<ForwarderMap>(*mForwarders);
+      (*forwarders)[forwarder->getID()] = info;
+
+      mForwarders = forwarders; // COW replacement
+
+      if ((!mDeliverToChannelWhileForwarding) &&
+          (!mForwardedReceiverReportTimer)) {
+        mForwardedReceiverReportTimer = Timer::create(mThisWeak.lock(), mForwardedReceiverReportInterval);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::unregisterForwarder(PUID forwarderID)
+    {
+      ZS_LOG_DEBUG(log("unregister forwarder") + ZS_PARAM("forwarder", forwarderID))
+
+      AutoRecursiveLock lock(*this);
+
+      auto found = mForwarders->find(forwarderID);
+      if (found == mForwarders->end()) {
+        ZS_LOG_WARNING(Debug, log("forwarder was not registered") + ZS_PARAM("forwarder", forwarderID))
+        return;
+      }
+
+      ForwarderMapPtr forwarders = make_shared<ForwarderMap>(*mForwarders);
+      forwarders->erase(forwarderID);
+
+      mForwarders = forwarders; // COW replacement
+
+      if (mForwarders->size() > 0) return;
+
+      if (mForwardedReceiverReportTimer) {
+        mForwardedReceiverReportTimer->cancel();
+        mForwardedReceiverReportTimer.reset();
+      }
+      mForwardedReceptions.clear();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1647,6 +2012,8 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()))
 
+      if (handleForwardedReceiverReportTimer(timer)) return;
+
       AutoRecursiveLock lock(*this);
 
       if (timer == mSSRCTableTimer) {
@@ -1709,6 +2076,41 @@ namespace ortc
     #pragma mark RTPReceiver => IRTPReceiverAsyncDelegate
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    void RTPReceiver::onForwardBufferedPackets()
+    {
+      ForwardPacketList packets;
+      ForwarderMapPtr forwarders;
+      ParametersPtr params;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (isShutdown()) {
+          ZS_LOG_WARNING(Debug, log("cannot forward buffered packets as shutdown"))
+          return;
+        }
+
+        packets.swap(mPendingForwardPackets);
+        forwarders = mForwarders; // obtain pointer to COW list while inside a lock
+        params = mParameters;
+      }
+
+      ZS_LOG_TRACE(log("forwarding buffered RTP packets") + ZS_PARAM("total", packets.size()))
+
+      bool clean = false;
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &rid = (*iter).first;
+        auto &packet = (*iter).second;
+        forwardPacket(*forwarders, params, rid, packet, clean);
+      }
+
+      if (clean) {
+        AutoRecursiveLock lock(*this);
+        cleanForwarders();
+      }
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1798,9 +2200,10 @@ namespace ortc
       UseServicesHelper::debugAppend(resultEl, "ssrc table expires", mSSRCTableExpires);
 
       UseServicesHelper::debugAppend(resultEl, "max buffered rtp packets", mMaxBufferedRTPPackets);
+      UseServicesHelper::debugAppend(resultEl, "max buffered rtp packets per ssrc", mMaxBufferedRTPPacketsPerSSRC);
       UseServicesHelper::debugAppend(resultEl, "max rtp packet age", mMaxRTPPacketAge);
 
-      UseServicesHelper::debugAppend(resultEl, "buffered rtp packets", mBufferedRTPPackets.size());
+      UseServicesHelper::debugAppend(resultEl, "buffered rtp packets", mBufferedRTPPackets.toDebug());
       UseServicesHelper::debugAppend(resultEl, "reattempt delivery", mReattemptRTPDelivery);
 
       UseServicesHelper::debugAppend(resultEl, "contributing sources", mContributingSources.size());
@@ -1813,6 +2216,29 @@ namespace ortc
 
       UseServicesHelper::debugAppend(resultEl, "ambiguous payload mapping min difference", mAmbigousPayloadMappingMinDifference);
 
+      if (mForwarders->size() > 0) {
+        ElementPtr forwardersEl = Element::create("forwarders");
+        for (auto iter = mForwarders->begin(); iter != mForwarders->end(); ++iter) {
+          auto &info = (*iter).second;
+          UseServicesHelper::debugAppend(forwardersEl, info.toDebug());
+        }
+        UseServicesHelper::debugAppend(resultEl, forwardersEl);
+      }
+      UseServicesHelper::debugAppend(resultEl, "deliver to channel while forwarding", mDeliverToChannelWhileForwarding);
+      UseServicesHelper::debugAppend(resultEl, "pending forward packets", mPendingForwardPackets.size());
+
+      if (mForwardedReceptions.size() > 0) {
+        ElementPtr receptionsEl = Element::create("forwarded receptions");
+        for (auto iter = mForwardedReceptions.begin(); iter != mForwardedReceptions.end(); ++iter) {
+          auto &reception = (*iter).second;
+          UseServicesHelper::debugAppend(receptionsEl, reception.toDebug());
+        }
+        UseServicesHelper::debugAppend(resultEl, receptionsEl);
+      }
+      UseServicesHelper::debugAppend(resultEl, "forwarded receiver report timer", mForwardedReceiverReportTimer ? mForwardedReceiverReportTimer->getID() : 0);
+      UseServicesHelper::debugAppend(resultEl, "forwarded receiver report interval", mForwardedReceiverReportInterval);
+      UseServicesHelper::debugAppend(resultEl, "forwarded receiver report ssrc", mForwardedReceiverReportSSRC);
+
       return resultEl;
     }
 
@@ -1883,22 +2309,57 @@ namespace ortc
       do
       {
         beforeSize = mBufferedRTPPackets.size();
-        for (auto iter_doNotUse = mBufferedRTPPackets.begin(); iter_doNotUse != mBufferedRTPPackets.end();) {
-          auto current = iter_doNotUse;
-          ++iter_doNotUse;
 
-          RTPPacketPtr packet = (*current).second;
+        // NOTE: only the oldest packet of each SSRC is tested; once an SSRC
+        //       maps all of its packets are drained (in order) without
+        //       visiting packets belonging to other SSRCs
+        mBufferedRTPPackets.getSSRCs(mBufferedSSRCs);
 
-          ChannelHolderPtr channelHolder;
-          String rid;
-          if (!findMapping(*packet, channelHolder, rid)) continue;
+        for (auto iterSSRC = mBufferedSSRCs.begin(); iterSSRC != mBufferedSSRCs.end(); ++iterSSRC) {
+          RTPPacketPtr firstPacket = mBufferedRTPPackets.front(*iterSSRC);
+          if (!firstPacket) continue;
 
-          postFindMappingProcessPacket(*packet, channelHolder);
+          {
+            ChannelHolderPtr channelHolder;
+            String rid;
+            if (!findMapping(*firstPacket, channelHolder, rid)) continue;
+          }
+
+          BufferedRTPPacketList packets;
+          mBufferedRTPPackets.drain(*iterSSRC, packets);
+
+          for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+            auto &buffered = (*iter);
+            RTPPacketPtr packet = buffered.mPacket;
+
+            ChannelHolderPtr channelHolder;
+            String rid;
+            if (!findMapping(*packet, channelHolder, rid)) {
+              // NOTE: rare (e.g. a payload type on the same SSRC not yet routable)
+              RTPPacketPtr overwritten = mBufferedRTPPackets.restore(buffered);
+              if (overwritten) {
+                ZS_LOG_TRACE(log("overwriting buffered rtp packet") + ZS_PARAM("ssrc", overwritten->ssrc()) + ZS_PARAM("sequence number", overwritten->sequenceNumber()) + ZS_PARAM("total", mBufferedRTPPackets.size()))
+              }
+              continue;
+            }
 
-          ZS_LOG_TRACE(log("will attempt to deliver buffered RTP packet") + ZS_PARAM("channel", channelHolder->getID()) + ZS_PARAM("ssrc", packet->ssrc()))
-          channelHolder->notify(packet);
+            postFindMappingProcessPacket(*packet, channelHolder);
 
-          mBufferedRTPPackets.erase(current);
+            // NOTE: forwarders are never called from within the receiver's
+            //       lock (a forwarder may call back into the receiver, e.g.
+            //       to request a key frame) thus buffered packets are queued
+            //       and forwarded asynchronously
+            if (isForwarded(rid)) {
+              queueForwardPacket(rid, packet);
+              if (!mDeliverToChannelWhileForwarding) {
+                recordForwardedReception(*packet);
+                continue;
+              }
+            }
+
+            ZS_LOG_TRACE(log("will attempt to deliver buffered RTP packet") + ZS_PARAM("channel", channelHolder->getID()) + ZS_PARAM("ssrc", packet->ssrc()))
+            channelHolder->notify(packet);
+          }
         }
 
       // NOTE: need to repetitively attempt to deliver packets as it's possible
@@ -1983,11 +2444,21 @@ namespace ortc
       ChannelWeakMapPtr channels = ChannelWeakMapPtr(make_shared<ChannelWeakMap>());
       mChannels = channels;
 
+      mForwarders = make_shared<ForwarderMap>();
+      mPendingForwardPackets.clear();
+
+      mForwardedReceptions.clear();
+      if (mForwardedReceiverReportTimer) {
+        mForwardedReceiverReportTimer->cancel();
+        mForwardedReceiverReportTimer.reset();
+      }
+
       if (mParameters) {
         mListener->unregisterReceiver(*this);
       }
 
       mRegisteredExtensions.clear();
+      mHeaderExtensionLookup.clear();
 
       mChannelInfos.clear();
       mSSRCRoutingPayloadTable.clear();
@@ -2377,6 +2848,19 @@ namespace ortc
 
         mRegisteredExtensions[newExt.mLocalID] = newExt;
       }
+
+      rebuildHeaderExtensionLookup();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::rebuildHeaderExtensionLookup()
+    {
+      mHeaderExtensionLookup.clear();
+
+      for (auto iter = mRegisteredExtensions.begin(); iter != mRegisteredExtensions.end(); ++iter) {
+        auto &extension = (*iter).second;
+        mHeaderExtensionLookup.add(extension.mLocalID, extension.mHeaderExtensionURI);
+      }
     }
 
     //-------------------------------------------------------------------------
@@ -2572,20 +3056,10 @@ namespace ortc
     {
       auto tick = zsLib::now();
 
-      while (mBufferedRTPPackets.size() > 0) {
-        auto packetTime = mBufferedRTPPackets.front().first;
-
-        {
-          if (mBufferedRTPPackets.size() > mMaxBufferedRTPPackets) goto expire_packet;
-          if (packetTime + mMaxRTPPacketAge < tick) goto expire_packet;
-          break;
-        }
-
-      expire_packet:
-        {
-          ZS_LOG_TRACE(log("expiring buffered rtp packet") + ZS_PARAM("tick", tick) + ZS_PARAM("packet time (s)", packetTime) + ZS_PARAM("total", mBufferedRTPPackets.size()))
-          mBufferedRTPPackets.pop_front();
-        }
+      TimeRTPPacketPair info;
+      while (mBufferedRTPPackets.popExpired(tick, info)) {
+        auto &packetTime = info.first;
+        ZS_LOG_TRACE(log("expiring buffered rtp packet") + ZS_PARAM("tick", tick) + ZS_PARAM("packet time (s)", packetTime) + ZS_PARAM("total", mBufferedRTPPackets.size()))
       }
     }
 
@@ -2664,51 +3138,26 @@ namespace ortc
                                    ChannelHolderPtr &outChannelHolder
                                    )
     {
-      for (auto ext = rtpPacket.firstHeaderExtension(); NULL != ext; ext = ext->mNext) {
-        LocalID localID = static_cast<LocalID>(ext->mID);
-        auto found = mRegisteredExtensions.find(localID);
-        if (found == mRegisteredExtensions.end()) continue; // header extension is not understood
-
-        RegisteredHeaderExtension &headerInfo = (*found).second;
-
-        if (IRTPTypes::HeaderExtensionURI_RID != headerInfo.mHeaderExtensionURI) continue;
+      String result;
 
+      auto ext = mHeaderExtensionLookup.find(rtpPacket, IRTPTypes::HeaderExtensionURI_RID);
+      if (NULL != ext) {
         RTPPacket::RidHeaderExtension rid(*ext);
-
-        String ridStr(rid.rid());
-        if (!ridStr.hasData()) continue;
-
-        setSSRCUsage(rtpPacket.ssrc(), routingPayload, ridStr, outChannelHolder);
-        return ridStr;
+        result = String(rid.rid());
       }
 
-      String result;
       setSSRCUsage(rtpPacket.ssrc(), routingPayload, result, outChannelHolder);
-
       return result;
     }
 
     //-------------------------------------------------------------------------
     String RTPReceiver::extractMuxID(const RTPPacket &rtpPacket)
     {
-      for (auto ext = rtpPacket.firstHeaderExtension(); NULL != ext; ext = ext->mNext) {
-        LocalID localID = static_cast<LocalID>(ext->mID);
-        auto found = mRegisteredExtensions.find(localID);
-        if (found == mRegisteredExtensions.end()) continue; // header extension is not understood
-
-        RegisteredHeaderExtension &headerInfo = (*found).second;
-
-        if (IRTPTypes::HeaderExtensionURI_MuxID != headerInfo.mHeaderExtensionURI) continue;
-
-        RTPPacket::MidHeaderExtension mid(*ext);
+      auto ext = mHeaderExtensionLookup.find(rtpPacket, IRTPTypes::HeaderExtensionURI_MuxID);
+      if (NULL == ext) return String();
 
-        String muxID(mid.mid());
-        if (!muxID.hasData()) continue;
-
-        return muxID;
-      }
-
-      return String();
+      RTPPacket::MidHeaderExtension mid(*ext);
+      return String(mid.mid());
     }
 
     //-------------------------------------------------------------------------
@@ -3520,6 +3969,37 @@ namespace ortc
       mListener->notifyUnhandled(muxID, rid, ssrc, payloadType);
     }
 
+    //-------------------------------------------------------------------------
+    void RTPReceiver::targetRTCPDelivery(
+                                         const RTCPPacket &rtcpPacket,
+                                         ChannelWeakMapPtr &ioChannels
+                                         )
+    {
+      if (!rtcpPacket.getReferencedSSRCs(mRTCPSenderSSRCs, mRTCPMediaSSRCs)) return;
+
+      ChannelWeakMapPtr channels(make_shared<ChannelWeakMap>());
+
+      for (auto iter = mRTCPSenderSSRCs.begin(); iter != mRTCPSenderSSRCs.end(); ++iter) {
+        SSRCType ssrc = (*iter);
+
+        for (auto found = mSSRCRoutingPayloadTable.lower_bound(SSRCRoutingPair(ssrc, 0)); found != mSSRCRoutingPayloadTable.end(); ++found) {
+          if ((*found).first.first != ssrc) break;
+
+          auto &ssrcInfo = (*found).second;
+          if (!ssrcInfo->mChannelHolder) continue;
+
+          (*channels)[ssrcInfo->mChannelHolder->getID()] = ssrcInfo->mChannelHolder;
+        }
+      }
+
+      if (channels->size() < 1) {
+        ZS_LOG_INSANE(log("no channel is mapped to any rtcp sender ssrc (thus delivering to all channels)"))
+        return;
+      }
+
+      ioChannels = channels;
+    }
+
     //-------------------------------------------------------------------------
     void RTPReceiver::processByes(const RTCPPacket &rtcpPacket)
     {
@@ -3601,6 +4081,13 @@ namespace ortc
     void RTPReceiver::processSenderReports(const RTCPPacket &rtcpPacket)
     {
       for (auto sr = rtcpPacket.firstSenderReport(); NULL != sr; sr = sr->nextSenderReport()) {
+        auto foundReception = mForwardedReceptions.find(sr->ssrcOfSender());
+        if (foundReception != mForwardedReceptions.end()) {
+          auto &reception = (*foundReception).second;
+          reception.mLSR = ((sr->ntpTimestampMS() & 0xFFFF) << 16) | (sr->ntpTimestampLS() >> 16);
+          reception.mLastSenderReport = zsLib::now();
+        }
+
         for (auto iter = mSSRCRoutingPayloadTable.begin(); iter != mSSRCRoutingPayloadTable.end(); ++iter)
         {
           auto &ssrc = (*iter).first.first;
@@ -3619,13 +4106,7 @@ namespace ortc
     void RTPReceiver::extractCSRCs(const RTPPacket &rtpPacket)
     {
       for (auto ext = rtpPacket.firstHeaderExtension(); NULL != ext; ext = ext->mNext) {
-        LocalID localID = static_cast<LocalID>(ext->mID);
-        auto found = mRegisteredExtensions.find(localID);
-        if (found == mRegisteredExtensions.end()) continue; // header extension is not understood
-
-        RegisteredHeaderExtension &headerInfo = (*found).second;
-
-        switch (headerInfo.mHeaderExtensionURI) {
+        switch (mHeaderExtensionLookup.uri(ext->mID)) {
           case IRTPTypes::HeaderExtensionURI_ClienttoMixerAudioLevelIndication:   {
             RTPPacket::ClientToMixerExtension levelExt(*ext);
             auto level = levelExt.level();
@@ -3714,6 +4195,186 @@ namespace ortc
       mTrack->notifyActiveReceiverChannel(RTPReceiverChannel::convert(channelHolder->mChannel));
     }
 
+    //-------------------------------------------------------------------------
+    bool RTPReceiver::forwardPacket(
+                                    const ForwarderMap &forwarders,
+                                    ParametersPtr params,
+                                    const String &rid,
+                                    RTPPacketPtr packet,
+                                    bool &outClean
+                                    )
+    {
+      if (!params) return false;
+
+      bool result = false;
+      for (auto iter = forwarders.begin(); iter != forwarders.end(); ++iter) {
+        auto &info = (*iter).second;
+
+        if (info.mRID.hasData()) {
+          if (info.mRID != rid) continue;
+        }
+
+        auto forwarder = info.mForwarder.lock();
+        if (!forwarder) {
+          outClean = true;
+          continue;
+        }
+
+        ZS_LOG_INSANE(log("forwarding RTP packet to sender") + ZS_PARAM("forwarder", forwarder->getID()) + ZS_PARAM("ssrc", packet->ssrc()) + ZS_PARAM("rid", rid))
+
+        auto forwarded = forwarder->forwardPacket(mID, params, packet);
+        result = result || forwarded;
+      }
+
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::cleanForwarders()
+    {
+      ForwarderMapPtr forwarders;
+
+      for (auto iter = mForwarders->begin(); iter != mForwarders->end(); ++iter) {
+        auto &info = (*iter).second;
+        if (info.mForwarder.lock()) continue;
+
+        if (!forwarders) forwarders = make_shared<ForwarderMap>(*mForwarders);
+
+        ZS_LOG_TRACE(log("removing forwarder which is gone") + ZS_PARAM("forwarder", (*iter).first))
+        forwarders->erase((*iter).first);
+      }
+
+      if (!forwarders) return;
+
+      mForwarders = forwarders; // COW replacement
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPReceiver::isForwarded(const String &rid) const
+    {
+      for (auto iter = mForwarders->begin(); iter != mForwarders->end(); ++iter) {
+        auto &info = (*iter).second;
+
+        if (info.mRID.hasData()) {
+          if (info.mRID != rid) continue;
+        }
+
+        if (info.mForwarder.lock()) return true;
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::queueForwardPacket(
+                                         const String &rid,
+                                         RTPPacketPtr packet
+                                         )
+    {
+      bool post = (0 == mPendingForwardPackets.size());
+
+      mPendingForwardPackets.push_back(RIDRTPPacketPair(rid, packet));
+
+      if (!post) return;
+
+      IRTPReceiverAsyncDelegateProxy::create(mThisWeak.lock())->onForwardBufferedPackets();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPReceiver::recordForwardedReception(const RTPPacket &rtpPacket)
+    {
+      SSRCType ssrc = rtpPacket.ssrc();
+
+      auto found = mForwardedReceptions.find(ssrc);
+      if (found == mForwardedReceptions.end()) {
+        ForwardedReception reception;
+        reception.mSSRC = ssrc;
+
+        if (mParameters) {
+          for (auto iter = mParameters->mCodecs.begin(); iter != mParameters->mCodecs.end(); ++iter) {
+            auto &codec = (*iter);
+            if (codec.mPayloadType != rtpPacket.pt()) continue;
+            if (codec.mClockRate.hasValue()) reception.mClockRate = codec.mClockRate.value();
+            break;
+          }
+        }
+
+        reception.start(rtpPacket.sequenceNumber(), zsLib::now());
+
+        found = mForwardedReceptions.insert(ForwardedReceptionMap::value_type(ssrc, reception)).first;
+      }
+
+      (*found).second.received(rtpPacket, zsLib::now());
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPReceiver::handleForwardedReceiverReportTimer(TimerPtr timer)
+    {
+      typedef ForwardedReception::ReportBlock ReportBlock;
+      typedef std::vector<ReportBlock> ReportBlockList;
+
+      RTCPPacketList reports;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (timer != mForwardedReceiverReportTimer) return false;
+
+        if ((isShuttingDown()) ||
+            (isShutdown())) return true;
+
+        auto tick = zsLib::now();
+        auto adjustedTick = tick - mSSRCTableExpires;
+
+        ReportBlockList blocks;
+        blocks.reserve(mForwardedReceptions.size());
+
+        for (auto iter_doNotUse = mForwardedReceptions.begin(); iter_doNotUse != mForwardedReceptions.end(); ) {
+          auto current = iter_doNotUse;
+          ++iter_doNotUse;
+
+          auto &reception = (*current).second;
+
+          if (adjustedTick > reception.mLastReceived) {
+            ZS_LOG_TRACE(log("expiring forwarded reception") + reception.toDebug())
+            mForwardedReceptions.erase(current);
+            continue;
+          }
+
+          if (0 != reception.mProbation) continue;   // not yet a valid source
+
+          blocks.push_back(ReportBlock());
+          reception.report(blocks.back(), tick);
+        }
+
+        if (blocks.size() < 1) return true;
+
+        SSRCType senderSSRC = mForwardedReceiverReportSSRC;
+        String cname;
+        if (mParameters) {
+          if (0 != mParameters->mRTCP.mSSRC) senderSSRC = mParameters->mRTCP.mSSRC;
+          cname = mParameters->mRTCP.mCName;
+        }
+
+        BYTE buffer[ForwardedReception::kMaxReportPacketSize];
+        ForwardedReceiverReportCollector collector(reports);
+        RTCPPacketWriter writer(&collector, buffer, sizeof(buffer));
+
+        writer.writeReceiverReport(senderSSRC, &(blocks[0]), blocks.size());
+        if (cname.hasData()) {
+          writer.writeSDES(senderSSRC, cname.c_str(), NULL, NULL);
+        }
+        writer.flush();
+      }
+
+      // NOTE: sent outside the receiver's lock
+      for (auto iter = reports.begin(); iter != reports.end(); ++iter) {
+        auto &report = (*iter);
+        ZS_LOG_TRACE(log("sending receiver report for forwarded streams") + ZS_PARAM("size", report->size()))
+        sendPacket(report);
+      }
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     void RTPReceiver::resetActiveReceiverChannel()
     {
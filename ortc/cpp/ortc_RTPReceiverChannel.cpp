@@ -365,6 +365,14 @@ namespace ortc
     #pragma mark RTPReceiverChannel => ForRTPReceiverChannelMediaBase
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    PUID RTPReceiverChannel::getSecureTransportID() const
+    {
+      auto receiver = mReceiver.lock();
+      if (!receiver) return 0;
+      return receiver->getSecureTransportID();
+    }
+
     //-------------------------------------------------------------------------
     bool RTPReceiverChannel::sendPacket(RTCPPacketPtr packet)
     {
@@ -176,8 +176,12 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPReceiverChannelAudio::init()
     {
+      auto channel = mReceiverChannel.lock();
+      PUID secureTransportID = (channel ? channel->getSecureTransportID() : 0);
+
       AutoRecursiveLock lock(*this);
 
+      mSecureTransportID = secureTransportID;
       mTransport = Transport::create(mThisWeak.lock());
 
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
@@ -666,6 +670,7 @@ namespace ortc
       mChannelResourceLifetimeHolderPromise = UseMediaEngine::setupChannel(
                                                                            mThisWeak.lock(),
                                                                            mTransport,
+                                                                           mSecureTransportID,
                                                                            MediaStreamTrack::convert(mTrack),
                                                                            mParameters,
                                                                            packet
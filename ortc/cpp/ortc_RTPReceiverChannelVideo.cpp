@@ -173,8 +173,12 @@ namespace ortc
     //-------------------------------------------------------------------------
     void RTPReceiverChannelVideo::init()
     {
+      auto channel = mReceiverChannel.lock();
+      PUID secureTransportID = (channel ? channel->getSecureTransportID() : 0);
+
       AutoRecursiveLock lock(*this);
 
+      mSecureTransportID = secureTransportID;
       mTransport = Transport::create(mThisWeak.lock());
 
       IWakeDelegateProxy::create(mThisWeak.lock())->onWake();
@@ -646,6 +650,7 @@ namespace ortc
       mChannelResourceLifetimeHolderPromise = UseMediaEngine::setupChannel(
                                                           mThisWeak.lock(),
                                                           mTransport,
+                                                          mSecureTransportID,
                                                           MediaStreamTrack::convert(mTrack),
                                                           mParameters,
                                                           packet
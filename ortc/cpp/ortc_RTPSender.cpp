@@ -31,6 +31,7 @@
 
 #include <ortc/internal/ortc_RTPSender.h>
 #include <ortc/internal/ortc_RTPSenderChannel.h>
+#include <ortc/internal/ortc_RTPReceiver.h>
 #include <ortc/internal/ortc_DTLSTransport.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
 #include <ortc/internal/ortc_RTPListener.h>
@@ -39,6 +40,7 @@
 #include <ortc/internal/ortc_RTPPacket.h>
 #include <ortc/internal/ortc_RTCPPacket.h>
 #include <ortc/internal/ortc_RTPTypes.h>
+#include <ortc/internal/ortc_RTPUtils.h>
 #include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_StatsReport.h>
 #include <ortc/internal/ortc_Tracing.h>
@@ -92,6 +94,92 @@ namespace ortc
     #pragma mark (helpers)
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    static BYTE getForwardedLocalID(
+                                   const RTPHeaderExtensionLookup &lookup,
+                                   IRTPTypes::HeaderExtensionURIs uri
+                                   )
+    {
+      WORD localID = lookup.mLocalIDs[uri];
+      if (RTPHeaderExtensionLookup::kMultipleLocalIDs == localID) return 0; // ambiguous (thus not forwarded)
+      return static_cast<BYTE>(localID);
+    }
+
+    //-------------------------------------------------------------------------
+    class ForwardedFeedbackCollector : public IRTCPPacketWriterDelegate
+    {
+    public:
+      typedef std::list<RTCPPacketPtr> RTCPPacketList;
+
+      ForwardedFeedbackCollector(RTCPPacketList &packets) : mPackets(packets) {}
+
+      virtual void onRTCPPacketWriterPacket(
+                                            const BYTE *packet,
+                                            size_t packetSizeInBytes
+                                            ) override
+      {
+        mPackets.push_back(RTCPPacket::create(packet, packetSizeInBytes));
+      }
+
+    protected:
+      RTCPPacketList &mPackets;
+    };
+
+    //-------------------------------------------------------------------------
+    class ForwardedNACKWriter
+    {
+    public:
+      typedef RTCPPacketWriter::GenericNACK GenericNACK;
+
+      static const size_t kMaxNACKsPerWrite {32};
+
+      ForwardedNACKWriter(
+                          RTCPPacketWriter &writer,
+                          IRTPTypes::SSRCType ssrcOfPacketSender,
+                          IRTPTypes::SSRCType ssrcOfMediaSource
+                          ) :
+        mWriter(writer),
+        mSSRCOfPacketSender(ssrcOfPacketSender),
+        mSSRCOfMediaSource(ssrcOfMediaSource)
+      {}
+
+      // NOTE: lost sequence numbers are packed into the previous entry's
+      //       bitmask whenever they follow it closely enough
+      void lost(WORD sequenceNumber)
+      {
+        if (0 != mTotalNACKs) {
+          auto &last = mNACKs[mTotalNACKs - 1];
+          WORD offset = static_cast<WORD>(sequenceNumber - last.mPID);
+          if (0 == offset) return;
+          if (offset <= 16) {
+            last.mBLP = static_cast<WORD>(last.mBLP | (1 << (offset - 1)));
+            return;
+          }
+        }
+
+        if (kMaxNACKsPerWrite == mTotalNACKs) flush();
+
+        auto &nack = mNACKs[mTotalNACKs];
+        nack.mPID = sequenceNumber;
+        nack.mBLP = 0;
+        ++mTotalNACKs;
+      }
+
+      void flush()
+      {
+        if (0 == mTotalNACKs) return;
+        mWriter.writeGenericNACK(mSSRCOfPacketSender, mSSRCOfMediaSource, &(mNACKs[0]), mTotalNACKs);
+        mTotalNACKs = 0;
+      }
+
+    protected:
+      RTCPPacketWriter &mWriter;
+      IRTPTypes::SSRCType mSSRCOfPacketSender {};
+      IRTPTypes::SSRCType mSSRCOfMediaSource {};
+
+      GenericNACK mNACKs[kMaxNACKsPerWrite] {};
+      size_t mTotalNACKs {};
+    };
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -104,7 +192,8 @@ namespace ortc
     //-------------------------------------------------------------------------
     void IRTPSenderForSettings::applyDefaults()
     {
-//      UseSettings::setUInt(ORTC_SETTING_SCTP_TRANSPORT_MAX_MESSAGE_SIZE, 5*1024);
+      UseSettings::setUInt(ORTC_SETTING_RTP_SENDER_FORWARD_MIN_KEY_FRAME_REQUEST_INTERVAL_IN_MILLISECONDS, 300);
+      UseSettings::setUInt(ORTC_SETTING_RTP_SENDER_FORWARDED_SENDER_REPORT_INTERVAL_IN_MILLISECONDS, 1000);
     }
 
     //-------------------------------------------------------------------------
@@ -152,6 +241,21 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPSender, object)->toDebug();
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPSenderForRTPReceiver
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr IRTPSenderForRTPReceiver::toDebug(ForRTPReceiverPtr object)
+    {
+      if (!object) return ElementPtr();
+      return ZS_DYNAMIC_PTR_CAST(RTPSender, object)->toDebug();
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -276,6 +380,128 @@ namespace ortc
       return resultEl;
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPSender::ForwardedCodec
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPSender::ForwardedCodec::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPSender::ForwardedCodec");
+
+      UseServicesHelper::debugAppend(resultEl, "payload type", mPayloadType);
+      UseServicesHelper::debugAppend(resultEl, "codec", IRTPTypes::toString(mCodec));
+      UseServicesHelper::debugAppend(resultEl, "clock rate", mClockRate);
+      UseServicesHelper::debugAppend(resultEl, "decapsulate rtx", mDecapsulateRTX);
+      UseServicesHelper::debugAppend(resultEl, "original payload type", mOriginalPayloadType);
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPSender::Forwarding
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPSender::Forwarding::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPSender::Forwarding");
+
+      UseServicesHelper::debugAppend(resultEl, "source", mSource ? mSource->getID() : 0);
+      UseServicesHelper::debugAppend(resultEl, "rid", mRID);
+
+      UseServicesHelper::debugAppend(resultEl, "valid", mValid);
+
+      if (mCodecs.size() > 0) {
+        ElementPtr codecsEl = Element::create("codecs");
+        for (auto iter = mCodecs.begin(); iter != mCodecs.end(); ++iter) {
+          ElementPtr codecEl = (*iter).second.toDebug();
+          UseServicesHelper::debugAppend(codecEl, "received payload type", (*iter).first);
+          UseServicesHelper::debugAppend(codecsEl, codecEl);
+        }
+        UseServicesHelper::debugAppend(resultEl, codecsEl);
+      }
+
+      UseServicesHelper::debugAppend(resultEl, "source header extensions", mSourceHeaderExtensions.toDebug());
+      UseServicesHelper::debugAppend(resultEl, "sender header extensions", mSenderHeaderExtensions.toDebug());
+
+      UseServicesHelper::debugAppend(resultEl, "ssrc", mSSRC);
+      UseServicesHelper::debugAppend(resultEl, "rtx ssrc", mRTXSSRC);
+      UseServicesHelper::debugAppend(resultEl, "mux id", mMuxID);
+      UseServicesHelper::debugAppend(resultEl, "encoding id", mEncodingID);
+      UseServicesHelper::debugAppend(resultEl, "feedback ssrc", mFeedbackSSRC);
+
+      UseServicesHelper::debugAppend(resultEl, "source ssrc", mSourceSSRC);
+      UseServicesHelper::debugAppend(resultEl, "sequence number delta", mSequenceNumberDelta);
+      UseServicesHelper::debugAppend(resultEl, "timestamp delta", mTimestampDelta);
+      UseServicesHelper::debugAppend(resultEl, "sent", mSent);
+      UseServicesHelper::debugAppend(resultEl, "last sequence number", mLastSequenceNumber);
+      UseServicesHelper::debugAppend(resultEl, "last timestamp", mLastTimestamp);
+      UseServicesHelper::debugAppend(resultEl, "last sent", mLastSent);
+      UseServicesHelper::debugAppend(resultEl, "last clock rate", mLastClockRate);
+      UseServicesHelper::debugAppend(resultEl, "rtx sequence number", mRTXSequenceNumber);
+
+      UseServicesHelper::debugAppend(resultEl, "packet count", mPacketCount);
+      UseServicesHelper::debugAppend(resultEl, "octet count", mOctetCount);
+      UseServicesHelper::debugAppend(resultEl, "rtx packet count", mRTXPacketCount);
+      UseServicesHelper::debugAppend(resultEl, "rtx octet count", mRTXOctetCount);
+
+      auto previousSource = mPreviousSource.lock();
+      UseServicesHelper::debugAppend(resultEl, "previous source", previousSource ? previousSource->getID() : 0);
+      UseServicesHelper::debugAppend(resultEl, "previous source ssrc", mPreviousSourceSSRC);
+      UseServicesHelper::debugAppend(resultEl, "previous sequence number delta", mPreviousSequenceNumberDelta);
+      UseServicesHelper::debugAppend(resultEl, "switch sequence number", mSwitchSequenceNumber);
+
+      UseServicesHelper::debugAppend(resultEl, "fir sequence number", mFIRSequenceNumber);
+      UseServicesHelper::debugAppend(resultEl, "last key frame request", mLastKeyFrameRequest);
+      UseServicesHelper::debugAppend(resultEl, "key frame request pending", mKeyFrameRequestPending);
+
+      UseServicesHelper::debugAppend(resultEl, "total forwarded", mTotalForwarded);
+      UseServicesHelper::debugAppend(resultEl, "total dropped", mTotalDropped);
+      UseServicesHelper::debugAppend(resultEl, "total feedback forwarded", mTotalFeedbackForwarded);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPSender::ForwardedPacing
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPSender::ForwardedPacing::toDebug() const
+    {
+      ElementPtr resultEl = Element::create("ortc::RTPSender::ForwardedPacing");
+
+      UseServicesHelper::debugAppend(resultEl, "congestion context", mCongestionContext ? mCongestionContext->toDebug() : ElementPtr());
+      UseServicesHelper::debugAppend(resultEl, "secure transport id", mSecureTransportID);
+
+      UseServicesHelper::debugAppend(resultEl, "min bitrate bps", mMinBitrateBps);
+      UseServicesHelper::debugAppend(resultEl, "start bitrate bps", mStartBitrateBps);
+      UseServicesHelper::debugAppend(resultEl, "max bitrate bps", mMaxBitrateBps);
+      UseServicesHelper::debugAppend(resultEl, "target bitrate bps", static_cast<uint32_t>(mTargetBitrateBps));
+
+      UseServicesHelper::debugAppend(resultEl, "queue", mQueue.size());
+      UseServicesHelper::debugAppend(resultEl, "queue size in bytes", mQueueSizeInBytes);
+      UseServicesHelper::debugAppend(resultEl, "budget in bytes", mBudgetInBytes);
+      UseServicesHelper::debugAppend(resultEl, "last budget update", mLastBudgetUpdate);
+      UseServicesHelper::debugAppend(resultEl, "timer", mTimer ? mTimer->getID() : 0);
+
+      UseServicesHelper::debugAppend(resultEl, "total paced", mTotalPaced);
+
+      return resultEl;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -308,7 +534,9 @@ namespace ortc
       MessageQueueAssociator(queue),
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mChannels(make_shared<ParametersToChannelHolderMap>()),
-      mTrack(MediaStreamTrack::convert(track))
+      mTrack(MediaStreamTrack::convert(track)),
+      mForwardMinKeyFrameRequestInterval(UseSettings::getUInt(ORTC_SETTING_RTP_SENDER_FORWARD_MIN_KEY_FRAME_REQUEST_INTERVAL_IN_MILLISECONDS)),
+      mForwardedSenderReportInterval(UseSettings::getUInt(ORTC_SETTING_RTP_SENDER_FORWARDED_SENDER_REPORT_INTERVAL_IN_MILLISECONDS))
     {
       ZS_LOG_DETAIL(debug("created"))
 
@@ -317,6 +545,10 @@ namespace ortc
 
       UseSecureTransport::getSendingTransport(transport, rtcpTransport, mSendRTPOverTransport, mSendRTCPOverTransport, mRTPTransport, mRTCPTransport);
 
+      if (mForwardedSenderReportInterval < Milliseconds(100)) {
+        mForwardedSenderReportInterval = Milliseconds(100);
+      }
+
       EventWriteOrtcRtpSenderCreate(
                                     __func__,
                                     mID,
@@ -384,6 +616,12 @@ namespace ortc
       return ZS_DYNAMIC_PTR_CAST(RTPSender, object);
     }
 
+    //-------------------------------------------------------------------------
+    RTPSenderPtr RTPSender::convert(ForRTPReceiverPtr object)
+    {
+      return ZS_DYNAMIC_PTR_CAST(RTPSender, object);
+    }
+
 
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -569,8 +807,35 @@ namespace ortc
         }
       }
 
+      PUID previousSecureTransportID = (mRTPTransport ? mRTPTransport->getID() : 0);
+
       UseSecureTransport::getSendingTransport(transport, rtcpTransport, mSendRTPOverTransport, mSendRTCPOverTransport, mRTPTransport, mRTCPTransport);
 
+      if ((mParameters) &&
+          (0 != previousSecureTransportID) &&
+          (previousSecureTransportID != (mRTPTransport ? mRTPTransport->getID() : 0))) {
+        // NOTE: a channel's media engine resource is bound to the congestion
+        //       context (estimator, pacer and allocator) of the secure
+        //       transport it was setup over, thus every channel is rebuilt to
+        //       rebind to the new transport's congestion context
+        ZS_LOG_DEBUG(log("secure transport changed (rebuilding channels)") + ZS_PARAM("previous", previousSecureTransportID) + ZS_PARAM("current", mRTPTransport ? mRTPTransport->getID() : 0))
+
+        ParametersToChannelHolderMapPtr replacementChannels = make_shared<ParametersToChannelHolderMap>();
+
+        for (auto iter = mChannels->begin(); iter != mChannels->end(); ++iter) {
+          auto &params = (*iter).first;
+          auto &channel = (*iter).second;
+
+          removeChannel(channel);
+          (*replacementChannels)[params] = addChannel(params);
+        }
+
+        mChannels = replacementChannels;  // COW replacement
+      }
+
+      // NOTE: forwarded packets follow the new transport's congestion context
+      if (mForwarding.mSource) acquireForwardedCongestionContext();
+
       EventWriteOrtcRtpSenderSetTransport(__func__, mID, ((bool)mListener) ? mListener->getID() : 0, ((bool)mRTPTransport) ? mRTPTransport->getID() : 0, ((bool)mRTCPTransport) ? mRTCPTransport->getID() : 0);
 
       if (mRTCPTransportSubscription) {
@@ -595,6 +860,12 @@ namespace ortc
       {
         AutoRecursiveLock lock(*this);
 
+        if ((track) &&
+            (mForwarding.mSource)) {
+          ZS_LOG_WARNING(Detail, log("cannot attach a track while forwarding from a source") + ZS_PARAM("track id", track->getID()) + ZS_PARAM("source", mForwarding.mSource->getID()))
+          return Promise::createRejected(IORTCForInternal::queueDelegate());
+        }
+
         if (mKind.hasValue()) {
           if (track) {
             if (mKind.value() != kind) {
@@ -674,7 +945,20 @@ namespace ortc
           promise->resolve();
           return promise;
         }
+      }
 
+      if (mForwarding.mSource) {
+        // NOTE: while forwarding the source's packets are sent as is (no
+        //       channel is created as a channel would send its own media
+        //       using the same SSRCs); channels are created from these
+        //       parameters once the forwarding source is cleared
+        ZS_LOG_DEBUG(log("forwarding from source (thus not creating channels)") + ZS_PARAM("source", mForwarding.mSource->getID()))
+
+        mParameters = make_shared<Parameters>(parameters);
+
+        mParametersGroupedIntoChannels.clear();
+        RTPTypesHelper::splitParamsIntoChannels(parameters, mParametersGroupedIntoChannels);
+      } else if (mParameters) {
         ParametersPtrList oldGroupedParams = mParametersGroupedIntoChannels;
 
         mParameters = make_shared<Parameters>(parameters);
@@ -785,8 +1069,99 @@ namespace ortc
 
       ZS_LOG_DEBUG(log("stop called"))
 
-      AutoRecursiveLock lock(*this);
-      cancel();
+      UseForwardingSourcePtr source;
+
+      {
+        AutoRecursiveLock lock(*this);
+        source = mForwarding.mSource;
+        cancel();
+      }
+
+      // NOTE: the source must never be called while holding the sender's
+      //       lock as the source may call the sender while holding its own lock
+      if (source) source->unregisterForwarder(mID);
+    }
+
+    //-------------------------------------------------------------------------
+    PromisePtr RTPSender::setForwardingSource(
+                                              IRTPReceiverPtr receiver,
+                                              const char *inRID
+                                              )
+    {
+      UseForwardingSourcePtr source = RTPReceiver::convert(receiver);
+      UseForwardingSourcePtr oldSource;
+      String rid(inRID);
+
+      ZS_LOG_DEBUG(log("set forwarding source called") + ZS_PARAM("receiver", source ? source->getID() : 0) + ZS_PARAM("rid", rid))
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if ((isShuttingDown()) ||
+            (isShutdown())) {
+          ZS_LOG_WARNING(Detail, log("cannot forward while shutting down / shutdown"))
+          return Promise::createRejected(IORTCForInternal::queueDelegate());
+        }
+
+        if ((source) &&
+            (mTrack)) {
+          ZS_LOG_WARNING(Detail, log("cannot forward while a track is attached") + ZS_PARAM("track id", mTrack->getID()) + ZS_PARAM("receiver", source->getID()))
+          return Promise::createRejected(IORTCForInternal::queueDelegate());
+        }
+
+        if (source) {
+          auto kind = source->getKind();
+          if (mKind.hasValue()) {
+            if (mKind.value() != kind) {
+              ZS_LOG_WARNING(Detail, log("forwarding source is not the same kind") + ZS_PARAM("kind", IMediaStreamTrackTypes::toString(mKind.value())) + ZS_PARAM("source kind", IMediaStreamTrackTypes::toString(kind)))
+              return Promise::createRejected(make_shared<IncompatibleMediaStreamTrackError>(), IORTCForInternal::queueDelegate());
+            }
+          } else {
+            mKind = kind;
+          }
+        }
+
+        if (mForwarding.mSource) {
+          if ((source) &&
+              (source->getID() == mForwarding.mSource->getID()) &&
+              (rid == mForwarding.mRID)) {
+            ZS_LOG_DEBUG(log("setting forwarding source to same source (noop)") + ZS_PARAM("receiver", source->getID()))
+            return Promise::createResolved(IORTCForInternal::queueDelegate());
+          }
+        }
+
+        oldSource = mForwarding.mSource;
+
+        switchForwardingSource(source, rid);
+
+        if ((source) &&
+            (!oldSource)) {
+          // NOTE: forwarded packets replace the media the channels would send
+          for (auto iter = mChannels->begin(); iter != mChannels->end(); ++iter) {
+            auto &channel = (*iter).second;
+            removeChannel(channel);
+          }
+          mChannels = make_shared<ParametersToChannelHolderMap>();
+        }
+
+        if ((!source) &&
+            (oldSource)) {
+          ParametersToChannelHolderMapPtr replacementChannels = make_shared<ParametersToChannelHolderMap>();
+
+          for (auto iter = mParametersGroupedIntoChannels.begin(); iter != mParametersGroupedIntoChannels.end(); ++iter) {
+            auto &params = (*iter);
+            (*replacementChannels)[params] = addChannel(params);
+          }
+          mChannels = replacementChannels;  // COW replacement
+        }
+      }
+
+      // NOTE: the source must never be called while holding the sender's
+      //       lock as the source may call the sender while holding its own lock
+      if (oldSource) oldSource->unregisterForwarder(mID);
+      if (source) source->registerForwarder(mThisWeak.lock(), rid.c_str());
+
+      return Promise::createResolved(IORTCForInternal::queueDelegate());
     }
 
     //-------------------------------------------------------------------------
@@ -825,6 +1200,8 @@ namespace ortc
         result = result || channelResult;
       }
 
+      forwardFeedback(*packet);
+
       return result;
     }
 
@@ -836,10 +1213,19 @@ namespace ortc
     #pragma mark RTPSender => IRTPSenderForRTPSenderChannel
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    PUID RTPSender::getSecureTransportID() const
+    {
+      AutoRecursiveLock lock(*this);
+      if (!mRTPTransport) return 0;
+      return mRTPTransport->getID();
+    }
+
     //-------------------------------------------------------------------------
     bool RTPSender::sendPacket(RTPPacketPtr packet)
     {
       UseSecureTransportPtr rtpTransport;
+      bool flush = false;
 
       {
         AutoRecursiveLock lock(*this);
@@ -850,6 +1236,12 @@ namespace ortc
         }
 
         rtpTransport = mRTPTransport;
+
+        // video frames span many packets with the marker bit set on the last
+        // packet of each frame whereas each audio packet is a frame on its own
+        flush = ((packet->m()) ||
+                 (!mKind.hasValue()) ||
+                 (IMediaStreamTrackTypes::Kind_Video != mKind.value()));
       }
 
       if (!rtpTransport) {
@@ -861,7 +1253,12 @@ namespace ortc
 
       EventWriteOrtcRtpSenderSendOutgoingPacket(__func__, mID, zsLib::to_underlying(mSendRTPOverTransport), zsLib::to_underlying(IICETypes::Component_RTP), SafeInt<unsigned int>(packet->buffer()->SizeInBytes()), packet->buffer()->BytePtr());
 
-      return rtpTransport->sendPacket(mSendRTPOverTransport, IICETypes::Component_RTP, packet->ptr(), packet->size());
+      auto result = rtpTransport->sendPacket(mSendRTPOverTransport, IICETypes::Component_RTP, packet->ptr(), packet->size());
+
+      // frame boundary reached (flush any packets batched by the transport)
+      if (flush) rtpTransport->flushPackets(mSendRTPOverTransport);
+
+      return result;
     }
 
     //-------------------------------------------------------------------------
@@ -889,7 +1286,12 @@ namespace ortc
 
       EventWriteOrtcRtpSenderSendOutgoingPacket(__func__, mID, zsLib::to_underlying(mSendRTCPOverTransport), zsLib::to_underlying(IICETypes::Component_RTCP), SafeInt<unsigned int>(packet->buffer()->SizeInBytes()), packet->buffer()->BytePtr());
 
-      return rtcpTransport->sendPacket(mSendRTCPOverTransport, IICETypes::Component_RTCP, packet->ptr(), packet->size());
+      auto result = rtcpTransport->sendPacket(mSendRTCPOverTransport, IICETypes::Component_RTCP, packet->ptr(), packet->size());
+
+      // rtcp is never part of a burst so do not hold it for a flush window
+      rtcpTransport->flushPackets(mSendRTCPOverTransport);
+
+      return result;
     }
 
     //-------------------------------------------------------------------------
@@ -935,6 +1337,92 @@ namespace ortc
       mDTMFSubscriptions.delegate()->onDTMFSenderToneChanged(mThisWeak.lock(), String(tone));
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPSender => IRTPSenderForRTPReceiver
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::forwardPacket(
+                                  PUID receiverID,
+                                  ParametersPtr receiverParams,
+                                  RTPPacketPtr packet
+                                  )
+    {
+      ForwardedPacketList outPackets;
+      UseForwardingSourcePtr source;
+      RTCPPacketList keyFrameRequests;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if ((isShuttingDown()) ||
+            (isShutdown())) {
+          ZS_LOG_TRACE(log("cannot forward packet while shutting down / shutdown"))
+          return false;
+        }
+
+        if (!mForwarding.mSource) {
+          ZS_LOG_TRACE(log("no forwarding source (thus ignoring forwarded packet)") + ZS_PARAM("receiver", receiverID))
+          return false;
+        }
+
+        if (receiverID != mForwarding.mSource->getID()) {
+          ZS_LOG_TRACE(log("packet forwarded from previous source (thus ignoring)") + ZS_PARAM("receiver", receiverID) + ZS_PARAM("source", mForwarding.mSource->getID()))
+          return false;
+        }
+
+        if (!prepareForwarding(receiverParams)) {
+          ++mForwarding.mTotalDropped;
+          return false;
+        }
+
+        ForwardedPacket outPacket;
+        if (!rewriteForwardedPacket(*packet, outPacket)) {
+          ++mForwarding.mTotalDropped;
+          return false;
+        }
+
+        ++mForwarding.mTotalForwarded;
+
+        mForwardedPacing.mQueue.push_back(outPacket);
+        mForwardedPacing.mQueueSizeInBytes += outPacket.mPacket->size();
+        paceForwardedPackets(outPackets);
+
+        if (mForwarding.mKeyFrameRequestPending) {
+          auto &forwarding = mForwarding;
+
+          // NOTE: a new source is asked for a key frame straight away (the
+          //       request throttle is bypassed) as the remote decoder cannot
+          //       decode the new source's frames until one arrives
+          forwarding.mKeyFrameRequestPending = false;
+          forwarding.mLastKeyFrameRequest = zsLib::now();
+
+          BYTE buffer[Forwarding::kMaxFeedbackPacketSize];
+          ForwardedFeedbackCollector collector(keyFrameRequests);
+          RTCPPacketWriter writer(&collector, buffer, sizeof(buffer));
+          writer.writePLI(forwarding.mFeedbackSSRC, forwarding.mSourceSSRC.value());
+          writer.flush();
+
+          source = forwarding.mSource;
+        }
+      }
+
+      sendForwardedPackets(outPackets);
+
+      // NOTE: sent outside the sender's lock (see stop())
+      for (auto iter = keyFrameRequests.begin(); iter != keyFrameRequests.end(); ++iter) {
+        auto &request = (*iter);
+        ZS_LOG_DEBUG(log("requesting key frame from source") + ZS_PARAM("source", source->getID()) + ZS_PARAM("size", request->size()))
+        source->sendPacket(request);
+      }
+
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1167,6 +1655,27 @@ namespace ortc
       step();
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPSender => ITimerDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPSender::onTimer(TimerPtr timer)
+    {
+      EventWriteOrtcRtpSenderInternalTimerEventFired(__func__, mID, timer->getID());
+
+      ZS_LOG_DEBUG(log("timer") + ZS_PARAM("timer id", timer->getID()))
+
+      if (handleForwardedPacingTimer(timer)) return;
+      if (handleForwardedSenderReportTimer(timer)) return;
+
+      ZS_LOG_WARNING(Debug, log("notified about obsolete timer (thus ignoring)") + ZS_PARAM("timer id", timer->getID()))
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1187,6 +1696,29 @@ namespace ortc
       mDTMFSubscriptions.delegate()->onDTMFSenderToneChanged(mThisWeak.lock(), tone);
     }
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPSender => IRTPMediaEngineCongestionContextDelegate
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    void RTPSender::notifyTargetBitrate(uint32_t targetBitrateBps)
+    {
+      // NOTE: called from the media engine's module process thread; never
+      //       take the sender's lock here as the lock is held while the
+      //       congestion context is released
+      mForwardedPacing.mTargetBitrateBps = targetBitrateBps;
+    }
+
+    //-------------------------------------------------------------------------
+    int RTPSender::getPaddingNeededBps()
+    {
+      return 0;   // forwarded streams are not padded
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1310,6 +1842,14 @@ namespace ortc
 
       UseServicesHelper::debugAppend(resultEl, "conflicts", mConflicts.size());
 
+      UseServicesHelper::debugAppend(resultEl, "forwarding", mForwarding.mSource ? mForwarding.toDebug() : ElementPtr());
+      UseServicesHelper::debugAppend(resultEl, "forward min key frame request interval", mForwardMinKeyFrameRequestInterval);
+
+      UseServicesHelper::debugAppend(resultEl, "forwarded sender report timer", mForwardedSenderReportTimer ? mForwardedSenderReportTimer->getID() : 0);
+      UseServicesHelper::debugAppend(resultEl, "forwarded sender report interval", mForwardedSenderReportInterval);
+
+      UseServicesHelper::debugAppend(resultEl, "forwarded pacing", mForwarding.mSource ? mForwardedPacing.toDebug() : ElementPtr());
+
       return resultEl;
     }
 
@@ -1392,6 +1932,9 @@ namespace ortc
         mRTCPTransportSubscription.reset();
       }
 
+      // NOTE: the source drops its (weak) reference to this sender lazily
+      switchForwardingSource(UseForwardingSourcePtr(), String());
+
       // make sure to cleanup any final reference to self
       mGracefulShutdownReference.reset();
     }
@@ -1513,6 +2056,961 @@ namespace ortc
       return (*found).second;
     }
 
+    //-------------------------------------------------------------------------
+    void RTPSender::switchForwardingSource(
+                                           UseForwardingSourcePtr source,
+                                           const String &rid
+                                           )
+    {
+      auto &forwarding = mForwarding;
+
+      keepPreviousForwarding();
+
+      // NOTE: the rewriting state (sequence number and timestamp deltas,
+      //       last packet sent, RTX and FIR sequence numbers) is kept so the
+      //       sent stream stays continuous across sources; clearing the
+      //       source SSRC re-bases on the next forwarded packet
+      forwarding.mSource = source;
+      forwarding.mRID = rid;
+
+      forwarding.mSourceParameters.reset();
+      forwarding.mValid = false;
+
+      forwarding.mSourceSSRC = Optional<SSRCType>();
+      forwarding.mLastKeyFrameRequest = Time();
+      forwarding.mKeyFrameRequestPending = false;
+
+      if (!source) {
+        if (mForwardedSenderReportTimer) {
+          mForwardedSenderReportTimer->cancel();
+          mForwardedSenderReportTimer.reset();
+        }
+
+        auto &pacing = mForwardedPacing;
+
+        // NOTE: packets still paced belong to a stream that is now replaced
+        //       by the channels (thus are dropped)
+        mForwarding.mTotalDropped += pacing.mQueue.size();
+        pacing.mQueue.clear();
+        pacing.mQueueSizeInBytes = 0;
+        pacing.mBudgetInBytes = 0;
+        pacing.mLastBudgetUpdate = Time();
+        if (pacing.mTimer) {
+          pacing.mTimer->cancel();
+          pacing.mTimer.reset();
+        }
+
+        releaseForwardedCongestionContext();
+        return;
+      }
+
+      if (!mForwardedSenderReportTimer) {
+        mForwardedSenderReportTimer = Timer::create(mThisWeak.lock(), mForwardedSenderReportInterval);
+      }
+
+      acquireForwardedCongestionContext();
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::prepareForwarding(ParametersPtr sourceParams)
+    {
+      auto &forwarding = mForwarding;
+
+      if ((sourceParams == forwarding.mSourceParameters) &&
+          (mParameters == forwarding.mSenderParameters)) return forwarding.mValid;
+
+      forwarding.mSourceParameters = sourceParams;
+      forwarding.mSenderParameters = mParameters;
+      forwarding.mValid = false;
+
+      forwarding.mCodecs.clear();
+      forwarding.mSourceHeaderExtensions.clear();
+      forwarding.mSenderHeaderExtensions.clear();
+
+      if ((!sourceParams) ||
+          (!mParameters)) {
+        ZS_LOG_TRACE(log("cannot forward until both the source and sender parameters are set"))
+        return false;
+      }
+
+      // scope: find the encoding being sent
+      {
+        const EncodingParameters *found = NULL;
+        for (auto iter = mParameters->mEncodings.begin(); iter != mParameters->mEncodings.end(); ++iter) {
+          auto &encoding = (*iter);
+          if (!encoding.mSSRC.hasValue()) continue;
+          found = &encoding;
+          break;
+        }
+
+        if (!found) {
+          ZS_LOG_WARNING(Detail, log("cannot forward as no encoding specifies the SSRC to send"))
+          return false;
+        }
+
+        Optional<SSRCType> rtxSSRC;
+        if (found->mRTX.hasValue()) {
+          if (found->mRTX.value().mSSRC.hasValue()) {
+            rtxSSRC = found->mRTX.value().mSSRC.value();
+          }
+        }
+
+        // see https://tools.ietf.org/html/rfc3550#section-6.4.1 (counts are
+        // reset whenever the SSRC identifier changes)
+        if (forwarding.mSSRC != found->mSSRC.value()) {
+          forwarding.mPacketCount = 0;
+          forwarding.mOctetCount = 0;
+        }
+        if ((forwarding.mRTXSSRC.hasValue() != rtxSSRC.hasValue()) ||
+            ((rtxSSRC.hasValue()) &&
+             (forwarding.mRTXSSRC.value() != rtxSSRC.value()))) {
+          forwarding.mRTXPacketCount = 0;
+          forwarding.mRTXOctetCount = 0;
+        }
+
+        forwarding.mSSRC = found->mSSRC.value();
+        forwarding.mRTXSSRC = rtxSSRC;
+        forwarding.mEncodingID = found->mEncodingID;
+
+        // NOTE: same bitrate bounds the media engine configures for an
+        //       encoded stream of the same kind
+        auto &pacing = mForwardedPacing;
+        if ((mKind.hasValue()) &&
+            (IMediaStreamTrackTypes::Kind_Video == mKind.value())) {
+          pacing.mMinBitrateBps = 30000;
+          pacing.mMaxBitrateBps = (found->mMaxBitrate.hasValue() ? static_cast<int>(found->mMaxBitrate.value()) : 2000000);
+          pacing.mStartBitrateBps = pacing.mMaxBitrateBps / 2;
+        } else {
+          pacing.mMinBitrateBps = 10000;
+          pacing.mStartBitrateBps = 40000;
+          pacing.mMaxBitrateBps = (found->mMaxBitrate.hasValue() ? static_cast<int>(found->mMaxBitrate.value()) : 100000);
+        }
+        pacing.mMinBitrateBps = std::min(pacing.mMinBitrateBps, pacing.mMaxBitrateBps);
+        pacing.mStartBitrateBps = std::min(pacing.mStartBitrateBps, pacing.mMaxBitrateBps);
+        updateForwardedBitrates();
+      }
+
+      forwarding.mMuxID = mParameters->mMuxID;
+      forwarding.mFeedbackSSRC = sourceParams->mRTCP.mSSRC;
+
+      // scope: map media codecs by name and clock rate
+      for (auto iter = sourceParams->mCodecs.begin(); iter != sourceParams->mCodecs.end(); ++iter) {
+        auto &sourceCodec = (*iter);
+        auto supportedCodec = IRTPTypes::toSupportedCodec(sourceCodec.mName);
+
+        switch (supportedCodec) {
+          case IRTPTypes::SupportedCodec_RTX:     continue;   // mapped once the original codecs are known
+          case IRTPTypes::SupportedCodec_ULPFEC:
+          case IRTPTypes::SupportedCodec_FlexFEC: continue;   // protection covers the original headers (thus cannot be forwarded)
+          default:                                break;
+        }
+
+        for (auto iterSender = mParameters->mCodecs.begin(); iterSender != mParameters->mCodecs.end(); ++iterSender) {
+          auto &senderCodec = (*iterSender);
+          if (0 != sourceCodec.mName.compareNoCase(senderCodec.mName)) continue;
+
+          if ((sourceCodec.mClockRate.hasValue()) &&
+              (senderCodec.mClockRate.hasValue())) {
+            if (sourceCodec.mClockRate.value() != senderCodec.mClockRate.value()) continue;
+          }
+
+          ForwardedCodec codec;
+          codec.mPayloadType = senderCodec.mPayloadType;
+          codec.mCodec = supportedCodec;
+          if (sourceCodec.mClockRate.hasValue()) {
+            codec.mClockRate = sourceCodec.mClockRate.value();
+          } else if (senderCodec.mClockRate.hasValue()) {
+            codec.mClockRate = senderCodec.mClockRate.value();
+          }
+
+          forwarding.mCodecs[sourceCodec.mPayloadType] = codec;
+          break;
+        }
+      }
+
+      // scope: map rtx codecs using the codec they retransmit
+      for (auto iter = sourceParams->mCodecs.begin(); iter != sourceParams->mCodecs.end(); ++iter) {
+        auto &sourceCodec = (*iter);
+        if (IRTPTypes::SupportedCodec_RTX != IRTPTypes::toSupportedCodec(sourceCodec.mName)) continue;
+
+        auto sourceRTX = RTXCodecParameters::convert(sourceCodec.mParameters);
+        if (!sourceRTX) continue;
+
+        auto foundOriginal = forwarding.mCodecs.find(sourceRTX->mApt);
+        if (foundOriginal == forwarding.mCodecs.end()) continue;
+
+        auto &original = (*foundOriginal).second;
+
+        ForwardedCodec codec;
+        codec.mPayloadType = original.mPayloadType;
+        codec.mCodec = IRTPTypes::SupportedCodec_RTX;
+        codec.mClockRate = original.mClockRate;
+        codec.mDecapsulateRTX = true;
+        codec.mOriginalPayloadType = original.mPayloadType;
+
+        if (forwarding.mRTXSSRC.hasValue()) {
+          for (auto iterSender = mParameters->mCodecs.begin(); iterSender != mParameters->mCodecs.end(); ++iterSender) {
+            auto &senderCodec = (*iterSender);
+            if (IRTPTypes::SupportedCodec_RTX != IRTPTypes::toSupportedCodec(senderCodec.mName)) continue;
+
+            auto senderRTX = RTXCodecParameters::convert(senderCodec.mParameters);
+            if (!senderRTX) continue;
+            if (senderRTX->mApt != original.mPayloadType) continue;
+
+            codec.mPayloadType = senderCodec.mPayloadType;
+            codec.mDecapsulateRTX = false;
+            break;
+          }
+        }
+
+        forwarding.mCodecs[sourceCodec.mPayloadType] = codec;
+      }
+
+      for (auto iter = sourceParams->mHeaderExtensions.begin(); iter != sourceParams->mHeaderExtensions.end(); ++iter) {
+        auto &ext = (*iter);
+        forwarding.mSourceHeaderExtensions.add(ext.mID, IRTPTypes::toHeaderExtensionURI(ext.mURI));
+      }
+      for (auto iter = mParameters->mHeaderExtensions.begin(); iter != mParameters->mHeaderExtensions.end(); ++iter) {
+        auto &ext = (*iter);
+        forwarding.mSenderHeaderExtensions.add(ext.mID, IRTPTypes::toHeaderExtensionURI(ext.mURI));
+      }
+
+      forwarding.mValid = (forwarding.mCodecs.size() > 0);
+
+      if (!forwarding.mValid) {
+        ZS_LOG_WARNING(Detail, log("no codec received can be forwarded") + forwarding.toDebug())
+        return false;
+      }
+
+      ZS_LOG_DEBUG(log("forwarding prepared") + forwarding.toDebug())
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::keepPreviousForwarding()
+    {
+      auto &forwarding = mForwarding;
+
+      // NOTE: nothing was forwarded from the current source since the last
+      //       switch thus the previous source remains the one to keep
+      if (!forwarding.mSourceSSRC.hasValue()) return;
+
+      forwarding.mPreviousSource = forwarding.mSource;
+      forwarding.mPreviousSourceSSRC = forwarding.mSourceSSRC;
+      forwarding.mPreviousSequenceNumberDelta = forwarding.mSequenceNumberDelta;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::rebaseForwarding(
+                                     const RTPPacket &packet,
+                                     ULONG clockRate
+                                     )
+    {
+      auto &forwarding = mForwarding;
+
+      keepPreviousForwarding();
+
+      if (forwarding.mSent) {
+        // continue from the last packet sent as if the new source had been
+        // sending all along
+        auto elapsed = zsLib::toMilliseconds(zsLib::now() - forwarding.mLastSent).count();
+        DWORD ticks = static_cast<DWORD>((static_cast<ULONGLONG>(elapsed) * static_cast<ULONGLONG>(clockRate)) / 1000);
+        if (0 == ticks) ticks = 1;
+
+        forwarding.mSequenceNumberDelta = static_cast<WORD>(static_cast<WORD>(forwarding.mLastSequenceNumber + 1) - packet.sequenceNumber());
+        forwarding.mTimestampDelta = static_cast<DWORD>((forwarding.mLastTimestamp + ticks) - packet.timestamp());
+      } else {
+        forwarding.mSequenceNumberDelta = 0;
+        forwarding.mTimestampDelta = 0;
+      }
+
+      forwarding.mSwitchSequenceNumber = static_cast<WORD>(packet.sequenceNumber() + forwarding.mSequenceNumberDelta);
+
+      ZS_LOG_DEBUG(log("forwarding source ssrc changed") + ZS_PARAM("old ssrc", forwarding.mSourceSSRC) + ZS_PARAM("new ssrc", packet.ssrc()) + ZS_PARAM("sequence number delta", forwarding.mSequenceNumberDelta) + ZS_PARAM("timestamp delta", forwarding.mTimestampDelta))
+
+      forwarding.mSourceSSRC = packet.ssrc();
+
+      if ((mKind.hasValue()) &&
+          (IMediaStreamTrackTypes::Kind_Video == mKind.value())) {
+        forwarding.mKeyFrameRequestPending = true;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::rewriteForwardedPacket(
+                                           const RTPPacket &packet,
+                                           ForwardedPacket &outPacket
+                                           )
+    {
+      typedef RTPPacket::HeaderExtension HeaderExtension;
+      typedef RTPPacket::StringHeaderExtension StringHeaderExtension;
+
+      auto &forwarding = mForwarding;
+
+      if (0 == packet.payloadSize()) {
+        // NOTE: padding only packets probe the source's link (not ours)
+        ZS_LOG_INSANE(log("not forwarding padding only packet") + ZS_PARAM("ssrc", packet.ssrc()) + ZS_PARAM("sequence number", packet.sequenceNumber()))
+        return false;
+      }
+
+      auto found = forwarding.mCodecs.find(packet.pt());
+      if (found == forwarding.mCodecs.end()) {
+        ZS_LOG_INSANE(log("payload type cannot be forwarded") + ZS_PARAM("pt", packet.pt()) + ZS_PARAM("ssrc", packet.ssrc()))
+        return false;
+      }
+
+      auto &codec = (*found).second;
+
+      RTPPacket::CreationParams params;
+      params.mM = packet.m();
+      params.mPT = codec.mPayloadType;
+      params.mSSRC = forwarding.mSSRC;
+      params.mPayload = packet.payload();
+      params.mPayloadSize = packet.payloadSize();
+      params.mHeaderExtensionAppBits = packet.headerExtensionAppBits();
+
+      SecureByteBlockPtr rewrittenPayload;
+
+      if (IRTPTypes::SupportedCodec_RTX == codec.mCodec) {
+        if (!forwarding.mSourceSSRC.hasValue()) {
+          ZS_LOG_TRACE(log("rtx received before any media was forwarded (thus dropping)") + ZS_PARAM("ssrc", packet.ssrc()))
+          return false;
+        }
+        if (params.mPayloadSize < sizeof(WORD)) {
+          ZS_LOG_WARNING(Trace, log("rtx packet is too small") + ZS_PARAM("ssrc", packet.ssrc()) + ZS_PARAM("payload size", params.mPayloadSize))
+          return false;
+        }
+
+        // NOTE: the original sequence number is assumed to belong to the
+        //       current source (any retransmission of an earlier source
+        //       would be too late to be useful anyway)
+        WORD originalSequenceNumber = static_cast<WORD>(RTPUtils::getBE16(params.mPayload) + forwarding.mSequenceNumberDelta);
+        params.mTimestamp = packet.timestamp() + forwarding.mTimestampDelta;
+
+        if (codec.mDecapsulateRTX) {
+          params.mPT = codec.mOriginalPayloadType;
+          params.mSequenceNumber = originalSequenceNumber;
+          params.mPayload += sizeof(WORD);
+          params.mPayloadSize -= sizeof(WORD);
+        } else {
+          params.mSSRC = forwarding.mRTXSSRC.value();
+          params.mSequenceNumber = forwarding.mRTXSequenceNumber;
+          ++forwarding.mRTXSequenceNumber;
+
+          rewrittenPayload = UseServicesHelper::convertToBuffer(params.mPayload, params.mPayloadSize);
+          RTPUtils::setBE16(rewrittenPayload->BytePtr(), originalSequenceNumber);
+          params.mPayload = rewrittenPayload->BytePtr();
+        }
+      } else {
+        if ((!forwarding.mSourceSSRC.hasValue()) ||
+            (forwarding.mSourceSSRC.value() != packet.ssrc())) {
+          rebaseForwarding(packet, codec.mClockRate);
+        }
+
+        params.mSequenceNumber = static_cast<WORD>(packet.sequenceNumber() + forwarding.mSequenceNumberDelta);
+        params.mTimestamp = packet.timestamp() + forwarding.mTimestampDelta;
+
+        if (IRTPTypes::SupportedCodec_RED == codec.mCodec) {
+          rewrittenPayload = UseServicesHelper::convertToBuffer(params.mPayload, params.mPayloadSize);
+          if (!rewriteForwardedREDPayloadTypes(rewrittenPayload->BytePtr(), rewrittenPayload->SizeInBytes())) {
+            ZS_LOG_TRACE(log("red packet contains a payload type which cannot be forwarded") + ZS_PARAM("ssrc", packet.ssrc()) + ZS_PARAM("sequence number", packet.sequenceNumber()))
+            return false;
+          }
+          params.mPayload = rewrittenPayload->BytePtr();
+        }
+
+        // only newer packets advance the stream (reordered packets do not)
+        if ((!forwarding.mSent) ||
+            (static_cast<WORD>(params.mSequenceNumber - forwarding.mLastSequenceNumber) < 0x8000)) {
+          forwarding.mSent = true;
+          forwarding.mLastSequenceNumber = params.mSequenceNumber;
+          forwarding.mLastTimestamp = params.mTimestamp;
+          forwarding.mLastSent = zsLib::now();
+          forwarding.mLastClockRate = codec.mClockRate;
+        }
+      }
+
+      if (params.mSSRC == forwarding.mSSRC) {
+        ++forwarding.mPacketCount;
+        forwarding.mOctetCount += static_cast<DWORD>(params.mPayloadSize);
+      } else {
+        ++forwarding.mRTXPacketCount;
+        forwarding.mRTXOctetCount += static_cast<DWORD>(params.mPayloadSize);
+      }
+
+      DWORD csrcs[Forwarding::kMaxCSRCs] {};
+      params.mCC = packet.cc();
+      if (params.mCC > Forwarding::kMaxCSRCs) params.mCC = Forwarding::kMaxCSRCs;
+      for (size_t index = 0; index < params.mCC; ++index) {
+        csrcs[index] = packet.getCSRC(index);
+      }
+      params.mCSRCList = (params.mCC > 0 ? &(csrcs[0]) : NULL);
+
+      // scope: rewrite the header extension IDs to those negotiated by the
+      //        sender (extensions the sender did not negotiate are removed)
+      HeaderExtension extensions[ORTC_RTPPACKET_VIEW_MAX_HEADER_EXTENSIONS] {};
+      StringHeaderExtension muxHeader(getForwardedLocalID(forwarding.mSenderHeaderExtensions, IRTPTypes::HeaderExtensionURI_MuxID), forwarding.mMuxID.c_str());
+      StringHeaderExtension ridHeader(getForwardedLocalID(forwarding.mSenderHeaderExtensions, IRTPTypes::HeaderExtensionURI_RID), forwarding.mEncodingID.c_str());
+
+      HeaderExtension **next = &(params.mFirstHeaderExtension);
+      size_t totalExtensions = 0;
+
+      for (auto ext = packet.firstHeaderExtension(); NULL != ext; ext = ext->mNext) {
+        auto uri = forwarding.mSourceHeaderExtensions.uri(ext->mID);
+
+        switch (uri) {
+          case IRTPTypes::HeaderExtensionURI_Unknown:                 continue;
+          case IRTPTypes::HeaderExtensionURI_MuxID:                   continue;   // replaced with the sender's MuxID
+          case IRTPTypes::HeaderExtensionURI_RID:                     continue;   // replaced with the sender's RID
+          case IRTPTypes::HeaderExtensionURI_TransportSequenceNumber: continue;   // re-stamped as sent (see stampForwardedPacket)
+          case IRTPTypes::HeaderExtensionURI_AbsoluteSendTime:        continue;   // re-stamped as sent (see stampForwardedPacket)
+          default:                                                    break;
+        }
+
+        BYTE localID = getForwardedLocalID(forwarding.mSenderHeaderExtensions, uri);
+        if (0 == localID) continue;
+
+        if (totalExtensions >= ORTC_RTPPACKET_VIEW_MAX_HEADER_EXTENSIONS) break;
+
+        auto &outExt = extensions[totalExtensions];
+        ++totalExtensions;
+
+        outExt.mID = localID;
+        outExt.mData = ext->mData;
+        outExt.mDataSizeInBytes = ext->mDataSizeInBytes;
+
+        (*next) = &outExt;
+        next = &(outExt.mNext);
+      }
+
+      // NOTE: placeholders are written so the values stamped once the packet
+      //       leaves the pacer replace them within the packet's own buffer;
+      //       transport-wide sequence numbers are only meaningful when
+      //       allocated from the transport's congestion context
+      BYTE transportSequenceNumberPlaceholder[sizeof(WORD)] {};
+      BYTE absoluteSendTimePlaceholder[3] {};
+      HeaderExtension transportSequenceNumberHeader;
+      HeaderExtension absoluteSendTimeHeader;
+
+      outPacket.mCongestionContext = mForwardedPacing.mCongestionContext;
+      outPacket.mTransportSequenceNumberID = (outPacket.mCongestionContext ? getForwardedLocalID(forwarding.mSenderHeaderExtensions, IRTPTypes::HeaderExtensionURI_TransportSequenceNumber) : 0);
+      outPacket.mAbsoluteSendTimeID = getForwardedLocalID(forwarding.mSenderHeaderExtensions, IRTPTypes::HeaderExtensionURI_AbsoluteSendTime);
+
+      if (0 != outPacket.mTransportSequenceNumberID) {
+        transportSequenceNumberHeader.mID = outPacket.mTransportSequenceNumberID;
+        transportSequenceNumberHeader.mData = &(transportSequenceNumberPlaceholder[0]);
+        transportSequenceNumberHeader.mDataSizeInBytes = sizeof(transportSequenceNumberPlaceholder);
+        (*next) = &transportSequenceNumberHeader;
+        next = &(transportSequenceNumberHeader.mNext);
+      }
+      if (0 != outPacket.mAbsoluteSendTimeID) {
+        absoluteSendTimeHeader.mID = outPacket.mAbsoluteSendTimeID;
+        absoluteSendTimeHeader.mData = &(absoluteSendTimePlaceholder[0]);
+        absoluteSendTimeHeader.mDataSizeInBytes = sizeof(absoluteSendTimePlaceholder);
+        (*next) = &absoluteSendTimeHeader;
+        next = &(absoluteSendTimeHeader.mNext);
+      }
+
+      if ((0 != muxHeader.mID) &&
+          (forwarding.mMuxID.hasData())) {
+        (*next) = &muxHeader;
+        next = &(muxHeader.mNext);
+      }
+      if ((0 != ridHeader.mID) &&
+          (forwarding.mEncodingID.hasData())) {
+        (*next) = &ridHeader;
+        next = &(ridHeader.mNext);
+      }
+
+      outPacket.mPacket = RTPPacket::create(params);
+      outPacket.mQueued = zsLib::now();
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::rewriteForwardedREDPayloadTypes(
+                                                    BYTE *payload,
+                                                    size_t payloadSizeInBytes
+                                                    ) const
+    {
+      // see https://tools.ietf.org/html/rfc2198#section-3
+      size_t pos = 0;
+      while (pos < payloadSizeInBytes) {
+        BYTE &header = payload[pos];
+        bool follows = (0 != (header & 0x80));
+
+        auto found = mForwarding.mCodecs.find(static_cast<PayloadType>(header & 0x7F));
+        if (found == mForwarding.mCodecs.end()) return false;
+
+        auto &codec = (*found).second;
+        if (IRTPTypes::SupportedCodec_RED == codec.mCodec) return false;
+        if (IRTPTypes::SupportedCodec_RTX == codec.mCodec) return false;
+
+        header = static_cast<BYTE>((header & 0x80) | (codec.mPayloadType & 0x7F));
+
+        if (!follows) return true;
+        pos += sizeof(DWORD);
+      }
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::forwardFeedback(const RTCPPacket &inPacket)
+    {
+      typedef RTCPPacket::TransportLayerFeedbackMessage TransportLayerFeedbackMessage;
+      typedef RTCPPacket::PayloadSpecificFeedbackMessage PayloadSpecificFeedbackMessage;
+      typedef RTCPPacketWriter::GenericNACK GenericNACK;
+      typedef RTCPPacketWriter::FIR FIR;
+      typedef std::list<const TransportLayerFeedbackMessage *> TransportLayerFeedbackMessageList;
+
+      {
+        AutoRecursiveLock lock(*this);
+        if (!mForwarding.mSource) return;
+        if (!mForwarding.mSourceSSRC.hasValue()) return;   // nothing forwarded yet
+      }
+
+      // NOTE: the listener parses RTCP in fast mode which skips the RTPFB /
+      //       PSFB reports thus the packet is decoded again in full (outside
+      //       of the lock) before any feedback can be mapped to the source
+      RTCPPacketPtr fullPacket;
+      if (RTCPPacket::ParseMode_Full != inPacket.parseMode()) {
+        fullPacket = RTCPPacket::create(inPacket.ptr(), inPacket.size());
+        if (!fullPacket) return;
+      }
+
+      const RTCPPacket &packet = (fullPacket ? *fullPacket : inPacket);
+
+      UseForwardingSourcePtr source;
+      UseForwardingSourcePtr previousSource;
+      RTCPPacketList packets;
+      RTCPPacketList previousPackets;
+      RTPMediaEngineCongestionContextPtr congestionContext;
+      TransportLayerFeedbackMessageList transportFeedback;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        auto &forwarding = mForwarding;
+
+        if (!forwarding.mSource) return;
+        if (!forwarding.mSourceSSRC.hasValue()) return;   // nothing forwarded yet
+
+        source = forwarding.mSource;
+        if (forwarding.mPreviousSourceSSRC.hasValue()) previousSource = forwarding.mPreviousSource.lock();
+
+        SSRCType sourceSSRC = forwarding.mSourceSSRC.value();
+
+        BYTE buffer[Forwarding::kMaxFeedbackPacketSize];
+        ForwardedFeedbackCollector collector(packets);
+        RTCPPacketWriter writer(&collector, buffer, sizeof(buffer));
+
+        BYTE previousBuffer[Forwarding::kMaxFeedbackPacketSize];
+        ForwardedFeedbackCollector previousCollector(previousPackets);
+        RTCPPacketWriter previousWriter(&previousCollector, previousBuffer, sizeof(previousBuffer));
+
+        ForwardedNACKWriter nackWriter(writer, forwarding.mFeedbackSSRC, sourceSSRC);
+        ForwardedNACKWriter previousNACKWriter(previousWriter, forwarding.mFeedbackSSRC, previousSource ? forwarding.mPreviousSourceSSRC.value() : 0);
+
+        // NOTE: transport-wide feedback reports on the packets sent over this
+        //       sender's transport (not the source's) thus is given to the
+        //       transport's congestion context rather than being forwarded
+        congestionContext = mForwardedPacing.mCongestionContext;
+        if (congestionContext) {
+          for (auto feedback = packet.firstTransportLayerFeedbackMessage(); NULL != feedback; feedback = feedback->nextTransportLayerFeedbackMessage()) {
+            if (TransportLayerFeedbackMessage::TransportCC::kFmt != feedback->fmt()) continue;
+            transportFeedback.push_back(feedback);
+          }
+        }
+
+        WORD sinceSwitch = static_cast<WORD>(forwarding.mLastSequenceNumber - forwarding.mSwitchSequenceNumber);
+
+        for (auto feedback = packet.firstTransportLayerFeedbackMessage(); NULL != feedback; feedback = feedback->nextTransportLayerFeedbackMessage()) {
+          if (GenericNACK::kFmt != feedback->fmt()) continue;
+          if (forwarding.mSSRC != feedback->ssrcOfMediaSource()) continue;
+
+          // NOTE: each lost packet is mapped on its own as a NACK entry may
+          //       span the latest switch; packets sent before the switch are
+          //       mapped with the previous source's delta (and requested
+          //       from the previous source)
+          for (size_t index = 0; index < feedback->genericNACKCount(); ++index) {
+            auto nack = feedback->genericNACKAtIndex(index);
+
+            for (size_t bit = 0; bit <= 16; ++bit) {
+              if ((0 != bit) &&
+                  (0 == (nack->blp() & (1 << (bit - 1))))) continue;
+
+              WORD sequenceNumber = static_cast<WORD>(nack->pid() + bit);
+              WORD age = static_cast<WORD>(forwarding.mLastSequenceNumber - sequenceNumber);
+
+              if ((age > sinceSwitch) &&
+                  (age < 0x8000)) {
+                if (!previousSource) continue;
+                previousNACKWriter.lost(static_cast<WORD>(sequenceNumber - forwarding.mPreviousSequenceNumberDelta));
+                continue;
+              }
+
+              nackWriter.lost(static_cast<WORD>(sequenceNumber - forwarding.mSequenceNumberDelta));
+            }
+          }
+        }
+
+        nackWriter.flush();
+        previousNACKWriter.flush();
+
+        bool requestPLI = false;
+        bool requestFIR = false;
+
+        for (auto feedback = packet.firstPayloadSpecificFeedbackMessage(); NULL != feedback; feedback = feedback->nextPayloadSpecificFeedbackMessage()) {
+          switch (feedback->fmt()) {
+            case PayloadSpecificFeedbackMessage::PLI::kFmt: {
+              if (forwarding.mSSRC != feedback->ssrcOfMediaSource()) break;
+              requestPLI = true;
+              break;
+            }
+            case PayloadSpecificFeedbackMessage::FIR::kFmt: {
+              for (size_t index = 0; index < feedback->firCount(); ++index) {
+                auto fir = feedback->firAtIndex(index);
+                if (forwarding.mSSRC != fir->ssrc()) continue;
+                requestFIR = true;
+              }
+              break;
+            }
+            case PayloadSpecificFeedbackMessage::REMB::kFmt: {
+              auto remb = feedback->remb();
+              if (!remb) break;
+
+              for (size_t index = 0; index < remb->numSSRC(); ++index) {
+                if (forwarding.mSSRC != remb->ssrcAtIndex(index)) continue;
+
+                // NOTE: the estimate is passed to the source as is (if more
+                //       than one sender forwards from the same source the
+                //       source sees each estimate in turn)
+                writer.writeREMB(forwarding.mFeedbackSSRC, remb->brExp(), remb->brMantissa(), &sourceSSRC, 1);
+                break;
+              }
+              break;
+            }
+            default: break;
+          }
+        }
+
+        if ((requestPLI) ||
+            (requestFIR)) {
+          auto tick = zsLib::now();
+
+          if (tick - forwarding.mLastKeyFrameRequest >= mForwardMinKeyFrameRequestInterval) {
+            forwarding.mLastKeyFrameRequest = tick;
+
+            if (requestFIR) {
+              FIR fir;
+              fir.mSSRC = sourceSSRC;
+              fir.mSeqNr = forwarding.mFIRSequenceNumber;
+              ++forwarding.mFIRSequenceNumber;
+              writer.writeFIR(forwarding.mFeedbackSSRC, &fir, 1);
+            } else {
+              writer.writePLI(forwarding.mFeedbackSSRC, sourceSSRC);
+            }
+          } else {
+            ZS_LOG_TRACE(log("key frame request to source suppressed (too soon since last request)") + ZS_PARAM("source ssrc", sourceSSRC))
+          }
+        }
+
+        writer.flush();
+        previousWriter.flush();
+
+        forwarding.mTotalFeedbackForwarded += packets.size() + previousPackets.size();
+      }
+
+      // NOTE: the report's contents follow its common header within the
+      //       packet (the header is included as the context parses the
+      //       whole report)
+      for (auto iter = transportFeedback.begin(); iter != transportFeedback.end(); ++iter) {
+        auto feedback = (*iter);
+        congestionContext->handleTransportFeedback(feedback->ptr() - sizeof(DWORD), feedback->size() + sizeof(DWORD));
+      }
+
+      // NOTE: sent outside the sender's lock (see stop())
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &feedbackPacket = (*iter);
+        ZS_LOG_TRACE(log("forwarding feedback to source") + ZS_PARAM("source", source->getID()) + ZS_PARAM("size", feedbackPacket->size()))
+        source->sendPacket(feedbackPacket);
+      }
+      for (auto iter = previousPackets.begin(); iter != previousPackets.end(); ++iter) {
+        auto &feedbackPacket = (*iter);
+        ZS_LOG_TRACE(log("forwarding feedback to previous source") + ZS_PARAM("source", previousSource->getID()) + ZS_PARAM("size", feedbackPacket->size()))
+        previousSource->sendPacket(feedbackPacket);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::handleForwardedSenderReportTimer(TimerPtr timer)
+    {
+      RTCPPacketList reports;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (timer != mForwardedSenderReportTimer) return false;
+
+        if ((isShuttingDown()) ||
+            (isShutdown())) return true;
+
+        auto &forwarding = mForwarding;
+
+        // NOTE: the media engine may only have started after the forwarding
+        //       source was set
+        if (!mForwardedPacing.mCongestionContext) acquireForwardedCongestionContext();
+
+        if (!forwarding.mSent) return true;   // nothing forwarded yet
+
+        // see https://tools.ietf.org/html/rfc3550#section-6.4.1 (the RTP
+        // timestamp is extrapolated from the last packet sent so it
+        // corresponds to the same instant as the NTP timestamp)
+        auto tick = zsLib::now();
+
+        auto sinceEpoch = std::chrono::duration_cast<Microseconds>(tick.time_since_epoch()).count();
+        ULONGLONG seconds = static_cast<ULONGLONG>(sinceEpoch / 1000000) + 2208988800ULL;   // NTP epoch is 1900 (not 1970)
+        ULONGLONG fraction = ((static_cast<ULONGLONG>(sinceEpoch % 1000000)) << 32) / 1000000;
+
+        DWORD ntpTimestampMS = static_cast<DWORD>(seconds);
+        DWORD ntpTimestampLS = static_cast<DWORD>(fraction);
+
+        auto elapsed = zsLib::toMilliseconds(tick - forwarding.mLastSent).count();
+        if (elapsed < 0) elapsed = 0;
+        DWORD rtpTimestamp = forwarding.mLastTimestamp + static_cast<DWORD>((static_cast<ULONGLONG>(elapsed) * static_cast<ULONGLONG>(forwarding.mLastClockRate)) / 1000);
+
+        String cname;
+        if (mParameters) cname = mParameters->mRTCP.mCName;
+
+        BYTE buffer[Forwarding::kMaxFeedbackPacketSize];
+        ForwardedFeedbackCollector collector(reports);
+        RTCPPacketWriter writer(&collector, buffer, sizeof(buffer));
+
+        writer.writeSenderReport(forwarding.mSSRC, ntpTimestampMS, ntpTimestampLS, rtpTimestamp, forwarding.mPacketCount, forwarding.mOctetCount, NULL, 0);
+        if ((forwarding.mRTXSSRC.hasValue()) &&
+            (0 != forwarding.mRTXPacketCount)) {
+          writer.writeSenderReport(forwarding.mRTXSSRC.value(), ntpTimestampMS, ntpTimestampLS, rtpTimestamp, forwarding.mRTXPacketCount, forwarding.mRTXOctetCount, NULL, 0);
+        }
+        if (cname.hasData()) {
+          writer.writeSDES(forwarding.mSSRC, cname.c_str(), NULL, NULL);
+        }
+        writer.flush();
+      }
+
+      // NOTE: sent outside the sender's lock (see stop())
+      for (auto iter = reports.begin(); iter != reports.end(); ++iter) {
+        auto &report = (*iter);
+        ZS_LOG_TRACE(log("sending sender report for forwarded stream") + ZS_PARAM("size", report->size()))
+        sendPacket(report);
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::acquireForwardedCongestionContext()
+    {
+      auto &pacing = mForwardedPacing;
+
+      PUID secureTransportID = (mRTPTransport ? mRTPTransport->getID() : 0);
+
+      if (pacing.mCongestionContext) {
+        if (secureTransportID == pacing.mSecureTransportID) return;
+        releaseForwardedCongestionContext();
+      }
+
+      if (0 == secureTransportID) return;
+
+      pacing.mCongestionContext = UseMediaEngine::acquireCongestionContext(secureTransportID);
+      if (!pacing.mCongestionContext) {
+        ZS_LOG_TRACE(log("media engine not running (forwarded packets are not congestion controlled)"))
+        return;
+      }
+
+      pacing.mSecureTransportID = secureTransportID;
+      pacing.mCongestionContext->registerChannel(mID, ZS_DYNAMIC_PTR_CAST(IRTPMediaEngineCongestionContextDelegate, mThisWeak.lock()));
+
+      ZS_LOG_DEBUG(log("acquired congestion context for forwarded packets") + ZS_PARAM("secure transport id", secureTransportID))
+
+      updateForwardedBitrates();
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::releaseForwardedCongestionContext()
+    {
+      auto &pacing = mForwardedPacing;
+
+      if (!pacing.mCongestionContext) return;
+
+      ZS_LOG_DEBUG(log("releasing congestion context for forwarded packets") + ZS_PARAM("secure transport id", pacing.mSecureTransportID))
+
+      pacing.mCongestionContext->unregisterChannel(mID);
+      UseMediaEngine::releaseCongestionContext(pacing.mCongestionContext);
+
+      pacing.mCongestionContext.reset();
+      pacing.mSecureTransportID = 0;
+      pacing.mTargetBitrateBps = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::updateForwardedBitrates()
+    {
+      auto &pacing = mForwardedPacing;
+
+      if (!pacing.mCongestionContext) return;
+      if (0 == pacing.mMaxBitrateBps) return;
+
+      pacing.mCongestionContext->setBweBitrates(mID, pacing.mMinBitrateBps, pacing.mStartBitrateBps, pacing.mMaxBitrateBps);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::paceForwardedPackets(ForwardedPacketList &outPackets)
+    {
+      // NOTE: webrtc's pacer can only release packets owned by an RTP/RTCP
+      //       module (which a forwarding sender does not have) thus forwarded
+      //       packets are paced here using the same interval budget at the
+      //       same multiple of this sender's allocated share of the
+      //       transport's estimate
+      auto &pacing = mForwardedPacing;
+
+      auto tick = zsLib::now();
+
+      uint32_t targetBitrateBps = pacing.mTargetBitrateBps;
+
+      if (0 == targetBitrateBps) {
+        // not (yet) congestion controlled
+        pacing.mBudgetInBytes = 0;
+        pacing.mLastBudgetUpdate = tick;
+      } else {
+        LONGLONG pacingBitrateBps = static_cast<LONGLONG>(webrtc::PacedSender::kDefaultPaceMultiplier * targetBitrateBps);
+        LONGLONG maxBudgetInBytes = (pacingBitrateBps * static_cast<LONGLONG>(ForwardedPacing::kBudgetWindowInMilliseconds)) / 8000;
+
+        LONGLONG elapsed = static_cast<LONGLONG>(ForwardedPacing::kIntervalInMilliseconds);
+        if (Time() != pacing.mLastBudgetUpdate) {
+          elapsed = zsLib::toMilliseconds(tick - pacing.mLastBudgetUpdate).count();
+          if (elapsed < 0) elapsed = 0;
+        }
+        pacing.mLastBudgetUpdate = tick;
+
+        pacing.mBudgetInBytes = std::min(pacing.mBudgetInBytes + ((elapsed * pacingBitrateBps) / 8000), maxBudgetInBytes);
+        pacing.mBudgetInBytes = std::max(pacing.mBudgetInBytes, -maxBudgetInBytes);
+      }
+
+      while (pacing.mQueue.size() > 0) {
+        auto &front = pacing.mQueue.front();
+
+        if ((0 != targetBitrateBps) &&
+            (pacing.mBudgetInBytes <= 0)) {
+          // NOTE: packets are never held longer than the maximum queue delay
+          //       (the stream would otherwise fall further behind the source)
+          if (tick - front.mQueued < Milliseconds(static_cast<Milliseconds::rep>(ForwardedPacing::kMaxQueueDelayInMilliseconds))) break;
+        }
+
+        size_t size = front.mPacket->size();
+
+        pacing.mBudgetInBytes -= static_cast<LONGLONG>(size);
+        pacing.mQueueSizeInBytes -= size;
+        if (tick != front.mQueued) ++pacing.mTotalPaced;
+
+        outPackets.push_back(front);
+        pacing.mQueue.pop_front();
+
+        stampForwardedPacket(outPackets.back());
+      }
+
+      if (pacing.mQueue.size() > 0) {
+        if (!pacing.mTimer) {
+          pacing.mTimer = Timer::create(mThisWeak.lock(), Milliseconds(static_cast<Milliseconds::rep>(ForwardedPacing::kIntervalInMilliseconds)));
+        }
+        return;
+      }
+
+      if (pacing.mTimer) {
+        pacing.mTimer->cancel();
+        pacing.mTimer.reset();
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::stampForwardedPacket(ForwardedPacket &packet)
+    {
+      typedef RTPPacket::HeaderExtension HeaderExtension;
+
+      BYTE transportSequenceNumber[sizeof(WORD)] {};
+      BYTE absoluteSendTime[3] {};
+      HeaderExtension transportSequenceNumberHeader;
+      HeaderExtension absoluteSendTimeHeader;
+
+      HeaderExtension *first = NULL;
+      HeaderExtension **next = &first;
+
+      if (0 != packet.mTransportSequenceNumberID) {
+        // see https://tools.ietf.org/html/draft-holmer-rmcat-transport-wide-cc-extensions-01#section-2
+        packet.mTransportSequenceNumber = packet.mCongestionContext->allocateTransportSequenceNumber();
+        RTPUtils::setBE16(&(transportSequenceNumber[0]), packet.mTransportSequenceNumber);
+
+        transportSequenceNumberHeader.mID = packet.mTransportSequenceNumberID;
+        transportSequenceNumberHeader.mData = &(transportSequenceNumber[0]);
+        transportSequenceNumberHeader.mDataSizeInBytes = sizeof(transportSequenceNumber);
+        (*next) = &transportSequenceNumberHeader;
+        next = &(transportSequenceNumberHeader.mNext);
+      }
+
+      if (0 != packet.mAbsoluteSendTimeID) {
+        // see http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time
+        // (24 bit 6.18 fixed point seconds)
+        auto sinceEpoch = std::chrono::duration_cast<Milliseconds>(zsLib::now().time_since_epoch()).count();
+        DWORD value = static_cast<DWORD>(((static_cast<ULONGLONG>(sinceEpoch) << 18) / 1000) & 0x00FFFFFF);
+
+        absoluteSendTime[0] = static_cast<BYTE>(value >> 16);
+        absoluteSendTime[1] = static_cast<BYTE>(value >> 8);
+        absoluteSendTime[2] = static_cast<BYTE>(value);
+
+        absoluteSendTimeHeader.mID = packet.mAbsoluteSendTimeID;
+        absoluteSendTimeHeader.mData = &(absoluteSendTime[0]);
+        absoluteSendTimeHeader.mDataSizeInBytes = sizeof(absoluteSendTime);
+        (*next) = &absoluteSendTimeHeader;
+        next = &(absoluteSendTimeHeader.mNext);
+      }
+
+      if (!first) return;
+
+      // NOTE: the placeholders written when the packet was rewritten are
+      //       replaced in place
+      packet.mPacket->insertHeaderExtensions(first);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPSender::sendForwardedPackets(ForwardedPacketList &packets)
+    {
+      // NOTE: sent outside the sender's lock (see stop())
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &packet = (*iter);
+
+        if (0 != packet.mTransportSequenceNumberID) {
+          packet.mCongestionContext->notifyPacketSent(packet.mTransportSequenceNumber, packet.mPacket->size());
+        }
+
+        sendPacket(packet.mPacket);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    bool RTPSender::handleForwardedPacingTimer(TimerPtr timer)
+    {
+      ForwardedPacketList packets;
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (timer != mForwardedPacing.mTimer) return false;
+
+        paceForwardedPackets(packets);
+      }
+
+      sendForwardedPackets(packets);
+      return true;
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -426,6 +426,14 @@ namespace ortc
     #pragma mark RTPSenderChannel => ForRTPSenderChannelMediaBase
     #pragma mark
 
+    //-------------------------------------------------------------------------
+    PUID RTPSenderChannel::getSecureTransportID() const
+    {
+      auto sender = mSender.lock();
+      if (!sender) return 0;
+      return sender->getSecureTransportID();
+    }
+
     //-------------------------------------------------------------------------
     bool RTPSenderChannel::sendPacket(RTPPacketPtr packet)
     {
@@ -456,35 +464,18 @@ namespace ortc
         if (!tagInfo->mReceiverAck) {
           tagInfo->mSequenceNumberLast = packet->sequenceNumber();
 
-          auto oldHeaderExtensions = packet->mHeaderExtensions; // remember old pointer temporarily
-
           RTPPacket::StringHeaderExtension muxHeader(mMuxHeader ? mMuxHeader->mID : 0, mMuxID.c_str());
           RTPPacket::StringHeaderExtension ridHeader(mRIDHeader ? mRIDHeader->mID : 0, mRID.c_str());
 
-          // Re-point extenion headers in RTP packet to first point to MuxID or
-          // RID or both.
+          RTPPacket::HeaderExtension *firstHeader = &ridHeader;
           if (mMuxID.hasData()) {
-            if (mRID.hasData()) {
-              muxHeader.mNext = &ridHeader;
-              ridHeader.mNext = oldHeaderExtensions;
-              packet->mHeaderExtensions = &muxHeader;
-            } else {
-              muxHeader.mNext = oldHeaderExtensions;
-              packet->mHeaderExtensions = &muxHeader;
-            }
-          } else {
-            ridHeader.mNext = oldHeaderExtensions;
-            packet->mHeaderExtensions = &ridHeader;
+            if (mRID.hasData()) muxHeader.mNext = &ridHeader;
+            firstHeader = &muxHeader;
           }
 
-          RTPPacketPtr newPacket = RTPPacket::create(*packet);
-
-          // Put back old pointer to prevent crash during free of old packet.
-          packet->mHeaderExtensions = oldHeaderExtensions;
-
-          // Replace old packet with new packet that will have additional
-          // extension headers.
-          packet = newPacket;
+          // The MuxID and/or RID are written directly into the packet's
+          // buffer (using the headroom reserved by the media transport).
+          packet->insertHeaderExtensions(firstHeader);
         }
       }
 
@@ -174,9 +174,13 @@ namespace ortc
     {
       TransportPtr transport = Transport::create(mThisWeak.lock());
 
+      auto channel = mSenderChannel.lock();
+      PUID secureTransportID = (channel ? channel->getSecureTransportID() : 0);
+
       PromiseWithRTPMediaEngineChannelResourcePtr setupChannelPromise = UseMediaEngine::setupChannel(
                                                                                                      mThisWeak.lock(),
                                                                                                      transport,
+                                                                                                     secureTransportID,
                                                                                                      MediaStreamTrack::convert(mTrack),
                                                                                                      mParameters,
                                                                                                      mThisWeak.lock()
@@ -609,7 +613,7 @@ namespace ortc
     {
       auto channel = mSenderChannel.lock();
       if (!channel) return false;
-      return channel->sendPacket(RTPPacket::create(packet, length));
+      return channel->sendPacket(RTPPacket::create(packet, length, ORTC_RTP_SENDER_CHANNEL_TAGGING_HEADROOM_IN_BYTES));
     }
     
     //-------------------------------------------------------------------------
@@ -33,11 +33,11 @@
 #include <ortc/internal/platform.h>
 #include <ortc/internal/ortc_RTPUtils.h>
 
-//#include <openpeer/services/IHelper.h>
+#include <openpeer/services/IHelper.h>
 //
 //#include <zsLib/Stringize.h>
 //#include <zsLib/Log.h>
-//#include <zsLib/XML.h>
+#include <zsLib/XML.h>
 //
 //#include <cryptopp/sha.h>
 
@@ -53,7 +53,7 @@ namespace ortc { ZS_DECLARE_SUBSYSTEM(ortclib_rtptypes) }
 namespace ortc
 {
 //  ZS_DECLARE_TYPEDEF_PTR(openpeer::services::ISettings, UseSettings)
-//  ZS_DECLARE_TYPEDEF_PTR(openpeer::services::IHelper, UseServicesHelper)
+  ZS_DECLARE_TYPEDEF_PTR(openpeer::services::IHelper, UseServicesHelper)
 //  ZS_DECLARE_TYPEDEF_PTR(openpeer::services::IHTTP, UseHTTP)
 //
 //  typedef openpeer::services::Hasher<CryptoPP::SHA1> SHA1Hasher;
@@ -464,5 +464,174 @@ namespace ortc
     {
       return Log::Params(message, "ortc::RTPUtils");
     }
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPBufferPool::PooledBuffer
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    class RTPBufferPool::PooledBuffer : public SecureByteBlock
+    {
+    public:
+      PooledBuffer(size_t capacityInBytes) :
+        SecureByteBlock(capacityInBytes),
+        mCapacity(capacityInBytes)
+      {}
+
+      ~PooledBuffer() {restoreSize();}  // wipe and free the entire allocation
+
+      size_t capacity() const {return mCapacity;}
+
+      // NOTE: m_size is the element count maintained by the underlying
+      // secure block; only the reported size changes (the allocation stays
+      // intact until the buffer is destroyed).
+      void setSize(size_t sizeInBytes)
+      {
+        ASSERT(sizeInBytes <= mCapacity)
+        m_size = (sizeInBytes <= mCapacity ? sizeInBytes : mCapacity);
+      }
+
+      void restoreSize() {m_size = mCapacity;}
+
+    protected:
+      size_t mCapacity {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPBufferPool::PooledBufferReleaser
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    struct RTPBufferPool::PooledBufferReleaser
+    {
+      RTPBufferPoolPtr mPool;
+
+      void operator()(SecureByteBlock *released) const {mPool->release(static_cast<PooledBuffer *>(released));}
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPBufferPool
+    #pragma mark
+
+    //-------------------------------------------------------------------------
+    RTPBufferPool::RTPBufferPool(
+                                 const make_private &,
+                                 size_t bufferCapacityInBytes,
+                                 size_t maxPooledBuffers
+                                 ) :
+      mBufferCapacity(bufferCapacityInBytes),
+      mMaxPooledBuffers(maxPooledBuffers)
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    RTPBufferPool::~RTPBufferPool()
+    {
+      mThisWeak.reset();
+
+      for (auto iter = mFreeBuffers.begin(); iter != mFreeBuffers.end(); ++iter) {
+        delete (*iter);
+      }
+      mFreeBuffers.clear();
+    }
+
+    //-------------------------------------------------------------------------
+    RTPBufferPoolPtr RTPBufferPool::create(
+                                           size_t bufferCapacityInBytes,
+                                           size_t maxPooledBuffers
+                                           )
+    {
+      RTPBufferPoolPtr pThis(make_shared<RTPBufferPool>(make_private{}, bufferCapacityInBytes, maxPooledBuffers));
+      pThis->mThisWeak = pThis;
+      return pThis;
+    }
+
+    //-------------------------------------------------------------------------
+    SecureByteBlockPtr RTPBufferPool::obtain(size_t sizeInBytes)
+    {
+      PooledBuffer *buffer {};
+
+      if (sizeInBytes <= mBufferCapacity) {
+        AutoLock lock(mLock);
+        if (mFreeBuffers.size() > 0) {
+          buffer = mFreeBuffers.back();
+          mFreeBuffers.pop_back();
+        }
+      }
+
+      if (!buffer) {
+        buffer = new PooledBuffer(sizeInBytes > mBufferCapacity ? sizeInBytes : mBufferCapacity);
+
+        AutoLock lock(mLock);
+        ++mTotalAllocated;
+      }
+
+      buffer->setSize(sizeInBytes);
+
+      RTPBufferPoolPtr pThis = mThisWeak.lock();
+      ASSERT((bool)pThis)
+
+      PooledBufferReleaser releaser;
+      releaser.mPool = pThis;
+      return SecureByteBlockPtr(buffer, releaser);
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPBufferPool::resize(
+                               const SecureByteBlockPtr &buffer,
+                               size_t sizeInBytes
+                               )
+    {
+      ASSERT((bool)buffer)
+
+      // NOTE: only buffers handed out by obtain() carry the pool's releaser;
+      //       any other block is not a PooledBuffer and cannot be resized
+      ASSERT(NULL != std::get_deleter<PooledBufferReleaser>(buffer))
+
+      static_cast<PooledBuffer &>(*buffer).setSize(sizeInBytes);
+    }
+
+    //-------------------------------------------------------------------------
+    ElementPtr RTPBufferPool::toDebug() const
+    {
+      AutoLock lock(mLock);
+
+      ElementPtr resultEl = Element::create("ortc::RTPBufferPool");
+
+      UseServicesHelper::debugAppend(resultEl, "buffer capacity", mBufferCapacity);
+      UseServicesHelper::debugAppend(resultEl, "max pooled buffers", mMaxPooledBuffers);
+      UseServicesHelper::debugAppend(resultEl, "free buffers", mFreeBuffers.size());
+      UseServicesHelper::debugAppend(resultEl, "total allocated", mTotalAllocated);
+
+      return resultEl;
+    }
+
+    //-------------------------------------------------------------------------
+    void RTPBufferPool::release(PooledBuffer *buffer)
+    {
+      if (buffer->capacity() == mBufferCapacity) {
+        buffer->restoreSize();
+
+        AutoLock lock(mLock);
+        if (mFreeBuffers.size() < mMaxPooledBuffers) {
+          mFreeBuffers.push_back(buffer);
+          return;
+        }
+      }
+
+      delete buffer;
+    }
   } // namespace internal
 }
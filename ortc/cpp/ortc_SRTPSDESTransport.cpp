@@ -342,6 +342,27 @@ namespace ortc
       return mSRTPTransport->sendPacket(sendOverICETransport, packetType, buffer, bufferLengthInBytes);
     }
 
+    //-------------------------------------------------------------------------
+    bool SRTPSDESTransport::sendPackets(
+                                        IICETypes::Components sendOverICETransport,
+                                        IICETypes::Components packetType,
+                                        const PacketBufferList &packets
+                                        )
+    {
+      ZS_LOG_TRACE(log("sending packets") + ZS_PARAM("send over transport", IICETypes::toString(sendOverICETransport)) + ZS_PARAM("packet type", IICETypes::toString(packetType)) + ZS_PARAM("total packets", packets.size()))
+
+      return mSRTPTransport->sendPackets(sendOverICETransport, packetType, packets);
+    }
+
+    //-------------------------------------------------------------------------
+    void SRTPSDESTransport::flushPackets(IICETypes::Components sendOverICETransport)
+    {
+      UseICETransportPtr transport = (IICETypes::Component_RTP == sendOverICETransport ? mICETransportRTP : fixRTCPTransport());
+      if (!transport) return;
+
+      transport->flushPackets();
+    }
+
     //-------------------------------------------------------------------------
     IICETransportPtr SRTPSDESTransport::getICETransport() const
     {
@@ -436,12 +457,32 @@ namespace ortc
       return transport->sendPacket(buffer, bufferLengthInBytes);
     }
 
+    //-------------------------------------------------------------------------
+    bool SRTPSDESTransport::sendEncryptedPackets(
+                                                 IICETypes::Components sendOverICETransport,
+                                                 IICETypes::Components packetType,
+                                                 const PacketBufferList &packets
+                                                 )
+    {
+      if (isShutdown()) {
+        ZS_LOG_WARNING(Debug, log("cannot send packets on shutdown transport"))
+        return false;
+      }
+
+      UseICETransportPtr transport = (IICETypes::Component_RTP == sendOverICETransport ? mICETransportRTP : fixRTCPTransport());
+      if (!transport) {
+        ZS_LOG_WARNING(Debug, log("no ice transport is attached") + ZS_PARAM("send over transport", IICETypes::toString(sendOverICETransport)) + ZS_PARAM("packet type", IICETypes::toString(packetType)))
+        return false;
+      }
+
+      return transport->sendPackets(packets);
+    }
+
     //-------------------------------------------------------------------------
     bool SRTPSDESTransport::handleReceivedDecryptedPacket(
                                                           IICETypes::Components viaTransport,
                                                           IICETypes::Components packetType,
-                                                          const BYTE *buffer,
-                                                          size_t bufferLengthInBytes
+                                                          SecureByteBlockPtr decryptedBuffer
                                                           )
     {
       if (isShutdown()) {
@@ -449,9 +490,9 @@ namespace ortc
         return false;
       }
 
-      ZS_LOG_INSANE(log("forwarding packet to RTP listener") + ZS_PARAM("rtp listener id", mRTPListener->getID()) + ZS_PARAM("via", IICETypes::toString(viaTransport)) + ZS_PARAM("packet type", IICETypes::toString(packetType)) + ZS_PARAM("buffer length", bufferLengthInBytes))
+      ZS_LOG_INSANE(log("forwarding packet to RTP listener") + ZS_PARAM("rtp listener id", mRTPListener->getID()) + ZS_PARAM("via", IICETypes::toString(viaTransport)) + ZS_PARAM("packet type", IICETypes::toString(packetType)) + ZS_PARAM("buffer length", decryptedBuffer->SizeInBytes()))
 
-      return mRTPListener->handleRTPPacket(viaTransport, packetType, buffer, bufferLengthInBytes);
+      return mRTPListener->handleRTPPacket(viaTransport, packetType, decryptedBuffer);
     }
 
     //-------------------------------------------------------------------------
@@ -135,6 +135,9 @@ namespace ortc
     void ISRTPTransportForSettings::applyDefaults()
     {
 //      UseSettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_WARN_OF_KEY_LIFETIME_EXHAUGSTION_WHEN_REACH_PERCENTAGE_USSED, 90);
+      UseSettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_PACKET_BUFFER_CAPACITY_IN_BYTES, 1500);
+      UseSettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_MAX_POOLED_DECRYPT_BUFFERS, 64);
+      UseSettings::setUInt(ORTC_SETTING_SRTP_TRANSPORT_MAX_POOLED_ENCRYPT_BUFFERS, 64);
     }
 
     //-------------------------------------------------------------------------
@@ -385,7 +388,8 @@ namespace ortc
       MessageQueueAssociator(queue),
       SharedRecursiveLock(SharedRecursiveLock::create()),
       mSecureTransport(secureTransport),
-      mSRTPInit(SRTPInit::singleton())
+      mSRTPInit(SRTPInit::singleton()),
+      mDecryptBufferPool(RTPBufferPool::create(UseSettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_PACKET_BUFFER_CAPACITY_IN_BYTES), UseSettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_MAX_POOLED_DECRYPT_BUFFERS)))
     {
       EventWriteOrtcSrtpTransportCreate(__func__, mID, ((bool)secureTransport) ? secureTransport->getID() : 0);
 
@@ -524,6 +528,10 @@ namespace ortc
           mMaterial[loop].mTempMKIHolder = make_shared<SecureByteBlock>(mkiLength);
         }
       }
+
+      // encrypted packets need headroom for the authentication tag and MKI
+      size_t encryptHeadroom = SRTP_MAX_TRAILER_LEN + (ORTC_SRTPTRANSPORT_ILLEGAL_MKI_LEGNTH != mMaterial[Direction_Encrypt].mMKILength ? mMaterial[Direction_Encrypt].mMKILength : 0);
+      mEncryptBufferPool = RTPBufferPool::create(UseSettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_PACKET_BUFFER_CAPACITY_IN_BYTES) + encryptHeadroom, UseSettings::getUInt(ORTC_SETTING_SRTP_TRANSPORT_MAX_POOLED_ENCRYPT_BUFFERS));
     }
 
     //-------------------------------------------------------------------------
@@ -737,25 +745,24 @@ namespace ortc
 
       ASSERT(((bool)transport))
 
+      // The packet is copied once into a pooled buffer and decrypted in place.
+      // The same buffer is later handed to the RTP listener which takes
+      // ownership of it (thus no further copies are made).
+      decryptedBuffer = mDecryptBufferPool->obtain(bufferLengthInBytes);
+      memcpy(decryptedBuffer->BytePtr(), buffer, bufferLengthInBytes);
+
       if (material.mMKILength > 0) {
         // As part of the decryption process, the MKI value must be stripped from
-        // the packet. This is done by selectively copying from the source packet
-        // to the decryptedBuffer (which is not yet decrypted).
-        decryptedBuffer = make_shared<SecureByteBlock>(bufferLengthInBytes - material.mMKILength);
-
+        // the packet. This is done by shifting the authentication tag over
+        // the MKI value within the buffer (which is not yet decrypted).
         size_t headerAndPayloadSize = bufferLengthInBytes - authenticationTagLength - material.mMKILength;
 
-        // first copy the RTP header and encrypted payload
-        memcpy(decryptedBuffer->BytePtr(), buffer, headerAndPayloadSize);
-
         BYTE *destAuthTag = &((decryptedBuffer->BytePtr())[headerAndPayloadSize]);
-        const BYTE *sourceAuthTag = &(buffer[headerAndPayloadSize + material.mMKILength]);
+        const BYTE *sourceAuthTag = &((decryptedBuffer->BytePtr())[headerAndPayloadSize + material.mMKILength]);
 
-        memcpy(destAuthTag, sourceAuthTag, authenticationTagLength);
-      } else {
-        // nothing fancy here, just copy the source packet into the decrypted
-        // buffer and prepare for decryption
-        decryptedBuffer = make_shared<SecureByteBlock>(buffer, bufferLengthInBytes);
+        memmove(destAuthTag, sourceAuthTag, authenticationTagLength);
+
+        RTPBufferPool::resize(decryptedBuffer, bufferLengthInBytes - material.mMKILength);
       }
 
 
@@ -830,8 +837,10 @@ namespace ortc
 
       ZS_LOG_INSANE(log("forwarding packet to secure transport") + ZS_PARAM("via", IICETypes::toString(viaTransport)) + ZS_PARAM("component", IICETypes::toString(component)) + ZS_PARAM("buffer length in bytes", decryptedBuffer->SizeInBytes()))
 
+      RTPBufferPool::resize(decryptedBuffer, SafeInt<size_t>(out_len));
+
       EventWriteOrtcSrtpTransportDeliverIncomingDecryptedPacket(__func__, mID, transport->getID(), zsLib::to_underlying(viaTransport), zsLib::to_underlying(component), SafeInt<size_t>(out_len), decryptedBuffer->BytePtr());
-      return transport->handleReceivedDecryptedPacket(viaTransport, component, decryptedBuffer->BytePtr(), SafeInt<size_t>(out_len));
+      return transport->handleReceivedDecryptedPacket(viaTransport, component, decryptedBuffer);
     }
 
     //-------------------------------------------------------------------------
@@ -892,9 +901,14 @@ namespace ortc
         updateTotalPackets(Direction_Encrypt, packetType, keyingMaterial);
       }
 
+      if (!mEncryptBufferPool) {
+        ZS_LOG_WARNING(Debug, log("cannot encrypt packet as encryption buffer pool is not available") + ZS_PARAM("buffer size", bufferLengthInBytes))
+        return false;
+      }
+
       // Encrypted buffer must include enough room for the full packet and the
       // MKI and authentication tag.
-      encryptedBuffer = make_shared<SecureByteBlock>(bufferLengthInBytes + authenticationTagLength + material.mMKILength);
+      encryptedBuffer = mEncryptBufferPool->obtain(bufferLengthInBytes + authenticationTagLength + material.mMKILength);
 
       memcpy(encryptedBuffer->BytePtr(), buffer, bufferLengthInBytes);
 
@@ -947,6 +961,165 @@ namespace ortc
       return transport->sendEncryptedPacket(sendOverICETransport, packetType, encryptedBuffer->BytePtr(), encryptedBuffer->SizeInBytes());
     }
 
+    //-------------------------------------------------------------------------
+    bool SRTPTransport::sendPackets(
+                                    IICETypes::Components sendOverICETransport,
+                                    IICETypes::Components packetType,  // are packets RTP or RTCP
+                                    const PacketBufferList &packets
+                                    )
+    {
+      if (packets.size() < 1) return true;
+
+      UseSecureTransportPtr transport;
+      KeyingMaterialPtr keyingMaterial;
+
+      bool protectIndividually {false};
+
+      DirectionMaterial &material = mMaterial[Direction_Encrypt]; // WARNING: only some values are accessible outside a lock
+
+      size_t authenticationTagLength = (IICETypes::Component_RTP == packetType ? material.mAuthenticationTagLength[packetType] : material.mAuthenticationTagLength[packetType] + 4);
+
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        if (!(*iter)) {
+          ZS_LOG_WARNING(Debug, log("cannot encrypt null packet in batch") + ZS_PARAM("total packets", packets.size()))
+          return false;
+        }
+      }
+
+      if (!mEncryptBufferPool) {
+        ZS_LOG_WARNING(Debug, log("cannot encrypt packets as encryption buffer pool is not available") + ZS_PARAM("total packets", packets.size()))
+        return false;
+      }
+
+      {
+        AutoRecursiveLock lock(*this);
+
+        if (0 == mLastRemainingOverallPercentageReported) {
+          ZS_LOG_WARNING(Detail, log("cannot encrypt packets as packet lifetime is exhausted"))
+          return false;
+        }
+
+        transport = mSecureTransport.lock();
+        if (!transport) {
+          ZS_LOG_WARNING(Debug, log("nowhere to send packets as secure transport is gone"))
+          return false;
+        }
+
+        while (true) {
+          if (material.mKeyList.size() < 1) {
+            ZS_LOG_WARNING(Debug, log("no more keying material is present (all lifetimes are exhausted)") + material.toDebug())
+            return false;
+          }
+
+          keyingMaterial = material.mKeyList.front();
+
+          ASSERT(((bool)keyingMaterial))
+
+          if (keyingMaterial->mTotalPackets[packetType] + 1 > keyingMaterial->mLifetime) {
+            ZS_LOG_WARNING(Debug, log("cannot use keying material as it's lifetime is exhausted") + keyingMaterial->toDebug())
+            material.mKeyList.pop_front();
+            continue; // try another key
+          }
+
+          break;
+        }
+
+        if (keyingMaterial->mTotalPackets[packetType] + packets.size() > keyingMaterial->mLifetime) {
+          // the key will be exhausted part way through the batch
+          protectIndividually = true;
+        } else {
+          for (size_t index = 0; index < packets.size(); ++index) {
+            updateTotalPackets(Direction_Encrypt, packetType, keyingMaterial);
+          }
+        }
+      }
+
+      if (protectIndividually) {
+        ZS_LOG_DEBUG(log("keying material will rotate within batch (thus protecting packets individually)") + ZS_PARAM("total packets", packets.size()))
+
+        bool result = true;
+        for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+          auto &packet = (*iter);
+          if (!sendPacket(sendOverICETransport, packetType, packet->BytePtr(), packet->SizeInBytes())) result = false;
+        }
+        return result;
+      }
+
+      PacketBufferList encryptedPackets;
+      encryptedPackets.reserve(packets.size());
+
+      // Every output slot is prepared (with room for the authentication tag
+      // and MKI) before the session lock is taken.
+      for (auto iter = packets.begin(); iter != packets.end(); ++iter) {
+        auto &packet = (*iter);
+
+        EventWriteOrtcSrtpTransportSendOutgoingPacketAndEncrypt(__func__, mID, zsLib::to_underlying(sendOverICETransport), zsLib::to_underlying(packetType), SafeInt<unsigned int>(packet->SizeInBytes()), packet->BytePtr());
+
+        SecureByteBlockPtr encryptedBuffer = mEncryptBufferPool->obtain(packet->SizeInBytes() + authenticationTagLength + material.mMKILength);
+        memcpy(encryptedBuffer->BytePtr(), packet->BytePtr(), packet->SizeInBytes());
+
+        encryptedPackets.push_back(encryptedBuffer);
+      }
+
+      size_t totalProtected {};
+
+      // scope: lock the keying material once for the entire batch
+      {
+        AutoLock lock(keyingMaterial->mSRTPSessionLock);
+
+        for (; totalProtected < packets.size(); ++totalProtected) {
+          auto &encryptedBuffer = encryptedPackets[totalProtected];
+
+          int out_len {static_cast<int>(packets[totalProtected]->SizeInBytes())};
+
+          int err = (packetType == IICETypes::Component_RTP ? srtp_protect(keyingMaterial->mSRTPSession, encryptedBuffer->BytePtr(), &out_len) :
+                                                              srtp_protect_rtcp(keyingMaterial->mSRTPSession, encryptedBuffer->BytePtr(), &out_len));
+
+          if (err != err_status_ok) {
+            ZS_LOG_WARNING(Debug, log("cannot use current keying material for encryption") + ZS_PARAM("packet index", totalProtected) + keyingMaterial->toDebug())
+            break;
+          }
+
+          ASSERT(SafeInt<size_t>(out_len) + material.mMKILength <= encryptedBuffer->SizeInBytes())
+        }
+      }
+
+      if (totalProtected < packets.size()) {
+        // NOTE: packets already protected consumed their SRTP index thus are
+        //       still sent; only the unprotected remainder is handed back
+        //       to the key's lifetime.
+        AutoRecursiveLock lock(*this);
+        releaseTotalPackets(Direction_Encrypt, packetType, keyingMaterial, packets.size() - totalProtected);
+        encryptedPackets.resize(totalProtected);
+      }
+
+      if (material.mMKILength > 0) {
+        // Need to make room for the MKI by moving the authentication tag
+        // after the spot where the MKI is to be inserted (see sendPacket).
+        for (size_t index = 0; index < encryptedPackets.size(); ++index) {
+          size_t packetSize = packets[index]->SizeInBytes();
+          BYTE *encrypted = encryptedPackets[index]->BytePtr();
+
+          memmove(&(encrypted[packetSize + material.mMKILength]), &(encrypted[packetSize]), authenticationTagLength);   // must use a memmove not a memcpy incase the source/dest buffers overlap
+          memcpy(&(encrypted[packetSize]), keyingMaterial->mMKIValue->BytePtr(), material.mMKILength);
+        }
+      }
+
+      ASSERT(((bool)transport))
+
+      // do NOT call this method from within a lock
+      for (auto iter = encryptedPackets.begin(); iter != encryptedPackets.end(); ++iter) {
+        auto &encryptedBuffer = (*iter);
+        EventWriteOrtcSrtpTransportSendOutgoingEncryptedPacketViaSecureTransport(__func__, mID, transport->getID(), zsLib::to_underlying(sendOverICETransport), zsLib::to_underlying(packetType), SafeInt<unsigned int>(encryptedBuffer->SizeInBytes()), encryptedBuffer->BytePtr());
+      }
+
+      bool sent = true;
+      if (encryptedPackets.size() > 0) {
+        sent = transport->sendEncryptedPackets(sendOverICETransport, packetType, encryptedPackets);
+      }
+      return sent && (totalProtected == packets.size());
+    }
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -1042,6 +1215,9 @@ namespace ortc
         UseServicesHelper::debugAppend(resultEl, toString((Directions)loopDirection), mMaterial[loopDirection].toDebug());
       }
 
+      UseServicesHelper::debugAppend(resultEl, "decrypt buffer pool", mDecryptBufferPool ? mDecryptBufferPool->toDebug() : ElementPtr());
+      UseServicesHelper::debugAppend(resultEl, "encrypt buffer pool", mEncryptBufferPool ? mEncryptBufferPool->toDebug() : ElementPtr());
+
       return resultEl;
     }
 
@@ -1099,6 +1275,23 @@ namespace ortc
       }
     }
 
+    //-------------------------------------------------------------------------
+    void SRTPTransport::releaseTotalPackets(
+                                            Directions direction,
+                                            IICETypes::Components component,
+                                            KeyingMaterialPtr &keyingMaterial,
+                                            size_t totalUnused
+                                            )
+    {
+      // NOTE: remaining percentages already reported are not raised again;
+      //       the next update simply reports from the corrected totals.
+      size_t &totalKeyPackets = (keyingMaterial->mTotalPackets[component]);
+      size_t &totalDirectionPackets = (mMaterial[direction].mTotalPackets[component]);
+
+      totalKeyPackets -= (totalUnused < totalKeyPackets ? totalUnused : totalKeyPackets);
+      totalDirectionPackets -= (totalUnused < totalDirectionPackets ? totalUnused : totalDirectionPackets);
+    }
+
     //-------------------------------------------------------------------------
     size_t SRTPTransport::parseLifetime(const String &lifetime) throw(InvalidParameters)
     {
@@ -40,8 +40,10 @@
 #include <ortc/internal/ortc_Identity.h>
 #include <ortc/internal/ortc_MediaDevices.h>
 #include <ortc/internal/ortc_MediaStreamTrack.h>
+#include <ortc/internal/ortc_ORTC.h>
 #include <ortc/internal/ortc_RTPListener.h>
 #include <ortc/internal/ortc_RTPMediaEngine.h>
+#include <ortc/internal/ortc_RTPPacket.h>
 #include <ortc/internal/ortc_RTPReceiver.h>
 #include <ortc/internal/ortc_RTPReceiverChannel.h>
 #include <ortc/internal/ortc_RTPReceiverChannelAudio.h>
@@ -169,8 +171,10 @@ namespace ortc
       IIdentityForSettings::applyDefaults();
       IMediaDevicesForSettings::applyDefaults();
       IMediaStreamTrackForSettings::applyDefaults();
+      IORTCForSettings::applyDefaults();
       IRTPListenerForSettings::applyDefaults();
       IRTPMediaEngineForSettings::applyDefaults();
+      IRTPPacketForSettings::applyDefaults();
       IRTPReceiverForSettings::applyDefaults();
       IRTPReceiverChannelForSettings::applyDefaults();
       IRTPReceiverChannelAudioForSettings::applyDefaults();
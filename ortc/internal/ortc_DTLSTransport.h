@@ -48,6 +48,7 @@
 
 #define ORTC_SETTING_DTLS_TRANSPORT_MAX_PENDING_DTLS_BUFFER "ortc/dtls/max-pending-dtls-buffer"
 #define ORTC_SETTING_DTLS_TRANSPORT_MAX_PENDING_RTP_PACKETS "ortc/dtls/max-pending-rtp-packets"
+#define ORTC_SETTING_DTLS_TRANSPORT_MAX_CACHED_SSL_CONTEXTS "ortc/dtls/max-cached-ssl-contexts"
 
 namespace ortc
 {
@@ -95,6 +96,7 @@ namespace ortc
     interaction IDTLSTransportAsyncDelegate
     {
       virtual void onAdapterSendPacket() = 0;
+      virtual void onAdapterReadPendingDTLS() = 0;
       virtual void onDeliverPendingIncomingRTP() = 0;
     };
 
@@ -156,6 +158,7 @@ namespace ortc
 
       typedef CryptoPP::ByteQueue ByteQueue;
       typedef std::queue<SecureByteBlockPtr> PacketQueue;
+      typedef std::queue<size_t> SizeQueue;
 
       typedef std::list<PromisePtr> PromiseList;
 
@@ -261,6 +264,14 @@ namespace ortc
                               size_t bufferLengthInBytes
                               ) override;
 
+      virtual bool sendPackets(
+                               IICETypes::Components sendOverICETransport,
+                               IICETypes::Components packetType,
+                               const PacketBufferList &packets
+                               ) override;
+
+      virtual void flushPackets(IICETypes::Components sendOverICETransport) override;
+
       virtual IICETransportPtr getICETransport() const override;
 
 
@@ -322,11 +333,16 @@ namespace ortc
                                        size_t bufferLengthInBytes
                                        ) override;
 
+      virtual bool sendEncryptedPackets(
+                                        IICETypes::Components sendOverICETransport,
+                                        IICETypes::Components packetType,
+                                        const PacketBufferList &packets
+                                        ) override;
+
       virtual bool handleReceivedDecryptedPacket(
                                                  IICETypes::Components viaTransport,
                                                  IICETypes::Components packetType,
-                                                 const BYTE *buffer,
-                                                 size_t bufferLengthInBytes
+                                                 SecureByteBlockPtr decryptedBuffer
                                                  ) override;
 
       //-----------------------------------------------------------------------
@@ -382,6 +398,7 @@ namespace ortc
       #pragma mark
 
       virtual void onAdapterSendPacket() override;
+      virtual void onAdapterReadPendingDTLS() override;
       virtual void onDeliverPendingIncomingRTP() override;
 
       //-----------------------------------------------------------------------
@@ -649,6 +666,7 @@ namespace ortc
 
         // SSL library configuration
         SSL_CTX* setupSSLContext();
+        String getSSLContextCacheKey() const;
         // SSL verification check
         bool sslPostConnectionCheck(
                                     SSL* ssl,
@@ -744,6 +762,8 @@ namespace ortc
       bool mPutIncomingRTPIntoPendingQueue {true};
       PacketQueue mPendingIncomingRTP;
       ByteQueue mPendingIncomingDTLS;
+      SizeQueue mPendingIncomingDTLSSizes;   // datagram boundaries within mPendingIncomingDTLS
+      bool mPendingIncomingDTLSPosted {false};
 
       PacketQueue mPendingOutgoingDTLS;
 
@@ -785,5 +805,6 @@ namespace ortc
 ZS_DECLARE_PROXY_BEGIN(ortc::internal::IDTLSTransportAsyncDelegate)
 ZS_DECLARE_PROXY_TYPEDEF(zsLib::PromisePtr, PromisePtr)
 ZS_DECLARE_PROXY_METHOD_0(onAdapterSendPacket)
+ZS_DECLARE_PROXY_METHOD_0(onAdapterReadPendingDTLS)
 ZS_DECLARE_PROXY_METHOD_0(onDeliverPendingIncomingRTP)
 ZS_DECLARE_PROXY_END()
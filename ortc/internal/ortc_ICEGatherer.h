@@ -50,6 +50,8 @@
 
 #include <cryptopp/queue.h>
 
+#include <atomic>
+
 #define ORTC_SETTING_GATHERER_INTERFACE_NAME_MAPPING  "ortc/gatherer/interface-name-mapping"
 #define ORTC_SETTING_GATHERER_USERNAME_FRAG_LENGTH  "ortc/gatherer/username-frag-length"
 #define ORTC_SETTING_GATHERER_PASSWORD_LENGTH  "ortc/gatherer/password-length"
@@ -86,6 +88,15 @@
 
 #define ORTC_SETTING_GATHERER_RECHECK_IP_ADDRESSES_IN_SECONDS "ortc/gatherer/recheck-ip-addresses-in-seconds"
 
+#define ORTC_SETTING_GATHERER_UDP_RECEIVE_BATCH_SIZE "ortc/gatherer/udp-receive-batch-size"                           // 0 or 1 = read one packet at a time
+#define ORTC_SETTING_GATHERER_UDP_RECEIVE_BATCH_SLAB_SIZE_IN_BYTES "ortc/gatherer/udp-receive-batch-slab-size-in-bytes"  // larger packets are dropped
+
+#define ORTC_SETTING_GATHERER_UDP_SEND_BATCH_SIZE "ortc/gatherer/udp-send-batch-size"                                 // 0 or 1 = send each packet immediately
+#define ORTC_SETTING_GATHERER_UDP_SEND_FLUSH_WINDOW_IN_MILLISECONDS "ortc/gatherer/udp-send-flush-window-in-milliseconds"  // longest time a packet waits in a send batch
+#define ORTC_SETTING_GATHERER_UDP_SEND_SEGMENTATION_OFFLOAD "ortc/gatherer/udp-send-segmentation-offload"             // use UDP_SEGMENT (GSO) when the kernel supports it
+
+#define ORTC_SETTING_GATHERER_UDP_REUSE_PORT_SHARDS "ortc/gatherer/udp-reuse-port-shards"                             // 0 or 1 = one UDP socket per host port
+
 namespace ortc
 {
   namespace internal
@@ -165,6 +176,14 @@ namespace ortc
                               size_t bufferSizeInBytes
                               ) = 0;
 
+      virtual bool sendPackets(
+                               UseICETransport &transport,
+                               RouterRoutePtr routerRoute,
+                               const PacketBufferList &packets
+                               ) = 0;
+
+      virtual void flushPackets() = 0;
+
       virtual void notifyLikelyReflexiveActivity(RouterRoutePtr routerRoute) = 0;
     };
 
@@ -285,6 +304,8 @@ namespace ortc
       ZS_DECLARE_TYPEDEF_PTR(IICETypes::CandidateList, CandidateList)
       ZS_DECLARE_TYPEDEF_PTR(ICEGathererRouter::Route, RouterRoute)
 
+      typedef ICEGathererRouter::LocalCandidateID LocalCandidateID;
+
       typedef std::list<IPAddress> IPAddressList;
 
       ZS_DECLARE_CLASS_PTR(HostIPSorter)
@@ -293,6 +314,9 @@ namespace ortc
       ZS_DECLARE_STRUCT_PTR(RelayPort)
       ZS_DECLARE_STRUCT_PTR(TCPPort)
       ZS_DECLARE_STRUCT_PTR(BufferedPacket)
+      ZS_DECLARE_STRUCT_PTR(UDPReceiveBatch)
+      ZS_DECLARE_STRUCT_PTR(UDPSendBatch)
+      ZS_DECLARE_STRUCT_PTR(UDPShard)
       ZS_DECLARE_STRUCT_PTR(Route)
       ZS_DECLARE_STRUCT_PTR(InstalledTransport)
       ZS_DECLARE_STRUCT_PTR(Preference)
@@ -326,6 +350,8 @@ namespace ortc
 
       typedef std::list<BufferedPacketPtr> BufferedPacketList;
 
+      typedef std::list<UDPShardPtr> UDPShardList;
+
       typedef String UsernameFragment;
       typedef PUID TransportID;
       typedef std::map<UsernameFragment, InstalledTransportPtr> TransportMap;
@@ -446,6 +472,14 @@ namespace ortc
                               size_t bufferSizeInBytes
                               ) override;
 
+      virtual bool sendPackets(
+                               UseICETransport &transport,
+                               RouterRoutePtr routerRoute,
+                               const PacketBufferList &packets
+                               ) override;
+
+      virtual void flushPackets() override;
+
       virtual void notifyLikelyReflexiveActivity(RouterRoutePtr routerRoute) override;
 
       //-----------------------------------------------------------------------
@@ -671,6 +705,7 @@ namespace ortc
 
         String mOptionsHash;
         CandidatePtr mCandidate;
+        LocalCandidateID mCandidateID {};
 
         Time mLastActivity;
         TimerPtr mInactivityTimer;
@@ -697,6 +732,8 @@ namespace ortc
         String mOptionsHash;
         CandidatePtr mRelayCandidate;
         CandidatePtr mReflexiveCandidate;
+        LocalCandidateID mRelayCandidateID {};
+        LocalCandidateID mReflexiveCandidateID {};
 
         Time mLastActivity;
         TimerPtr mInactivityTimer;
@@ -720,12 +757,18 @@ namespace ortc
 
         String mBoundOptionsHash;
         CandidatePtr mCandidateUDP;
+        LocalCandidateID mCandidateUDPID {};
         IPAddress mBoundUDPIP;
         SocketPtr mBoundUDPSocket;
         UseBackOffTimerPtr mBindUDPBackOffTimer;
+        UDPReceiveBatchPtr mUDPReceiveBatch;  // only used when batch receiving is supported
+        UDPSendBatchPtr mUDPSendBatch;        // only used when batch sending is supported
+        UDPShardList mUDPShards;              // SO_REUSEPORT sockets bound to mBoundUDPIP (first shard reads from mBoundUDPSocket)
         
         CandidatePtr mCandidateTCPPassive;
         CandidatePtr mCandidateTCPActive;
+        LocalCandidateID mCandidateTCPPassiveID {};
+        LocalCandidateID mCandidateTCPActiveID {};
 
         IPAddress mBoundTCPIP;
         SocketPtr mBoundTCPSocket;
@@ -745,6 +788,71 @@ namespace ortc
         ElementPtr toDebug() const;
       };
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGatherer::UDPShard
+      #pragma mark
+
+      struct UDPShard : public MessageQueueAssociator,
+                        public zsLib::ISocketDelegate
+      {
+        struct CachedRoute
+        {
+          PUID mRouteID {};
+          RouterRoutePtr mRouterRoute;
+          UseICETransportWeakPtr mTransport;
+          Time mExpires;
+          size_t mGeneration {};
+        };
+
+        typedef std::map<IPAddress, CachedRoute> RemoteIPToCachedRouteMap;
+
+        AutoPUID mID;
+        UDPShardWeakPtr mThisWeak;
+
+        ICEGathererWeakPtr mGatherer;
+        HostPortWeakPtr mHostPort;
+        SocketPtr mSocket;
+
+        UDPReceiveBatchPtr mUDPReceiveBatch;  // only used when batch receiving is supported
+
+        mutable Lock mLock;
+        RemoteIPToCachedRouteMap mRouteCache;
+
+        UDPShard(IMessageQueuePtr queue) : MessageQueueAssociator(queue) {}
+
+        static UDPShardPtr create(
+                                  IMessageQueuePtr queue,
+                                  ICEGathererPtr gatherer,
+                                  HostPortPtr hostPort,
+                                  SocketPtr socket
+                                  );
+
+        bool findRoute(
+                       const IPAddress &remoteIP,
+                       size_t generation,
+                       PUID &outRouteID,
+                       RouterRoutePtr &outRouterRoute,
+                       UseICETransportPtr &outTransport
+                       );
+        void cacheRoute(
+                        const IPAddress &remoteIP,
+                        size_t generation,
+                        PUID routeID,
+                        RouterRoutePtr routerRoute,
+                        UseICETransportPtr transport
+                        );
+
+        virtual void onReadReady(SocketPtr socket) override;
+        virtual void onWriteReady(SocketPtr socket) override;
+        virtual void onException(SocketPtr socket) override;
+
+        ElementPtr toDebug() const;
+      };
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -761,6 +869,7 @@ namespace ortc
         bool mWriteReady {false};
 
         CandidatePtr mCandidate;
+        LocalCandidateID mCandidateID {};
 
         IPAddress mRemoteIP;
         SocketPtr mSocket;
@@ -945,7 +1054,8 @@ namespace ortc
       SocketPtr bind(
                      bool firstAttempt,
                      IPAddress &ioBindIP,
-                     IICETypes::Protocols protocol
+                     IICETypes::Protocols protocol,
+                     bool reusePort
                      );
 
       CandidatePtr createCandidate(
@@ -981,6 +1091,15 @@ namespace ortc
                 HostPortPtr hostPort,
                 SocketPtr socket
                 );
+      bool readBatch(
+                     HostPortPtr hostPort,
+                     UDPShardPtr shard,
+                     SocketPtr socket
+                     );
+      bool readShard(
+                     HostPortPtr hostPort,
+                     UDPShardPtr shard
+                     );
       void read(
                 HostPort &hostPort,
                 TCPPort &tcpPort
@@ -1001,16 +1120,28 @@ namespace ortc
                  HostPortPtr hostPort
                  );
 
+      void handleUDPPacket(
+                           HostPortPtr hostPort,
+                           SocketPtr socket,
+                           UDPShardPtr shard,
+                           const IPAddress &fromIP,
+                           const BYTE *buffer,
+                           size_t bufferSizeInBytes
+                           );
+
       SecureByteBlockPtr handleIncomingPacket(
                                               CandidatePtr localCandidate,
+                                              LocalCandidateID localCandidateID,
                                               const IPAddress &remoteIP,
                                               STUNPacketPtr stunPacket
                                               );
       void handleIncomingPacket(
                                 CandidatePtr localCandidate,
+                                LocalCandidateID localCandidateID,
                                 const IPAddress &remoteIP,
                                 const BYTE *buffer,
-                                size_t bufferSizeInBytes
+                                size_t bufferSizeInBytes,
+                                UDPShardPtr shard
                                 );
 
       CandidatePtr findSentFromLocalCandidate(RouterRoutePtr routerRoute);
@@ -1040,6 +1171,25 @@ namespace ortc
                          size_t bufferSizeInBytes
                          );
 
+      bool queueUDPPacket(
+                          UDPSendBatch &batch,
+                          SocketPtr socket,
+                          const IPAddress &boundIP,
+                          const IPAddress &remoteIP,
+                          const BYTE *buffer,
+                          size_t bufferSizeInBytes
+                          );
+      bool flushUDPPackets(
+                           UDPSendBatch &batch,
+                           SocketPtr socket,
+                           const IPAddress &boundIP
+                           );
+      void flushAllUDPPackets();
+
+      void createUDPShards(HostPortPtr hostPort);
+      void closeUDPShards(HostPort &hostPort);
+      void notifyUDPShardException(HostPortPtr hostPort);
+
       bool shouldKeepWarm() const;
       bool shouldWarmUpAfterInterfaceBinding() const;
 
@@ -1149,6 +1299,18 @@ namespace ortc
       TransportList mPendingTransports;
 
       STUNPacket::ParseOptions mSTUNPacketParseOptions;
+
+      size_t mUDPReceiveBatchSize {};
+      size_t mUDPReceiveBatchSlabSize {};
+
+      size_t mUDPSendBatchSize {};
+      Milliseconds mUDPSendFlushWindow {};
+      bool mUDPSendSegmentationOffload {};
+      TimerPtr mUDPSendFlushTimer;
+      std::atomic<bool> mUDPSendPending {};  // set whenever a send batch may hold packets
+
+      size_t mUDPReusePortShards {};
+      std::atomic<size_t> mUDPShardRouteCacheGeneration {};  // bumped whenever shard route caches become stale
     };
 
     //-------------------------------------------------------------------------
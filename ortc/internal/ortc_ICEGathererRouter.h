@@ -38,6 +38,7 @@
 #include <zsLib/Timer.h>
 
 #include <tuple>
+#include <vector>
 
 namespace ortc
 {
@@ -60,12 +61,15 @@ namespace ortc
 
     public:
       ZS_DECLARE_STRUCT_PTR(Route)
+      ZS_DECLARE_STRUCT_PTR(RouteKey)
+      ZS_DECLARE_CLASS_PTR(RouteTable)
 
       ZS_DECLARE_TYPEDEF_PTR(IICETypes::Candidate, Candidate)
 
       typedef String LocalCandidateHash;
-      typedef std::pair<LocalCandidateHash, IPAddress> CandidateRemoteIPPair;
-      typedef std::map<CandidateRemoteIPPair, RouteWeakPtr> CandidateRemoteIPToRouteMap;
+      typedef PUID LocalCandidateID;
+      typedef std::map<LocalCandidateHash, LocalCandidateID> LocalCandidateHashToIDMap;
+      typedef std::map<LocalCandidateID, CandidatePtr> LocalCandidateMap;
 
     public:
       ICEGathererRouter(
@@ -90,12 +94,33 @@ namespace ortc
 
       virtual PUID getID() const {return mID;}
 
+      // NOTE: Local candidate IDs are assigned once per unique local
+      //       candidate (based upon the candidate's hash). The same ID is
+      //       returned for any copy of the same candidate thus the ID can be
+      //       used in place of the candidate when searching for routes.
+      //       Returns 0 if the candidate is unknown and is not registered.
+      virtual LocalCandidateID getLocalCandidateID(
+                                                   CandidatePtr localCandidate,
+                                                   bool registerIfNeeded = true
+                                                   );
+
+      // NOTE: Forgets a local candidate (and its ID) once the gatherer no
+      //       longer offers the candidate. Routes already created for the
+      //       candidate remain usable until released and are then pruned.
+      virtual void removeLocalCandidate(const LocalCandidateHash &localCandidateHash);
+
       virtual RoutePtr findRoute(
                                  CandidatePtr localCandidate,
                                  const IPAddress &remoteIP,
                                  bool createRouteIfNeeded
                                  );
 
+      virtual RoutePtr findRoute(
+                                 LocalCandidateID localCandidateID,
+                                 const IPAddress &remoteIP,
+                                 bool createRouteIfNeeded
+                                 );
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -127,6 +152,7 @@ namespace ortc
       {
         AutoPUID mID;
 
+        LocalCandidateID mLocalCandidateID {};
         CandidatePtr mLocalCandidate;
         IPAddress mRemoteIP;
 
@@ -134,6 +160,77 @@ namespace ortc
         ElementPtr toDebug() const;
       };
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererRouter::RouteKey
+      #pragma mark
+
+      struct RouteKey
+      {
+        LocalCandidateID mLocalCandidateID {};
+        ULONGLONG mRemoteIP[2] {};
+        WORD mRemotePort {};
+
+        RouteKey() {}
+        RouteKey(
+                 LocalCandidateID localCandidateID,
+                 const IPAddress &remoteIP
+                 );
+
+        bool operator==(const RouteKey &op2) const;
+        bool operator!=(const RouteKey &op2) const {return !(*this == op2);}
+
+        size_t hash() const;
+        bool isEmpty() const {return 0 == mLocalCandidateID;}
+      };
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICEGathererRouter::RouteTable
+      #pragma mark
+
+      // NOTE: Open addressing (linear probing) table from route key to route.
+      //       The table capacity is always a power of two and erased slots
+      //       are left as tombstones until the next rehash.
+      class RouteTable
+      {
+      public:
+        struct Entry
+        {
+          RouteKey mKey;
+          RouteWeakPtr mRoute;
+          bool mErased {false};
+
+          bool isFree() const {return mKey.isEmpty();}
+          bool isUsed() const {return (!mKey.isEmpty()) && (!mErased);}
+        };
+
+        typedef std::vector<Entry> EntryVector;
+
+      public:
+        RouteTable(size_t initialCapacity = 64);
+
+        Entry *find(const RouteKey &key);
+        void insert(
+                    const RouteKey &key,
+                    RoutePtr route
+                    );
+        void erase(Entry *entry);
+        void clear();
+
+        size_t size() const {return mSize;}
+        size_t capacity() const {return mEntries.size();}
+
+        EntryVector &entries() {return mEntries;}
+
+        void rehash(size_t newCapacity);
+
+      protected:
+        EntryVector mEntries;
+        size_t mSize {};
+        size_t mTombstones {};
+      };
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -143,7 +240,10 @@ namespace ortc
       AutoPUID mID;
       ICEGathererRouterWeakPtr mThisWeak;
 
-      CandidateRemoteIPToRouteMap mRoutes;
+      LocalCandidateHashToIDMap mLocalCandidateIDs;
+      LocalCandidateMap mLocalCandidates;
+
+      RouteTable mRoutes;
 
       TimerPtr mTimer;
     };
@@ -45,6 +45,7 @@
 #include <zsLib/Timer.h>
 
 #include <queue>
+#include <unordered_map>
 
 #define ORTC_SETTING_ICE_TRANSPORT_MAX_CANDIDATE_PAIRS_TO_TEST  "ortc/ice-transport/max-candidate-pairs-to-test"
 
@@ -63,6 +64,10 @@
 
 #define ORTC_SETTING_ICE_TRANSPORT_MAX_BUFFERED_FOR_SECURE_TRANSPORT "ortc/ice-transport/max-buffered-packets-for-secure-transport"
 
+#define ORTC_SETTING_ICE_TRANSPORT_PACKET_PATH_REFRESH_IN_MILLISECONDS "ortc/ice-transport/packet-path-refresh-in-milliseconds"
+
+#define ORTC_SETTING_ICE_TRANSPORT_SCHEDULER_TICK_IN_MILLISECONDS "ortc/ice-transport/scheduler-tick-in-milliseconds"
+
 namespace ortc
 {
   namespace internal
@@ -79,6 +84,8 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(IICEGathererForICETransport)
     ZS_DECLARE_INTERACTION_PTR(IICETransportControllerForICETransport)
 
+    ZS_DECLARE_CLASS_PTR(ICETransportScheduler)
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -196,6 +203,10 @@ namespace ortc
                               const BYTE *buffer,
                               size_t bufferSizeInBytes
                               ) = 0;
+
+      virtual bool sendPackets(const PacketBufferList &packets) = 0;
+
+      virtual void flushPackets() = 0;
     };
     
     //-------------------------------------------------------------------------
@@ -230,6 +241,7 @@ namespace ortc
       virtual void onResolveStatsPromise(IStatsProvider::PromiseWithStatsReportPtr promise) = 0;
       virtual void onNotifyPacketRetried(
                                          IICETypes::CandidatePtr localCandidate,
+                                         PUID localCandidateID,
                                          IPAddress remoteIP,
                                          STUNPacketPtr stunPacket
                                          ) = 0;
@@ -241,6 +253,130 @@ namespace ortc
       virtual void onDeliverPendingPackets() = 0;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ICETransportScheduler
+    #pragma mark
+
+    // Process wide hierarchical timer wheel which drives the keep warm,
+    // consent freshness and route expiry timers of every ICETransport from a
+    // single zsLib timer. Scheduling, cancelling and expiring a timer are all
+    // O(1) and every timer that expires on the same tick is handed to its
+    // transport as one batch.
+    class ICETransportScheduler : public MessageQueueAssociator,
+                                  public SharedRecursiveLock,
+                                  public zsLib::ITimerDelegate,
+                                  public ISingletonManagerDelegate
+    {
+    protected:
+      struct make_private {};
+
+    public:
+      typedef PUID TimerID;
+      typedef std::list<TimerID> TimerIDList;
+      typedef QWORD Tick;
+
+      enum WheelSizes
+      {
+        WheelSize_Lower = 256,
+        WheelSize_Upper = 64,
+      };
+
+      struct Entry
+      {
+        TimerID mID {};
+        PUID mTransportID {};
+        ICETransportWeakPtr mTransport;
+        Tick mExpires {};
+      };
+
+      typedef std::list<Entry> EntryList;
+
+      struct Location
+      {
+        EntryList *mSlot {};
+        EntryList::iterator mEntry;
+      };
+
+      typedef std::unordered_map<TimerID, Location> LocationMap;
+
+      typedef std::pair<ICETransportWeakPtr, TimerIDList> TransportTimersPair;
+      typedef std::map<PUID, TransportTimersPair> TransportTimersMap;
+
+    public:
+      ICETransportScheduler(
+                            const make_private &,
+                            IMessageQueuePtr queue
+                            );
+
+    public:
+      ~ICETransportScheduler();
+
+      static ICETransportSchedulerPtr create();
+      static ICETransportSchedulerPtr singleton();
+
+      TimerID schedule(
+                       ICETransportPtr transport,
+                       const Time &when
+                       );
+      void cancel(TimerID timerID);
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICETransportScheduler => ITimerDelegate
+      #pragma mark
+
+      virtual void onTimer(TimerPtr timer) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICETransportScheduler => ISingletonManagerDelegate
+      #pragma mark
+
+      virtual void notifySingletonCleanup() override;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICETransportScheduler => (internal)
+      #pragma mark
+
+      Log::Params log(const char *message) const;
+      static Log::Params slog(const char *message);
+      ElementPtr toDebug() const;
+
+      Tick toTick(const Time &when) const;
+      EntryList &getSlot(Tick expires);
+      void place(
+                 EntryList &fromSlot,
+                 EntryList::iterator entry
+                 );
+      void advance(TransportTimersMap &ioExpired);
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICETransportScheduler => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      ICETransportSchedulerWeakPtr mThisWeak;
+
+      Milliseconds mTickDuration {};
+      Time mStarted;
+      Tick mCurrentTick {};
+
+      TimerPtr mTimer;
+
+      EntryList mLowerWheel[WheelSize_Lower];
+      EntryList mUpperWheel[WheelSize_Upper];
+
+      LocationMap mLocations;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -276,10 +412,12 @@ namespace ortc
       friend interaction IICETransportForICETransportContoller;
       friend interaction IICETransportForSecureTransport;
       friend interaction IICETransportForDataTransport;
+      friend class ICETransportScheduler;
 
       ZS_DECLARE_STRUCT_PTR(RouteStateTracker)
       ZS_DECLARE_STRUCT_PTR(Route)
       ZS_DECLARE_STRUCT_PTR(ReasonNoMoreRelationship)
+      ZS_DECLARE_STRUCT_PTR(PacketPath)
 
       ZS_DECLARE_TYPEDEF_PTR(openpeer::services::ISTUNRequester, ISTUNRequester)
       ZS_DECLARE_TYPEDEF_PTR(IICEGathererForICETransport, UseICEGatherer)
@@ -290,6 +428,8 @@ namespace ortc
       ZS_DECLARE_TYPEDEF_PTR(ISecureTransportForICETransport, UseSecureTransport)
       ZS_DECLARE_TYPEDEF_PTR(ICEGathererRouter::Route, RouterRoute)
 
+      typedef ICEGathererRouter::LocalCandidateID RouterLocalCandidateID;
+
       typedef String Hash;
       typedef std::map<Hash, CandidatePtr> CandidateMap;
 
@@ -301,7 +441,9 @@ namespace ortc
 
       typedef std::map<RouteID, RoutePtr> RouteIDMap;
       typedef std::map<ISTUNRequesterPtr, RoutePtr> STUNCheckMap;
-      typedef std::map<TimerPtr, RoutePtr> TimerRouteMap;
+      typedef ICETransportScheduler::TimerID ScheduledTimerID;
+      typedef ICETransportScheduler::TimerIDList ScheduledTimerIDList;
+      typedef std::map<ScheduledTimerID, RoutePtr> ScheduledRouteMap;
       typedef std::map<PromisePtr, RoutePtr> PromiseRouteMap;
 
       typedef std::list<PromisePtr> PromiseList;
@@ -472,6 +614,10 @@ namespace ortc
                               size_t bufferSizeInBytes
                               ) override;
 
+      virtual bool sendPackets(const PacketBufferList &packets) override;
+
+      virtual void flushPackets() override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark ICETransport => IICETransportForDataTransport
@@ -491,6 +637,7 @@ namespace ortc
       virtual void onResolveStatsPromise(IStatsProvider::PromiseWithStatsReportPtr promise) override;
       virtual void onNotifyPacketRetried(
                                          IICETypes::CandidatePtr localCandidate,
+                                         PUID localCandidateID,
                                          IPAddress remoteIP,
                                          STUNPacketPtr stunPacket
                                          ) override;
@@ -515,6 +662,13 @@ namespace ortc
 
       virtual void onTimer(TimerPtr timer) override;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICETransport => friend ICETransportScheduler
+      #pragma mark
+
+      void notifyScheduledTimers(const ScheduledTimerIDList &timers);
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark ICETransport => IPromiseSettledDelegate
@@ -605,6 +759,7 @@ namespace ortc
         RouteStateTrackerPtr mTracker;
 
         RouterRoutePtr mGathererRoute;
+        RouterLocalCandidateID mGathererLocalCandidateID {};  // cached to avoid hashing the local candidate per install
 
         QWORD mPendingPriority {};
 
@@ -617,7 +772,7 @@ namespace ortc
         bool mPrune {false};
         bool mKeepWarm {false};
         ISTUNRequesterPtr mOutgoingCheck;
-        TimerPtr mNextKeepWarm;
+        ScheduledTimerID mNextKeepWarm {};
 
         PromisePtr mFrozenPromise;
         PromiseList mDependentPromises;
@@ -674,6 +829,25 @@ namespace ortc
         size_t count(States state);
       };
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ICETransport::PacketPath
+      #pragma mark
+
+      // Immutable snapshot of the validated steady-state packet path. Built
+      // while holding the transport lock and published atomically so the
+      // media path can send and receive without taking the lock. Any change
+      // to the active route, gatherer or secure transport resets it.
+      struct PacketPath
+      {
+        RoutePtr mRoute;
+        RouterRoutePtr mRouterRoute;
+        UseICEGathererPtr mGatherer;
+        UseSecureTransportWeakPtr mSecureTransport;
+        Time mRefreshAfter;
+      };
+
+      //-----------------------------------------------------------------------
       struct ReasonNoMoreRelationship : public Any
       {
       };
@@ -722,6 +896,9 @@ namespace ortc
       void handleActivationTimer();
       void handleNextKeepWarmTimer(RoutePtr route);
 
+      ScheduledTimerID scheduleTimer(const Time &when);
+      void cancelScheduledTimer(ScheduledTimerID &ioTimerID);
+
       void forceActive(RoutePtr route);
       void shutdown(RoutePtr route);
 
@@ -743,6 +920,12 @@ namespace ortc
 
       bool installGathererRoute(RoutePtr route);
 
+      void publishPacketPath();
+      void resetPacketPath();
+      PacketPathPtr getPacketPath() const;
+      void notifyFastPathPacketReceived(const Time &now);
+      Time getLastReceivedPacket() const;
+
       void installFoundation(RoutePtr route);
 
       void removeLegal(RoutePtr route);
@@ -866,6 +1049,8 @@ namespace ortc
       RouteStateTrackerPtr mRouteStateTracker;
 
       TimerPtr mActivationTimer;
+
+      ICETransportSchedulerPtr mScheduler;
       bool mNextActivationCausesAllRoutesThatReceivedChecksToActivate {false};
 
       SortedRouteMap mPendingActivation;
@@ -879,18 +1064,19 @@ namespace ortc
       RouteIDMap mGathererRoutes;
 
       STUNCheckMap mOutgoingChecks;
-      TimerRouteMap mNextKeepWarmTimers;
+      ScheduledRouteMap mNextKeepWarmTimers;
 
       RoutePtr mUseCandidateRoute;
       ISTUNRequesterPtr mUseCandidateRequest;
       Time mLastReceivedUseCandidate;
 
       Time mLastReceivedPacket;
-      TimerPtr mLastReceivedPacketTimer;
+      std::atomic<Time::rep> mLastReceivedPacketFastPath {};
+      ScheduledTimerID mLastReceivedPacketTimer {};
       Seconds mNoPacketsReceivedRecheckTime {};
 
       Seconds mExpireRouteTime {};
-      TimerPtr mExpireRouteTimer;
+      ScheduledTimerID mExpireRouteTimer {};
       bool mTestLowerPreferenceCandidatePairs {false};
       bool mBlacklistConsent {false};
 
@@ -905,6 +1091,9 @@ namespace ortc
       bool mMustBufferPackets {true};
       PacketQueue mBufferedPackets;
 
+      PacketPathPtr mPacketPath;  // only access using std::atomic_load / std::atomic_store
+      Milliseconds mPacketPathRefreshTime {};
+
       STUNPacket::Options mSTUNPacketOptions;
     };
 
@@ -936,7 +1125,7 @@ ZS_DECLARE_PROXY_TYPEDEF(ortc::IICETypes::CandidatePtr, CandidatePtr)
 ZS_DECLARE_PROXY_TYPEDEF(zsLib::IPAddress, IPAddress)
 ZS_DECLARE_PROXY_TYPEDEF(openpeer::services::STUNPacketPtr, STUNPacketPtr)
 ZS_DECLARE_PROXY_METHOD_1(onResolveStatsPromise, PromiseWithStatsReportPtr)
-ZS_DECLARE_PROXY_METHOD_3(onNotifyPacketRetried, CandidatePtr, IPAddress, STUNPacketPtr)
+ZS_DECLARE_PROXY_METHOD_4(onNotifyPacketRetried, CandidatePtr, PUID, IPAddress, STUNPacketPtr)
 ZS_DECLARE_PROXY_METHOD_0(onWarmRoutesChanged)
 ZS_DECLARE_PROXY_METHOD_1(onNotifyAttached, PUID)
 ZS_DECLARE_PROXY_METHOD_1(onNotifyDetached, PUID)
@@ -144,6 +144,14 @@ namespace ortc
                               size_t bufferLengthInBytes
                               ) = 0;
 
+      virtual bool sendPackets(
+                               IICETypes::Components sendOverICETransport,
+                               IICETypes::Components packetType,
+                               const PacketBufferList &packets
+                               ) = 0;
+
+      virtual void flushPackets(IICETypes::Components sendOverICETransport) = 0;
+
       virtual IICETransportPtr getICETransport() const = 0;
     };
 
@@ -183,6 +191,8 @@ namespace ortc
                               size_t bufferLengthInBytes
                               ) = 0;
 
+      virtual void flushPackets(IICETypes::Components sendOverICETransport) = 0;
+
       virtual IICETransportPtr getICETransport() const = 0;
     };
 
@@ -209,11 +219,16 @@ namespace ortc
                                        size_t bufferLengthInBytes
                                        ) = 0;
 
+      virtual bool sendEncryptedPackets(
+                                        IICETypes::Components sendOverICETransport,
+                                        IICETypes::Components packetType,
+                                        const PacketBufferList &packets
+                                        ) = 0;
+
       virtual bool handleReceivedDecryptedPacket(
                                                  IICETypes::Components viaTransport,
                                                  IICETypes::Components packetType,
-                                                 const BYTE *buffer,
-                                                 size_t bufferLengthInBytes
+                                                 SecureByteBlockPtr decryptedBuffer  // NOTE: ownership of buffer is taken
                                                  ) = 0;
     };
 
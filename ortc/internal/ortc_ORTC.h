@@ -34,16 +34,84 @@
 #include <ortc/internal/types.h>
 #include <ortc/IORTC.h>
 
+#include <atomic>
+
 #define ORTC_QUEUE_MAIN_THREAD_NAME "org.ortc.ortcLibMainThread"
 #define ORTC_QUEUE_BLOCKING_MEDIA_STARTUP_THREAD_NAME "org.ortc.ortcLibBlockingMedia"
 #define ORTC_QUEUE_CERTIFICATE_GENERATION_NAME "org.ortc.ortcLibCertificateGeneration"
 #define ORTC_QUEUE_PACKET_THREAD_NAME "org.ortc.ortcLibPacketThread."
-#define ORTC_QUEUE_TOTAL_PACKET_THREADS 4
+#define ORTC_QUEUE_MAX_PACKET_THREADS 64
+#define ORTC_QUEUE_DTLS_HANDSHAKE_THREAD_NAME "org.ortc.ortcLibDTLSHandshakeThread."
+#define ORTC_QUEUE_MAX_DTLS_HANDSHAKE_THREADS 16
+
+#define ORTC_SETTING_ORTC_DTLS_HANDSHAKE_THREADS "ortc/dtls/handshake-worker-threads"
+
+// 0 = size the packet thread pool to the number of CPU cores
+#define ORTC_SETTING_ORTC_PACKET_THREADS "ortc/packet/worker-threads"
+#define ORTC_SETTING_ORTC_PACKET_THREADS_PIN_TO_CPU "ortc/packet/pin-worker-threads-to-cpu"
 
 namespace ortc
 {
   namespace internal
   {
+    ZS_DECLARE_INTERACTION_PROXY(IORTCAsyncDelegate)
+
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    #pragma mark
+    #pragma mark ORTCPacketQueue
+    #pragma mark
+
+    // NOTE: counters are updated from the posting and processing threads
+    //       without taking any lock.
+    struct ORTCPacketQueue
+    {
+      ORTCPacketQueue(
+                      size_t index,
+                      IMessageQueuePtr queue
+                      );
+
+      void notifyAssigned();
+      void notifyUnassigned();
+      void notifyQueued();
+      void notifyProcessed(Microseconds latency);
+      void notifyDropped();
+      void notifyDiscarded();
+
+      ElementPtr toDebug() const;
+
+      const size_t mIndex;
+      const IMessageQueuePtr mQueue;
+
+      std::atomic<size_t> mTotalAssigned {};
+      std::atomic<size_t> mDepth {};
+      std::atomic<size_t> mMaxDepth {};
+      std::atomic<ULONGLONG> mTotalQueued {};
+      std::atomic<ULONGLONG> mTotalProcessed {};
+      std::atomic<ULONGLONG> mTotalDropped {};
+      std::atomic<ULONGLONG> mTotalLatencyInMicroseconds {};
+      std::atomic<ULONGLONG> mMaxLatencyInMicroseconds {};
+    };
+
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IORTCForSettings
+    #pragma mark
+
+    interaction IORTCForSettings
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IORTCForSettings, ForSettings)
+
+      static void applyDefaults();
+
+      virtual ~IORTCForSettings() {}
+    };
+
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
@@ -56,16 +124,34 @@ namespace ortc
     {
       ZS_DECLARE_TYPEDEF_PTR(IORTCForInternal, ForInternal)
 
+      typedef std::list<ORTCPacketQueuePtr> PacketQueueList;
+
       static void overrideQueueDelegate(IMessageQueuePtr queue);
       static IMessageQueuePtr queueDelegate();
       static IMessageQueuePtr queueORTC();
       static IMessageQueuePtr queuePacket();
+      static ORTCPacketQueuePtr packetQueue();
+      static PacketQueueList packetQueues();
       static IMessageQueuePtr queueBlockingMediaStartStopThread();
       static IMessageQueuePtr queueCertificateGeneration();
+      static IMessageQueuePtr queueDTLSHandshake();
 
       static Optional<Log::Level> webrtcLogLevel();
     };
 
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IORTCAsyncDelegate
+    #pragma mark
+
+    interaction IORTCAsyncDelegate
+    {
+      virtual void onPinPacketThread(size_t cpu) = 0;
+    };
+
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
@@ -76,6 +162,7 @@ namespace ortc
 
     class ORTC : public IORTC,
                  public IORTCForInternal,
+                 public IORTCAsyncDelegate,
                  public SharedRecursiveLock
     {
     protected:
@@ -130,11 +217,21 @@ namespace ortc
       virtual IMessageQueuePtr queueDelegate() const;
       virtual IMessageQueuePtr queueORTC() const;
       virtual IMessageQueuePtr queuePacket() const;
+      virtual ORTCPacketQueuePtr packetQueue() const;
+      virtual PacketQueueList packetQueues() const;
       virtual IMessageQueuePtr queueBlockingMediaStartStopThread() const;
       virtual IMessageQueuePtr queueCertificateGeneration() const;
+      virtual IMessageQueuePtr queueDTLSHandshake() const;
 
       virtual Optional<Log::Level> webrtcLogLevel() const;
 
+      //---------------------------------------------------------------------
+      #pragma mark
+      #pragma mark ORTC => IORTCAsyncDelegate
+      #pragma mark
+
+      virtual void onPinPacketThread(size_t cpu) override;
+
       //---------------------------------------------------------------------
       #pragma mark
       #pragma mark ORTC => (internal)
@@ -143,6 +240,10 @@ namespace ortc
       Log::Params log(const char *message) const;
       static Log::Params slog(const char *message);
 
+      static size_t totalCPUCores();
+
+      ORTCPacketQueuePtr selectPacketQueue() const;
+
     protected:
       //---------------------------------------------------------------------
       #pragma mark
@@ -158,8 +259,10 @@ namespace ortc
       mutable IMessageQueuePtr mBlockingMediaStartStopThread;
       mutable IMessageQueuePtr mCertificateGeneration;
 
-      mutable IMessageQueuePtr mPacketQueues[ORTC_QUEUE_TOTAL_PACKET_THREADS];
-      mutable size_t mNextPacketQueueThread {};
+      mutable ORTCPacketQueuePtr mPacketQueues[ORTC_QUEUE_MAX_PACKET_THREADS];
+
+      mutable IMessageQueuePtr mDTLSHandshakeQueues[ORTC_QUEUE_MAX_DTLS_HANDSHAKE_THREADS];
+      mutable size_t mNextDTLSHandshakeQueueThread {};
 
       Milliseconds mNTPServerTime {};
 
@@ -168,3 +271,7 @@ namespace ortc
     };
   }
 }
+
+ZS_DECLARE_PROXY_BEGIN(ortc::internal::IORTCAsyncDelegate)
+ZS_DECLARE_PROXY_METHOD_1(onPinPacketThread, size_t)
+ZS_DECLARE_PROXY_END()
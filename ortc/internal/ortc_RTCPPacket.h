@@ -52,6 +52,24 @@ namespace ortc
     protected:
       struct make_private {};
 
+    public:
+      enum ParseModes
+      {
+        ParseMode_First,
+
+        ParseMode_Full = ParseMode_First,   // decode every report
+        ParseMode_Fast,                     // decode only SR (200), RR (201), SDES (202) and BYE (203);
+                                            // APP (204), RTPFB (205), PSFB (206), XR (207) and any
+                                            // unknown report types are skipped (never sized, parsed or
+                                            // returned from first() / firstXXX())
+
+        ParseMode_Last = ParseMode_Fast,
+      };
+
+      static const char *toString(ParseModes mode);
+
+      typedef std::vector<DWORD> SSRCList;
+
     public:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -660,6 +678,55 @@ namespace ortc
         public:
         };
 
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RTCPPacket::TransportLayerFeedbackMessage::TransportCC
+        #pragma mark
+
+        struct TransportCC
+        {
+          // https://tools.ietf.org/html/draft-holmer-rmcat-transport-wide-cc-extensions-01#section-3.1
+
+          static const BYTE kFmt {15};
+
+          static const size_t kReferenceTimeResolutionInMilliseconds {64};
+          static const size_t kDeltaResolutionInMicroseconds {250};
+
+          enum PacketStatusSymbols
+          {
+            PacketStatusSymbol_First,
+
+            PacketStatusSymbol_NotReceived = PacketStatusSymbol_First,
+            PacketStatusSymbol_ReceivedSmallDelta,
+            PacketStatusSymbol_ReceivedLargeOrNegativeDelta,
+
+            PacketStatusSymbol_Last = PacketStatusSymbol_ReceivedLargeOrNegativeDelta,
+          };
+
+          static const char *toString(PacketStatusSymbols symbol);
+
+          WORD baseSequenceNumber() const                       {return mBaseSequenceNumber;}
+          size_t packetStatusCount() const                      {return static_cast<size_t>(mPacketStatusCount);}
+          LONG referenceTime() const                            {return mReferenceTime;}  // in kReferenceTimeResolutionInMilliseconds units
+          BYTE fbPktCount() const                               {return mFBPktCount;}
+
+          PacketStatusSymbols packetStatusAtIndex(size_t index) const;
+
+          size_t recvDeltaCount() const                         {return mRecvDeltaCount;}
+          LONG recvDeltaAtIndex(size_t index) const;            // in kDeltaResolutionInMicroseconds units
+
+        public:
+          WORD mBaseSequenceNumber {};
+          WORD mPacketStatusCount {};
+          LONG mReferenceTime {};                               // 24 bit signed
+          BYTE mFBPktCount {};
+
+          BYTE *mPacketStatuses {};                             // one PacketStatusSymbols per packet status
+
+          size_t mRecvDeltaCount {};                            // one delta per received packet status
+          LONG *mRecvDeltas {};
+        };
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark RTCPPacket::TransportLayerFeedbackMessage (public)
@@ -678,6 +745,8 @@ namespace ortc
         size_t tmmbnCount() const                               {return mTMMBNCount;}
         TMMBN *tmmbnAtIndex(size_t index) const;
 
+        TransportCC *transportCC() const;
+
         TransportLayerFeedbackMessage *unknown() const          {return mUnknown;}
 
       public:
@@ -692,6 +761,9 @@ namespace ortc
         size_t mTMMBNCount {};
         TMMBN *mFirstTMMBN {};
 
+        bool mHasTransportCC {false};
+        TransportCC mTransportCC {};
+
         TransportLayerFeedbackMessage *mUnknown {};
       };
 
@@ -1410,9 +1482,17 @@ namespace ortc
       RTCPPacket(const make_private &);
       ~RTCPPacket();
 
+      // NOTE: parsed reports point into the buffer the packet owns thus the
+      //       overloads taking a caller's buffer (by pointer or reference)
+      //       copy it first; only the SecureByteBlockPtr overloads (which
+      //       take ownership) avoid the copy.
       static RTCPPacketPtr create(const BYTE *buffer, size_t bufferLengthInBytes);
       static RTCPPacketPtr create(const SecureByteBlock &buffer);
       static RTCPPacketPtr create(SecureByteBlockPtr buffer);  // NOTE: ownership of buffer is taken
+      static RTCPPacketPtr create(
+                                  SecureByteBlockPtr buffer,     // NOTE: ownership of buffer is taken
+                                  ParseModes mode
+                                  );
       static RTCPPacketPtr create(const Report *first);
       static SecureByteBlockPtr generateFrom(const Report *first);
 
@@ -1420,6 +1500,8 @@ namespace ortc
       size_t size() const;
       SecureByteBlockPtr buffer() const;
 
+      ParseModes parseMode() const                                                {return mParseMode;}
+
       Report *first() const                                                       {return mFirst;}
 
       SenderReport *firstSenderReport() const                                     {return mFirstSenderReport;}
@@ -1454,6 +1536,18 @@ namespace ortc
       XR *xrAtIndex(size_t index) const;
       UnknownReport *unknownAtIndex(size_t index) const;
 
+      // NOTE: walks the raw compound packet (thus works in any parse mode)
+      //       gathering the SSRCs of the sources sending the reports and of
+      //       the media sources the reports / feedback are about; SDES is
+      //       not considered. Transport-wide feedback is attributed to its
+      //       media SSRC (the sender of that SSRC feeds the transport's
+      //       congestion controller). Returns false if any report cannot be
+      //       attributed to specific SSRCs (e.g. XR or unknown reports).
+      bool getReferencedSSRCs(
+                              SSRCList &outSenderSSRCs,
+                              SSRCList &outMediaSSRCs
+                              ) const;
+
       ElementPtr toDebug() const;
 
     protected:
@@ -1466,7 +1560,13 @@ namespace ortc
       Log::Params log(const char *message) const;
       Log::Params debug(const char *message) const;
 
+      // NOTE: parsing is two passes over the wire data: a sizing pre-pass
+      //       validates every decoded block and totals the memory needed,
+      //       then a single pooled arena of that size is obtained and the
+      //       second pass decodes the reports into it. Skipped report types
+      //       (see ParseMode_Fast) cost only a header read in either pass.
       bool parse();
+      bool shouldDecode(BYTE pt) const;
 
       bool getAllocationSize(BYTE version, BYTE padding, BYTE reportSpecific, BYTE pt, const BYTE *contents, size_t contentSize);
       bool getSenderReportAllocationSize(BYTE version, BYTE padding, BYTE reportSpecific, const BYTE *contents, size_t contentSize);
@@ -1482,6 +1582,7 @@ namespace ortc
       bool getTransportLayerFeedbackMessageGenericNACKAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
       bool getTransportLayerFeedbackMessageTMMBRAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
       bool getTransportLayerFeedbackMessageTMMBNAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
+      bool getTransportLayerFeedbackMessageTransportCCAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
 
       bool getPayloadSpecificFeedbackMessagePLIAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
       bool getPayloadSpecificFeedbackMessageSLIAllocationSize(BYTE fmt, const BYTE *contents, size_t contentSize);
@@ -1526,6 +1627,7 @@ namespace ortc
       void fillTMMBRCommon(TransportLayerFeedbackMessage *report, TransportLayerFeedbackMessage::TMMBRCommon *common, const BYTE *pos);
       bool parseTMMBR(TransportLayerFeedbackMessage *report);
       bool parseTMMBN(TransportLayerFeedbackMessage *report);
+      bool parseTransportCC(TransportLayerFeedbackMessage *report);
       bool parseUnknown(TransportLayerFeedbackMessage *report);
 
       //CodecControlCommon
@@ -1554,10 +1656,15 @@ namespace ortc
 
       void *allocateBuffer(size_t size);
 
+      static SecureByteBlockPtr allocatePacketBuffer(size_t size);
+      static SecureByteBlockPtr allocateArena(size_t size);
+
       static size_t getPacketSize(const Report *first);
       static void writePacket(const Report *first, BYTE * &ioPos, size_t &ioRemaining);
 
     public:
+      ParseModes mParseMode {ParseMode_Full};
+
       SecureByteBlockPtr mBuffer;
       SecureByteBlockPtr mAllocationBuffer;
 
@@ -1589,6 +1696,184 @@ namespace ortc
       UnknownReport *mFirstUnknownReport {};
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTCPPacketWriterDelegate
+    #pragma mark
+
+    interaction IRTCPPacketWriterDelegate
+    {
+      // NOTE: called synchronously from within the writer whenever a compound
+      //       packet is complete; the packet memory is the writer's buffer
+      //       and is only valid for the duration of the call.
+      virtual void onRTCPPacketWriterPacket(
+                                            const BYTE *packet,
+                                            size_t packetSizeInBytes
+                                            ) = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTCPPacketWriter
+    #pragma mark
+
+    class RTCPPacketWriter
+    {
+    public:
+      typedef RTCPPacket::SenderReceiverCommonReport::ReportBlock ReportBlock;
+      typedef RTCPPacket::TransportLayerFeedbackMessage::GenericNACK GenericNACK;
+      typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
+      typedef RTCPPacket::PayloadSpecificFeedbackMessage::FIR FIR;
+      typedef RTCPPacket::XR::DLRRReportBlock::SubBlock DLRRSubBlock;
+
+    public:
+      // NOTE: reports are serialized directly into the caller's buffer. When
+      //       the next report does not fit, the current compound packet is
+      //       handed to the delegate and writing restarts at the start of
+      //       the buffer (with an empty RR when the compound packet began
+      //       with a SR / RR). The buffer size is thus the maximum compound
+      //       packet size (i.e. the MTU available for RTCP). Call flush() to
+      //       hand off the final compound packet.
+      RTCPPacketWriter(
+                       IRTCPPacketWriterDelegate *delegate,
+                       BYTE *buffer,
+                       size_t bufferSizeInBytes
+                       );
+      ~RTCPPacketWriter();
+
+      RTCPPacketWriter(const RTCPPacketWriter &) = delete;
+      RTCPPacketWriter &operator=(const RTCPPacketWriter &) = delete;
+
+      size_t size() const                                                         {return mSize;}
+      size_t remaining() const                                                    {return mBufferSize - mSize;}
+      size_t totalPacketsFlushed() const                                          {return mTotalPacketsFlushed;}
+
+      // NOTE: more than 31 report blocks are continued in additional RR
+      //       reports (see RFC3550 section 6.4); each continuation may start
+      //       a new compound packet if the MTU is reached.
+      bool writeSenderReport(
+                             DWORD ssrcOfSender,
+                             DWORD ntpTimestampMS,
+                             DWORD ntpTimestampLS,
+                             DWORD rtpTimestamp,
+                             DWORD senderPacketCount,
+                             DWORD senderOctetCount,
+                             const ReportBlock *reportBlocks,
+                             size_t reportBlockCount
+                             );
+      bool writeReceiverReport(
+                               DWORD ssrcOfPacketSender,
+                               const ReportBlock *reportBlocks,
+                               size_t reportBlockCount
+                               );
+
+      // NOTE: writes a single chunk SDES; NULL or empty items are skipped.
+      bool writeSDES(
+                     DWORD ssrc,
+                     const char *cname,
+                     const char *mid,
+                     const char *rid
+                     );
+
+      bool writeBye(
+                    const DWORD *ssrcs,
+                    size_t ssrcCount,
+                    const char *reasonForLeaving
+                    );
+
+      // NOTE: NACK items that do not fit are continued in additional generic
+      //       NACK feedback messages.
+      bool writeGenericNACK(
+                            DWORD ssrcOfPacketSender,
+                            DWORD ssrcOfMediaSource,
+                            const GenericNACK *nacks,
+                            size_t nackCount
+                            );
+      bool writeTransportCC(
+                            DWORD ssrcOfPacketSender,
+                            DWORD ssrcOfMediaSource,
+                            const TransportCC &transportCC
+                            );
+      bool writePLI(
+                    DWORD ssrcOfPacketSender,
+                    DWORD ssrcOfMediaSource
+                    );
+
+      // NOTE: FIR entries that do not fit are continued in additional FIR
+      //       feedback messages (the media source SSRC is always zero).
+      bool writeFIR(
+                    DWORD ssrcOfPacketSender,
+                    const FIR *firs,
+                    size_t firCount
+                    );
+      bool writeREMB(
+                     DWORD ssrcOfPacketSender,
+                     BYTE brExp,
+                     DWORD brMantissa,
+                     const DWORD *ssrcs,
+                     size_t ssrcCount
+                     );
+
+      bool writeXRReceiverReferenceTime(
+                                        DWORD ssrc,
+                                        DWORD ntpTimestampMS,
+                                        DWORD ntpTimestampLS
+                                        );
+      bool writeXRDLRR(
+                       DWORD ssrc,
+                       const DLRRSubBlock *subBlocks,
+                       size_t subBlockCount
+                       );
+
+      void flush();
+
+      ElementPtr toDebug() const;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTCPPacketWriter => (internal)
+      #pragma mark
+
+      static Log::Params slog(const char *message);
+      Log::Params log(const char *message) const;
+      Log::Params debug(const char *message) const;
+
+      BYTE *reserve(
+                    BYTE reportSpecific,
+                    BYTE pt,
+                    size_t sizeInBytes
+                    );
+      void continueCompound(BYTE nextPT);
+      static void writeReportBlocks(
+                                    BYTE *pos,
+                                    const ReportBlock *reportBlocks,
+                                    size_t reportBlockCount
+                                    );
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTCPPacketWriter => (data)
+      #pragma mark
+
+      IRTCPPacketWriterDelegate *mDelegate {};
+
+      BYTE *mBuffer {};
+      size_t mBufferSize {};
+
+      size_t mSize {};
+
+      size_t mTotalPacketsFlushed {};
+      size_t mTotalReportsWritten {};
+    };
+
   }
 }
 
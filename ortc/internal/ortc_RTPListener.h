@@ -33,6 +33,8 @@
 
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
 
 #include <ortc/IRTPListener.h>
 #include <ortc/IMediaStreamTrack.h>
@@ -42,8 +44,12 @@
 #include <zsLib/Timer.h>
 #include <zsLib/TearAway.h>
 
+#include <unordered_map>
+#include <atomic>
+
 #define ORTC_SETTING_RTP_LISTENER_MAX_RTP_PACKETS_IN_BUFFER "ortc/rtp-listener/max-rtp-packets-in-buffer"
 #define ORTC_SETTING_RTP_LISTENER_MAX_AGE_RTP_PACKETS_IN_SECONDS "ortc/rtp-listener/max-age-rtp-packets-in-seconds"
+#define ORTC_SETTING_RTP_LISTENER_MAX_RTP_PACKETS_PER_SSRC_IN_BUFFER "ortc/rtp-listener/max-rtp-packets-per-ssrc-in-buffer"
 
 #define ORTC_SETTING_RTP_LISTENER_MAX_RTCP_PACKETS_IN_BUFFER "ortc/rtp-listener/max-rtcp-packets-in-buffer"
 #define ORTC_SETTING_RTP_LISTENER_MAX_AGE_RTCP_PACKETS_IN_SECONDS "ortc/rtp-listener/max-age-rtcp-packets-in-seconds"
@@ -53,6 +59,9 @@
 
 #define ORTC_SETTING_RTP_LISTENER_ONLY_RESOLVE_AMBIGUOUS_PAYLOAD_MAPPING_IF_ACTIVITY_DIFFERS_IN_MILLISECONDS "ortc/rtp-listener/only-resolve-ambiguous-payload-mapping-if-activity-differs-in-milliseconds"
 
+#define ORTC_SETTING_RTP_LISTENER_TRANSPORT_CC_FEEDBACK_INTERVAL_IN_MILLISECONDS "ortc/rtp-listener/transport-cc-feedback-interval-in-milliseconds"
+#define ORTC_SETTING_RTP_LISTENER_TRANSPORT_CC_MAX_RECORDED_PACKETS "ortc/rtp-listener/transport-cc-max-recorded-packets"
+
 namespace ortc
 {
   namespace internal
@@ -108,6 +117,12 @@ namespace ortc
                                    const BYTE *buffer,
                                    size_t bufferLengthInBytes
                                    ) = 0;
+
+      virtual bool handleRTPPacket(
+                                   IICETypes::Components viaComponent,
+                                   IICETypes::Components packetType,
+                                   SecureByteBlockPtr buffer  // NOTE: ownership of buffer is taken
+                                   ) = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -236,6 +251,7 @@ namespace ortc
       ZS_DECLARE_STRUCT_PTR(RegisteredHeaderExtension)
       ZS_DECLARE_STRUCT_PTR(ReceiverInfo)
       ZS_DECLARE_STRUCT_PTR(SSRCInfo)
+      ZS_DECLARE_STRUCT_PTR(SSRCRoutes)
       ZS_DECLARE_STRUCT_PTR(UnhandledEventInfo)
 
       ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverForRTPListener, UseRTPReceiver)
@@ -246,14 +262,16 @@ namespace ortc
 
       typedef std::list<RTCPPacketPtr> RTCPPacketList;
 
-      typedef std::pair<Time, RTPPacketPtr> TimeRTPPacketPair;
-      typedef std::list<TimeRTPPacketPair> BufferedRTPPacketList;
+      typedef RTPPacketRingBuffer BufferedRTPPackets;
+      typedef BufferedRTPPackets::TimeRTPPacketPair TimeRTPPacketPair;
+      typedef BufferedRTPPackets::Entry BufferedRTPPacket;
+      typedef BufferedRTPPackets::EntryList BufferedRTPPacketList;
 
       typedef std::pair<Time, RTCPPacketPtr> TimeRTCPPacketPair;
       typedef std::list<TimeRTCPPacketPair> BufferedRTCPPacketList;
 
-      typedef std::map<SSRCType, SSRCInfoPtr> SSRCMap;
-      typedef std::map<SSRCType, SSRCInfoWeakPtr> SSRCWeakMap;
+      typedef std::unordered_map<SSRCType, SSRCInfoPtr> SSRCMap;
+      typedef std::unordered_map<SSRCType, SSRCInfoWeakPtr> SSRCWeakMap;
 
       typedef PUID ObjectID;
       typedef USHORT LocalID;
@@ -312,6 +330,19 @@ namespace ortc
       ZS_DECLARE_PTR(ReceiverObjectMap)
       ZS_DECLARE_PTR(SenderObjectMap)
 
+      // NOTE: secondary indexes over mReceivers (in receiver ID order) so
+      //       that mapping an unknown SSRC only visits receivers which could
+      //       possibly match rather than every registered receiver.
+      typedef std::vector<ReceiverInfoPtr> ReceiverInfoList;
+      typedef std::unordered_map<SSRCType, ReceiverInfoList> EncodingSSRCIndex;
+      typedef std::unordered_map<PayloadType, ReceiverInfoList> PayloadTypeIndex;
+      typedef String RID;
+      typedef std::unordered_map<RID, ReceiverInfoList, std::hash<std::string> > RIDIndex;
+
+      typedef std::map<SenderID, Parameters> SenderParametersMap;
+      typedef std::vector<SenderID> SenderIDList;
+      typedef std::unordered_map<SSRCType, SenderIDList> SenderSSRCIndex;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPListener::SSRCInfo
@@ -320,7 +351,7 @@ namespace ortc
       struct SSRCInfo
       {
         SSRCType mSSRC {};
-        Time mLastUsage;
+        std::atomic<Time> mLastUsage;   // also updated by lock-free routing
         String mMuxID;
 
         ReceiverInfoPtr mReceiverInfo;    // can be NULL
@@ -330,7 +361,51 @@ namespace ortc
       };
 
       typedef String MuxID;
-      typedef std::map<MuxID, ReceiverInfoPtr> MuxIDMap;
+      typedef std::unordered_map<MuxID, ReceiverInfoPtr, std::hash<std::string> > MuxIDMap;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPListener::SSRCRoutes
+      #pragma mark
+
+      // NOTE: Immutable snapshot of every SSRC already latched to a receiver
+      //       held in an open addressing (linear probing) table whose
+      //       capacity is a power of two kept at or below 50% load. A new
+      //       snapshot is published (std::atomic_store) whenever the SSRC
+      //       table, receivers or header extensions change so packets for
+      //       known SSRCs are routed without taking the listener's lock.
+      struct SSRCRoutes
+      {
+        struct Route
+        {
+          bool mInUse {};
+          bool mActive {};                // false if only registered (not in the SSRC table)
+          SSRCType mSSRC {};
+          SSRCInfoPtr mSSRCInfo;
+          ReceiverInfoPtr mReceiverInfo;
+        };
+
+        typedef std::vector<Route> RouteVector;
+
+        SSRCRoutes(size_t totalRoutes);
+
+        void insert(
+                    SSRCInfoPtr ssrcInfo,
+                    bool active
+                    );
+        const Route *find(SSRCType ssrc) const;
+
+        size_t size() const {return mSize;}
+        size_t capacity() const {return mRoutes.size();}
+
+        static size_t hash(SSRCType ssrc);
+
+        RouteVector mRoutes;
+        size_t mSize {};
+
+        RTPHeaderExtensionLookup mHeaderExtensionLookup;
+        bool mTransportCC {};
+      };
 
       //-----------------------------------------------------------------------
       #pragma mark
@@ -351,6 +426,62 @@ namespace ortc
 
       typedef std::map<struct UnhandledEventInfo, Time> UnhandledEventMap;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPListener::TransportCCRecorder
+      #pragma mark
+
+      // NOTE: records the arrival time of every packet carrying a
+      //       transport-wide sequence number (across all SSRCs on the
+      //       transport) so transport-cc feedback can be returned to the
+      //       remote sender.
+      struct TransportCCRecorder
+      {
+        typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
+
+        static const size_t kMaxPacketStatusesPerFeedback {400};
+        static const size_t kMaxFeedbackPacketSize {1200};
+
+        struct Arrival
+        {
+          LONGLONG mSequenceNumber {};  // unwrapped
+          Time mTime;
+
+          bool operator<(const Arrival &op2) const {return mSequenceNumber < op2.mSequenceNumber;}
+        };
+        typedef std::vector<Arrival> ArrivalList;
+
+        size_t mMaxArrivals {};
+        ArrivalList mArrivals;
+
+        bool mHasLastSequenceNumber {};
+        LONGLONG mLastSequenceNumber {};  // unwrapped
+        SSRCType mMediaSSRC {};
+        BYTE mFeedbackPacketCount {};
+
+        std::vector<BYTE> mPacketStatuses;
+        std::vector<LONG> mRecvDeltas;
+
+        size_t mTotalRecorded {};
+        size_t mTotalDropped {};
+        size_t mTotalFeedbackPackets {};
+
+        void record(
+                    WORD sequenceNumber,
+                    SSRCType ssrc,
+                    const Time &arrival
+                    );
+
+        // NOTE: consumes the recorded arrivals; the returned transport-cc
+        //       points into mPacketStatuses / mRecvDeltas and is only valid
+        //       until the next call.
+        bool fillFeedback(TransportCC &outTransportCC);
+
+        void reset();
+
+        ElementPtr toDebug() const;
+      };
+
       enum States
       {
         State_Pending,
@@ -433,6 +564,12 @@ namespace ortc
                                    size_t bufferLengthInBytes
                                    ) override;
 
+      virtual bool handleRTPPacket(
+                                   IICETypes::Components viaComponent,
+                                   IICETypes::Components packetType,
+                                   SecureByteBlockPtr buffer
+                                   ) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPListener => IRTPListenerForRTPReceiver
@@ -538,6 +675,10 @@ namespace ortc
       void setError(WORD error, const char *reason = NULL);
 
       void expireRTPPackets();
+      void disposeBufferedRTPPacket(
+                                    RTPPacketPtr packet,
+                                    const char *reason
+                                    );
       void expireRTCPPackets();
 
       void registerHeaderExtensionReference(
@@ -548,36 +689,43 @@ namespace ortc
                                             );
 
       void unregisterAllHeaderExtensionReferences(PUID objectID);
+      void rebuildHeaderExtensionLookup();
 
       bool findMapping(
-                       const RTPPacket &rtpPacket,
+                       const RTPPacketView &rtpPacket,
                        ReceiverInfoPtr &outReceiverInfo,
                        String &outMuxID
                        );
 
       bool findMappingUsingMuxID(
                                  const String &muxID,
-                                 const RTPPacket &rtpPacket,
+                                 const RTPPacketView &rtpPacket,
                                  ReceiverInfoPtr &outReceiverInfo
                                  );
 
+      bool findMappingUsingRID(
+                               const String &muxID,
+                               const RTPPacketView &rtpPacket,
+                               ReceiverInfoPtr &outReceiverInfo
+                               );
+
       bool findMappingUsingSSRCInEncodingParams(
                                                 const String &muxID,
-                                                const RTPPacket &rtpPacket,
+                                                const RTPPacketView &rtpPacket,
                                                 ReceiverInfoPtr &outReceiverInfo
                                                 );
 
       bool findMappingUsingPayloadType(
                                        const String &muxID,
-                                       const RTPPacket &rtpPacket,
+                                       const RTPPacketView &rtpPacket,
                                        ReceiverInfoPtr &outReceiverInfo
                                        );
 
       String extractMuxID(
-                          const RTPPacket &rtpPacket,
+                          const RTPPacketView &rtpPacket,
                           ReceiverInfoPtr &ioReceiverInfo
                           );
-      String extractRID(const RTPPacket &rtpPacket);
+      String extractRID(const RTPPacketView &rtpPacket);
 
       bool fillMuxIDParameters(
                                const String &muxID,
@@ -585,6 +733,14 @@ namespace ortc
                                );
 
       void setReceiverInfo(ReceiverInfoPtr receiverInfo);
+      void rebuildReceiverIndexes();
+      void rebuildSenderIndexes();
+
+      void targetRTCPDelivery(
+                              const RTCPPacket &rtcpPacket,
+                              ReceiverObjectMapPtr &ioReceivers,
+                              SenderObjectMapPtr &ioSenders
+                              );
 
       void processByes(const RTCPPacket &rtcpPacket);
       void processSDESMid(const RTCPPacket &rtcpPacket);
@@ -615,6 +771,19 @@ namespace ortc
                             const Time &tick
                             );
 
+      bool findRoute(
+                     const RTPPacketView &rtpPacket,
+                     ReceiverInfoPtr &outReceiverInfo
+                     );
+      void publishSSRCRoutes();
+
+      static bool hasTransportCCFeedback(const Parameters &params);
+      void recordTransportArrival(
+                                  const RTPHeaderExtensionLookup &lookup,
+                                  const RTPPacketView &rtpPacket
+                                  );
+      void sendTransportCCFeedback();
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -636,21 +805,36 @@ namespace ortc
       UseRTPTransportWeakPtr mRTPTransport;
 
       size_t mMaxBufferedRTPPackets {};
+      size_t mMaxBufferedRTPPacketsPerSSRC {};
       Seconds mMaxRTPPacketAge {};
 
       size_t mMaxBufferedRTCPPackets {};
       Seconds mMaxRTCPPacketAge {};
 
-      BufferedRTPPacketList mBufferedRTPPackets;
+      BufferedRTPPackets mBufferedRTPPackets;
+      BufferedRTPPackets::SSRCList mBufferedSSRCs;  // scratch (avoids allocation during delivery attempts)
       BufferedRTCPPacketList mBufferedRTCPPackets;
 
       HeaderExtensionMap mRegisteredExtensions;
+      RTPHeaderExtensionLookup mHeaderExtensionLookup;
 
       ReceiverObjectMapPtr mReceivers;  // non-mutable map values (COW)
       SenderObjectMapPtr mSenders;      // non-mutable map values (COW)
 
+      EncodingSSRCIndex mEncodingSSRCIndex;   // rebuilt whenever mReceivers changes
+      PayloadTypeIndex mPayloadTypeIndex;     // rebuilt whenever mReceivers changes
+      RIDIndex mRIDIndex;                     // rebuilt whenever mReceivers changes
+
+      SenderParametersMap mSenderParameters;
+      SenderSSRCIndex mSenderSSRCIndex;       // rebuilt whenever mSenderParameters changes
+      SenderIDList mUnindexedSenders;         // senders with SSRCs not known in advance (always receive RTCP)
+
+      RTCPPacket::SSRCList mRTCPSenderSSRCs;  // scratch (avoids per packet allocation)
+      RTCPPacket::SSRCList mRTCPMediaSSRCs;   // scratch (avoids per packet allocation)
+
       SSRCMap mSSRCTable;
       SSRCWeakMap mRegisteredSSRCs;
+      SSRCRoutesPtr mSSRCRoutes;              // only access using std::atomic_load / std::atomic_store
 
       MuxIDMap mMuxIDTable;
 
@@ -664,6 +848,13 @@ namespace ortc
       Seconds mUnhanldedEventsExpires {};
 
       Milliseconds mAmbigousPayloadMappingMinDifference {};
+
+      Milliseconds mTransportCCFeedbackInterval {};
+      ReceiverInfoList mTransportCCReceivers; // receivers which negotiated "transport-cc" (rebuilt whenever mReceivers changes)
+      SSRCType mTransportCCSenderSSRC {};     // local SSRC used when no receiver/sender SSRC is known
+      mutable Lock mTransportCCLock;          // protects recorder and timer (arrivals are recorded without the listener lock)
+      TransportCCRecorder mTransportCCRecorder;
+      TimerPtr mTransportCCTimer;
     };
 
     //-------------------------------------------------------------------------
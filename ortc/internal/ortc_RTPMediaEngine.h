@@ -58,13 +58,24 @@
 #include <webrtc/modules/utility/include/process_thread.h>
 #include <webrtc/voice_engine/include/voe_base.h>
 #include <webrtc/video/vie_remb.h>
-//#define ORTC_SETTING_SCTP_TRANSPORT_MAX_MESSAGE_SIZE "ortc/sctp/max-message-size"
+
+// 0 = size the pool to the number of CPU cores
+#define ORTC_SETTING_RTP_MEDIA_ENGINE_PROCESS_THREAD_POOL_SIZE "ortc/rtp-media-engine/process-thread-pool-size"
+
+// 0 = never move channel resources between packet threads
+#define ORTC_SETTING_RTP_MEDIA_ENGINE_PACKET_QUEUE_REBALANCE_INTERVAL_IN_SECONDS "ortc/rtp-media-engine/packet-queue-rebalance-interval-in-seconds"
+
+// rounded up to a power of two; packets arriving while the ring is full are dropped
+#define ORTC_SETTING_RTP_MEDIA_ENGINE_CHANNEL_PACKET_RING_SIZE "ortc/rtp-media-engine/channel-packet-ring-size"
 
 namespace ortc
 {
   namespace internal
   {
     ZS_DECLARE_INTERACTION_PTR(IRTPMediaEngineRegistration);
+    ZS_DECLARE_STRUCT_PTR(RTPMediaEngineProcessThreads);
+    ZS_DECLARE_STRUCT_PTR(RTPMediaEngineCongestionContext);
+    ZS_DECLARE_INTERACTION_PTR(IRTPMediaEngineCongestionContextDelegate);
 
     // resource based interfaces
     ZS_DECLARE_INTERACTION_PTR(IRTPMediaEngineDeviceResource);
@@ -86,6 +97,7 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(IRTPMediaEngineForRTPSenderChannelAudio);
     ZS_DECLARE_INTERACTION_PTR(IRTPMediaEngineForRTPSenderChannelVideo);
     ZS_DECLARE_INTERACTION_PTR(IRTPMediaEngineForMediaStreamTrack);
+    ZS_DECLARE_INTERACTION_PTR(IRTPMediaEngineForRTPSender);
 
     ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrackForRTPMediaEngine);
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverChannelMediaBaseForRTPMediaEngine);
@@ -122,6 +134,164 @@ namespace ortc
       }
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngineProcessThreads
+    #pragma mark
+
+    // NOTE: A module process thread and pacer thread pair shared by
+    //       congestion contexts. Every module of a congestion context (and of
+    //       the channel resources using it) is registered onto a single pair
+    //       so the modules keep affinity with each other. The threads are
+    //       started on creation and stopped when the last reference to the
+    //       pair is gone.
+    struct RTPMediaEngineProcessThreads
+    {
+      RTPMediaEngineProcessThreads(size_t index);
+      ~RTPMediaEngineProcessThreads();
+
+      ElementPtr toDebug() const;
+
+      size_t mIndex {};
+      size_t mTotalUsers {};      // protected by the media engine's lock
+
+      rtc::scoped_ptr<webrtc::ProcessThread> mModuleProcessThread;
+      rtc::scoped_ptr<webrtc::ProcessThread> mPacerThread;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPMediaEngineCongestionContextDelegate
+    #pragma mark
+
+    interaction IRTPMediaEngineCongestionContextDelegate
+    {
+      virtual void notifyTargetBitrate(uint32_t targetBitrateBps) = 0;
+      virtual int getPaddingNeededBps() = 0;
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPMediaEngineCongestionContext
+    #pragma mark
+
+    // NOTE: Bandwidth estimation, pacing and bitrate allocation shared by
+    //       every channel resource sending or receiving over the same secure
+    //       transport. With a bundled transport all streams share one path so
+    //       they must share one estimate rather than compete with each other.
+    //       All modules run on a single process thread pair. Transport-cc
+    //       feedback (routed by the RTP listener to the sender of the
+    //       referenced media SSRC) reaches the send stream via DeliverRtcp and
+    //       from there the controller's transport feedback observer, which
+    //       runs the send-side delay based estimate for the whole transport.
+    struct RTPMediaEngineCongestionContext : public webrtc::BitrateObserver
+    {
+      struct ChannelInfo
+      {
+        IRTPMediaEngineCongestionContextDelegateWeakPtr mDelegate;
+
+        int mMinBitrateBps {};
+        int mStartBitrateBps {};
+        int mMaxBitrateBps {};
+      };
+
+      struct ChannelAllocation
+      {
+        IRTPMediaEngineCongestionContextDelegateWeakPtr mDelegate;
+
+        int mMinBitrateBps {};
+        int mMaxBitrateBps {};
+        uint32_t mAllocatedBitrateBps {};
+      };
+
+      typedef PUID ChannelID;
+      typedef std::map<ChannelID, ChannelInfo> ChannelMap;
+      typedef std::list<ChannelAllocation> ChannelAllocationList;
+
+      RTPMediaEngineCongestionContext(
+                                      PUID secureTransportID,
+                                      RTPMediaEngineProcessThreadsPtr processThreads
+                                      );
+      ~RTPMediaEngineCongestionContext();
+
+      void registerChannel(
+                           ChannelID channelID,
+                           IRTPMediaEngineCongestionContextDelegatePtr delegate
+                           );
+      void unregisterChannel(ChannelID channelID);
+
+      void setBweBitrates(
+                          ChannelID channelID,
+                          int minBitrateBps,
+                          int startBitrateBps,
+                          int maxBitrateBps
+                          );
+
+      // NOTE: used by senders that forward already encoded packets (thus
+      //       without a send stream or RTP/RTCP module of their own); the
+      //       sequence numbers are allocated from the same packet router as
+      //       the send streams so they remain unique over the transport.
+      WORD allocateTransportSequenceNumber();
+      void notifyPacketSent(
+                            WORD transportSequenceNumber,
+                            size_t packetSizeInBytes
+                            );
+      void handleTransportFeedback(
+                                   const BYTE *buffer,
+                                   size_t bufferSizeInBytes
+                                   );
+
+      ElementPtr toDebug() const;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPMediaEngineCongestionContext => webrtc::BitrateObserver
+      #pragma mark
+
+      virtual void OnNetworkChanged(uint32_t targetBitrateBps, uint8_t fractionLoss, int64_t rttMs) override;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPMediaEngineCongestionContext => (internal)
+      #pragma mark
+
+      void updateBweBitrates();
+
+      static void allocateBitrates(
+                                   uint32_t targetBitrateBps,
+                                   ChannelAllocationList &ioAllocations
+                                   );
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPMediaEngineCongestionContext => (data)
+      #pragma mark
+
+      AutoPUID mID;
+      PUID mSecureTransportID {};
+      size_t mTotalChannels {};   // protected by the media engine's lock
+
+      mutable Lock mLock;
+      ChannelMap mChannels;
+
+      RTPMediaEngineProcessThreadsPtr mProcessThreads;
+
+      webrtc::Clock *mClock;
+      webrtc::VieRemb mRemb;
+      rtc::scoped_ptr<webrtc::CallStats> mCallStats;
+      rtc::scoped_ptr<webrtc::BitrateAllocator> mBitrateAllocator;
+      rtc::scoped_ptr<webrtc::CongestionController> mCongestionController;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -415,6 +585,7 @@ namespace ortc
       static PromiseWithRTPMediaEngineChannelResourcePtr setupChannel(
                                                                       UseReceiverChannelMediaBasePtr channel,
                                                                       TransportPtr transport,
+                                                                      PUID secureTransportID,
                                                                       UseMediaStreamTrackPtr track,
                                                                       ParametersPtr parameters,
                                                                       RTPPacketPtr packet
@@ -488,6 +659,7 @@ namespace ortc
       static PromiseWithRTPMediaEngineChannelResourcePtr setupChannel(
                                                                       UseSenderChannelMediaBasePtr channel,
                                                                       TransportPtr transport,
+                                                                      PUID secureTransportID,
                                                                       UseMediaStreamTrackPtr track,
                                                                       ParametersPtr parameters,
                                                                       IDTMFSenderDelegatePtr dtmfDelegate
@@ -546,6 +718,26 @@ namespace ortc
       virtual ~IRTPMediaEngineForMediaStreamTrack() {}
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPMediaEngineForRTPSender
+    #pragma mark
+
+    interaction IRTPMediaEngineForRTPSender
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPMediaEngineForRTPSender, ForRTPSender)
+
+      // NOTE: returns NULL when the media engine is not running (forwarded
+      //       packets are then sent without congestion control)
+      static RTPMediaEngineCongestionContextPtr acquireCongestionContext(PUID secureTransportID);
+      static void releaseCongestionContext(RTPMediaEngineCongestionContextPtr context);
+
+      virtual ~IRTPMediaEngineForRTPSender() {}
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -583,6 +775,9 @@ namespace ortc
       virtual rtc::scoped_refptr<webrtc::AudioState> getAudioState() = 0;
       virtual const SharedRecursiveLock &getSharedLock() const = 0;
       virtual IMessageQueuePtr getMessageQueue() const = 0;
+
+      virtual RTPMediaEngineCongestionContextPtr acquireCongestionContext(PUID secureTransportID) = 0;
+      virtual void releaseCongestionContext(RTPMediaEngineCongestionContextPtr context) = 0;
     };
 
 
@@ -614,6 +809,7 @@ namespace ortc
       {
         PromiseWithRTPMediaEngineChannelResourcePtr mPromise;
         TransportPtr mTransport;
+        PUID mSecureTransportID {};
         UseMediaStreamTrackPtr mTrack;
         ParametersPtr mParameters;
       };
@@ -653,9 +849,7 @@ namespace ortc
     {
       ZS_DECLARE_TYPEDEF_PTR(webrtc::VideoFrame, VideoFrame);
 
-      virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) = 0;
-      virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) = 0;
-      virtual void onSendVideoFrame(VideoFramePtr videoFrame) = 0;
+      virtual void onDrainPackets() = 0;
     };
     
 
@@ -681,6 +875,7 @@ namespace ortc
                            public IRTPMediaEngineForRTPSenderChannelAudio,
                            public IRTPMediaEngineForRTPSenderChannelVideo,
                            public IRTPMediaEngineForMediaStreamTrack,
+                           public IRTPMediaEngineForRTPSender,
                            public IRTPMediaEngineForDeviceResource,
                            public IRTPMediaEngineForChannelResource,
                            public IWakeDelegate,
@@ -707,6 +902,7 @@ namespace ortc
       friend interaction IRTPMediaEngineForRTPSenderChannelAudio;
       friend interaction IRTPMediaEngineForRTPSenderChannelVideo;
       friend interaction IRTPMediaEngineForMediaStreamTrack;
+      friend interaction IRTPMediaEngineForRTPSender;
       friend interaction IRTPMediaEngineForDeviceResource;
       friend interaction IRTPMediaEngineForChannelResource;
 
@@ -749,6 +945,9 @@ namespace ortc
       typedef std::list<DeviceResourcePtr> DeviceResourceList;
       typedef std::map<PUID, ChannelResourceWeakPtr> ChannelResourceWeakMap;
       typedef std::list<ChannelResourcePtr> ChannelResourceList;
+      typedef std::vector<RTPMediaEngineProcessThreadsPtr> RTPMediaEngineProcessThreadsList;
+      typedef std::map<PUID, RTPMediaEngineCongestionContextWeakPtr> CongestionContextWeakMap;
+      typedef std::map<size_t, ULONGLONG> PacketQueueSampleMap;
 
     public:
       RTPMediaEngine(
@@ -823,6 +1022,7 @@ namespace ortc
       PromiseWithRTPMediaEngineChannelResourcePtr setupChannel(
                                                                UseReceiverChannelMediaBasePtr channel,
                                                                TransportPtr transport,
+                                                               PUID secureTransportID,
                                                                UseMediaStreamTrackPtr track,
                                                                ParametersPtr parameters,
                                                                RTPPacketPtr packet
@@ -855,6 +1055,7 @@ namespace ortc
       PromiseWithRTPMediaEngineChannelResourcePtr setupChannel(
                                                                UseSenderChannelMediaBasePtr channel,
                                                                TransportPtr transport,
+                                                               PUID secureTransportID,
                                                                UseMediaStreamTrackPtr track,
                                                                ParametersPtr parameters,
                                                                IDTMFSenderDelegatePtr dtmfDelegate
@@ -905,6 +1106,9 @@ namespace ortc
       // (duplicate) virtual const SharedRecursiveLock &getSharedLock() const = 0;
       // (duplicate) virtual IMessageQueuePtr getMessageQueue() const = 0;
 
+      virtual RTPMediaEngineCongestionContextPtr acquireCongestionContext(PUID secureTransportID) override;
+      virtual void releaseCongestionContext(RTPMediaEngineCongestionContextPtr context) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPMediaEngine => IWakeDelegate
@@ -1008,6 +1212,11 @@ namespace ortc
       void setState(States state);
       void setError(WORD error, const char *reason = NULL);
 
+      RTPMediaEngineProcessThreadsPtr acquireProcessThreads();
+      void releaseProcessThreads(RTPMediaEngineProcessThreadsPtr threads);
+
+      void rebalancePacketQueues();
+
     public:
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -1322,7 +1531,8 @@ namespace ortc
       class ChannelResource : public BaseResource,
                               public IRTPMediaEngineHandlePacketAsyncDelegate,
                               public IChannelResourceForRTPMediaEngine,
-                              public IRTPMediaEngineChannelResourceAsyncDelegate
+                              public IRTPMediaEngineChannelResourceAsyncDelegate,
+                              public IRTPMediaEngineCongestionContextDelegate
       {
       public:
         typedef std::list<PromisePtr> PromiseList;
@@ -1339,6 +1549,47 @@ namespace ortc
           std::atomic<size_t> &mAccessFromNonLockedMethods;
         };
 
+        struct QueuedPacket
+        {
+          enum Types
+          {
+            Type_RTP,
+            Type_RTCP,
+            Type_VideoFrame,
+          };
+
+          Types mType {Type_RTP};
+          Time mQueued;
+          DWORD mTimestamp {};
+          SecureByteBlockPtr mBuffer;
+          VideoFramePtr mVideoFrame;
+          ORTCPacketQueue *mPacketQueue {};   // queue accounting for the packet (queues live as long as the ORTC singleton)
+        };
+
+        // NOTE: bounded single producer / single consumer ring; producers
+        //       are serialized by mPacketQueueLock and only one packet
+        //       thread drains the ring at a time (see mDrainScheduled) thus
+        //       neither side allocates nor locks against the other.
+        struct PacketRing
+        {
+          PacketRing(size_t capacity);
+
+          bool isEmpty() const;
+          bool isFull() const;
+
+          void push(QueuedPacket &packet);
+          bool pop(QueuedPacket &outPacket);
+
+          std::vector<QueuedPacket> mSlots;
+          const size_t mMask;
+
+          // NOTE: producer and consumer positions live on separate cache
+          //       lines (thus channel resources holding a ring are created
+          //       with an AlignedAllocator rather than make_shared)
+          alignas(64) std::atomic<size_t> mHead {};   // consumer position
+          alignas(64) std::atomic<size_t> mTail {};   // producer position
+        };
+
       public:
         ChannelResource(
                         const make_private &priv,
@@ -1367,11 +1618,32 @@ namespace ortc
 
         virtual void onSendDTMFTone() override { }
 
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RTPMediaEngine::ChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
+        #pragma mark
+
+        virtual void onDrainPackets() override;
+
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark RTPMediaEngine::ChannelResource => IRTPMediaEngineCongestionContextDelegate
+        #pragma mark
+
+        virtual void notifyTargetBitrate(uint32_t targetBitrateBps) override;
+        virtual int getPaddingNeededBps() override { return 0; }
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark RTPMediaEngine::ChannelResource => (friend RTPMediaEngine)
         #pragma mark
 
+        void setSecureTransportID(PUID secureTransportID) { mSecureTransportID = secureTransportID; }
+
+        ORTCPacketQueuePtr getPacketQueue() const;
+        ULONGLONG samplePacketsQueued();
+        bool migratePacketQueue(ORTCPacketQueuePtr queue);
+
         virtual void stepSetup() = 0;
         virtual void stepShutdown() = 0;
 
@@ -1385,6 +1657,20 @@ namespace ortc
         bool isShutdown() const {return mShutdown;}
         void notifyPromisesShutdown();
 
+        void postRTPPacket(
+                           DWORD timestamp,
+                           SecureByteBlockPtr buffer
+                           );
+        void postRTCPPacket(SecureByteBlockPtr buffer);
+        void postVideoFrame(VideoFramePtr videoFrame);
+
+        virtual void processRTPPacket(
+                                      DWORD timestamp,
+                                      SecureByteBlockPtr buffer
+                                      ) {}
+        virtual void processRTCPPacket(SecureByteBlockPtr buffer) {}
+        virtual void processVideoFrame(VideoFramePtr videoFrame) {}
+
       protected:
         //---------------------------------------------------------------------
         #pragma mark
@@ -1393,24 +1679,41 @@ namespace ortc
 
         PromisePtr getShutdownPromise();
 
+        bool acquireCongestionContext();
+        void releaseCongestionContext();
+
+        void postPacket(QueuedPacket &packet);
+        void postDrainPackets();
+
       protected:
         String mCodecPayloadName;
         BYTE mCodecPayloadType {0};
-        UINT mCurrentTargetBitrate {0};
+        std::atomic<UINT> mCurrentTargetBitrate {0};
+
+        PUID mSecureTransportID {};
 
-        rtc::scoped_ptr<webrtc::ProcessThread> mModuleProcessThread;
-        rtc::scoped_ptr<webrtc::ProcessThread> mPacerThread;
-        webrtc::Clock *mClock;
-        webrtc::VieRemb mRemb;
-        rtc::scoped_ptr<webrtc::CallStats> mCallStats;
-        rtc::scoped_ptr<webrtc::CongestionController> mCongestionController;
-        rtc::scoped_ptr<webrtc::BitrateAllocator> mBitrateAllocator;
+        // NOTE: all pointers below are owned by the shared congestion context
+        RTPMediaEngineCongestionContextPtr mCongestionContext;
+        webrtc::ProcessThread *mModuleProcessThread {};
+        webrtc::ProcessThread *mPacerThread {};
+        webrtc::VieRemb *mRemb {};
+        webrtc::CallStats *mCallStats {};
+        webrtc::CongestionController *mCongestionController {};
+        webrtc::BitrateAllocator *mBitrateAllocator {};
 
         bool mShuttingDown {false};
         bool mShutdown {false};
         PromiseList mShutdownPromises;
 
-        IMessageQueuePtr mHandlePacketQueue;
+        // NOTE: packet queue state is protected by its own lock so packets
+        //       can be posted without taking the shared lock.
+        mutable Lock mPacketQueueLock;
+        ORTCPacketQueuePtr mPacketQueue;
+        PacketRing mPacketRing;
+        std::atomic<bool> mDrainScheduled {};
+        std::atomic<ULONGLONG> mTotalPacketsQueued {};
+        ULONGLONG mLastSampledPacketsQueued {};
+
         std::atomic<size_t> mAccessFromNonLockedMethods {};
         std::atomic<bool> mDenyNonLockedAccess {};
       };
@@ -1424,8 +1727,7 @@ namespace ortc
       #pragma mark
 
       class AudioReceiverChannelResource : public IRTPMediaEngineAudioReceiverChannelResource,
-                                           public ChannelResource,
-                                           public webrtc::BitrateObserver
+                                           public ChannelResource
       {
       public:
         friend class RTPMediaEngine;
@@ -1492,19 +1794,14 @@ namespace ortc
 
         //---------------------------------------------------------------------
         #pragma mark
-        #pragma mark RTPMediaEngine::AudioReceiverChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
-        #pragma mark
-
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override;
-        virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
-        virtual void onSendVideoFrame(VideoFramePtr videoFrame) override {}
-
-        //---------------------------------------------------------------------
-        #pragma mark
-        #pragma mark RTPMediaEngine::AudioReceiverChannelResource => webrtc::BitrateObserver
+        #pragma mark RTPMediaEngine::AudioReceiverChannelResource => ChannelResource
         #pragma mark
 
-        virtual void OnNetworkChanged(uint32_t targetBitrateBps, uint8_t fractionLoss, int64_t rttMs) override;
+        virtual void processRTPPacket(
+                                      DWORD timestamp,
+                                      SecureByteBlockPtr buffer
+                                      ) override;
+        virtual void processRTCPPacket(SecureByteBlockPtr buffer) override;
 
       protected:
         //-----------------------------------------------------------------------
@@ -1553,8 +1850,7 @@ namespace ortc
 
       class AudioSenderChannelResource : public IRTPMediaEngineAudioSenderChannelResource,
                                          public ChannelResource,
-                                         public zsLib::ITimerDelegate,
-                                         public webrtc::BitrateObserver
+                                         public zsLib::ITimerDelegate
       {
       public:
         friend class RTPMediaEngine;
@@ -1637,12 +1933,10 @@ namespace ortc
 
         //---------------------------------------------------------------------
         #pragma mark
-        #pragma mark RTPMediaEngine::AudioSenderChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
+        #pragma mark RTPMediaEngine::AudioSenderChannelResource => ChannelResource
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override {}
-        virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
-        virtual void onSendVideoFrame(VideoFramePtr videoFrame) override {}
+        virtual void processRTCPPacket(SecureByteBlockPtr buffer) override;
 
         //-----------------------------------------------------------------------
         #pragma mark
@@ -1651,13 +1945,6 @@ namespace ortc
 
         virtual void onTimer(TimerPtr timer) override;
 
-        //---------------------------------------------------------------------
-        #pragma mark
-        #pragma mark RTPMediaEngine::AudioSenderChannelResource => webrtc::BitrateObserver
-        #pragma mark
-
-        virtual void OnNetworkChanged(uint32_t targetBitrateBps, uint8_t fractionLoss, int64_t rttMs) override;
-
       protected:
         //-----------------------------------------------------------------------
         #pragma mark
@@ -1711,8 +1998,7 @@ namespace ortc
       #pragma mark
 
       class VideoReceiverChannelResource : public IRTPMediaEngineVideoReceiverChannelResource,
-                                           public ChannelResource,
-                                           public webrtc::BitrateObserver
+                                           public ChannelResource
       {
       public:
         friend class RTPMediaEngine;
@@ -1795,12 +2081,14 @@ namespace ortc
 
         //---------------------------------------------------------------------
         #pragma mark
-        #pragma mark RTPMediaEngine::VideoReceiverChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
+        #pragma mark RTPMediaEngine::VideoReceiverChannelResource => ChannelResource
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override;
-        virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
-        virtual void onSendVideoFrame(VideoFramePtr videoFrame) override {}
+        virtual void processRTPPacket(
+                                      DWORD timestamp,
+                                      SecureByteBlockPtr buffer
+                                      ) override;
+        virtual void processRTCPPacket(SecureByteBlockPtr buffer) override;
 
         //-----------------------------------------------------------------------
         #pragma mark
@@ -1810,13 +2098,6 @@ namespace ortc
         virtual void stepSetup() override;
         virtual void stepShutdown() override;
 
-        //---------------------------------------------------------------------
-        #pragma mark
-        #pragma mark RTPMediaEngine::VideoReceiverChannelResource => webrtc::BitrateObserver
-        #pragma mark
-
-        virtual void OnNetworkChanged(uint32_t targetBitrateBps, uint8_t fractionLoss, int64_t rttMs) override;
-
       protected:
         TransportPtr mTransport;
         std::atomic<ISecureTransport::States> mTransportState { ISecureTransport::State_Pending };
@@ -1843,8 +2124,7 @@ namespace ortc
       #pragma mark
 
       class VideoSenderChannelResource : public IRTPMediaEngineVideoSenderChannelResource,
-                                         public ChannelResource,
-                                         public webrtc::BitrateObserver
+                                         public ChannelResource
       {
       public:
         friend class RTPMediaEngine;
@@ -1916,12 +2196,11 @@ namespace ortc
 
         //---------------------------------------------------------------------
         #pragma mark
-        #pragma mark RTPMediaEngine::VideoSenderChannelResource => IRTPMediaEngineHandlePacketAsyncDelegate
+        #pragma mark RTPMediaEngine::VideoSenderChannelResource => ChannelResource
         #pragma mark
 
-        virtual void onHandleRTPPacket(DWORD timestamp, SecureByteBlockPtr buffer) override {}
-        virtual void onHandleRTCPPacket(SecureByteBlockPtr buffer) override;
-        virtual void onSendVideoFrame(VideoFramePtr videoFrame) override;
+        virtual void processRTCPPacket(SecureByteBlockPtr buffer) override;
+        virtual void processVideoFrame(VideoFramePtr videoFrame) override;
 
         //-----------------------------------------------------------------------
         #pragma mark
@@ -1933,10 +2212,10 @@ namespace ortc
 
         //---------------------------------------------------------------------
         #pragma mark
-        #pragma mark RTPMediaEngine::VideoSenderChannelResource => webrtc::BitrateObserver
+        #pragma mark RTPMediaEngine::VideoSenderChannelResource => IRTPMediaEngineCongestionContextDelegate
         #pragma mark
 
-        virtual void OnNetworkChanged(uint32_t targetBitrateBps, uint8_t fractionLoss, int64_t rttMs) override;
+        virtual int getPaddingNeededBps() override;
 
       protected:
         TransportPtr mTransport;
@@ -1982,6 +2261,14 @@ namespace ortc
       rtc::scoped_refptr<webrtc::AudioState> mAudioState;
       rtc::scoped_ptr<webrtc::VoiceEngine, VoiceEngineDeleter> mVoiceEngine;
 
+      size_t mProcessThreadPoolSize {};
+      RTPMediaEngineProcessThreadsList mProcessThreadPool;
+
+      CongestionContextWeakMap mCongestionContexts;
+
+      TimerPtr mPacketQueueRebalanceTimer;
+      PacketQueueSampleMap mPacketQueueSamples;
+
       rtc::scoped_ptr<WebRtcTraceCallback> mTraceCallback;
       rtc::scoped_ptr<WebRtcLogSink> mLogSink;
       rtc::TraceLog mTraceLog;
@@ -2036,7 +2323,5 @@ ZS_DECLARE_PROXY_END()
 ZS_DECLARE_PROXY_BEGIN(ortc::internal::IRTPMediaEngineHandlePacketAsyncDelegate)
 ZS_DECLARE_PROXY_TYPEDEF(openpeer::services::SecureByteBlockPtr, SecureByteBlockPtr)
 ZS_DECLARE_PROXY_TYPEDEF(ortc::internal::IRTPMediaEngineHandlePacketAsyncDelegate::VideoFramePtr, VideoFramePtr)
-ZS_DECLARE_PROXY_METHOD_2(onHandleRTPPacket, DWORD, SecureByteBlockPtr)
-ZS_DECLARE_PROXY_METHOD_1(onHandleRTCPPacket, SecureByteBlockPtr)
-ZS_DECLARE_PROXY_METHOD_1(onSendVideoFrame, VideoFramePtr)
+ZS_DECLARE_PROXY_METHOD_0(onDrainPackets)
 ZS_DECLARE_PROXY_END()
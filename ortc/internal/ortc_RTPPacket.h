@@ -34,11 +34,42 @@
 #include <ortc/internal/types.h>
 
 #include <ortc/IICETypes.h>
+#include <ortc/IRTPTypes.h>
+
+#include <deque>
+#include <unordered_map>
+
+#define ORTC_RTPPACKET_MAX_INLINE_HEADER_EXTENSIONS (8)
+#define ORTC_RTPPACKET_VIEW_MAX_HEADER_EXTENSIONS (16)
+#define ORTC_RTPPACKET_MAX_HEADER_EXTENSION_IDS (256)
+
+#define ORTC_SETTING_RTP_PACKET_MAX_POOLED_PACKETS_PER_SHARD "ortc/rtp-packet/max-pooled-packets-per-shard"
+#define ORTC_SETTING_RTP_PACKET_MAX_POOLED_BUFFERS_PER_THREAD "ortc/rtp-packet/max-pooled-buffers-per-thread"
+#define ORTC_SETTING_RTP_PACKET_POOLED_BUFFER_CAPACITY_IN_BYTES "ortc/rtp-packet/pooled-buffer-capacity-in-bytes"
 
 namespace ortc
 {
   namespace internal
   {
+    ZS_DECLARE_INTERACTION_PTR(IRTPPacketForSettings)
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPPacketForSettings
+    #pragma mark
+
+    interaction IRTPPacketForSettings
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPPacketForSettings, ForSettings)
+
+      static void applyDefaults();
+
+      virtual ~IRTPPacketForSettings() {}
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -52,6 +83,8 @@ namespace ortc
     protected:
       struct make_private {};
 
+      friend class RTPPacketView;
+
     public:
       struct HeaderExtension;
       struct VideoOrientationHeaderExtension;
@@ -338,6 +371,15 @@ namespace ortc
       static RTPPacketPtr create(const SecureByteBlock &buffer);
       static RTPPacketPtr create(SecureByteBlockPtr buffer);  // NOTE: ownership of buffer is taken
 
+      // NOTE: copies the packet into a buffer which reserves extra capacity
+      //       beyond the packet so header extensions can later be inserted
+      //       in place (see insertHeaderExtensions).
+      static RTPPacketPtr create(
+                                 const BYTE *buffer,
+                                 size_t bufferLengthInBytes,
+                                 size_t reserveHeadroomInBytes
+                                 );
+
       const BYTE *ptr() const;
       size_t size() const;
       SecureByteBlockPtr buffer() const;
@@ -370,6 +412,12 @@ namespace ortc
 
       void changeHeaderExtensions(HeaderExtension *firstExtension);
 
+      // NOTE: inserts the extensions into the packet (replacing any existing
+      //       extensions with a matching ID). The packet is rewritten within
+      //       its existing buffer when enough capacity was reserved,
+      //       otherwise a new buffer is allocated.
+      void insertHeaderExtensions(HeaderExtension *firstExtension);
+
       ElementPtr toDebug() const;
 
     protected:
@@ -382,8 +430,38 @@ namespace ortc
       Log::Params log(const char *message) const;
       Log::Params debug(const char *message) const;
 
+      static RTPPacketPtr allocate();
+      static SecureByteBlockPtr allocateBuffer(size_t sizeInBytes);
+      static SecureByteBlockPtr allocateBuffer(
+                                               size_t sizeInBytes,
+                                               size_t reserveHeadroomInBytes,
+                                               size_t &outCapacityInBytes
+                                               );
+
+      HeaderExtension *allocateHeaderExtensions(size_t totalExtensions);
+      void freeHeaderExtensions(HeaderExtension *extensions);
+
       bool parse();
 
+      static bool countHeaderExtensions(
+                                        const BYTE *pos,
+                                        size_t remaining,
+                                        bool oneByte,
+                                        size_t &outTotalExtensions
+                                        );
+
+      static bool parseHeaderExtensions(
+                                        const BYTE *pos,
+                                        size_t remaining,
+                                        bool oneByte,
+                                        HeaderExtension *extensions,
+                                        size_t maxExtensions,
+                                        size_t &outTotalExtensions,
+                                        size_t &outPrepaddedSize,
+                                        const BYTE * &outParseStoppedPos,
+                                        size_t &outParseStoppedSize
+                                        );
+
       void writeHeaderExtensions(
                                  HeaderExtension *firstExtension,
                                  bool twoByteHeader
@@ -393,6 +471,7 @@ namespace ortc
 
     public:
       SecureByteBlockPtr mBuffer;
+      size_t mBufferCapacity {};  // 0 = buffer cannot be resized in place
 
       BYTE mVersion {};
       size_t mPadding {};
@@ -414,6 +493,268 @@ namespace ortc
       size_t mHeaderExtensionPrepaddedSize {};
       const BYTE *mHeaderExtensionParseStoppedPos {};
       size_t mHeaderExtensionParseStoppedSize {};
+
+      // two banks so extensions can be rewritten from the bank in use
+      HeaderExtension mInlineHeaderExtensions[2][ORTC_RTPPACKET_MAX_INLINE_HEADER_EXTENSIONS] {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPPacketView
+    #pragma mark
+
+    // NOTE: A non-owning view over an RTP packet held in a buffer owned by
+    //       someone else (which must outlive the view). Only the fixed
+    //       header is decoded at construction; header extensions are decoded
+    //       into an inline array the first time they are requested. Intended
+    //       to be constructed on the stack while demuxing so that an
+    //       RTPPacket only needs to be materialized once the packet is
+    //       buffered or delivered.
+    class RTPPacketView
+    {
+    public:
+      typedef RTPPacket::HeaderExtension HeaderExtension;
+
+    public:
+      RTPPacketView(
+                    const BYTE *buffer,
+                    size_t bufferLengthInBytes
+                    );
+      RTPPacketView(const RTPPacket &packet);
+      ~RTPPacketView();
+
+      RTPPacketView(const RTPPacketView &) = delete;
+      RTPPacketView &operator=(const RTPPacketView &) = delete;
+
+      bool isValid() const {return mValid;}
+
+      const BYTE *ptr() const {return mBuffer;}
+      size_t size() const {return mSize;}
+
+      BYTE version() const {return mVersion;}
+      size_t cc() const {return static_cast<size_t>(mCC);}
+      bool m() const {return mM;}
+      BYTE pt() const {return mPT;}
+      WORD sequenceNumber() const {return mSequenceNumber;}
+      DWORD timestamp() const {return mTimestamp;}
+      DWORD ssrc() const {return mSSRC;}
+
+      DWORD getCSRC(size_t index) const;
+
+      size_t totalHeaderExtensions() const;
+      HeaderExtension *firstHeaderExtension() const;
+
+      // NOTE: O(1) after the first call (a dense index by ID is built when
+      //       the extensions are first looked up by ID)
+      HeaderExtension *findHeaderExtension(BYTE id) const;
+
+      ElementPtr toDebug() const;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark (internal)
+      #pragma mark
+
+      Log::Params log(const char *message) const;
+      Log::Params debug(const char *message) const;
+
+      bool parse();
+      void parseHeaderExtensionsIfNeeded() const;
+      void indexHeaderExtensionsIfNeeded() const;
+
+    protected:
+      const BYTE *mBuffer {};
+      size_t mSize {};
+      bool mValid {};
+
+      BYTE mVersion {};
+      BYTE mCC {};
+      bool mM {};
+      BYTE mPT {};
+      WORD mSequenceNumber {};
+      DWORD mTimestamp {};
+      DWORD mSSRC {};
+
+      const BYTE *mHeaderExtensionPos {};
+      size_t mHeaderExtensionRemaining {};
+      bool mOneByteHeader {};
+      size_t mCountedHeaderExtensions {};
+
+      mutable bool mHeaderExtensionsParsed {};
+      mutable size_t mTotalHeaderExtensions {};
+      mutable HeaderExtension *mFirstHeaderExtension {};
+      mutable HeaderExtension mHeaderExtensions[ORTC_RTPPACKET_VIEW_MAX_HEADER_EXTENSIONS] {};
+      mutable HeaderExtension *mOverflowHeaderExtensions {};  // only when more than ORTC_RTPPACKET_VIEW_MAX_HEADER_EXTENSIONS are present
+
+      mutable bool mHeaderExtensionsIndexed {};
+      mutable BYTE mHeaderExtensionIndexByID[ORTC_RTPPACKET_MAX_HEADER_EXTENSION_IDS] {}; // index + 1 (0 = not present)
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPHeaderExtensionLookup
+    #pragma mark
+
+    // NOTE: Fixed size tables mapping negotiated header extension local IDs
+    //       to URIs (and URIs back to local IDs) so locating a particular
+    //       extension within a packet never requires a map lookup.
+    struct RTPHeaderExtensionLookup
+    {
+      typedef IRTPTypes::HeaderExtensionURIs HeaderExtensionURIs;
+      typedef RTPPacket::HeaderExtension HeaderExtension;
+
+      static const WORD kNoLocalID {0};
+      static const WORD kMultipleLocalIDs {0xFFFF};
+
+      void clear();
+      void add(
+               WORD localID,
+               HeaderExtensionURIs uri
+               );
+
+      HeaderExtensionURIs uri(BYTE localID) const {return mURIs[localID];}
+
+      HeaderExtension *find(
+                            const RTPPacketView &packet,
+                            HeaderExtensionURIs uri
+                            ) const;
+      HeaderExtension *find(
+                            const RTPPacket &packet,
+                            HeaderExtensionURIs uri
+                            ) const;
+
+      ElementPtr toDebug() const;
+
+      static Log::Params slog(const char *message);
+
+      HeaderExtensionURIs mURIs[ORTC_RTPPACKET_MAX_HEADER_EXTENSION_IDS] {};
+      WORD mLocalIDs[IRTPTypes::HeaderExtensionURI_Last + 1] {};
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPPacketRingBuffer
+    #pragma mark
+
+    // NOTE: Bounded buffering of RTP packets which cannot be routed yet. Each
+    //       SSRC has its own fixed size ring (oldest packets of an SSRC are
+    //       overwritten once full) and a single arrival ordered queue of
+    //       (SSRC, serial) entries makes evicting the oldest packet overall
+    //       O(1). Entries in the arrival queue for packets already drained or
+    //       overwritten are discarded lazily.
+    class RTPPacketRingBuffer
+    {
+    public:
+      typedef IRTPTypes::SSRCType SSRCType;
+      typedef std::pair<Time, RTPPacketPtr> TimeRTPPacketPair;
+      typedef std::vector<SSRCType> SSRCList;
+
+      struct Entry
+      {
+        ULONGLONG mSerial {};     // arrival order
+        Time mTime;
+        RTPPacketPtr mPacket;
+      };
+      typedef std::list<Entry> EntryList;
+
+    public:
+      void setLimits(
+                     size_t maxPackets,
+                     size_t maxPacketsPerSSRC,
+                     Seconds maxAge
+                     );
+
+      size_t size() const                   {return mTotal;}
+      size_t ssrcCount() const              {return mRings.size();}
+
+      // NOTE: returns the packet overwritten to make room (if any)
+      RTPPacketPtr push(
+                        const Time &tick,
+                        RTPPacketPtr packet
+                        );
+
+      // NOTE: re-buffers a previously drained packet at its original arrival
+      //       position (thus its original expiry order is kept); returns the
+      //       packet overwritten to make room (if any) which may be the
+      //       restored packet itself if it is older than everything kept
+      RTPPacketPtr restore(const Entry &entry);
+
+      // NOTE: pops the oldest packet if the buffer is over capacity or the
+      //       packet is too old (call repeatedly until false is returned)
+      bool popExpired(
+                      const Time &tick,
+                      TimeRTPPacketPair &outExpired
+                      );
+
+      void getSSRCs(SSRCList &outSSRCs) const;
+      RTPPacketPtr front(SSRCType ssrc) const;
+
+      // NOTE: removes every packet buffered for the SSRC (in arrival order)
+      void drain(
+                 SSRCType ssrc,
+                 EntryList &outPackets
+                 );
+
+      void clear();
+
+      ElementPtr toDebug() const;
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPPacketRingBuffer => (internal)
+      #pragma mark
+
+      typedef std::vector<Entry> EntryVector;
+
+      struct Ring
+      {
+        EntryVector mEntries;
+        size_t mHead {};
+        size_t mCount {};
+
+        Entry &head()                       {return mEntries[mHead];}
+        Entry &at(size_t index)             {return mEntries[(mHead + index) % mEntries.size()];}
+        void popHead();
+      };
+      typedef std::unordered_map<SSRCType, Ring> RingMap;
+
+      struct OrderEntry
+      {
+        SSRCType mSSRC {};
+        ULONGLONG mSerial {};
+      };
+      typedef std::deque<OrderEntry> OrderQueue;
+
+      void compactOrder();
+
+    protected:
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPPacketRingBuffer => (data)
+      #pragma mark
+
+      size_t mMaxPackets {};
+      size_t mMaxPacketsPerSSRC {};
+      Seconds mMaxAge {};
+
+      RingMap mRings;
+      OrderQueue mOrder;
+
+      ULONGLONG mNextSerial {};
+      size_t mTotal {};
+
+      size_t mTotalOverwritten {};
     };
 
   }
@@ -34,6 +34,8 @@
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
 #include <ortc/internal/ortc_RTPTypes.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTCPPacket.h>
 
 #include <ortc/IICETransport.h>
 #include <ortc/IRTPReceiver.h>
@@ -49,6 +51,7 @@
 
 #define ORTC_SETTING_RTP_RECEIVER_MAX_RTP_PACKETS_IN_BUFFER "ortc/rtp-receiver/max-rtp-packets-in-buffer"
 #define ORTC_SETTING_RTP_RECEIVER_MAX_AGE_RTP_PACKETS_IN_SECONDS "ortc/rtp-receiver/max-age-rtp-packets-in-seconds"
+#define ORTC_SETTING_RTP_RECEIVER_MAX_RTP_PACKETS_PER_SSRC_IN_BUFFER "ortc/rtp-receiver/max-rtp-packets-per-ssrc-in-buffer"
 
 #define ORTC_SETTING_RTP_RECEIVER_CSRC_EXPIRY_TIME_IN_SECONDS "ortc/rtp-receiver/csrc-expiry-time-in-seconds"
 
@@ -56,6 +59,10 @@
 
 #define ORTC_SETTING_RTP_RECEIVER_LOCK_TO_RECEIVER_CHANNEL_AFTER_SWITCH_EXCLUSIVELY_FOR_IN_MILLISECONDS "ortc/rtp-receiver/lock-to-receiver-channel-after-switch-in-milliseconds"
 
+#define ORTC_SETTING_RTP_RECEIVER_DELIVER_TO_CHANNEL_WHILE_FORWARDING "ortc/rtp-receiver/deliver-to-channel-while-forwarding"
+
+#define ORTC_SETTING_RTP_RECEIVER_FORWARDED_RECEIVER_REPORT_INTERVAL_IN_MILLISECONDS "ortc/rtp-receiver/forwarded-receiver-report-interval-in-milliseconds"
+
 namespace ortc
 {
   namespace internal
@@ -63,6 +70,7 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForSettings)
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPListener)
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForMediaStreamTrack)
+    ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPSender)
 
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverChannelForRTPReceiver)
 
@@ -70,6 +78,7 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(IRTPListenerForRTPReceiver)
     ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPReceiverChannel)
     ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrackForRTPReceiver)
+    ZS_DECLARE_INTERACTION_PTR(IRTPSenderForRTPReceiver)
 
     ZS_DECLARE_INTERACTION_PROXY(IRTPReceiverAsyncDelegate)
 
@@ -115,6 +124,10 @@ namespace ortc
                                 IICETypes::Components viaTransport,
                                 RTCPPacketPtr packet
                                 ) = 0;
+
+      // NOTE: sends listener generated RTCP (e.g. transport-cc feedback)
+      //       over the receiver's RTCP transport (which need not be muxed)
+      virtual bool sendPacket(RTCPPacketPtr packet) = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -133,6 +146,8 @@ namespace ortc
 
       virtual PUID getID() const = 0;
 
+      virtual PUID getSecureTransportID() const = 0;
+
       virtual bool sendPacket(RTCPPacketPtr packet) = 0;
     };
 
@@ -153,6 +168,40 @@ namespace ortc
       virtual PUID getID() const = 0;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPReceiverForRTPSender
+    #pragma mark
+
+    interaction IRTPReceiverForRTPSender
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverForRTPSender, ForRTPSender)
+
+      ZS_DECLARE_TYPEDEF_PTR(IRTPSenderForRTPReceiver, UseForwarder)
+
+      static ElementPtr toDebug(ForRTPSenderPtr object);
+
+      virtual PUID getID() const = 0;
+
+      virtual IMediaStreamTrackTypes::Kinds getKind() const = 0;
+
+      // NOTE: RTP packets mapped to the receiver (optionally only those of
+      //       the specified rid) are handed to the forwarder synchronously
+      //       from the packet path (outside of the receiver's lock); packets
+      //       which were buffered until mapped are handed over
+      //       asynchronously (also outside of the receiver's lock).
+      virtual void registerForwarder(
+                                     UseForwarderPtr forwarder,
+                                     const char *rid
+                                     ) = 0;
+      virtual void unregisterForwarder(PUID forwarderID) = 0;
+
+      virtual bool sendPacket(RTCPPacketPtr packet) = 0;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -164,6 +213,8 @@ namespace ortc
     interaction IRTPReceiverAsyncDelegate
     {
       virtual ~IRTPReceiverAsyncDelegate() {}
+
+      virtual void onForwardBufferedPackets() = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -182,6 +233,7 @@ namespace ortc
                         public IRTPReceiverForRTPListener,
                         public IRTPReceiverForRTPReceiverChannel,
                         public IRTPReceiverForMediaStreamTrack,
+                        public IRTPReceiverForRTPSender,
                         public ISecureTransportDelegate,
                         public IWakeDelegate,
                         public zsLib::ITimerDelegate,
@@ -197,11 +249,13 @@ namespace ortc
       friend interaction IRTPReceiverForRTPListener;
       friend interaction IRTPReceiverForRTPReceiverChannel;
       friend interaction IRTPReceiverForMediaStreamTrack;
+      friend interaction IRTPReceiverForRTPSender;
 
       ZS_DECLARE_TYPEDEF_PTR(ISecureTransportForRTPReceiver, UseSecureTransport);
       ZS_DECLARE_TYPEDEF_PTR(IRTPListenerForRTPReceiver, UseListener);
       ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverChannelForRTPReceiver, UseChannel);
       ZS_DECLARE_TYPEDEF_PTR(IMediaStreamTrackForRTPReceiver, UseMediaStreamTrack);
+      ZS_DECLARE_TYPEDEF_PTR(IRTPSenderForRTPReceiver, UseForwarder);
       ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::PromiseWithStatsReport, PromiseWithStatsReport);
 
       ZS_DECLARE_STRUCT_PTR(RegisteredHeaderExtension);
@@ -235,8 +289,10 @@ namespace ortc
 
       ZS_DECLARE_PTR(RTCPPacketList)
 
-      typedef std::pair<Time, RTPPacketPtr> TimeRTPPacketPair;
-      typedef std::list<TimeRTPPacketPair> BufferedRTPPacketList;
+      typedef RTPPacketRingBuffer BufferedRTPPackets;
+      typedef BufferedRTPPackets::TimeRTPPacketPair TimeRTPPacketPair;
+      typedef BufferedRTPPackets::Entry BufferedRTPPacket;
+      typedef BufferedRTPPackets::EntryList BufferedRTPPacketList;
 
       typedef String RID;
       typedef PUID ChannelID;
@@ -250,6 +306,91 @@ namespace ortc
       typedef std::map<SSRCRoutingPair, SSRCInfoPtr> SSRCRoutingMap;
       typedef std::map<SSRCRoutingPair, SSRCInfoWeakPtr> SSRCRoutingWeakMap;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPReceiver::ForwarderInfo
+      #pragma mark
+
+      struct ForwarderInfo
+      {
+        UseForwarderWeakPtr mForwarder;
+        String mRID;                        // empty = forward every encoding
+
+        ElementPtr toDebug() const;
+      };
+
+      typedef PUID ForwarderID;
+      typedef std::map<ForwarderID, ForwarderInfo> ForwarderMap;
+      ZS_DECLARE_PTR(ForwarderMap)
+
+      typedef std::pair<RID, RTPPacketPtr> RIDRTPPacketPair;
+      typedef std::list<RIDRTPPacketPair> ForwardPacketList;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPReceiver::ForwardedReception
+      #pragma mark
+
+      // NOTE: reception statistics of a stream which is only forwarded (thus
+      //       never seen by a receiver channel) so receiver reports are
+      //       still sent to the source (see RFC3550 appendix A.1, A.3, A.8)
+      struct ForwardedReception
+      {
+        typedef RTCPPacket::SenderReceiverCommonReport::ReportBlock ReportBlock;
+
+        static const size_t kMaxReportPacketSize {1200};
+        static const WORD kMaxDropout {3000};
+        static const WORD kMaxMisorder {100};
+        static const ULONG kMinSequential {2};
+        static const DWORD kSequenceNumberMod {0x10000};
+
+        SSRCType mSSRC {};
+        ULONG mClockRate {};
+
+        WORD mMaxSequenceNumber {};
+        DWORD mCycles {};
+        DWORD mBaseSequenceNumber {};
+        DWORD mBadSequenceNumber {kSequenceNumberMod + 1};
+        ULONG mProbation {};                // packets in sequence still needed before the source is valid
+        DWORD mReceived {};
+        DWORD mExpectedPrior {};
+        DWORD mReceivedPrior {};
+
+        Time mFirstArrival;
+        DWORD mTransit {};
+        DWORD mJitter {};                   // scaled by 16 (see RFC3550 A.8)
+
+        DWORD mLSR {};                      // middle 32 bits of the last SR's NTP timestamp
+        Time mLastSenderReport;
+
+        Time mLastReceived;
+
+        void start(
+                   WORD sequenceNumber,
+                   const Time &tick
+                   );
+        void restart(
+                     WORD sequenceNumber,
+                     const Time &tick
+                     );
+        bool updateSequenceNumber(
+                                  WORD sequenceNumber,
+                                  const Time &tick
+                                  );
+        void received(
+                      const RTPPacket &packet,
+                      const Time &tick
+                      );
+        void report(
+                    ReportBlock &outBlock,
+                    const Time &tick
+                    );
+
+        ElementPtr toDebug() const;
+      };
+
+      typedef std::map<SSRCType, ForwardedReception> ForwardedReceptionMap;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiver::RegisteredHeaderExtension
@@ -425,6 +566,7 @@ namespace ortc
       static RTPReceiverPtr convert(ForRTPListenerPtr object);
       static RTPReceiverPtr convert(ForRTPReceiverChannelPtr object);
       static RTPReceiverPtr convert(ForMediaStreamTrackPtr object);
+      static RTPReceiverPtr convert(ForRTPSenderPtr object);
 
     protected:
       //-----------------------------------------------------------------------
@@ -489,6 +631,8 @@ namespace ortc
                                 RTCPPacketPtr packet
                                 ) override;
 
+      virtual bool sendPacket(RTCPPacketPtr packet) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiver => IRTPReceiverForRTPReceiverChannel
@@ -498,7 +642,9 @@ namespace ortc
 
       // (duplicate) virtual PUID getID() const = 0;
 
-      virtual bool sendPacket(RTCPPacketPtr packet) override;
+      virtual PUID getSecureTransportID() const override;
+
+      // (duplicate) virtual bool sendPacket(RTCPPacketPtr packet) override;
 
       //-----------------------------------------------------------------------
       #pragma mark
@@ -509,6 +655,25 @@ namespace ortc
 
       // (duplicate) virtual PUID getID() const = 0;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPReceiver => IRTPReceiverForRTPSender
+      #pragma mark
+
+      // (duplicate) static ElementPtr toDebug(ForRTPSenderPtr object);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual IMediaStreamTrackTypes::Kinds getKind() const override;
+
+      virtual void registerForwarder(
+                                     UseForwarderPtr forwarder,
+                                     const char *rid
+                                     ) override;
+      virtual void unregisterForwarder(PUID forwarderID) override;
+
+      // (duplicate) virtual bool sendPacket(RTCPPacketPtr packet) = 0;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiver => ISecureTransportDelegate
@@ -538,6 +703,8 @@ namespace ortc
       #pragma mark RTPReceiver => IRTPReceiverAsyncDelegate
       #pragma mark
 
+      virtual void onForwardBufferedPackets() override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPReceiver => (friend RTPReceiver::ChannelHolder)
@@ -580,6 +747,7 @@ namespace ortc
       void removeChannel(const ChannelInfo &channelInfo);
 
       void registerHeaderExtensions(const Parameters &params);
+      void rebuildHeaderExtensionLookup();
 
       SSRCInfoPtr setSSRCUsage(
                                SSRCType ssrc,
@@ -677,6 +845,11 @@ namespace ortc
       void processByes(const RTCPPacket &rtcpPacket);
       void processSenderReports(const RTCPPacket &rtcpPacket);
 
+      void targetRTCPDelivery(
+                              const RTCPPacket &rtcpPacket,
+                              ChannelWeakMapPtr &ioChannels
+                              );
+
       void extractCSRCs(const RTPPacket &rtpPacket);
       void setContributingSource(
                                  SSRCType csrc,
@@ -689,6 +862,23 @@ namespace ortc
                                         ChannelHolderPtr &channelHolder
                                         );
 
+      bool forwardPacket(
+                         const ForwarderMap &forwarders,
+                         ParametersPtr params,
+                         const String &rid,
+                         RTPPacketPtr packet,
+                         bool &outClean
+                         );
+      void cleanForwarders();
+      bool isForwarded(const String &rid) const;
+      void queueForwardPacket(
+                              const String &rid,
+                              RTPPacketPtr packet
+                              );
+
+      void recordForwardedReception(const RTPPacket &rtpPacket);
+      bool handleForwardedReceiverReportTimer(TimerPtr timer);
+
       void resetActiveReceiverChannel();
 
       Optional<RoutingPayloadType> decodeREDRoutingPayloadType(
@@ -769,19 +959,25 @@ namespace ortc
       ParametersToChannelInfoMap mChannelInfos;
 
       HeaderExtensionMap mRegisteredExtensions;
+      RTPHeaderExtensionLookup mHeaderExtensionLookup;
 
       SSRCRoutingMap mSSRCRoutingPayloadTable;
       SSRCRoutingWeakMap mRegisteredSSRCRoutingPayloads;
 
       RIDToChannelMap mRIDTable;
 
+      RTCPPacket::SSRCList mRTCPSenderSSRCs;       // scratch (avoids per packet allocation)
+      RTCPPacket::SSRCList mRTCPMediaSSRCs;        // scratch (avoids per packet allocation)
+
       TimerPtr mSSRCTableTimer;
       Seconds mSSRCTableExpires {};
 
       size_t mMaxBufferedRTPPackets {};
+      size_t mMaxBufferedRTPPacketsPerSSRC {};
       Seconds mMaxRTPPacketAge {};
 
-      BufferedRTPPacketList mBufferedRTPPackets;
+      BufferedRTPPackets mBufferedRTPPackets;
+      BufferedRTPPackets::SSRCList mBufferedSSRCs;  // scratch (avoids allocation during delivery attempts)
       bool mReattemptRTPDelivery {false};
 
       ContributingSourceMap mContributingSources;
@@ -793,6 +989,15 @@ namespace ortc
       Milliseconds mLockAfterSwitchTime {};
 
       Milliseconds mAmbigousPayloadMappingMinDifference {};
+
+      ForwarderMapPtr mForwarders;                 // COW pattern, always valid ptr
+      bool mDeliverToChannelWhileForwarding {};
+      ForwardPacketList mPendingForwardPackets;    // buffered packets forwarded outside of the lock
+
+      ForwardedReceptionMap mForwardedReceptions;
+      TimerPtr mForwardedReceiverReportTimer;
+      Milliseconds mForwardedReceiverReportInterval {};
+      SSRCType mForwardedReceiverReportSSRC {};    // used when the parameters do not specify an RTCP SSRC
     };
 
     //-------------------------------------------------------------------------
@@ -825,5 +1030,5 @@ namespace ortc
 }
 
 ZS_DECLARE_PROXY_BEGIN(ortc::internal::IRTPReceiverAsyncDelegate)
-//ZS_DECLARE_PROXY_METHOD_2(onDeliverPacket, UseChannelPtr, RTPPacketPtr)
+ZS_DECLARE_PROXY_METHOD_0(onForwardBufferedPackets)
 ZS_DECLARE_PROXY_END()
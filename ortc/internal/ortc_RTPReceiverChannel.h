@@ -190,6 +190,8 @@ namespace ortc
 
       virtual PUID getID() const = 0;
 
+      virtual PUID getSecureTransportID() const = 0;
+
       virtual bool sendPacket(RTCPPacketPtr packet) = 0;
     };
 
@@ -355,6 +357,8 @@ namespace ortc
 
       // (duplicate) virtual PUID getID() const = 0;
 
+      virtual PUID getSecureTransportID() const override;
+
       virtual bool sendPacket(RTCPPacketPtr packet) override;
 
       //-----------------------------------------------------------------------
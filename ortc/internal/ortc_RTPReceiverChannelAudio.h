@@ -434,6 +434,7 @@ namespace ortc
       String mLastErrorReason;
 
       UseChannelWeakPtr mReceiverChannel;
+      PUID mSecureTransportID {};
 
       ParametersPtr mParameters;
 
@@ -414,6 +414,7 @@ namespace ortc
       String mLastErrorReason;
 
       UseChannelWeakPtr mReceiverChannel;
+      PUID mSecureTransportID {};
 
       ParametersPtr mParameters;
 
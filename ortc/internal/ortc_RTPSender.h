@@ -33,6 +33,8 @@
 
 #include <ortc/internal/types.h>
 #include <ortc/internal/ortc_ISecureTransport.h>
+#include <ortc/internal/ortc_RTPPacket.h>
+#include <ortc/internal/ortc_RTPMediaEngine.h>
 
 #include <ortc/IRTPSender.h>
 #include <ortc/IDTLSTransport.h>
@@ -46,6 +48,9 @@
 
 //#define ORTC_SETTING_SCTP_TRANSPORT_MAX_MESSAGE_SIZE "ortc/sctp/max-message-size"
 
+#define ORTC_SETTING_RTP_SENDER_FORWARD_MIN_KEY_FRAME_REQUEST_INTERVAL_IN_MILLISECONDS "ortc/rtp-sender/forward-min-key-frame-request-interval-in-milliseconds"
+#define ORTC_SETTING_RTP_SENDER_FORWARDED_SENDER_REPORT_INTERVAL_IN_MILLISECONDS "ortc/rtp-sender/forwarded-sender-report-interval-in-milliseconds"
+
 namespace ortc
 {
   namespace internal
@@ -60,6 +65,8 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(IRTPListenerForRTPSender);
     ZS_DECLARE_INTERACTION_PTR(IRTPSenderChannelForRTPSender);
     ZS_DECLARE_INTERACTION_PTR(IMediaStreamTrackForRTPSender);
+    ZS_DECLARE_INTERACTION_PTR(IRTPReceiverForRTPSender);
+    ZS_DECLARE_INTERACTION_PTR(IRTPSenderForRTPReceiver);
 
     ZS_DECLARE_INTERACTION_PROXY(IRTPSenderAsyncDelegate)
 
@@ -120,6 +127,8 @@ namespace ortc
 
       virtual PUID getID() const = 0;
 
+      virtual PUID getSecureTransportID() const = 0;
+
       virtual bool sendPacket(RTPPacketPtr packet) = 0;
       virtual bool sendPacket(RTCPPacketPtr packet) = 0;
 
@@ -132,6 +141,35 @@ namespace ortc
       virtual void notifyDTMFSenderToneChanged(const char *tone) = 0;
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark IRTPSenderForRTPReceiver
+    #pragma mark
+
+    interaction IRTPSenderForRTPReceiver
+    {
+      ZS_DECLARE_TYPEDEF_PTR(IRTPSenderForRTPReceiver, ForRTPReceiver)
+
+      ZS_DECLARE_TYPEDEF_PTR(IRTPTypes::Parameters, Parameters)
+
+      static ElementPtr toDebug(ForRTPReceiverPtr object);
+
+      virtual PUID getID() const = 0;
+
+      // NOTE: called from the receiver's packet path (never while holding
+      //       the receiver's lock) with the receiver's current parameters
+      //       (which are never modified once set thus the pointer identifies
+      //       when they have changed).
+      virtual bool forwardPacket(
+                                 PUID receiverID,
+                                 ParametersPtr receiverParams,
+                                 RTPPacketPtr packet
+                                 ) = 0;
+    };
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -202,9 +240,12 @@ namespace ortc
                       public IRTPSenderForRTPSenderChannel,
                       public IRTPSenderForDTMFSender,
                       public IRTPSenderForMediaStreamTrack,
+                      public IRTPSenderForRTPReceiver,
                       public ISecureTransportDelegate,
                       public IWakeDelegate,
+                      public zsLib::ITimerDelegate,
                       public IDTMFSenderDelegate,
+                      public IRTPMediaEngineCongestionContextDelegate,
                       public IRTPSenderAsyncDelegate
     {
     protected:
@@ -218,11 +259,14 @@ namespace ortc
       friend interaction IRTPSenderForRTPSenderChannel;
       friend interaction IRTPSenderForDTMFSender;
       friend interaction IRTPSenderForMediaStreamTrack;
+      friend interaction IRTPSenderForRTPReceiver;
 
       ZS_DECLARE_TYPEDEF_PTR(ISecureTransportForRTPSender, UseSecureTransport);
       ZS_DECLARE_TYPEDEF_PTR(IRTPListenerForRTPSender, UseListener);
       ZS_DECLARE_TYPEDEF_PTR(IRTPSenderChannelForRTPSender, UseChannel);
       ZS_DECLARE_TYPEDEF_PTR(IMediaStreamTrackForRTPSender, UseMediaStreamTrack);
+      ZS_DECLARE_TYPEDEF_PTR(IRTPReceiverForRTPSender, UseForwardingSource);
+      ZS_DECLARE_TYPEDEF_PTR(IRTPMediaEngineForRTPSender, UseMediaEngine);
 
       ZS_DECLARE_TYPEDEF_PTR(IStatsProviderTypes::PromiseWithStatsReport, PromiseWithStatsReport);
 
@@ -238,6 +282,143 @@ namespace ortc
 
       typedef std::list<IRTPTypes::SSRCType> SSRCList;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender::ForwardedCodec
+      #pragma mark
+
+      struct ForwardedCodec
+      {
+        PayloadType mPayloadType {};        // payload type as sent
+        IRTPTypes::SupportedCodecs mCodec {IRTPTypes::SupportedCodec_Unknown};
+        ULONG mClockRate {};
+
+        // rtx only: when the sender has no rtx the original packet is
+        // restored (using the sender's payload type of the original codec)
+        bool mDecapsulateRTX {};
+        PayloadType mOriginalPayloadType {};
+
+        ElementPtr toDebug() const;
+      };
+
+      typedef std::map<PayloadType, ForwardedCodec> ForwardedCodecMap;  // received payload type -> sent codec
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender::Forwarding
+      #pragma mark
+
+      struct Forwarding
+      {
+        static const size_t kMaxFeedbackPacketSize {1200};
+        static const size_t kMaxCSRCs {0xF};
+
+        UseForwardingSourcePtr mSource;
+        String mRID;                        // receiver encoding forwarded (empty = all)
+
+        // tables are rebuilt whenever either side's parameters are replaced
+        ParametersPtr mSourceParameters;
+        ParametersPtr mSenderParameters;
+        bool mValid {};
+
+        ForwardedCodecMap mCodecs;
+        RTPHeaderExtensionLookup mSourceHeaderExtensions;
+        RTPHeaderExtensionLookup mSenderHeaderExtensions;
+
+        IRTPTypes::SSRCType mSSRC {};
+        Optional<IRTPTypes::SSRCType> mRTXSSRC;
+        String mMuxID;
+        String mEncodingID;
+        IRTPTypes::SSRCType mFeedbackSSRC {};
+
+        // rewriting state (re-based whenever the source's media SSRC changes
+        // so the sent stream remains continuous)
+        Optional<IRTPTypes::SSRCType> mSourceSSRC;
+        WORD mSequenceNumberDelta {};
+        DWORD mTimestampDelta {};
+        bool mSent {};
+        WORD mLastSequenceNumber {};
+        DWORD mLastTimestamp {};
+        Time mLastSent;
+        ULONG mLastClockRate {};
+        WORD mRTXSequenceNumber {};
+
+        // sender report state (counts restart whenever the sent SSRC changes)
+        DWORD mPacketCount {};
+        DWORD mOctetCount {};               // payload octets only
+        DWORD mRTXPacketCount {};
+        DWORD mRTXOctetCount {};
+
+        // rewriting state of the source forwarded before the latest re-base
+        // (NACKs for packets sent before the switch are mapped back to it)
+        UseForwardingSourceWeakPtr mPreviousSource;
+        Optional<IRTPTypes::SSRCType> mPreviousSourceSSRC;
+        WORD mPreviousSequenceNumberDelta {};
+        WORD mSwitchSequenceNumber {};      // first sequence number sent from the current source
+
+        BYTE mFIRSequenceNumber {};
+        Time mLastKeyFrameRequest;
+        bool mKeyFrameRequestPending {};    // source ssrc changed (video only)
+
+        size_t mTotalForwarded {};
+        size_t mTotalDropped {};
+        size_t mTotalFeedbackForwarded {};
+
+        ElementPtr toDebug() const;
+      };
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender::ForwardedPacket
+      #pragma mark
+
+      struct ForwardedPacket
+      {
+        RTPPacketPtr mPacket;
+        Time mQueued;
+
+        // header extension IDs stamped as the packet leaves the pacer (0 = not sent)
+        RTPMediaEngineCongestionContextPtr mCongestionContext;
+        BYTE mTransportSequenceNumberID {};
+        BYTE mAbsoluteSendTimeID {};
+        WORD mTransportSequenceNumber {};
+      };
+
+      typedef std::list<ForwardedPacket> ForwardedPacketList;
+
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender::ForwardedPacing
+      #pragma mark
+
+      struct ForwardedPacing
+      {
+        static const size_t kIntervalInMilliseconds {5};
+        static const size_t kBudgetWindowInMilliseconds {500};
+        static const size_t kMaxQueueDelayInMilliseconds {2000};
+
+        RTPMediaEngineCongestionContextPtr mCongestionContext;
+        PUID mSecureTransportID {};
+
+        int mMinBitrateBps {};
+        int mStartBitrateBps {};
+        int mMaxBitrateBps {};
+
+        // this sender's share of the transport's estimate (set from the
+        // media engine's module process thread; 0 = not paced)
+        std::atomic<uint32_t> mTargetBitrateBps {};
+
+        ForwardedPacketList mQueue;
+        size_t mQueueSizeInBytes {};
+        LONGLONG mBudgetInBytes {};
+        Time mLastBudgetUpdate;
+        TimerPtr mTimer;
+
+        size_t mTotalPaced {};
+
+        ElementPtr toDebug() const;
+      };
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender::ChannelHolder
@@ -318,6 +499,7 @@ namespace ortc
       static RTPSenderPtr convert(ForRTPSenderChannelPtr object);
       static RTPSenderPtr convert(ForDTMFSenderPtr object);
       static RTPSenderPtr convert(ForMediaStreamTrackPtr object);
+      static RTPSenderPtr convert(ForRTPReceiverPtr object);
 
     protected:
       //-----------------------------------------------------------------------
@@ -360,6 +542,11 @@ namespace ortc
       virtual PromisePtr send(const Parameters &parameters) override;
       virtual void stop() override;
 
+      virtual PromisePtr setForwardingSource(
+                                             IRTPReceiverPtr receiver,
+                                             const char *rid
+                                             ) override;
+
 
       //-----------------------------------------------------------------------
       #pragma mark
@@ -384,6 +571,8 @@ namespace ortc
 
       // (duplicate) virtual PUID getID() const = 0;
 
+      virtual PUID getSecureTransportID() const override;
+
       virtual bool sendPacket(RTPPacketPtr packet) override;
       virtual bool sendPacket(RTCPPacketPtr packet) override;
 
@@ -404,6 +593,21 @@ namespace ortc
 
       // (duplicate) virtual PUID getID() const = 0;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender => IRTPSenderForRTPReceiver
+      #pragma mark
+
+      // (duplciate) static ElementPtr toDebug(ForRTPReceiverPtr object);
+
+      // (duplicate) virtual PUID getID() const = 0;
+
+      virtual bool forwardPacket(
+                                 PUID receiverID,
+                                 ParametersPtr receiverParams,
+                                 RTPPacketPtr packet
+                                 ) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender => IRTPSenderForDTMFSender
@@ -449,6 +653,13 @@ namespace ortc
 
       virtual void onWake() override;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender => ITimerDelegate
+      #pragma mark
+
+      virtual void onTimer(TimerPtr timer) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender => IDTMFSenderDelegate
@@ -459,6 +670,14 @@ namespace ortc
                                            String tone
                                            ) override;
 
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark RTPSender => IRTPMediaEngineCongestionContextDelegate
+      #pragma mark
+
+      virtual void notifyTargetBitrate(uint32_t targetBitrateBps) override;
+      virtual int getPaddingNeededBps() override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark RTPSender => IRTPSenderAsyncDelegate
@@ -504,6 +723,35 @@ namespace ortc
 
       ChannelHolderPtr getDTMFChannelHolder() const;
 
+      void switchForwardingSource(
+                                  UseForwardingSourcePtr source,
+                                  const String &rid
+                                  );
+      bool prepareForwarding(ParametersPtr sourceParams);
+      void keepPreviousForwarding();
+      void rebaseForwarding(
+                            const RTPPacket &packet,
+                            ULONG clockRate
+                            );
+      bool rewriteForwardedPacket(
+                                  const RTPPacket &packet,
+                                  ForwardedPacket &outPacket
+                                  );
+      bool rewriteForwardedREDPayloadTypes(
+                                           BYTE *payload,
+                                           size_t payloadSizeInBytes
+                                           ) const;
+      void forwardFeedback(const RTCPPacket &packet);
+      bool handleForwardedSenderReportTimer(TimerPtr timer);
+
+      void acquireForwardedCongestionContext();
+      void releaseForwardedCongestionContext();
+      void updateForwardedBitrates();
+      void paceForwardedPackets(ForwardedPacketList &outPackets);
+      void stampForwardedPacket(ForwardedPacket &packet);
+      void sendForwardedPackets(ForwardedPacketList &packets);
+      bool handleForwardedPacingTimer(TimerPtr timer);
+
     protected:
       //-----------------------------------------------------------------------
       #pragma mark
@@ -546,6 +794,14 @@ namespace ortc
       ParametersToChannelHolderMapPtr mChannels;  // using COW pattern
 
       SSRCList mConflicts;
+
+      Forwarding mForwarding;
+      Milliseconds mForwardMinKeyFrameRequestInterval {};
+
+      TimerPtr mForwardedSenderReportTimer;
+      Milliseconds mForwardedSenderReportInterval {};
+
+      ForwardedPacing mForwardedPacing;
     };
 
     //-------------------------------------------------------------------------
@@ -50,6 +50,10 @@
 #define ORTC_SETTING_RTP_SENDER_CHANNEL_RETAG_RTP_PACKETS_AFTER_SSRC_NOT_SENT_IN_SECONDS "ortc/rtp-sender-channel/retag-rtp-packets-after-ssrc-not-sent-in-seconds"
 #define ORTC_SETTING_RTP_SENDER_CHANNEL_TAG_MID_RID_IN_RTCP_SDES "ortc/rtp-sender-channel/tag-mid-rid-in-rtcp-sdes"
 
+// capacity reserved beyond each outgoing RTP packet so MID/RID header
+// extensions can be tagged in place
+#define ORTC_RTP_SENDER_CHANNEL_TAGGING_HEADROOM_IN_BYTES (64)
+
 namespace ortc
 {
   namespace internal
@@ -152,6 +156,8 @@ namespace ortc
 
       virtual PUID getID() const = 0;
 
+      virtual PUID getSecureTransportID() const = 0;
+
       virtual bool sendPacket(RTPPacketPtr packet) = 0;
 
       virtual bool sendPacket(RTCPPacketPtr packet) = 0;
@@ -382,6 +388,8 @@ namespace ortc
 
       // (duplicate) virtual PUID getID() const = 0;
 
+      virtual PUID getSecureTransportID() const override;
+
       virtual bool sendPacket(RTPPacketPtr packet) override;
 
       virtual bool sendPacket(RTCPPacketPtr packet) override;
@@ -39,6 +39,8 @@ namespace ortc
 {
   namespace internal
   {
+    ZS_DECLARE_CLASS_PTR(RTPBufferPool)
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -84,5 +86,122 @@ namespace ortc
       static Log::Params slog(const char *message);
     };
 
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark RTPBufferPool
+    #pragma mark
+
+    // Recycles fixed capacity packet buffers so the per packet media paths
+    // do not allocate (and wipe on free) a fresh SecureByteBlock for every
+    // packet. Buffers handed out are ordinary SecureByteBlockPtr objects
+    // which return themselves to the pool when the last reference is
+    // released (thus they can be given to RTPPacket / RTCPPacket directly).
+    class RTPBufferPool
+    {
+    protected:
+      struct make_private {};
+
+      class PooledBuffer;
+      struct PooledBufferReleaser;
+
+      typedef std::list<PooledBuffer *> PooledBufferList;
+
+    public:
+      RTPBufferPool(
+                    const make_private &,
+                    size_t bufferCapacityInBytes,
+                    size_t maxPooledBuffers
+                    );
+      ~RTPBufferPool();
+
+      static RTPBufferPoolPtr create(
+                                     size_t bufferCapacityInBytes,
+                                     size_t maxPooledBuffers
+                                     );
+
+      size_t bufferCapacity() const {return mBufferCapacity;}
+
+      // NOTE: buffers larger than the pool's capacity are still returned
+      //       but are freed rather than recycled upon release.
+      SecureByteBlockPtr obtain(size_t sizeInBytes);
+
+      // NOTE: only legal for buffers returned from obtain(); changes the
+      //       reported size of the buffer (shrinking or growing up to the
+      //       capacity of the original allocation) without reallocating.
+      //       Debug builds assert the buffer was obtained from a pool.
+      static void resize(
+                         const SecureByteBlockPtr &buffer,
+                         size_t sizeInBytes
+                         );
+
+      ElementPtr toDebug() const;
+
+    protected:
+      void release(PooledBuffer *buffer);
+
+    protected:
+      RTPBufferPoolWeakPtr mThisWeak;
+
+      mutable Lock mLock;
+
+      size_t mBufferCapacity {};
+      size_t mMaxPooledBuffers {};
+
+      PooledBufferList mFreeBuffers;
+      size_t mTotalAllocated {};   // buffers ever created (pool misses)
+    };
+
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    //-------------------------------------------------------------------------
+    #pragma mark
+    #pragma mark AlignedAllocator
+    #pragma mark
+
+    // Before C++17 operator new (and thus make_shared) only honours
+    // alignments up to that of std::max_align_t. Objects holding over-aligned
+    // members (e.g. alignas(64) cache line separated atomics) are created
+    // with allocate_shared using this allocator instead.
+    template <typename T>
+    class AlignedAllocator
+    {
+    public:
+      typedef T value_type;
+
+      AlignedAllocator() {}
+      template <typename U> AlignedAllocator(const AlignedAllocator<U> &) {}
+
+      T *allocate(size_t count)
+      {
+        const size_t alignment = (alignof(T) > alignof(void *) ? alignof(T) : alignof(void *));
+
+        // NOTE: the original allocation is remembered just before the
+        //       aligned pointer handed out
+        void *original = ::operator new((count * sizeof(T)) + alignment + sizeof(void *));
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(original) + sizeof(void *);
+        uintptr_t aligned = (start + (alignment - 1)) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+        reinterpret_cast<void **>(aligned)[-1] = original;
+        return reinterpret_cast<T *>(aligned);
+      }
+
+      void deallocate(
+                      T *pointer,
+                      size_t count
+                      )
+      {
+        if (!pointer) return;
+        ::operator delete(reinterpret_cast<void **>(pointer)[-1]);
+      }
+
+      template <typename U> bool operator==(const AlignedAllocator<U> &) const {return true;}
+      template <typename U> bool operator!=(const AlignedAllocator<U> &) const {return false;}
+    };
+
   }
 }
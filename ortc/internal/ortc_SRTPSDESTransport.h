@@ -215,6 +215,14 @@ namespace ortc
                               size_t bufferLengthInBytes
                               ) override;
 
+      virtual bool sendPackets(
+                               IICETypes::Components sendOverICETransport,
+                               IICETypes::Components packetType,
+                               const PacketBufferList &packets
+                               ) override;
+
+      virtual void flushPackets(IICETypes::Components sendOverICETransport) override;
+
       virtual IICETransportPtr getICETransport() const override;
 
       //-----------------------------------------------------------------------
@@ -278,11 +286,16 @@ namespace ortc
                                        size_t bufferLengthInBytes
                                        ) override;
 
+      virtual bool sendEncryptedPackets(
+                                        IICETypes::Components sendOverICETransport,
+                                        IICETypes::Components packetType,
+                                        const PacketBufferList &packets
+                                        ) override;
+
       virtual bool handleReceivedDecryptedPacket(
                                                  IICETypes::Components viaTransport,
                                                  IICETypes::Components packetType,
-                                                 const BYTE *buffer,
-                                                 size_t bufferLengthInBytes
+                                                 SecureByteBlockPtr decryptedBuffer
                                                  ) override;
 
       //-----------------------------------------------------------------------
@@ -46,6 +46,9 @@ struct srtp_ctx_t;
 struct srtp_policy_t;
 
 //#define ORTC_SETTING_SRTP_TRANSPORT_WARN_OF_KEY_LIFETIME_EXHAUGSTION_WHEN_REACH_PERCENTAGE_USSED "ortc/srtp/warm-key-lifetime-exhaustion-when-reach-percentage-used"
+#define ORTC_SETTING_SRTP_TRANSPORT_PACKET_BUFFER_CAPACITY_IN_BYTES "ortc/srtp/packet-buffer-capacity-in-bytes"
+#define ORTC_SETTING_SRTP_TRANSPORT_MAX_POOLED_DECRYPT_BUFFERS "ortc/srtp/max-pooled-decrypt-buffers"
+#define ORTC_SETTING_SRTP_TRANSPORT_MAX_POOLED_ENCRYPT_BUFFERS "ortc/srtp/max-pooled-encrypt-buffers"
 
 #pragma warning(push)
 #pragma warning(disable:4351)
@@ -55,6 +58,7 @@ namespace ortc
   namespace internal
   {
     ZS_DECLARE_CLASS_PTR(SRTPInit)
+    ZS_DECLARE_CLASS_PTR(RTPBufferPool)
 
     ZS_DECLARE_INTERACTION_PTR(ISecureTransportForSRTPTransport)
 
@@ -122,6 +126,12 @@ namespace ortc
                               const BYTE *buffer,
                               size_t bufferLengthInBytes
                               ) = 0;
+
+      virtual bool sendPackets(
+                               IICETypes::Components sendOverICETransport,
+                               IICETypes::Components component,
+                               const PacketBufferList &packets
+                               ) = 0;
     };
 
     //-------------------------------------------------------------------------
@@ -243,6 +253,12 @@ namespace ortc
                               size_t bufferLengthInBytes
                               ) override;
 
+      virtual bool sendPackets(
+                               IICETypes::Components sendOverICETransport,
+                               IICETypes::Components component,
+                               const PacketBufferList &packets
+                               ) override;
+
       //-----------------------------------------------------------------------
       #pragma mark
       #pragma mark SRTPTransport => IWakeDelegate
@@ -281,6 +297,12 @@ namespace ortc
                               IICETypes::Components component,
                               KeyingMaterialPtr &keyingMaterial
                               );
+      void releaseTotalPackets(
+                               Directions direction,
+                               IICETypes::Components component,
+                               KeyingMaterialPtr &keyingMaterial,
+                               size_t totalUnused
+                               );
 
       static size_t parseLifetime(const String &lifetime) throw(InvalidParameters);
 
@@ -367,6 +389,9 @@ namespace ortc
       DirectionMaterial mMaterial[Direction_Last+1];
 
       SRTPInitPtr mSRTPInit;
+
+      RTPBufferPoolPtr mDecryptBufferPool;  // thread safe (used outside of lock)
+      RTPBufferPoolPtr mEncryptBufferPool;  // thread safe (used outside of lock)
     };
 
     //-------------------------------------------------------------------------
@@ -427,6 +427,7 @@
 #define EventWriteOrtcRtpSenderInternalChannelErrorEventFired(xStr_Method, xPUID, xPUID_ChannelObjectID, xWORD_Error, xStr_Reason, xBool_SelfDestructChannel)
 #define EventWriteOrtcRtpSenderInternalSecureTransportStateChangedEventFired(xStr_Method, xPUID, xPUID_SecureTransportObjectID, xStr_State)
 #define EventWriteOrtcRtpSenderInternalWakeEventFired(xStr_Method, xPUID)
+#define EventWriteOrtcRtpSenderInternalTimerEventFired(xStr_Method, xPUID, xPUID_TimerObjectID)
 #define EventWriteOrtcRtpSenderInternalDestroyChannelEventFired(xStr_Method, xPUID, xPUID_ChannelObjectID)
 #define EventWriteOrtcRtpSenderInternalChannelGoneEventFired(xStr_Method, xPUID)
 
@@ -900,6 +901,7 @@ inline void EventWriteOrtcRtpSenderSsrcConflictEventFired(const char *xStr_Metho
 inline void EventWriteOrtcRtpSenderInternalChannelErrorEventFired(const char *xStr_Method, PUID xPUID, PUID xPUID_ChannelObjectID, WORD xWORD_Error, const char *xStr_Reason, bool xBool_SelfDestructChannel) {}
 inline void EventWriteOrtcRtpSenderInternalSecureTransportStateChangedEventFired(const char *xStr_Method, PUID xPUID, PUID xPUID_SecureTransportObjectID, const char *xStr_State) {}
 inline void EventWriteOrtcRtpSenderInternalWakeEventFired(const char *xStr_Method, PUID xPUID) {}
+inline void EventWriteOrtcRtpSenderInternalTimerEventFired(const char *xStr_Method, PUID xPUID, PUID xPUID_TimerObjectID) {}
 inline void EventWriteOrtcRtpSenderInternalDestroyChannelEventFired(const char *xStr_Method, PUID xPUID, PUID xPUID_ChannelObjectID) {}
 inline void EventWriteOrtcRtpSenderInternalChannelGoneEventFired(const char *xStr_Method, PUID xPUID) {}
 
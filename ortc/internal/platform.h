@@ -42,6 +42,11 @@
 #undef HAVE_SPRINTF_S
 #undef HAVE_GETADAPTERADDRESSES
 #undef HAVE_GETIFADDRS
+#undef HAVE_RECVMMSG
+#undef HAVE_SENDMMSG
+#undef HAVE_SO_REUSEPORT
+#undef HAVE_PTHREAD_SETAFFINITY_NP
+#undef HAVE_SETTHREADAFFINITYMASK
 
 
 #ifdef _WIN32
@@ -58,6 +63,7 @@
 #define HAVE_GMTIME_S 1
 #define HAVE_SPRINTF_S 1
 #define HAVE_GETADAPTERADDRESSES 1
+#define HAVE_SETTHREADAFFINITYMASK 1
 
 #ifdef WINRT
 
@@ -65,6 +71,7 @@
 
 // WINRT does not support these features (but WIN32 does)
 #undef HAVE_GETADAPTERADDRESSES
+#undef HAVE_SETTHREADAFFINITYMASK
 
 #if defined(WINAPI_FAMILY) && WINAPI_FAMILY == WINAPI_FAMILY_PHONE_APP
 
@@ -116,6 +123,10 @@
 #define HAVE_NET_IF_H 1
 #define HAVE_NETINIT6_IN6_VAR_H 1
 #define HAVE_GETIFADDRS 1
+#define HAVE_RECVMMSG 1
+#define HAVE_SENDMMSG 1
+#define HAVE_SO_REUSEPORT 1
+#define HAVE_PTHREAD_SETAFFINITY_NP 1
 
 #ifdef _ANDROID
 
@@ -123,6 +134,9 @@
 
 // Android does not support these features
 #undef HAVE_IFADDRS_H
+#undef HAVE_RECVMMSG
+#undef HAVE_SENDMMSG
+#undef HAVE_PTHREAD_SETAFFINITY_NP
 
 #endif //_ANDROID
 #endif //_LINUX
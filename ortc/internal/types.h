@@ -42,6 +42,7 @@ namespace ortc
   namespace internal
   {
     using std::make_shared;
+    using std::allocate_shared;
 
     using zsLib::UINT;
     using zsLib::PTRNUMBER;
@@ -95,6 +96,8 @@ namespace ortc
 
     using openpeer::services::IFactory;
 
+    typedef std::vector<SecureByteBlockPtr> PacketBufferList;
+
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
     //-------------------------------------------------------------------------
@@ -104,7 +107,10 @@ namespace ortc
     #pragma mark
 
     ZS_DECLARE_CLASS_PTR(RTPPacket)
+    ZS_DECLARE_CLASS_PTR(RTPPacketView)
     ZS_DECLARE_CLASS_PTR(RTCPPacket)
+    ZS_DECLARE_CLASS_PTR(RTCPPacketWriter)
+    ZS_DECLARE_INTERACTION_PTR(IRTCPPacketWriterDelegate)
 
     ZS_DECLARE_INTERACTION_PTR(IDataTransportForSecureTransport)
     ZS_DECLARE_INTERACTION_PTR(ISecureTransport)
@@ -115,6 +121,7 @@ namespace ortc
     ZS_DECLARE_INTERACTION_PTR(ISRTPTransport)
 
     ZS_DECLARE_CLASS_PTR(ORTC)
+    ZS_DECLARE_STRUCT_PTR(ORTCPacketQueue)
     ZS_DECLARE_CLASS_PTR(Settings)
     ZS_DECLARE_CLASS_PTR(Certificate)
     ZS_DECLARE_CLASS_PTR(DataChannel)
@@ -298,6 +298,7 @@ namespace ortc
         typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBRCommon TMMBRCommon;
         typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBR TMMBR;
         typedef RTCPPacket::TransportLayerFeedbackMessage::TMMBN TMMBN;
+        typedef RTCPPacket::TransportLayerFeedbackMessage::TransportCC TransportCC;
 
         typedef RTCPPacket::PayloadSpecificFeedbackMessage::PLI PLI;
         typedef RTCPPacket::PayloadSpecificFeedbackMessage::SLI SLI;
@@ -555,6 +556,14 @@ namespace ortc
             delete [] report->mFirstTMMBN;
             report->mFirstTMMBN = NULL;
           }
+          if (NULL != report->mTransportCC.mPacketStatuses) {
+            delete [] report->mTransportCC.mPacketStatuses;
+            report->mTransportCC.mPacketStatuses = NULL;
+          }
+          if (NULL != report->mTransportCC.mRecvDeltas) {
+            delete [] report->mTransportCC.mRecvDeltas;
+            report->mTransportCC.mRecvDeltas = NULL;
+          }
           if (NULL != report->mFCI) {
             delete [] report->mFCI;
             report->mFCI = NULL;
@@ -1345,6 +1354,29 @@ namespace ortc
               }
               break;
             }
+            case TransportCC::kFmt: {
+              auto transportCC1 = report1->transportCC();
+              auto transportCC2 = report2->transportCC();
+
+              TESTING_CHECK(NULL != transportCC1)
+              TESTING_CHECK(NULL != transportCC2)
+              TESTING_CHECK(NULL == report1->mUnknown)
+              TESTING_CHECK(NULL == report2->mUnknown)
+
+              TESTING_EQUAL(transportCC1->baseSequenceNumber(), transportCC2->baseSequenceNumber())
+              TESTING_EQUAL(transportCC1->packetStatusCount(), transportCC2->packetStatusCount())
+              TESTING_EQUAL(transportCC1->referenceTime(), transportCC2->referenceTime())
+              TESTING_EQUAL(transportCC1->fbPktCount(), transportCC2->fbPktCount())
+              TESTING_EQUAL(transportCC1->recvDeltaCount(), transportCC2->recvDeltaCount())
+
+              for (size_t index = 0; index < transportCC1->packetStatusCount(); ++index) {
+                TESTING_EQUAL(transportCC1->packetStatusAtIndex(index), transportCC2->packetStatusAtIndex(index))
+              }
+              for (size_t index = 0; index < transportCC1->recvDeltaCount(); ++index) {
+                TESTING_EQUAL(transportCC1->recvDeltaAtIndex(index), transportCC2->recvDeltaAtIndex(index))
+              }
+              break;
+            }
             default:
             {
               TESTING_CHECK(NULL != report1->mUnknown)
@@ -2647,14 +2679,17 @@ namespace ortc
           result->mSSRCOfPacketSender = randomDWORD();
           result->mSSRCOfMediaSource = randomDWORD();
 
-          switch (randomSize(3)) {
+          switch (randomSize(4)) {
             case 0: result->mReportSpecific = GenericNACK::kFmt; break;
             case 1: result->mReportSpecific = TMMBR::kFmt; break;
             case 2: result->mReportSpecific = TMMBN::kFmt; break;
             case 3: {
-              result->mReportSpecific = static_cast<decltype(result->mReportSpecific)>(randomSize(TMMBN::kFmt+1, 0x1F));
+              do {
+                result->mReportSpecific = static_cast<decltype(result->mReportSpecific)>(randomSize(TMMBN::kFmt+1, 0x1F));
+              } while (TransportCC::kFmt == result->mReportSpecific);
               break;
             }
+            case 4: result->mReportSpecific = TransportCC::kFmt; break;
             default:
             {
               TESTING_CHECK(false)
@@ -2703,6 +2738,35 @@ namespace ortc
               }
               break;
             }
+            case TransportCC::kFmt:  {
+              result->mHasTransportCC = true;
+
+              auto &transportCC = result->mTransportCC;
+              transportCC.mBaseSequenceNumber = randomWORD();
+              transportCC.mPacketStatusCount = static_cast<WORD>(randomSize(0, 100));
+              transportCC.mReferenceTime = static_cast<LONG>(randomDWORD(24)) - static_cast<LONG>(0x800000);
+              transportCC.mFBPktCount = randomBYTE();
+
+              size_t count = transportCC.packetStatusCount();
+              if (0 == count) break;
+
+              transportCC.mPacketStatuses = new BYTE[count];
+              transportCC.mRecvDeltas = new LONG[count];
+
+              BYTE symbol = static_cast<BYTE>(randomSize(TransportCC::PacketStatusSymbol_Last));
+              for (size_t index = 0; index < count; ++index) {
+                if (shouldPerform(30)) symbol = static_cast<BYTE>(randomSize(TransportCC::PacketStatusSymbol_Last));  // runs of symbols exercise run length chunks
+
+                transportCC.mPacketStatuses[index] = symbol;
+
+                switch (symbol) {
+                  case TransportCC::PacketStatusSymbol_ReceivedSmallDelta:            transportCC.mRecvDeltas[transportCC.mRecvDeltaCount] = static_cast<LONG>(randomSize(0xFF)); ++transportCC.mRecvDeltaCount; break;
+                  case TransportCC::PacketStatusSymbol_ReceivedLargeOrNegativeDelta:  transportCC.mRecvDeltas[transportCC.mRecvDeltaCount] = static_cast<LONG>(randomSize(0xFFFF)) - static_cast<LONG>(0x8000); ++transportCC.mRecvDeltaCount; break;
+                  default:                                                            break;
+                }
+              }
+              break;
+            }
             default: {
               result->mUnknown = result;
               if (shouldPerform(90)) {
@@ -3418,6 +3482,35 @@ namespace ortc
 
           checkSanity(*mPacket);
           compare(mPacket->first(), mGeneratedFirst);
+
+          compareFastParse();
+        }
+
+        //---------------------------------------------------------------------
+        void compareFastParse()
+        {
+          TESTING_CHECK((bool)mPacket)
+
+          RTCPPacketPtr fastPacket = RTCPPacket::create(UseServicesHelper::convertToBuffer(mPacket->ptr(), mPacket->size()), RTCPPacket::ParseMode_Fast);
+          TESTING_CHECK((bool)fastPacket)
+
+          TESTING_EQUAL(mPacket->senderReportCount(), fastPacket->senderReportCount())
+          TESTING_EQUAL(mPacket->receiverReportCount(), fastPacket->receiverReportCount())
+          TESTING_EQUAL(mPacket->sdesCount(), fastPacket->sdesCount())
+          TESTING_EQUAL(mPacket->byeCount(), fastPacket->byeCount())
+
+          TESTING_EQUAL(0, fastPacket->appCount())
+          TESTING_EQUAL(0, fastPacket->transportLayerFeedbackMessageCount())
+          TESTING_EQUAL(0, fastPacket->payloadSpecificFeedbackMessage())
+          TESTING_EQUAL(0, fastPacket->xrCount())
+          TESTING_EQUAL(0, fastPacket->unknownReportCount())
+
+          for (size_t index = 0; index < mPacket->senderReportCount(); ++index) {
+            compareSenderReport(mPacket->senderReportAtIndex(index), fastPacket->senderReportAtIndex(index));
+          }
+          for (size_t index = 0; index < mPacket->byeCount(); ++index) {
+            compareBye(mPacket->byeAtIndex(index), fastPacket->byeAtIndex(index));
+          }
         }
 
         //---------------------------------------------------------------------
@@ -3436,6 +3529,186 @@ namespace ortc
         RTCPPacketPtr mPacket;
       };
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark WriterTester
+      #pragma mark
+
+      class WriterTester : public ortc::internal::IRTCPPacketWriterDelegate
+      {
+      public:
+        typedef ortc::internal::RTCPPacketWriter RTCPPacketWriter;
+        typedef std::list<RTCPPacketPtr> PacketList;
+
+        //---------------------------------------------------------------------
+        virtual void onRTCPPacketWriterPacket(
+                                              const BYTE *packet,
+                                              size_t packetSizeInBytes
+                                              )
+        {
+          TESTING_CHECK(packetSizeInBytes <= sizeof(mBuffer))
+          TESTING_CHECK(0 == (packetSizeInBytes % sizeof(DWORD)))
+
+          RTCPPacketPtr result = RTCPPacket::create(packet, packetSizeInBytes);
+          TESTING_CHECK((bool)result)
+          mPackets.push_back(result);
+        }
+
+        //---------------------------------------------------------------------
+        void test()
+        {
+          typedef RTCPPacket::SenderReceiverCommonReport::ReportBlock ReportBlock;
+          typedef RTCPPacket::TransportLayerFeedbackMessage::GenericNACK GenericNACK;
+          typedef RTCPPacket::PayloadSpecificFeedbackMessage::REMB REMB;
+          typedef RTCPPacket::XR::DLRRReportBlock::SubBlock DLRRSubBlock;
+
+          ReportBlock blocks[2] {};
+          blocks[0].mSSRC = 0x1111;
+          blocks[0].mFractionLost = 7;
+          blocks[0].mCumulativeNumberOfPacketsLost = 0x123456;
+          blocks[1].mSSRC = 0x2222;
+          blocks[1].mDLSR = 99;
+
+          GenericNACK nacks[60] {};
+          for (size_t index = 0; index < 60; ++index) {
+            nacks[index].mPID = static_cast<WORD>(index * 17);
+            nacks[index].mBLP = static_cast<WORD>(index);
+          }
+
+          DWORD rembSSRCs[2] = {0x1111, 0x2222};
+
+          DLRRSubBlock subBlock {};
+          subBlock.mSSRC = 0x3333;
+          subBlock.mLRR = 5;
+          subBlock.mDLRR = 6;
+
+          DWORD byeSSRC = 0x4444;
+
+          {
+            RTCPPacketWriter writer(this, mBuffer, sizeof(mBuffer));
+
+            TESTING_CHECK(writer.writeSenderReport(0xAAAA, 1, 2, 3, 4, 5, blocks, 2))
+            TESTING_CHECK(writer.writeSDES(0xAAAA, "cname", "mid", "rid"))
+            TESTING_CHECK(writer.writeGenericNACK(0xAAAA, 0x1111, nacks, 60))
+            TESTING_CHECK(writer.writePLI(0xAAAA, 0x1111))
+            TESTING_CHECK(writer.writeREMB(0xAAAA, 3, 0x1234, rembSSRCs, 2))
+            TESTING_CHECK(writer.writeXRReceiverReferenceTime(0xAAAA, 10, 11))
+            TESTING_CHECK(writer.writeXRDLRR(0xAAAA, &subBlock, 1))
+            TESTING_CHECK(writer.writeBye(&byeSSRC, 1, "bye"))
+            writer.flush();
+
+            TESTING_EQUAL(0, writer.size())
+            TESTING_EQUAL(mPackets.size(), writer.totalPacketsFlushed())
+          }
+
+          TESTING_CHECK(mPackets.size() > 1)  // NACKs cannot fit into a single compound packet
+
+          size_t totalNACKs = 0;
+          size_t totalSR = 0;
+          size_t totalRR = 0;
+          size_t totalSDES = 0;
+          size_t totalPLI = 0;
+          size_t totalREMB = 0;
+          size_t totalXR = 0;
+          size_t totalBye = 0;
+
+          for (auto iter = mPackets.begin(); iter != mPackets.end(); ++iter) {
+            auto packet = (*iter);
+
+            // every compound packet (including each continuation) must begin with a SR / RR
+            TESTING_CHECK(NULL != packet->first())
+            if (iter == mPackets.begin()) {
+              TESTING_EQUAL(RTCPPacket::SenderReport::kPayloadType, packet->first()->pt())
+            } else {
+              TESTING_EQUAL(RTCPPacket::ReceiverReport::kPayloadType, packet->first()->pt())
+            }
+
+            for (auto rr = packet->firstReceiverReport(); NULL != rr; rr = rr->nextReceiverReport(), ++totalRR) {
+              TESTING_EQUAL(0xAAAA, rr->ssrcOfPacketSender())
+              TESTING_EQUAL(0, rr->rc())
+            }
+
+            for (auto sr = packet->firstSenderReport(); NULL != sr; sr = sr->nextSenderReport(), ++totalSR) {
+              TESTING_EQUAL(0xAAAA, sr->ssrcOfSender())
+              TESTING_EQUAL(5, sr->senderOctetCount())
+              TESTING_EQUAL(2, sr->rc())
+              auto block = sr->firstReportBlock();
+              TESTING_CHECK(NULL != block)
+              TESTING_EQUAL(0x1111, block->ssrc())
+              TESTING_EQUAL(7, block->fractionLost())
+              TESTING_EQUAL(0x123456, block->cumulativeNumberOfPacketsLost())
+              TESTING_CHECK(NULL != block->next())
+              TESTING_EQUAL(99, block->next()->dlsr())
+            }
+
+            for (auto sdes = packet->firstSDES(); NULL != sdes; sdes = sdes->nextSDES(), ++totalSDES) {
+              auto chunk = sdes->firstChunk();
+              TESTING_CHECK(NULL != chunk)
+              TESTING_EQUAL(0xAAAA, chunk->ssrc())
+              TESTING_CHECK(NULL != chunk->firstCName())
+              TESTING_EQUAL(String("cname"), String(chunk->firstCName()->value()))
+              TESTING_CHECK(NULL != chunk->firstMid())
+              TESTING_EQUAL(String("mid"), String(chunk->firstMid()->value()))
+              TESTING_CHECK(NULL != chunk->firstRid())
+              TESTING_EQUAL(String("rid"), String(chunk->firstRid()->value()))
+            }
+
+            for (auto fm = packet->firstTransportLayerFeedbackMessage(); NULL != fm; fm = fm->nextTransportLayerFeedbackMessage()) {
+              TESTING_EQUAL(0x1111, fm->ssrcOfMediaSource())
+              for (size_t index = 0; index < fm->genericNACKCount(); ++index, ++totalNACKs) {
+                TESTING_EQUAL(static_cast<WORD>(totalNACKs * 17), fm->genericNACKAtIndex(index)->pid())
+                TESTING_EQUAL(static_cast<WORD>(totalNACKs), fm->genericNACKAtIndex(index)->blp())
+              }
+            }
+
+            for (auto fm = packet->firstPayloadSpecificFeedbackMessage(); NULL != fm; fm = fm->nextPayloadSpecificFeedbackMessage()) {
+              if (NULL != fm->pli()) ++totalPLI;
+              REMB *remb = fm->remb();
+              if (NULL == remb) continue;
+              ++totalREMB;
+              TESTING_EQUAL(3, remb->brExp())
+              TESTING_EQUAL(0x1234, remb->brMantissa())
+              TESTING_EQUAL(2, remb->numSSRC())
+              TESTING_EQUAL(0x2222, remb->ssrcAtIndex(1))
+            }
+
+            for (auto xr = packet->firstXR(); NULL != xr; xr = xr->nextXR(), ++totalXR) {
+              for (auto block = xr->firstReceiverReferenceTimeReportBlock(); NULL != block; block = block->nextReceiverReferenceTimeReportBlock()) {
+                TESTING_EQUAL(10, block->ntpTimestampMS())
+                TESTING_EQUAL(11, block->ntpTimestampLS())
+              }
+              for (auto block = xr->firstDLRRReportBlock(); NULL != block; block = block->nextDLRRReportBlock()) {
+                TESTING_EQUAL(1, block->subBlockCount())
+                TESTING_EQUAL(0x3333, block->subBlockAtIndex(0)->ssrc())
+                TESTING_EQUAL(6, block->subBlockAtIndex(0)->dlrr())
+              }
+            }
+
+            for (auto bye = packet->firstBye(); NULL != bye; bye = bye->nextBye(), ++totalBye) {
+              TESTING_EQUAL(1, bye->sc())
+              TESTING_EQUAL(0x4444, bye->ssrc(0))
+              TESTING_EQUAL(String("bye"), String(bye->reasonForLeaving()))
+            }
+          }
+
+          TESTING_EQUAL(1, totalSR)
+          TESTING_EQUAL(mPackets.size() - 1, totalRR)
+          TESTING_EQUAL(1, totalSDES)
+          TESTING_EQUAL(60, totalNACKs)
+          TESTING_EQUAL(1, totalPLI)
+          TESTING_EQUAL(1, totalREMB)
+          TESTING_EQUAL(2, totalXR)
+          TESTING_EQUAL(1, totalBye)
+        }
+
+      protected:
+        BYTE mBuffer[200] {};
+        PacketList mPackets;
+      };
+
     }
   }
 }
@@ -3560,10 +3833,12 @@ void doTestRTCPPacket()
                 break;
               }
               case 3: {
-                reachedFinalStep = true;
+                ortc::test::rtcppacket::WriterTester writerTester;
+                writerTester.test();
                 break;
               }
               case 4: {
+                reachedFinalStep = true;
                 break;
               }
               case 5: {
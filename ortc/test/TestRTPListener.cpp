@@ -1688,6 +1688,7 @@ ZS_DECLARE_TYPEDEF_PTR(ortc::IRTPTypes::EncodingParameters, EncodingParameters)
 using ortc::IICETypes;
 using zsLib::Optional;
 using zsLib::WORD;
+using zsLib::DWORD;
 using zsLib::BYTE;
 using zsLib::Milliseconds;
 using ortc::SecureByteBlock;
@@ -1695,6 +1696,7 @@ using ortc::SecureByteBlockPtr;
 
 #define TEST_BASIC_ROUTING 0
 #define TEST_BASIC_ROUTING_EXTENDED_SOURCE 1
+#define TEST_SSRC_TABLE_EXPIRY 2
 
 static void bogusSleep()
 {
@@ -1776,6 +1778,23 @@ void doTestRTPListener()
           expectations1.mUnhandled = 0;
           break;
         }
+        case TEST_SSRC_TABLE_EXPIRY:
+        {
+          UseSettings::setUInt("ortc/rtp-listener/ssrc-timeout-in-seconds", 2);
+
+          testObject1 = RTPListenerTester::create(thread);
+          testObject2 = RTPListenerTester::create(thread);
+
+          TESTING_CHECK(testObject1)
+          TESTING_CHECK(testObject2)
+
+          testObject1->setClientRole(true);
+          testObject2->setClientRole(false);
+
+          expectations1.mReceivedPackets = 3;
+          expectations1.mUnhandled = 0;
+          break;
+        }
         default:  quit = true; break;
       }
       if (quit) break;
@@ -2097,6 +2116,110 @@ void doTestRTPListener()
             }
             break;
           }
+          case TEST_SSRC_TABLE_EXPIRY: {
+            switch (step) {
+              case 1: {
+                if (testObject1) testObject1->connect(testObject2);
+                if (testObject1) testObject1->state(IICETransport::State_Completed);
+                if (testObject2) testObject2->state(IICETransport::State_Completed);
+                if (testObject1) testObject1->state(IDTLSTransportTypes::State_Connected);
+                if (testObject2) testObject2->state(IDTLSTransportTypes::State_Connected);
+                //bogusSleep();
+                break;
+              }
+              case 2: {
+                Parameters params;
+                testObject2->send("s1", params);
+                //bogusSleep();
+                break;
+              }
+              case 3: {
+                RTPPacket::CreationParams params;
+                params.mPT = 96;
+                params.mSequenceNumber = 1;
+                params.mTimestamp = 10000;
+                params.mSSRC = 5;
+                const char *payload = "expirethetablebutkeeptheroute";
+                params.mPayload = reinterpret_cast<const BYTE *>(payload);
+                params.mPayloadSize = strlen(payload);
+
+                RTPPacketPtr packet = RTPPacket::create(params);
+                testObject1->store("p1", packet);
+                testObject2->store("p1", packet);
+
+                params.mSequenceNumber = 2;
+                params.mTimestamp = 20000;
+                packet = RTPPacket::create(params);
+                testObject1->store("p2", packet);
+                testObject2->store("p2", packet);
+
+                // sender report from SSRC 5 (no report blocks)
+                BYTE sr[sizeof(DWORD)*7] = {
+                  0x80, 200, 0x00, 0x06,
+                  0x00, 0x00, 0x00, 0x05,
+                  0x00, 0x00, 0x00, 0x01,
+                  0x00, 0x00, 0x00, 0x02,
+                  0x00, 0x00, 0x4E, 0x20,
+                  0x00, 0x00, 0x00, 0x02,
+                  0x00, 0x00, 0x00, 0x3A
+                };
+
+                RTCPPacketPtr rtcpPacket = RTCPPacket::create(sr, sizeof(sr));
+                testObject1->store("sr1", rtcpPacket);
+                testObject2->store("sr1", rtcpPacket);
+
+                Parameters receiveParams;
+                EncodingParameters encoding;
+
+                encoding.mSSRC = 5;
+
+                receiveParams.mEncodings.push_back(encoding);
+
+                testObject1->receive("r1", receiveParams);
+                //bogusSleep();
+                break;
+              }
+              case 4: {
+                testObject1->expectPacket("r1", "p1");
+                testObject2->sendPacket("s1", "p1");
+                //bogusSleep();
+                break;
+              }
+              case 8: {
+                // NOTE: the SSRC table entry has expired by now (but the SSRC
+                //       remains registered) thus the sender report must
+                //       still be targeted to the receiver
+                testObject1->expectPacket("r1", "sr1");
+                testObject2->sendPacket("s1", "sr1");
+                //bogusSleep();
+                break;
+              }
+              case 9: {
+                testObject1->expectPacket("r1", "p2");
+                testObject2->sendPacket("s1", "p2");
+                //bogusSleep();
+                break;
+              }
+              case 10: {
+                if (testObject1) testObject1->state(IDTLSTransportTypes::State_Closed);
+                if (testObject2) testObject2->state(IDTLSTransportTypes::State_Closed);
+                if (testObject1) testObject1->state(IICETransport::State_Closed);
+                if (testObject2) testObject2->state(IICETransport::State_Closed);
+                //bogusSleep();
+                break;
+              }
+              case 11: {
+                lastStepReached = true;
+                //bogusSleep();
+                break;
+              }
+              default: {
+                // nothing happening in this step
+                break;
+              }
+            }
+            break;
+          }
           default: {
             // none defined
             break;
@@ -45,6 +45,8 @@
 #include "config.h"
 #include "testing.h"
 
+#include <thread>
+
 namespace ortc { namespace test { ZS_DECLARE_SUBSYSTEM(ortc_test) } }
 
 using std::make_shared;
@@ -76,6 +78,7 @@ namespace ortc
     {
       ZS_DECLARE_CLASS_PTR(Tester)
       ZS_DECLARE_USING_PTR(ortc::internal, RTPPacket)
+      using ortc::internal::RTPPacketView;
 
       class Tester : public SharedRecursiveLock
       {
@@ -161,6 +164,117 @@ namespace ortc
           return result;
         }
         
+        //---------------------------------------------------------------------
+        static SecureByteBlockPtr createHeaderExtensions(
+                                                         size_t totalExtensions,
+                                                         size_t trailingPaddingInBytes,
+                                                         bool twoByteHeader = false
+                                                         )
+        {
+          // each element carries one data byte ('a', 'b', ...)
+          size_t elementSize = (twoByteHeader ? 3 : 2);
+          size_t elementsSize = (totalExtensions * elementSize) + trailingPaddingInBytes;
+          size_t words = (elementsSize / sizeof(DWORD)) + ((0 != (elementsSize % sizeof(DWORD))) ? 1 : 0);
+
+          auto result = make_shared<SecureByteBlock>(sizeof(DWORD) + (words * sizeof(DWORD)));
+          memset(result->BytePtr(), 0, result->SizeInBytes());  // padding bytes are zero
+
+          BYTE *pos = result->BytePtr();
+          if (twoByteHeader) {
+            pos[0] = 0x10;
+            pos[1] = 0x00;
+          } else {
+            pos[0] = 0xBE;
+            pos[1] = 0xDE;
+          }
+          UseRTPUtils::setBE16(&(pos[2]), static_cast<WORD>(words));
+          pos += sizeof(DWORD);
+
+          for (size_t index = 0; index < totalExtensions; ++index, pos += elementSize) {
+            if (twoByteHeader) {
+              pos[0] = static_cast<BYTE>(index + 1);
+              pos[1] = 1;
+              pos[2] = static_cast<BYTE>('a' + index);
+            } else {
+              pos[0] = static_cast<BYTE>(((index % 14) + 1) << 4);
+              pos[1] = static_cast<BYTE>('a' + index);
+            }
+          }
+          return result;
+        }
+
+        //---------------------------------------------------------------------
+        static void checkMalformed(const SecureByteBlock &buffer)
+        {
+          RTPPacketView view(buffer.BytePtr(), buffer.SizeInBytes());
+          TESTING_CHECK(!view.isValid())
+
+          RTPPacketPtr packet = RTPPacket::create(buffer);
+          TESTING_CHECK(!packet)
+        }
+
+        //---------------------------------------------------------------------
+        static void setExtension(
+                                 RTPPacket::HeaderExtension &extension,
+                                 BYTE id,
+                                 const char *data,
+                                 RTPPacket::HeaderExtension *next = NULL
+                                 )
+        {
+          extension.mID = id;
+          extension.mData = reinterpret_cast<const BYTE *>(data);
+          extension.mDataSizeInBytes = strlen(data);
+          extension.mNext = next;
+        }
+
+        //---------------------------------------------------------------------
+        static void checkExtensions(
+                                    const RTPPacket &packet,
+                                    const BYTE *expectedIDs,
+                                    const char * const *expectedData,
+                                    size_t totalExpected,
+                                    const char *payload
+                                    )
+        {
+          // the packet must describe itself correctly and a fresh parse of
+          // its buffer must agree
+          RTPPacketPtr reparsed = RTPPacket::create(*packet.buffer());
+          TESTING_CHECK(reparsed)
+          if (!reparsed) return;
+
+          const RTPPacket *packets[2] = {&packet, reparsed.get()};
+
+          for (size_t loop = 0; loop < 2; ++loop) {
+            const RTPPacket &current = *(packets[loop]);
+
+            TESTING_EQUAL(totalExpected, current.totalHeaderExtensions())
+            TESTING_EQUAL(packet.sequenceNumber(), current.sequenceNumber())
+            TESTING_EQUAL(packet.ssrc(), current.ssrc())
+
+            size_t index = 0;
+            for (auto extension = current.firstHeaderExtension(); (NULL != extension) && (index < totalExpected); extension = extension->mNext, ++index) {
+              TESTING_EQUAL(expectedIDs[index], extension->mID)
+              TESTING_EQUAL(strlen(expectedData[index]), extension->mDataSizeInBytes)
+              TESTING_EQUAL(0, memcmp(expectedData[index], extension->mData, extension->mDataSizeInBytes))
+            }
+            TESTING_EQUAL(totalExpected, index)
+
+            TESTING_EQUAL(strlen(payload), current.payloadSize())
+            TESTING_EQUAL(0, memcmp(payload, current.payload(), current.payloadSize()))
+          }
+        }
+
+        //---------------------------------------------------------------------
+        static bool isInline(
+                             const RTPPacketPtr &packet,
+                             const void *ptr
+                             )
+        {
+          const BYTE *start = reinterpret_cast<const BYTE *>(packet.get());
+          const BYTE *pos = reinterpret_cast<const BYTE *>(ptr);
+          return (pos >= start) && (pos < start + sizeof(RTPPacket));
+        }
+
         //---------------------------------------------------------------------
         void load(
                   const SecureByteBlock &buffer,
@@ -237,9 +351,15 @@ static void bogusSleep()
 }
 
 #define TEST_BASIC_RTP 0
+#define TEST_RTP_PACKET_POOLS 1
+#define TEST_RTP_PACKET_VALIDATION 2
+#define TEST_RTP_PACKET_INSERT_HEADER_EXTENSIONS 3
+#define TEST_RTP_PACKET_TWO_BYTE_HEADER_EXTENSIONS 4
+#define TEST_RTP_PACKET_RING_BUFFER 5
 
 ZS_DECLARE_USING_PTR(ortc::test::rtppacket, Tester)
 ZS_DECLARE_USING_PTR(ortc::internal, RTPPacket)
+using ortc::internal::RTPPacketView;
 
 static BYTE gHeader1[] =
 {
@@ -311,7 +431,12 @@ void doTestRTPPacket()
       ULONG expecting = 0;
 
       switch (testNumber) {
-        case TEST_BASIC_RTP: {
+        case TEST_BASIC_RTP:
+        case TEST_RTP_PACKET_POOLS:
+        case TEST_RTP_PACKET_VALIDATION:
+        case TEST_RTP_PACKET_INSERT_HEADER_EXTENSIONS:
+        case TEST_RTP_PACKET_TWO_BYTE_HEADER_EXTENSIONS:
+        case TEST_RTP_PACKET_RING_BUFFER: {
           {
             testObject1 = Tester::create();
 
@@ -1032,6 +1157,589 @@ void doTestRTPPacket()
             }
             break;
           }
+          case TEST_RTP_PACKET_POOLS: {
+            switch (step) {
+              case 1: {
+                // released packets (and their buffers) are reused
+                auto buffer = Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, NULL, 0, "POOLED");
+
+                RTPPacketPtr packet = RTPPacket::create(*buffer);
+                TESTING_CHECK(packet)
+
+                const void *packetAddress = packet.get();
+                const BYTE *bufferAddress = packet->ptr();
+                packet.reset();
+
+                packet = RTPPacket::create(*buffer);
+                TESTING_CHECK(packet)
+                TESTING_CHECK(packetAddress == packet.get())
+                TESTING_CHECK(bufferAddress == packet->ptr())
+
+                // a packet released on another thread returns to the pool of
+                // the thread which created it
+                std::thread releaseThread([&packet]() {packet.reset();});
+                releaseThread.join();
+                TESTING_CHECK(!packet)
+
+                packet = RTPPacket::create(*buffer);
+                TESTING_CHECK(packet)
+                TESTING_CHECK(packetAddress == packet.get())
+                TESTING_CHECK(bufferAddress == packet->ptr())
+                break;
+              }
+              case 2: {
+                const char *payload = "INLINE";
+
+                // a few extensions with lots of padding stay in the inline bank
+                {
+                  auto extensions = Tester::createHeaderExtensions(3, 40);
+                  RTPPacketPtr packet = RTPPacket::create(*Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, extensions->BytePtr(), extensions->SizeInBytes(), payload));
+                  TESTING_CHECK(packet)
+                  TESTING_EQUAL(3, packet->totalHeaderExtensions())
+                  TESTING_CHECK(Tester::isInline(packet, packet->firstHeaderExtension()))
+                  TESTING_CHECK(NULL == packet->headerExtensionParseStopped())
+                }
+
+                // exactly as many extensions as the inline bank holds
+                {
+                  auto extensions = Tester::createHeaderExtensions(ORTC_RTPPACKET_MAX_INLINE_HEADER_EXTENSIONS, 0);
+                  RTPPacketPtr packet = RTPPacket::create(*Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, extensions->BytePtr(), extensions->SizeInBytes(), payload));
+                  TESTING_CHECK(packet)
+                  TESTING_EQUAL(ORTC_RTPPACKET_MAX_INLINE_HEADER_EXTENSIONS, packet->totalHeaderExtensions())
+                  TESTING_CHECK(Tester::isInline(packet, packet->firstHeaderExtension()))
+                }
+
+                // more extensions than the inline bank overflow to the heap
+                {
+                  auto extensions = Tester::createHeaderExtensions(ORTC_RTPPACKET_MAX_INLINE_HEADER_EXTENSIONS + 4, 0);
+                  RTPPacketPtr packet = RTPPacket::create(*Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, extensions->BytePtr(), extensions->SizeInBytes(), payload));
+                  TESTING_CHECK(packet)
+                  TESTING_EQUAL(ORTC_RTPPACKET_MAX_INLINE_HEADER_EXTENSIONS + 4, packet->totalHeaderExtensions())
+                  TESTING_CHECK(!Tester::isInline(packet, packet->firstHeaderExtension()))
+
+                  size_t index = 0;
+                  for (auto current = packet->firstHeaderExtension(); NULL != current; current = current->mNext, ++index) {
+                    TESTING_EQUAL(static_cast<BYTE>((index % 14) + 1), current->mID)
+                    TESTING_EQUAL(1, current->mDataSizeInBytes)
+                    TESTING_EQUAL(static_cast<BYTE>('a' + index), current->mData[0])
+                  }
+                  TESTING_EQUAL(ORTC_RTPPACKET_MAX_INLINE_HEADER_EXTENSIONS + 4, index)
+                }
+                break;
+              }
+              case 3: {
+                reachedFinalStep = true;
+                break;
+              }
+              default: {
+                // nothing happening in this step
+                break;
+              }
+            }
+            break;
+          }
+          case TEST_RTP_PACKET_VALIDATION: {
+            switch (step) {
+              case 1: {
+                const char *payload = "MALFORMED";
+
+                // one byte element claims more data than the extension holds
+                {
+                  auto extensions = Tester::createHeaderExtensions(2, 0);
+                  extensions->BytePtr()[sizeof(DWORD) + 2] |= 0x0F;   // second element now claims 16 bytes
+                  Tester::checkMalformed(*Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, extensions->BytePtr(), extensions->SizeInBytes(), payload));
+                }
+
+                // two byte element claims more data than the extension holds
+                {
+                  auto extensions = Tester::createHeaderExtensions(2, 0, true);
+                  extensions->BytePtr()[sizeof(DWORD) + 3 + 1] = 0xFF;  // second element now claims 255 bytes
+                  Tester::checkMalformed(*Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, extensions->BytePtr(), extensions->SizeInBytes(), payload));
+                }
+
+                // extension length exceeds the packet
+                {
+                  auto extensions = Tester::createHeaderExtensions(2, 0);
+                  UseRTPUtils::setBE16(&(extensions->BytePtr()[2]), 0x100);
+                  Tester::checkMalformed(*Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, extensions->BytePtr(), extensions->SizeInBytes(), payload));
+                }
+
+                // unknown extension profile
+                {
+                  auto extensions = Tester::createHeaderExtensions(2, 0);
+                  extensions->BytePtr()[0] = 0xAB;
+                  Tester::checkMalformed(*Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, extensions->BytePtr(), extensions->SizeInBytes(), payload));
+                }
+
+                // CSRC count exceeds the packet
+                {
+                  auto buffer = Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, NULL, 0, NULL);
+                  buffer->BytePtr()[0] |= 0x0F;
+                  Tester::checkMalformed(*buffer);
+                }
+
+                // padding exceeds the packet
+                {
+                  auto buffer = Tester::createPacket(2, 4, 0, false, 96, 1, 1024, 5, NULL, NULL, 0, payload);
+                  buffer->BytePtr()[buffer->SizeInBytes() - 1] = 0xF0;
+                  Tester::checkMalformed(*buffer);
+                }
+
+                // zero padding size
+                {
+                  auto buffer = Tester::createPacket(2, 4, 0, false, 96, 1, 1024, 5, NULL, NULL, 0, payload);
+                  buffer->BytePtr()[buffer->SizeInBytes() - 1] = 0;
+                  Tester::checkMalformed(*buffer);
+                }
+                break;
+              }
+              case 2: {
+                // more extensions than a view holds inline are all decoded
+                const char *payload = "OVERLIMIT";
+                size_t total = ORTC_RTPPACKET_VIEW_MAX_HEADER_EXTENSIONS + 4;
+
+                auto extensions = Tester::createHeaderExtensions(total, 0, true);
+                auto buffer = Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, extensions->BytePtr(), extensions->SizeInBytes(), payload);
+
+                RTPPacketView view(buffer->BytePtr(), buffer->SizeInBytes());
+                TESTING_CHECK(view.isValid())
+                TESTING_EQUAL(total, view.totalHeaderExtensions())
+
+                size_t index = 0;
+                for (auto current = view.firstHeaderExtension(); NULL != current; current = current->mNext, ++index) {
+                  TESTING_EQUAL(static_cast<BYTE>(index + 1), current->mID)
+                  TESTING_EQUAL(static_cast<BYTE>('a' + index), current->mData[0])
+                }
+                TESTING_EQUAL(total, index)
+
+                auto last = view.findHeaderExtension(static_cast<BYTE>(total));
+                TESTING_CHECK(NULL != last)
+                TESTING_EQUAL(static_cast<BYTE>('a' + total - 1), last->mData[0])
+
+                RTPPacketPtr packet = RTPPacket::create(*buffer);
+                TESTING_CHECK(packet)
+                TESTING_EQUAL(total, packet->totalHeaderExtensions())
+                TESTING_CHECK(NULL == packet->headerExtensionParseStopped())
+                break;
+              }
+              case 3: {
+                reachedFinalStep = true;
+                break;
+              }
+              default: {
+                // nothing happening in this step
+                break;
+              }
+            }
+            break;
+          }
+          case TEST_RTP_PACKET_INSERT_HEADER_EXTENSIONS: {
+            typedef RTPPacket::HeaderExtension HeaderExtension;
+
+            switch (step) {
+              case 1: {
+                // insert into a packet without any extensions (in place)
+                const char *payload = "NOEXTENSIONS";
+                auto buffer = Tester::createPacket(2, 0, 0, false, 96, 7, 1024, 5, NULL, NULL, 0, payload);
+
+                RTPPacketPtr packet = RTPPacket::create(buffer->BytePtr(), buffer->SizeInBytes(), 64);
+                TESTING_CHECK(packet)
+                TESTING_EQUAL(0, packet->totalHeaderExtensions())
+
+                const BYTE *before = packet->ptr();
+
+                HeaderExtension second;
+                HeaderExtension first;
+                Tester::setExtension(second, 2, "BC");
+                Tester::setExtension(first, 1, "A", &second);
+
+                packet->insertHeaderExtensions(&first);
+
+                TESTING_CHECK(before == packet->ptr())
+
+                BYTE ids[] = {1, 2};
+                const char *data[] = {"A", "BC"};
+                Tester::checkExtensions(*packet, ids, data, 2, payload);
+
+                // one byte header format retained
+                TESTING_EQUAL(0xBE, packet->ptr()[packet->headerSize()])
+                TESTING_EQUAL(0xDE, packet->ptr()[packet->headerSize() + 1])
+                break;
+              }
+              case 2: {
+                // insert into a packet with existing extensions and padding
+                // (in place, replacing a matching ID and appending another)
+                const char *payload = "EXISTING";
+                auto extensions = Tester::createHeaderExtensions(2, 2);  // IDs 1 and 2 with data "a" and "b"
+                auto buffer = Tester::createPacket(2, 4, 0, false, 96, 8, 1024, 5, NULL, extensions->BytePtr(), extensions->SizeInBytes(), payload);
+
+                RTPPacketPtr packet = RTPPacket::create(buffer->BytePtr(), buffer->SizeInBytes(), 64);
+                TESTING_CHECK(packet)
+                TESTING_EQUAL(2, packet->totalHeaderExtensions())
+                TESTING_EQUAL(4, packet->padding())
+
+                const BYTE *before = packet->ptr();
+
+                HeaderExtension appended;
+                HeaderExtension replaced;
+                Tester::setExtension(appended, 3, "XYZ");
+                Tester::setExtension(replaced, 2, "QR", &appended);
+
+                packet->insertHeaderExtensions(&replaced);
+
+                TESTING_CHECK(before == packet->ptr())
+                TESTING_EQUAL(4, packet->padding())
+
+                BYTE ids[] = {1, 2, 3};
+                const char *data[] = {"a", "QR", "XYZ"};
+                Tester::checkExtensions(*packet, ids, data, 3, payload);
+
+                // the padding trailer survives the move
+                TESTING_EQUAL(4, packet->ptr()[packet->size() - 1])
+                break;
+              }
+              case 3: {
+                // headroom exhaustion falls back to a newly allocated buffer
+                std::string payloadStr(1480, 'P');
+                const char *payload = payloadStr.c_str();
+
+                auto buffer = Tester::createPacket(2, 0, 0, false, 96, 9, 1024, 5, NULL, NULL, 0, payload);
+
+                RTPPacketPtr packet = RTPPacket::create(buffer->BytePtr(), buffer->SizeInBytes(), 0);
+                TESTING_CHECK(packet)
+
+                const BYTE *before = packet->ptr();
+                SecureByteBlockPtr originalBuffer = packet->buffer();
+
+                HeaderExtension large;
+                Tester::setExtension(large, 4, "0123456789ABCDEF");
+
+                packet->insertHeaderExtensions(&large);
+
+                TESTING_CHECK(before != packet->ptr())
+                TESTING_EQUAL(12 + strlen(payload), originalBuffer->SizeInBytes())   // original buffer untouched
+
+                BYTE ids[] = {4};
+                const char *data[] = {"0123456789ABCDEF"};
+                Tester::checkExtensions(*packet, ids, data, 1, payload);
+
+                // packets created without reserved headroom always fall back
+                RTPPacketPtr plain = RTPPacket::create(*Tester::createPacket(2, 0, 0, false, 96, 10, 1024, 5, NULL, NULL, 0, "PLAIN"));
+                TESTING_CHECK(plain)
+                before = plain->ptr();
+
+                HeaderExtension small;
+                Tester::setExtension(small, 1, "S");
+                plain->insertHeaderExtensions(&small);
+
+                TESTING_CHECK(before != plain->ptr())
+
+                BYTE plainIDs[] = {1};
+                const char *plainData[] = {"S"};
+                Tester::checkExtensions(*plain, plainIDs, plainData, 1, "PLAIN");
+                break;
+              }
+              case 4: {
+                // inserting an extension which cannot be expressed in the one
+                // byte format promotes the packet to the two byte format
+                const char *payload = "PROMOTE";
+                auto extensions = Tester::createHeaderExtensions(1, 0);   // ID 1 with data "a"
+                auto buffer = Tester::createPacket(2, 0, 0, false, 96, 11, 1024, 5, NULL, extensions->BytePtr(), extensions->SizeInBytes(), payload);
+
+                RTPPacketPtr packet = RTPPacket::create(buffer->BytePtr(), buffer->SizeInBytes(), 64);
+                TESTING_CHECK(packet)
+
+                const BYTE *before = packet->ptr();
+
+                HeaderExtension highID;
+                Tester::setExtension(highID, 20, "HI");  // IDs above 14 require two byte headers
+
+                HeaderExtension longData;
+                Tester::setExtension(longData, 5, "0123456789ABCDEFG", &highID);  // 17 bytes of data require two byte headers
+
+                packet->insertHeaderExtensions(&longData);
+
+                TESTING_CHECK(before == packet->ptr())
+
+                // two byte header profile (0x100 << 4)
+                TESTING_EQUAL(0x10, packet->ptr()[packet->headerSize()])
+                TESTING_EQUAL(0x00, packet->ptr()[packet->headerSize() + 1] & 0xF0)
+
+                BYTE ids[] = {1, 5, 20};
+                const char *data[] = {"a", "0123456789ABCDEFG", "HI"};
+                Tester::checkExtensions(*packet, ids, data, 3, payload);
+                break;
+              }
+              case 5: {
+                reachedFinalStep = true;
+                break;
+              }
+              default: {
+                // nothing happening in this step
+                break;
+              }
+            }
+            break;
+          }
+          case TEST_RTP_PACKET_TWO_BYTE_HEADER_EXTENSIONS: {
+            typedef RTPPacket::HeaderExtension HeaderExtension;
+            typedef ortc::internal::RTPHeaderExtensionLookup RTPHeaderExtensionLookup;
+
+            switch (step) {
+              case 1: {
+                // the largest element the two byte format can carry
+                const char *payload = "MAXIMUM";
+                std::string largeData(0xFF, 'r');
+
+                RTPPacketPtr packet = RTPPacket::create(*Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, NULL, 0, payload));
+                TESTING_CHECK(packet)
+
+                HeaderExtension empty;
+                HeaderExtension large;
+                Tester::setExtension(empty, 21, "");
+                Tester::setExtension(large, 20, largeData.c_str(), &empty);
+
+                packet->changeHeaderExtensions(&large);
+
+                TESTING_EQUAL(0x10, packet->ptr()[packet->headerSize()])
+
+                BYTE ids[] = {20, 21};
+                const char *data[] = {largeData.c_str(), ""};
+                Tester::checkExtensions(*packet, ids, data, 2, payload);
+
+                // a fresh parse of the rewritten packet
+                RTPPacketPtr copy = RTPPacket::create(packet->ptr(), packet->size());
+                TESTING_CHECK(copy)
+
+                // the same elements inserted in place
+
+                RTPPacketPtr headroom = RTPPacket::create(*Tester::createPacket(2, 0, 0, false, 96, 2, 1024, 5, NULL, NULL, 0, payload));
+                TESTING_CHECK(headroom)
+                headroom = RTPPacket::create(headroom->ptr(), headroom->size(), 0x200);
+                TESTING_CHECK(headroom)
+
+                const BYTE *before = headroom->ptr();
+                headroom->insertHeaderExtensions(&large);
+                TESTING_CHECK(before == headroom->ptr())
+                Tester::checkExtensions(*headroom, ids, data, 2, payload);
+
+                // the lookup resolves the string straight from the packet and
+                // from a view of the raw buffer
+                RTPHeaderExtensionLookup lookup;
+                lookup.add(20, ortc::IRTPTypes::HeaderExtensionURI_RID);
+
+                auto ext = lookup.find(*copy, ortc::IRTPTypes::HeaderExtensionURI_RID);
+                TESTING_CHECK(NULL != ext)
+                if (NULL != ext) {
+                  RTPPacket::RidHeaderExtension rid(*ext);
+                  TESTING_EQUAL(largeData, std::string(rid.rid()))
+                }
+
+                RTPPacketView view(copy->ptr(), copy->size());
+                TESTING_CHECK(view.isValid())
+                auto viewExt = lookup.find(view, ortc::IRTPTypes::HeaderExtensionURI_RID);
+                TESTING_CHECK(NULL != viewExt)
+                if (NULL != viewExt) {
+                  TESTING_EQUAL(0xFF, viewExt->mDataSizeInBytes)
+                }
+
+                TESTING_CHECK(NULL == lookup.find(*copy, ortc::IRTPTypes::HeaderExtensionURI_MuxID))
+                break;
+              }
+              case 2: {
+                // elements which no header format can express are rejected
+                // (before the packet is modified)
+                const char *payload = "REJECTED";
+                std::string tooLarge(0x100, 'x');
+
+                RTPPacketPtr packet = RTPPacket::create(*Tester::createPacket(2, 0, 0, false, 96, 1, 1024, 5, NULL, NULL, 0, payload));
+                TESTING_CHECK(packet)
+
+                HeaderExtension large;
+                Tester::setExtension(large, 20, tooLarge.c_str());
+
+                bool thrown = false;
+                try {
+                  packet->changeHeaderExtensions(&large);
+                } catch (const ortc::InvalidParameters &) {
+                  thrown = true;
+                }
+                TESTING_CHECK(thrown)
+
+                thrown = false;
+                try {
+                  packet->insertHeaderExtensions(&large);
+                } catch (const ortc::InvalidParameters &) {
+                  thrown = true;
+                }
+                TESTING_CHECK(thrown)
+
+                HeaderExtension zeroID;
+                Tester::setExtension(zeroID, 0, "Z");
+
+                thrown = false;
+                try {
+                  packet->insertHeaderExtensions(&zeroID);
+                } catch (const ortc::InvalidParameters &) {
+                  thrown = true;
+                }
+                TESTING_CHECK(thrown)
+
+                TESTING_EQUAL(0, packet->totalHeaderExtensions())
+                TESTING_EQUAL(strlen(payload), packet->payloadSize())
+                TESTING_EQUAL(0, memcmp(payload, packet->payload(), packet->payloadSize()))
+                break;
+              }
+              case 3: {
+                reachedFinalStep = true;
+                break;
+              }
+              default: {
+                // nothing happening in this step
+                break;
+              }
+            }
+            break;
+          }
+          case TEST_RTP_PACKET_RING_BUFFER: {
+            typedef ortc::internal::RTPPacketRingBuffer RTPPacketRingBuffer;
+            typedef zsLib::Time Time;
+            typedef zsLib::Seconds Seconds;
+            typedef zsLib::Milliseconds Milliseconds;
+
+            auto makePacket = [](DWORD ssrc, WORD sequenceNumber) -> RTPPacketPtr {
+              return RTPPacket::create(*Tester::createPacket(2, 0, 0, false, 96, sequenceNumber, 1024, ssrc, NULL, NULL, 0, "BUFFERED"));
+            };
+
+            Time base = zsLib::now();
+
+            switch (step) {
+              case 1: {
+                // per SSRC overwrite and total capacity expiry
+                RTPPacketRingBuffer buffer;
+                buffer.setLimits(3, 2, Seconds(60));
+
+                RTPPacketPtr a1 = makePacket(5, 1);
+                RTPPacketPtr a2 = makePacket(5, 2);
+                RTPPacketPtr a3 = makePacket(5, 3);
+                RTPPacketPtr b1 = makePacket(6, 1);
+                RTPPacketPtr b2 = makePacket(6, 2);
+
+                TESTING_CHECK(!buffer.push(base, a1))
+                TESTING_CHECK(!buffer.push(base, a2))
+                TESTING_CHECK(a1 == buffer.push(base, a3))
+                TESTING_EQUAL(2, buffer.size())
+                TESTING_EQUAL(1, buffer.ssrcCount())
+                TESTING_CHECK(a2 == buffer.front(5))
+
+                TESTING_CHECK(!buffer.push(base, b1))
+                TESTING_CHECK(!buffer.push(base, b2))
+                TESTING_EQUAL(4, buffer.size())
+                TESTING_EQUAL(2, buffer.ssrcCount())
+
+                RTPPacketRingBuffer::SSRCList ssrcs;
+                buffer.getSSRCs(ssrcs);
+                TESTING_EQUAL(2, ssrcs.size())
+
+                // the oldest packet overall is expired to get back under capacity
+                RTPPacketRingBuffer::TimeRTPPacketPair expired;
+                TESTING_CHECK(buffer.popExpired(base, expired))
+                TESTING_CHECK(a2 == expired.second)
+                TESTING_CHECK(!buffer.popExpired(base, expired))
+                TESTING_EQUAL(3, buffer.size())
+
+                buffer.clear();
+                TESTING_EQUAL(0, buffer.size())
+                TESTING_CHECK(!buffer.front(5))
+                break;
+              }
+              case 2: {
+                // drained packets which are restored keep their expiry order
+                RTPPacketRingBuffer buffer;
+                buffer.setLimits(10, 5, Seconds(10));
+
+                RTPPacketPtr a1 = makePacket(5, 1);
+                RTPPacketPtr b1 = makePacket(6, 1);
+                RTPPacketPtr a2 = makePacket(5, 2);
+
+                buffer.push(base, a1);
+                buffer.push(base + Seconds(1), b1);
+                buffer.push(base + Seconds(2), a2);
+
+                RTPPacketRingBuffer::EntryList drained;
+                buffer.drain(5, drained);
+                TESTING_EQUAL(2, drained.size())
+                TESTING_EQUAL(1, buffer.size())
+                TESTING_CHECK(!buffer.front(5))
+                TESTING_CHECK(a1 == drained.front().mPacket)
+                TESTING_CHECK(a2 == drained.back().mPacket)
+
+                // restored out of order on purpose
+                TESTING_CHECK(!buffer.restore(drained.back()))
+                TESTING_CHECK(!buffer.restore(drained.front()))
+                TESTING_EQUAL(3, buffer.size())
+                TESTING_CHECK(a1 == buffer.front(5))
+
+                RTPPacketRingBuffer::TimeRTPPacketPair expired;
+                TESTING_CHECK(!buffer.popExpired(base + Seconds(5), expired))
+
+                TESTING_CHECK(buffer.popExpired(base + Seconds(10) + Milliseconds(500), expired))
+                TESTING_CHECK(a1 == expired.second)
+                TESTING_CHECK(base == expired.first)
+                TESTING_CHECK(!buffer.popExpired(base + Seconds(10) + Milliseconds(500), expired))
+
+                TESTING_CHECK(buffer.popExpired(base + Seconds(13), expired))
+                TESTING_CHECK(b1 == expired.second)
+                TESTING_CHECK(buffer.popExpired(base + Seconds(13), expired))
+                TESTING_CHECK(a2 == expired.second)
+                TESTING_CHECK(!buffer.popExpired(base + Seconds(13), expired))
+
+                TESTING_EQUAL(0, buffer.size())
+                TESTING_EQUAL(0, buffer.ssrcCount())
+                break;
+              }
+              case 3: {
+                // restoring into a full ring drops whichever packet is oldest
+                RTPPacketRingBuffer buffer;
+                buffer.setLimits(10, 2, Seconds(60));
+
+                RTPPacketPtr a1 = makePacket(5, 1);
+                RTPPacketPtr a2 = makePacket(5, 2);
+                RTPPacketPtr a3 = makePacket(5, 3);
+
+                buffer.push(base, a1);
+                buffer.push(base, a2);
+
+                RTPPacketRingBuffer::EntryList drained;
+                buffer.drain(5, drained);
+                TESTING_EQUAL(0, buffer.size())
+
+                buffer.push(base + Seconds(1), a3);
+
+                TESTING_CHECK(!buffer.restore(drained.back()))
+                TESTING_CHECK(a1 == buffer.restore(drained.front()))
+                TESTING_EQUAL(2, buffer.size())
+                TESTING_CHECK(a2 == buffer.front(5))
+
+                RTPPacketRingBuffer::TimeRTPPacketPair expired;
+                TESTING_CHECK(buffer.popExpired(base + Seconds(61), expired))
+                TESTING_CHECK(a2 == expired.second)
+                TESTING_CHECK(!buffer.popExpired(base + Seconds(61), expired))
+                TESTING_CHECK(buffer.popExpired(base + Seconds(62), expired))
+                TESTING_CHECK(a3 == expired.second)
+                break;
+              }
+              case 4: {
+                reachedFinalStep = true;
+                break;
+              }
+              default: {
+                // nothing happening in this step
+                break;
+              }
+            }
+            break;
+          }
           default: {
             // none defined
             break;
@@ -1875,6 +1875,69 @@ namespace ortc
         return true;
       }
 
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark FakeReceiver => IRTPReceiverForRTPSender
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      IMediaStreamTrackTypes::Kinds FakeReceiver::getKind() const
+      {
+        return mKind;
+      }
+
+      //-----------------------------------------------------------------------
+      void FakeReceiver::registerForwarder(
+                                           UseForwarderPtr forwarder,
+                                           const char *rid
+                                           )
+      {
+        TESTING_CHECK(forwarder)
+
+        ZS_LOG_BASIC(log("registering forwarder") + ZS_PARAM("forwarder", forwarder->getID()) + ZS_PARAM("rid", rid))
+
+        AutoRecursiveLock lock(*this);
+        mForwarder = forwarder;
+      }
+
+      //-----------------------------------------------------------------------
+      void FakeReceiver::unregisterForwarder(PUID forwarderID)
+      {
+        ZS_LOG_BASIC(log("unregistering forwarder") + ZS_PARAM("forwarder", forwarderID))
+
+        AutoRecursiveLock lock(*this);
+
+        auto forwarder = mForwarder.lock();
+        if (!forwarder) return;
+        if (forwarder->getID() != forwarderID) return;
+
+        mForwarder.reset();
+      }
+
+      //-----------------------------------------------------------------------
+      bool FakeReceiver::sendPacket(RTCPPacketPtr packet)
+      {
+        ZS_LOG_BASIC(log("sending RTCP packet to source") + packet->toDebug())
+
+        AutoRecursiveLock lock(*this);
+
+        TESTING_CHECK(mExpectFeedbackBuffers.size() > 0)
+        if (mExpectFeedbackBuffers.size() < 1) return false;
+
+        TESTING_CHECK(0 == UseServicesHelper::compare(*(mExpectFeedbackBuffers.front()), *(packet->buffer())))
+
+        mExpectFeedbackBuffers.pop_front();
+
+        auto tester = mTester.lock();
+
+        if (tester) tester->notifyReceivedPacket();
+
+        return true;
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -1978,6 +2041,38 @@ namespace ortc
         transport->sendPacket(IICETypes::Component_RTP, IICETypes::Component_RTP, buffer->BytePtr(), buffer->SizeInBytes());
       }
 
+      //-----------------------------------------------------------------------
+      void FakeReceiver::forwardPacket(RTPPacketPtr packet)
+      {
+        UseForwarderPtr forwarder;
+        ParametersPtr params;
+
+        {
+          AutoRecursiveLock lock(*this);
+          forwarder = mForwarder.lock();
+          params = mParameters;
+        }
+
+        TESTING_CHECK(forwarder)
+        TESTING_CHECK(params)
+        if (!forwarder) return;
+
+        // NOTE: forwarded outside of the lock (as the receiver does)
+        forwarder->forwardPacket(FakeReceiver::getID(), params, packet);
+      }
+
+      //-----------------------------------------------------------------------
+      void FakeReceiver::expectFeedback(SecureByteBlockPtr data)
+      {
+        TESTING_CHECK((bool)data)
+
+        AutoRecursiveLock lock(*this);
+
+        ZS_LOG_TRACE(log("expecting feedback") + ZS_PARAM("buffer size", data->SizeInBytes()))
+
+        mExpectFeedbackBuffers.push_back(data);
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -2788,6 +2883,75 @@ namespace ortc
         }
       }
 
+      //-----------------------------------------------------------------------
+      void RTPSenderTester::setForwardingSource(const char *receiverID)
+      {
+        FakeReceiverPtr receiver = getReceiver(receiverID);
+        TESTING_CHECK(receiver)
+
+        TESTING_CHECK(mSender)
+
+        // a sender cannot forward while a track is attached
+        TESTING_CHECK(mSender->setForwardingSource(receiver, NULL)->isRejected())
+
+        mSender->setTrack(IMediaStreamTrackPtr());
+
+        TESTING_CHECK(mSender->setForwardingSource(receiver, NULL)->isResolved())
+      }
+
+      //-----------------------------------------------------------------------
+      void RTPSenderTester::forwardPacket(
+                                          const char *receiverID,
+                                          const char *packetID
+                                          )
+      {
+        FakeReceiverPtr receiver = getReceiver(receiverID);
+        TESTING_CHECK(receiver)
+
+        RTPPacketPtr packet = getRTPPacket(packetID);
+        TESTING_CHECK(packet)
+
+        receiver->forwardPacket(packet);
+      }
+
+      //-----------------------------------------------------------------------
+      void RTPSenderTester::deliverFeedback(const char *packetID)
+      {
+        TESTING_CHECK(mSender)
+
+        RTCPPacketPtr packet = getRTCPPacket(packetID);
+        TESTING_CHECK(packet)
+
+        // NOTE: the listener hands RTCP to the sender parsed in fast mode
+        RTCPPacketPtr fastPacket = RTCPPacket::create(UseServicesHelper::convertToBuffer(packet->ptr(), packet->size()), RTCPPacket::ParseMode_Fast);
+        TESTING_CHECK(fastPacket)
+
+        internal::IRTPSenderForRTPListenerPtr sender = RTPSender::convert(mSender);
+        TESTING_CHECK(sender)
+
+        sender->handlePacket(IICETypes::Component_RTCP, fastPacket);
+      }
+
+      //-----------------------------------------------------------------------
+      void RTPSenderTester::expectFeedback(
+                                           const char *receiverID,
+                                           const char *packetID
+                                           )
+      {
+        FakeReceiverPtr receiver = getReceiver(receiverID);
+        TESTING_CHECK(receiver)
+
+        RTCPPacketPtr packet = getRTCPPacket(packetID);
+        TESTING_CHECK(packet)
+
+        {
+          AutoRecursiveLock lock(*this);
+          ++mExpecting.mReceivedPackets;
+        }
+
+        receiver->expectFeedback(packet->buffer());
+      }
+
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
       //-----------------------------------------------------------------------
@@ -3015,12 +3179,57 @@ namespace ortc
 
         receiver->sendPacket(secureBuffer);
       }
+
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      //-----------------------------------------------------------------------
+      #pragma mark
+      #pragma mark FeedbackWriter
+      #pragma mark
+
+      //-----------------------------------------------------------------------
+      class FeedbackWriter : public ortc::internal::IRTCPPacketWriterDelegate
+      {
+      public:
+        typedef ortc::internal::RTCPPacketWriter RTCPPacketWriter;
+        typedef RTCPPacketWriter::GenericNACK GenericNACK;
+
+      public:
+        FeedbackWriter() : mWriter(this, mBuffer, sizeof(mBuffer)) {}
+
+        RTCPPacketWriter &writer()                              {return mWriter;}
+
+        RTCPPacketPtr packet()
+        {
+          mWriter.flush();
+          TESTING_CHECK(mPacket)
+          return mPacket;
+        }
+
+        virtual void onRTCPPacketWriterPacket(
+                                              const BYTE *packet,
+                                              size_t packetSizeInBytes
+                                              ) override
+        {
+          TESTING_CHECK(!mPacket)   // all feedback must fit a single compound packet
+
+          mPacket = RTCPPacket::create(packet, packetSizeInBytes);
+          TESTING_CHECK(mPacket)
+        }
+
+      protected:
+        BYTE mBuffer[1200] {};
+        RTCPPacketWriter mWriter;
+        RTCPPacketPtr mPacket;
+      };
     }
   }
 }
 
 ZS_DECLARE_USING_PTR(ortc::test::rtpsender, FakeICETransport)
 ZS_DECLARE_USING_PTR(ortc::test::rtpsender, RTPSenderTester)
+using ortc::test::rtpsender::FeedbackWriter;
 ZS_DECLARE_USING_PTR(ortc, IICETransport)
 ZS_DECLARE_USING_PTR(ortc, IDTLSTransport)
 using ortc::IDTLSTransportTypes;
@@ -3050,6 +3259,7 @@ using ortc::SecureByteBlockPtr;
 
 #define TEST_BASIC_ROUTING 0
 #define TEST_SSRC_ROUTING 1
+#define TEST_FORWARDED_FEEDBACK 2
 
 static void bogusSleep()
 {
@@ -3118,6 +3328,14 @@ void doTestRTPSender()
           }
           break;
         }
+        case TEST_FORWARDED_FEEDBACK: {
+          {
+            testObject1 = RTPSenderTester::create(thread, IMediaStreamTrackTypes::Kind_Audio, true);
+
+            TESTING_CHECK(testObject1)
+          }
+          break;
+        }
         default:  quit = true; break;
       }
       if (quit) break;
@@ -4185,6 +4403,115 @@ void doTestRTPSender()
             }
             break;
           }
+          case TEST_FORWARDED_FEEDBACK: {
+            switch (step) {
+              case 2: {
+                {
+                  Parameters params;
+
+                  CodecParameters codec;
+                  codec.mName = IRTPTypes::toString(IRTPTypes::SupportedCodec_Opus);
+                  codec.mClockRate = 48000;
+                  codec.mPayloadType = 100;
+                  params.mCodecs.push_back(codec);
+
+                  params.mRTCP.mSSRC = 2000;    // ssrc the source receives feedback from
+
+                  testObject1->store("params-source", params);
+                }
+                {
+                  Parameters params;
+
+                  CodecParameters codec;
+                  codec.mName = IRTPTypes::toString(IRTPTypes::SupportedCodec_Opus);
+                  codec.mClockRate = 48000;
+                  codec.mPayloadType = 96;
+                  params.mCodecs.push_back(codec);
+
+                  EncodingParameters encoding;
+                  encoding.mSSRC = 1000;
+                  encoding.mCodecPayloadType = 96;
+                  params.mEncodings.push_back(encoding);
+
+                  testObject1->store("params-send", params);
+                }
+                {
+                  RTPPacket::CreationParams params;
+                  params.mPT = 100;
+                  params.mSequenceNumber = 100;
+                  params.mTimestamp = 10000;
+                  params.mSSRC = 5000;
+                  const char *payload = "first source";
+                  params.mPayload = reinterpret_cast<const BYTE *>(payload);
+                  params.mPayloadSize = strlen(payload);
+
+                  RTPPacketPtr packet = RTPPacket::create(params);
+                  testObject1->store("p1", packet);
+                }
+                {
+                  RTPPacket::CreationParams params;
+                  params.mPT = 100;
+                  params.mSequenceNumber = 500;
+                  params.mTimestamp = 70000;
+                  params.mSSRC = 6000;
+                  const char *payload = "second source";
+                  params.mPayload = reinterpret_cast<const BYTE *>(payload);
+                  params.mPayloadSize = strlen(payload);
+
+                  RTPPacketPtr packet = RTPPacket::create(params);
+                  testObject1->store("p2", packet);
+                }
+                {
+                  // remote asks the sender (ssrc 1000) for sequence number 102 and a key frame
+                  FeedbackWriter feedback;
+                  FeedbackWriter::GenericNACK nack;
+                  nack.mPID = 102;
+                  feedback.writer().writeGenericNACK(7777, 1000, &nack, 1);
+                  feedback.writer().writePLI(7777, 1000);
+                  testObject1->store("fb1", feedback.packet());
+                }
+                {
+                  // p2 was sent as sequence number 101 thus 102 maps back to 501 (of ssrc 6000)
+                  FeedbackWriter feedback;
+                  FeedbackWriter::GenericNACK nack;
+                  nack.mPID = 501;
+                  feedback.writer().writeGenericNACK(2000, 6000, &nack, 1);
+                  feedback.writer().writePLI(2000, 6000);
+                  testObject1->store("fb1-mapped", feedback.packet());
+                }
+                break;
+              }
+              case 3: {
+                testObject1->receive("source", "params-source");
+                testObject1->setForwardingSource("source");
+                testObject1->send("params-send");
+                break;
+              }
+              case 4: {
+                testObject1->forwardPacket("source", "p1");
+                testObject1->forwardPacket("source", "p2");
+                break;
+              }
+              case 5: {
+                testObject1->expectFeedback("source", "fb1-mapped");
+                testObject1->deliverFeedback("fb1");
+                break;
+              }
+              case 7: {
+                if (testObject1) testObject1->closeByReset();
+                break;
+              }
+              case 8: {
+                lastStepReached = true;
+                break;
+              }
+              default: {
+                // nothing happening in this step
+                break;
+              }
+            }
+            break;
+          }
           default: {
             // none defined
             break;
@@ -944,6 +944,21 @@ namespace ortc
                                   RTCPPacketPtr packet
                                   ) override;
 
+        //---------------------------------------------------------------------
+        #pragma mark
+        #pragma mark FakeReceiver => IRTPReceiverForRTPSender
+        #pragma mark
+
+        virtual IMediaStreamTrackTypes::Kinds getKind() const override;
+
+        virtual void registerForwarder(
+                                       UseForwarderPtr forwarder,
+                                       const char *rid
+                                       ) override;
+        virtual void unregisterForwarder(PUID forwarderID) override;
+
+        virtual bool sendPacket(RTCPPacketPtr packet) override;
+
         //---------------------------------------------------------------------
         #pragma mark
         #pragma mark FakeReceiver => (friend RTPSenderTester)
@@ -958,6 +973,9 @@ namespace ortc
 
         void sendPacket(SecureByteBlockPtr buffer);
 
+        void forwardPacket(RTPPacketPtr packet);
+        void expectFeedback(SecureByteBlockPtr data);
+
       protected:
         //---------------------------------------------------------------------
         #pragma mark
@@ -985,6 +1003,9 @@ namespace ortc
 
         UseListenerPtr mListener;
         UseSecureTransportPtr mSecureTransport;
+
+        UseForwarderWeakPtr mForwarder;
+        BufferList mExpectFeedbackBuffers;
       };
 
       //-----------------------------------------------------------------------
@@ -1248,6 +1269,17 @@ namespace ortc
                           const char *packetID
                           );
 
+        void setForwardingSource(const char *receiverID);
+        void forwardPacket(
+                           const char *receiverID,
+                           const char *packetID
+                           );
+        void deliverFeedback(const char *packetID);
+        void expectFeedback(
+                            const char *receiverID,
+                            const char *packetID
+                            );
+
       protected:
 
         //---------------------------------------------------------------------
@@ -311,10 +311,12 @@ namespace ortc
         virtual bool handleReceivedDecryptedPacket(
                                                    IICETypes::Components viaTransport,
                                                    IICETypes::Components packetType,
-                                                   const BYTE *buffer,
-                                                   size_t bufferLengthInBytes
+                                                   SecureByteBlockPtr decryptedBuffer
                                                    ) override
         {
+          const BYTE *buffer = decryptedBuffer->BytePtr();
+          size_t bufferLengthInBytes = decryptedBuffer->SizeInBytes();
+
           ZS_LOG_DEBUG(log("handling decrypted packet from SRTP") + ZS_PARAM("via", IICETypes::toString(viaTransport)) + ZS_PARAM("packet type", IICETypes::toString(packetType)) + ZS_PARAM("buffer", (PTRNUMBER)(buffer)) + ZS_PARAM("buffer size", bufferLengthInBytes))
 
           ISRTPTesterPtr tester;